@@ -65,6 +65,10 @@
 #!
 
 #! \param SUBPROJECTS List of CDash labels
+#! \param AUTOLOAD_INTERFACES List of service interface ids provided by an auto-load
+#!        module (see AUTOLOAD_WITH). An auto-load manifest listing them is generated
+#!        next to the module, so that it is only loaded on the first lookup of one of
+#!        these interfaces if lazy auto-loading is enabled.
 #! \param INCLUDE_DIRS Include directories for this module:
 #!        \verbatim
 #! [[PUBLIC|PRIVATE|INTERFACE] <dir1>...]...
@@ -113,6 +117,7 @@ function(mitk_create_module)
 
   set(_macro_multiparams
       SUBPROJECTS            # list of CDash labels
+      AUTOLOAD_INTERFACES    # list of service interface ids written to the auto-load manifest
       INCLUDE_DIRS           # include directories: [PUBLIC|PRIVATE|INTERFACE] <list>
       INTERNAL_INCLUDE_DIRS  # include dirs internal to this module (DEPRECATED)
       DEPENDS                # list of modules this module depends on: [PUBLIC|PRIVATE|INTERFACE] <list>
@@ -557,6 +562,16 @@ function(mitk_create_module)
         set_target_properties(${MODULE_TARGET} PROPERTIES
                               MITK_AUTOLOAD_DIRECTORY ${MODULE_AUTOLOAD_WITH})
 
+        if(MODULE_AUTOLOAD_INTERFACES)
+          # the auto-load manifest lets CppMicroServices defer loading this module
+          # until one of its service interfaces is looked up
+          string(REPLACE ";" "\", \"" _module_autoload_interfaces "${MODULE_AUTOLOAD_INTERFACES}")
+          file(GENERATE OUTPUT "$<TARGET_FILE:${MODULE_TARGET}>.autoload.json"
+               CONTENT "{ \"interfaces\" : [ \"${_module_autoload_interfaces}\" ] }\n")
+          set_target_properties(${MODULE_TARGET} PROPERTIES
+                                MITK_AUTOLOAD_INTERFACES "${MODULE_AUTOLOAD_INTERFACES}")
+        endif()
+
         # add the auto-load module name as a property
         set_property(TARGET ${MODULE_AUTOLOAD_WITH} APPEND PROPERTY MITK_AUTOLOAD_TARGETS ${MODULE_TARGET})
       endif()
@@ -68,6 +68,16 @@ function(mitkFunctionInstallAutoLoadModules)
                     DESTINATION ${_module_install_dir}
                     CONFIGURATIONS Release)
 
+            get_target_property(_autoload_interfaces ${_autoload_target} MITK_AUTOLOAD_INTERFACES)
+            if(_autoload_interfaces)
+              install(FILES ${_target_loc_debug}.autoload.json
+                      DESTINATION ${_module_install_dir}
+                      CONFIGURATIONS Debug)
+              install(FILES ${_target_loc_release}.autoload.json
+                      DESTINATION ${_module_install_dir}
+                      CONFIGURATIONS Release)
+            endif()
+
             set(_${_autoload_target}_installed 1)
 
             if(UNIX AND NOT APPLE)
@@ -34,6 +34,10 @@ namespace mitk
   //## or a TimeGeometry containing multiple instances
   //## of PlaneGeometry
   //##
+  //## As the distance from the plane is linear along an image row, the
+  //## crossing of the plane is computed once per row and both parts of
+  //## the row are written at once. The slices are clipped in parallel.
+  //##
   //## \todo add AutoOrientLabels, which makes the "left" side (minimum X value) side of the image get one defined
   //label.
   //##       left-most because vtkPolyDataNormals uses the same definition and this filter is used for visualization of
@@ -38,6 +38,9 @@ namespace mitk
    * voxels which are out of bounds when projected on this plane will be clipped
    * as well.
    *
+   * The rows of the height field and the slices of the image are processed
+   * in parallel.
+   *
    * \ingroup Process
    */
   class MITKALGORITHMSEXT_EXPORT HeightFieldSurfaceClipImageFilter : public ImageToImageFilter
@@ -16,10 +16,10 @@ found in the LICENSE file.
 #include "mitkTimeHelper.h"
 
 #include "mitkImageToItk.h"
+#include "mitkParallelFor.h"
 
-#include "itkImageRegionConstIterator.h"
-#include "itkImageRegionIteratorWithIndex.h"
-
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 mitk::GeometryClipImageFilter::GeometryClipImageFilter()
@@ -111,6 +111,52 @@ void mitk::GeometryClipImageFilter::GenerateOutputInformation()
   m_TimeOfHeaderInitialization.Modified();
 }
 
+namespace
+{
+  /** Computes the part [begin, end) of a row of n voxels in which distance + x * increment is positive.
+   *  The crossing is computed analytically and corrected afterwards, so that the result agrees exactly
+   *  with evaluating every voxel of the row. */
+  void GetPositiveSpan(double distance, double increment, std::size_t n, std::size_t &begin, std::size_t &end)
+  {
+    auto isPositive = [distance, increment](std::size_t x) { return distance + increment * x > 0; };
+
+    if (increment == 0)
+    {
+      begin = 0;
+      end = distance > 0 ? n : 0;
+      return;
+    }
+
+    const double crossing = -distance / increment;
+    std::size_t split = 0;
+    if (crossing >= n)
+      split = n;
+    else if (crossing > 0)
+      split = static_cast<std::size_t>(std::ceil(crossing));
+
+    if (increment > 0)
+    {
+      // positive part is at the end of the row
+      while (split > 0 && isPositive(split - 1))
+        --split;
+      while (split < n && !isPositive(split))
+        ++split;
+      begin = split;
+      end = n;
+    }
+    else
+    {
+      // positive part is at the beginning of the row
+      while (split > 0 && !isPositive(split - 1))
+        --split;
+      while (split < n && isPositive(split))
+        ++split;
+      begin = 0;
+      end = split;
+    }
+  }
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::GeometryClipImageFilter::_InternalComputeClippedImage(itk::Image<TPixel, VImageDimension> *inputItkImage,
                                                                  mitk::GeometryClipImageFilter *geometryClipper,
@@ -118,40 +164,29 @@ void mitk::GeometryClipImageFilter::_InternalComputeClippedImage(itk::Image<TPix
 {
   typedef itk::Image<TPixel, VImageDimension> ItkInputImageType;
   typedef itk::Image<TPixel, VImageDimension> ItkOutputImageType;
-
-  typedef itk::ImageRegionConstIteratorWithIndex<ItkInputImageType> ItkInputImageIteratorType;
-  typedef itk::ImageRegionIteratorWithIndex<ItkOutputImageType> ItkOutputImageIteratorType;
+  typedef typename ItkOutputImageType::PixelType OutputPixelType;
 
   typename mitk::ImageToItk<ItkOutputImageType>::Pointer outputimagetoitk = mitk::ImageToItk<ItkOutputImageType>::New();
   outputimagetoitk->SetInput(geometryClipper->m_OutputTimeSelector->GetOutput());
   outputimagetoitk->Update();
   typename ItkOutputImageType::Pointer outputItkImage = outputimagetoitk->GetOutput();
 
-  // create the iterators
-  typename ItkInputImageType::RegionType inputRegionOfInterest = inputItkImage->GetLargestPossibleRegion();
-  ItkInputImageIteratorType inputIt(inputItkImage, inputRegionOfInterest);
-  ItkOutputImageIteratorType outputIt(outputItkImage, inputRegionOfInterest);
-
-  typename ItkOutputImageType::PixelType outsideValue;
+  OutputPixelType outsideValue;
   if (geometryClipper->m_AutoOutsideValue)
-    outsideValue = itk::NumericTraits<typename ItkOutputImageType::PixelType>::min();
+    outsideValue = itk::NumericTraits<OutputPixelType>::min();
   else
-    outsideValue = (typename ItkOutputImageType::PixelType)geometryClipper->m_OutsideValue;
+    outsideValue = (OutputPixelType)geometryClipper->m_OutsideValue;
 
   mitk::BaseGeometry *inputGeometry = geometryClipper->m_InputTimeSelector->GetOutput()->GetGeometry();
-  typedef itk::Index<VImageDimension> IndexType;
-  Point3D indexPt;
-  indexPt.Fill(0);
-  int i, dim = IndexType::GetIndexDimension();
-  Point3D pointInMM;
   bool above = geometryClipper->m_ClipPartAboveGeometry;
   bool labelBothSides = geometryClipper->GetLabelBothSides();
 
   if (geometryClipper->GetAutoOrientLabels())
   {
     Point3D leftMostPoint;
-    leftMostPoint.Fill(std::numeric_limits<float>::min() / 2.0);
-    if (clippingPlaneGeometry->IsAbove(pointInMM) != above)
+    // numeric_limits::min() is the smallest positive value, lowest() is the most negative one
+    leftMostPoint.Fill(std::numeric_limits<float>::lowest() / 2.0);
+    if (clippingPlaneGeometry->IsAbove(leftMostPoint) != above)
     {
       // invert meaning of above --> left is always the "above" side
       above = !above;
@@ -161,38 +196,86 @@ void mitk::GeometryClipImageFilter::_InternalComputeClippedImage(itk::Image<TPix
       MITK_INFO << leftMostPoint << " is above geometry" << std::endl;
   }
 
-  auto aboveLabel =
-    (typename ItkOutputImageType::PixelType)geometryClipper->GetAboveGeometryLabel();
-  auto belowLabel =
-    (typename ItkOutputImageType::PixelType)geometryClipper->GetBelowGeometryLabel();
+  auto aboveLabel = (OutputPixelType)geometryClipper->GetAboveGeometryLabel();
+  auto belowLabel = (OutputPixelType)geometryClipper->GetBelowGeometryLabel();
 
-  for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+  // The signed distance of a voxel from the plane is an affine function of its index. It is
+  // described by the distance of index (0,0,0) and the increments along the image axes, which
+  // allows to compute the crossing of the plane once per row instead of testing every voxel.
+  Point3D indexPt;
+  indexPt.Fill(0);
+  Point3D pointInMM;
+  inputGeometry->IndexToWorld(indexPt, pointInMM);
+  const double originDistance = clippingPlaneGeometry->SignedDistanceFromPlane(pointInMM);
+
+  const double normalLength = clippingPlaneGeometry->GetNormalVnl().two_norm();
+  const Vector3D normal = clippingPlaneGeometry->GetNormal();
+  double distanceIncrement[3] = {0.0, 0.0, 0.0};
+  for (unsigned int i = 0; i < 3 && normalLength != 0; ++i)
   {
-    if ((typename ItkOutputImageType::PixelType)inputIt.Get() == outsideValue)
+    Vector3D axis, axisInMM;
+    axis.Fill(0);
+    axis[i] = 1;
+    inputGeometry->IndexToWorld(axis, axisInMM);
+    distanceIncrement[i] = axisInMM * normal / normalLength;
+  }
+
+  const typename ItkInputImageType::RegionType region = inputItkImage->GetBufferedRegion();
+  const std::size_t rowLength = region.GetSize(0);
+  if (rowLength == 0)
+    return;
+  const std::size_t rowsPerSlice = VImageDimension > 1 ? region.GetSize(1) : 1;
+  const std::size_t numberOfSlices = region.GetNumberOfPixels() / (rowLength * rowsPerSlice);
+
+  const TPixel *inputBuffer = inputItkImage->GetBufferPointer();
+  OutputPixelType *outputBuffer = outputItkImage->GetBufferPointer();
+
+  // Writes a span of voxels that lie all on the same side of the plane
+  auto writeSpan = [&](const TPixel *in, OutputPixelType *out, std::size_t count, bool clippedSide)
+  {
+    if (!labelBothSides)
     {
-      outputIt.Set(outsideValue);
+      // voxels that have the outside value already keep it when copied
+      if (clippedSide)
+        std::fill_n(out, count, outsideValue);
+      else
+        std::copy(in, in + count, out);
     }
     else
     {
-      for (i = 0; i < dim; ++i)
-        indexPt[i] = (mitk::ScalarType)inputIt.GetIndex()[i];
-      inputGeometry->IndexToWorld(indexPt, pointInMM);
-      if (clippingPlaneGeometry->IsAbove(pointInMM) == above)
-      {
-        if (labelBothSides)
-          outputIt.Set(aboveLabel);
-        else
-          outputIt.Set(outsideValue);
-      }
-      else
+      const OutputPixelType label = clippedSide ? aboveLabel : belowLabel;
+      for (std::size_t x = 0; x < count; ++x)
+        out[x] = ((OutputPixelType)in[x] == outsideValue) ? outsideValue : label;
+    }
+  };
+
+  mitk::ParallelFor(numberOfSlices, [&](std::size_t slice)
+  {
+    for (std::size_t rowInSlice = 0; rowInSlice < rowsPerSlice; ++rowInSlice)
+    {
+      const std::size_t row = slice * rowsPerSlice + rowInSlice;
+
+      // distance of the first voxel of the row
+      double rowDistance = originDistance + distanceIncrement[0] * region.GetIndex(0);
+      std::size_t remainder = row;
+      for (unsigned int d = 1; d < VImageDimension; ++d)
       {
-        if (labelBothSides)
-          outputIt.Set(belowLabel);
-        else
-          outputIt.Set(inputIt.Get());
+        const std::size_t index = remainder % region.GetSize(d);
+        remainder /= region.GetSize(d);
+        if (d < 3)
+          rowDistance += distanceIncrement[d] * (region.GetIndex(d) + static_cast<double>(index));
       }
+
+      std::size_t begin, end;
+      GetPositiveSpan(rowDistance, distanceIncrement[0], rowLength, begin, end);
+
+      const TPixel *in = inputBuffer + row * rowLength;
+      OutputPixelType *out = outputBuffer + row * rowLength;
+      writeSpan(in, out, begin, !above);
+      writeSpan(in + begin, out + begin, end - begin, above);
+      writeSpan(in + end, out + end, rowLength - end, !above);
     }
-  }
+  });
 }
 
 #include "mitkImageAccessByItk.h"
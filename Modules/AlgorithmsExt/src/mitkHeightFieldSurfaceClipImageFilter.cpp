@@ -17,15 +17,69 @@ found in the LICENSE file.
 
 #include "mitkImageAccessByItk.h"
 #include "mitkImageToItk.h"
-
-#include <itkImageRegionConstIterator.h>
-#include <itkImageRegionIteratorWithIndex.h>
-#include <itkImageSliceConstIteratorWithIndex.h>
+#include "mitkParallelFor.h"
 
 #include <vtkCellLocator.h>
 #include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
+
+namespace
+{
+  /** Returns the first index in [0, n] for which the monotonic predicate (false ... false, true ... true)
+   *  holds, starting the search at the estimate guess. */
+  template <typename TPredicate>
+  std::size_t FindFirst(const TPredicate &predicate, double guess, std::size_t n)
+  {
+    std::size_t i = 0;
+    if (guess >= n)
+      i = n;
+    else if (guess > 0)
+      i = static_cast<std::size_t>(std::ceil(guess));
+
+    while (i > 0 && predicate(i - 1))
+      --i;
+    while (i < n && !predicate(i))
+      ++i;
+    return i;
+  }
+
+  /** Restricts the span [begin, end) of a line of n points to the points i for which
+   *  lower < a + b * i < upper. As the coordinate is linear along the line, the bounds
+   *  are computed analytically and only corrected at the crossings. */
+  void RestrictSpanToInterval(
+    double a, double b, double lower, double upper, std::size_t n, std::size_t &begin, std::size_t &end)
+  {
+    auto coordinate = [a, b](std::size_t i) { return a + b * i; };
+
+    if (b == 0)
+    {
+      if (!(coordinate(0) > lower && coordinate(0) < upper))
+        end = begin;
+      return;
+    }
+
+    const double lowerCrossing = (lower - a) / b;
+    const double upperCrossing = (upper - a) / b;
+    if (b > 0)
+    {
+      begin = std::max(begin, FindFirst([&](std::size_t i) { return coordinate(i) > lower; }, lowerCrossing, n));
+      end = std::min(end, FindFirst([&](std::size_t i) { return !(coordinate(i) < upper); }, upperCrossing, n));
+    }
+    else
+    {
+      begin = std::max(begin, FindFirst([&](std::size_t i) { return coordinate(i) < upper; }, upperCrossing, n));
+      end = std::min(end, FindFirst([&](std::size_t i) { return !(coordinate(i) > lower); }, lowerCrossing, n));
+    }
+
+    if (end < begin)
+      end = begin;
+  }
+}
 
 namespace mitk
 {
@@ -140,20 +194,11 @@ namespace mitk
     typedef itk::Image<TPixel, VImageDimension> ItkInputImageType;
     typedef itk::Image<TPixel, VImageDimension> ItkOutputImageType;
 
-    typedef itk::ImageSliceConstIteratorWithIndex<ItkInputImageType> ItkInputImageIteratorType;
-    typedef itk::ImageRegionIteratorWithIndex<ItkOutputImageType> ItkOutputImageIteratorType;
-
     typename ImageToItk<ItkOutputImageType>::Pointer outputimagetoitk = ImageToItk<ItkOutputImageType>::New();
     outputimagetoitk->SetInput(clipImageFilter->m_OutputTimeSelector->GetOutput());
     outputimagetoitk->Update();
 
     typename ItkOutputImageType::Pointer outputItkImage = outputimagetoitk->GetOutput();
-    std::vector<double> test;
-
-    // create the iterators
-    typename ItkInputImageType::RegionType inputRegionOfInterest = inputItkImage->GetLargestPossibleRegion();
-    ItkInputImageIteratorType inputIt(inputItkImage, inputRegionOfInterest);
-    ItkOutputImageIteratorType outputIt(outputItkImage, inputRegionOfInterest);
 
     // Get bounds of clipping data
     clippingPolyData->ComputeBounds();
@@ -162,178 +207,198 @@ namespace mitk
     double xWidth = bounds[1] - bounds[0];
     double yWidth = bounds[3] - bounds[2];
 
-    // Create vtkCellLocator for clipping poly data
-    vtkCellLocator *cellLocator = vtkCellLocator::New();
-    cellLocator->SetDataSet(clippingPolyData);
-    cellLocator->CacheCellBoundsOn();
-    cellLocator->AutomaticOn();
-    cellLocator->BuildLocator();
+    // The rows of the height field are computed in chunks, one per thread. Each chunk
+    // uses its own vtkCellLocator for clipping poly data, because intersecting lines
+    // is not thread safe: the locator marks visited cells. The locators are built
+    // one after the other, as this builds the cells of the poly data.
+    const std::size_t numberOfChunks =
+      std::min<std::size_t>(m_HeightFieldResolutionY, mitk::GetParallelForNumberOfThreads());
+    std::vector<vtkSmartPointer<vtkCellLocator>> cellLocators(numberOfChunks);
+    for (auto &cellLocator : cellLocators)
+    {
+      cellLocator = vtkSmartPointer<vtkCellLocator>::New();
+      cellLocator->SetDataSet(clippingPolyData);
+      cellLocator->CacheCellBoundsOn();
+      cellLocator->AutomaticOn();
+      cellLocator->BuildLocator();
+    }
 
     // Allocate memory for 2D image to hold the height field generated by
     // projecting the clipping data onto the plane
-    auto heightField = new double[m_HeightFieldResolutionX * m_HeightFieldResolutionY];
+    std::vector<double> heightField(m_HeightFieldResolutionX * m_HeightFieldResolutionY);
 
     // Walk through height field and for each entry calculate height of the
     // clipping poly data at this point by means of vtkCellLocator. The
     // clipping data x/y bounds are used for converting from poly data space to
     // image (height-field) space.
     MITK_INFO << "Calculating Height Field..." << std::endl;
-    for (unsigned int y = 0; y < m_HeightFieldResolutionY; ++y)
+    mitk::ParallelFor(numberOfChunks, [&](std::size_t chunk)
     {
-      for (unsigned int x = 0; x < m_HeightFieldResolutionX; ++x)
+      vtkCellLocator *cellLocator = cellLocators[chunk];
+      const std::size_t firstRow = chunk * m_HeightFieldResolutionY / numberOfChunks;
+      const std::size_t endRow = (chunk + 1) * m_HeightFieldResolutionY / numberOfChunks;
+      for (std::size_t y = firstRow; y < endRow; ++y)
       {
-        double p0[3], p1[3], surfacePoint[3], pcoords[3];
-        p0[0] = bounds[0] + xWidth * x / (double)m_HeightFieldResolutionX;
-        p0[1] = bounds[2] + yWidth * y / (double)m_HeightFieldResolutionY;
-        p0[2] = -m_MaxHeight;
-
-        p1[0] = p0[0];
-        p1[1] = p0[1];
-        p1[2] = m_MaxHeight;
-
-        double t, distance;
-        int subId;
-        if (cellLocator->IntersectWithLine(p0, p1, 0.1, t, surfacePoint, pcoords, subId))
+        for (unsigned int x = 0; x < m_HeightFieldResolutionX; ++x)
         {
-          distance = (2.0 * t - 1.0) * m_MaxHeight;
-        }
-        else
-        {
-          distance = -65536.0;
+          double p0[3], p1[3], surfacePoint[3], pcoords[3];
+          p0[0] = bounds[0] + xWidth * x / (double)m_HeightFieldResolutionX;
+          p0[1] = bounds[2] + yWidth * y / (double)m_HeightFieldResolutionY;
+          p0[2] = -m_MaxHeight;
+
+          p1[0] = p0[0];
+          p1[1] = p0[1];
+          p1[2] = m_MaxHeight;
+
+          double t, distance;
+          int subId;
+          if (cellLocator->IntersectWithLine(p0, p1, 0.1, t, surfacePoint, pcoords, subId))
+          {
+            distance = (2.0 * t - 1.0) * m_MaxHeight;
+          }
+          else
+          {
+            distance = -65536.0;
+          }
+          heightField[y * m_HeightFieldResolutionX + x] = distance;
         }
-        heightField[y * m_HeightFieldResolutionX + x] = distance;
-        itk::Image<double, 2>::IndexType index;
-        index[0] = x;
-        index[1] = y;
       }
-    }
+    });
 
     // Walk through entire input image and for each point determine its distance
     // from the x/y plane.
     MITK_INFO << "Performing clipping..." << std::endl;
 
+    const int clippingMode = clipImageFilter->m_ClippingMode;
     auto factor = static_cast<TPixel>(clipImageFilter->m_MultiplicationFactor);
-    TPixel clippingConstant = clipImageFilter->m_ClippingConstant;
+    auto clippingConstant = static_cast<TPixel>(clipImageFilter->m_ClippingConstant);
+    const unsigned multiPlaneValue = m_MultiPlaneValue;
+
+    // different modes: differnt values for the clipped pixel
+    auto clipPixel = [=](TPixel value) -> TPixel
+    {
+      if (clippingMode == CLIPPING_MODE_CONSTANT)
+        return clippingConstant;
+      else if (clippingMode == CLIPPING_MODE_MULTIPLYBYFACTOR)
+        return static_cast<TPixel>(value * factor);
+      else if (clippingMode == CLIPPING_MODE_MULTIPLANE && value != 0)
+        return static_cast<TPixel>(value + multiPlaneValue);
+      return value;
+    };
+
+    auto clipSpan = [&](const TPixel *in, TPixel *out, std::size_t count)
+    {
+      if (clippingMode == CLIPPING_MODE_CONSTANT)
+      {
+        std::fill_n(out, count, clippingConstant);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < count; ++i)
+          out[i] = clipPixel(in[i]);
+      }
+    };
+
+    const typename ItkInputImageType::RegionType region = inputItkImage->GetBufferedRegion();
+    const std::size_t rowLength = region.GetSize(0);
+    if (rowLength == 0)
+    {
+      return;
+    }
+    const std::size_t rowsPerSlice = VImageDimension > 1 ? region.GetSize(1) : 1;
+    const std::size_t numberOfSlices = region.GetNumberOfPixels() / (rowLength * rowsPerSlice);
+
+    const TPixel *inputBuffer = inputItkImage->GetBufferPointer();
+    TPixel *outputBuffer = outputItkImage->GetBufferPointer();
 
-    inputIt.SetFirstDirection(0);
-    inputIt.SetSecondDirection(1);
-    // through all slices
-    for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); inputIt.NextSlice())
+    // through all slices in parallel
+    mitk::ParallelFor(numberOfSlices, [&](std::size_t slice)
     {
       // through all lines of a slice
-      for (; !inputIt.IsAtEndOfSlice(); inputIt.NextLine())
+      for (std::size_t rowInSlice = 0; rowInSlice < rowsPerSlice; ++rowInSlice)
       {
+        const std::size_t row = slice * rowsPerSlice + rowInSlice;
+
         // Transform the start(line) point from the image to the plane
         Point3D imageP0, planeP0;
-        imageP0[0] = inputIt.GetIndex()[0];
-        imageP0[1] = inputIt.GetIndex()[1];
-        imageP0[2] = inputIt.GetIndex()[2];
+        imageP0.Fill(0);
+        imageP0[0] = region.GetIndex(0);
+        std::size_t remainder = row;
+        for (unsigned int d = 1; d < VImageDimension; ++d)
+        {
+          const std::size_t index = remainder % region.GetSize(d);
+          remainder /= region.GetSize(d);
+          if (d < 3)
+            imageP0[d] = region.GetIndex(d) + static_cast<double>(index);
+        }
         planeP0 = imageToPlaneTransform->TransformPoint(imageP0);
 
         // Transform the end point (line) from the image to the plane
         Point3D imageP1, planeP1;
-        imageP1[0] = imageP0[0] + inputRegionOfInterest.GetSize(0);
-        imageP1[1] = imageP0[1];
-        imageP1[2] = imageP0[2];
+        imageP1 = imageP0;
+        imageP1[0] += rowLength;
         planeP1 = imageToPlaneTransform->TransformPoint(imageP1);
 
         // calculate the step size (if the plane is rotate, you go "crossway" through the image)
-        Vector3D step = (planeP1 - planeP0) / (double)inputRegionOfInterest.GetSize(0);
+        Vector3D step = (planeP1 - planeP0) / (double)rowLength;
+
+        // position of the line in height field coordinates
+        const double u0 = (double)(m_HeightFieldResolutionX) * (planeP0[0] - bounds[0]) / xWidth;
+        const double du = (double)(m_HeightFieldResolutionX) * step[0] / xWidth;
+        const double v0 = (double)(m_HeightFieldResolutionY) * (planeP0[1] - bounds[2]) / yWidth;
+        const double dv = (double)(m_HeightFieldResolutionY) * step[1] / yWidth;
+
+        // if a point is outside of the plane region (RegionOfInterest) --> clip the pixel allways.
+        // The points inside the region form one span of the line, which is computed directly.
+        std::size_t begin = 0;
+        std::size_t end = rowLength;
+        RestrictSpanToInterval(u0, du, -1.0, m_HeightFieldResolutionX, rowLength, begin, end);
+        RestrictSpanToInterval(v0, dv, -1.0, m_HeightFieldResolutionY, rowLength, begin, end);
+
+        const TPixel *in = inputBuffer + row * rowLength;
+        TPixel *out = outputBuffer + row * rowLength;
+
+        clipSpan(in, out, begin);
+        clipSpan(in + end, out + end, rowLength - end);
 
-        // over all pixel
-        for (; !inputIt.IsAtEndOfLine(); ++inputIt, ++outputIt, planeP0 += step)
+        // over all pixel inside of the plane region
+        for (std::size_t i = begin; i < end; ++i)
         {
-          // Only ConstantMode: if image pixel value == constant mode value-->set output pixel value directly
-          if ((clipImageFilter->m_ClippingMode == CLIPPING_MODE_CONSTANT) &&
-              ((TPixel)inputIt.Get() == clippingConstant))
+          const double p00 = u0 + du * i;
+          const double p01 = v0 + dv * i;
+          auto x0 = (int)p00;
+          auto y0 = (int)p01;
+
+          // Calculate bilinearly interpolated height field value at plane point
+          int x1 = x0 + 1;
+          int y1 = y0 + 1;
+          if (x1 >= (int)m_HeightFieldResolutionX)
           {
-            outputIt.Set(clippingConstant);
+            x1 = x0;
           }
-
-          else
+          if (y1 >= (int)m_HeightFieldResolutionY)
           {
-            auto x0 = (int)((double)(m_HeightFieldResolutionX) * (planeP0[0] - bounds[0]) / xWidth);
-            auto y0 = (int)((double)(m_HeightFieldResolutionY) * (planeP0[1] - bounds[2]) / yWidth);
-
-            bool clip;
-
-            // if the current point is outside of the plane region (RegionOfInterest)-->clip the pixel allways
-            if ((x0 < 0) || (x0 >= (int)m_HeightFieldResolutionX) || (y0 < 0) || (y0 >= (int)m_HeightFieldResolutionY))
-            {
-              clip = true;
-            }
-
-            else
-            {
-              // Calculate bilinearly interpolated height field value at plane point
-              int x1 = x0 + 1;
-              int y1 = y0 + 1;
-              if (x1 >= (int)m_HeightFieldResolutionX)
-              {
-                x1 = x0;
-              }
-              if (y1 >= (int)m_HeightFieldResolutionY)
-              {
-                y1 = y0;
-              }
-
-              // Get the neighbour points for the interpolation
-              ScalarType q00, q01, q10, q11;
-              q00 = heightField[y0 * m_HeightFieldResolutionX + x0];
-              q01 = heightField[y0 * m_HeightFieldResolutionX + x1];
-              q10 = heightField[y1 * m_HeightFieldResolutionX + x0];
-              q11 = heightField[y1 * m_HeightFieldResolutionX + x1];
-
-              double p00 = ((double)(m_HeightFieldResolutionX) * (planeP0[0] - bounds[0]) / xWidth);
-              double p01 = ((double)(m_HeightFieldResolutionY) * (planeP0[1] - bounds[2]) / yWidth);
-
-              ScalarType q =
-                q00 * ((double)x1 - p00) * ((double)y1 - p01) + q01 * (p00 - (double)x0) * ((double)y1 - p01) +
-                q10 * ((double)x1 - p00) * (p01 - (double)y0) + q11 * (p00 - (double)x0) * (p01 - (double)y0);
-
-              if (q - planeP0[2] < 0)
-              {
-                clip = true;
-              }
-              else
-              {
-                clip = false;
-              }
-            }
-
-            // different modes: differnt values for the clipped pixel
-            if (clip)
-            {
-              if (clipImageFilter->m_ClippingMode == CLIPPING_MODE_CONSTANT)
-              {
-                outputIt.Set(clipImageFilter->m_ClippingConstant);
-              }
-              else if (clipImageFilter->m_ClippingMode == CLIPPING_MODE_MULTIPLYBYFACTOR)
-              {
-                outputIt.Set(inputIt.Get() * factor);
-              }
-              else if (clipImageFilter->m_ClippingMode == CLIPPING_MODE_MULTIPLANE)
-              {
-                if (inputIt.Get() != 0)
-                  outputIt.Set(inputIt.Get() + m_MultiPlaneValue);
-                else
-                  outputIt.Set(inputIt.Get());
-              }
-            }
-            // the non-clipped pixel keeps his value
-            else
-            {
-              outputIt.Set(inputIt.Get());
-            }
+            y1 = y0;
           }
+
+          // Get the neighbour points for the interpolation
+          ScalarType q00, q01, q10, q11;
+          q00 = heightField[y0 * m_HeightFieldResolutionX + x0];
+          q01 = heightField[y0 * m_HeightFieldResolutionX + x1];
+          q10 = heightField[y1 * m_HeightFieldResolutionX + x0];
+          q11 = heightField[y1 * m_HeightFieldResolutionX + x1];
+
+          ScalarType q =
+            q00 * ((double)x1 - p00) * ((double)y1 - p01) + q01 * (p00 - (double)x0) * ((double)y1 - p01) +
+            q10 * ((double)x1 - p00) * (p01 - (double)y0) + q11 * (p00 - (double)x0) * (p01 - (double)y0);
+
+          // the non-clipped pixel keeps his value
+          out[i] = (q - (planeP0[2] + step[2] * i) < 0) ? clipPixel(in[i]) : in[i];
         }
       }
-    }
+    });
 
     MITK_INFO << "DONE!" << std::endl;
-
-    // Clean-up
-    cellLocator->Delete();
   }
 
   void HeightFieldSurfaceClipImageFilter::GenerateData()
@@ -9,6 +9,9 @@ set(MODULE_TESTS
   mitkUnstructuredGridClusteringFilterTest.cpp
   mitkUnstructuredGridToUnstructuredGridFilterTest.cpp
   mitkCropTimestepsImageFilterTest.cpp
+  mitkMaskImageFilterTest.cpp
+  mitkGeometryClipImageFilterTest.cpp
+  mitkHeightFieldSurfaceClipImageFilterTest.cpp
 )
 
 set(MODULE_CUSTOM_TESTS
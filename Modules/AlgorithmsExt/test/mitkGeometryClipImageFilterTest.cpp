@@ -0,0 +1,238 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+// MITK includes
+#include <mitkGeometryClipImageFilter.h>
+#include <mitkImageCast.h>
+#include <mitkPlaneGeometry.h>
+
+// ITK includes
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <cmath>
+
+class mitkGeometryClipImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGeometryClipImageFilterTestSuite);
+  MITK_TEST(Clip_ObliquePlane_EqualsPerVoxelReference);
+  MITK_TEST(Clip_ObliquePlaneBelow_EqualsPerVoxelReference);
+  MITK_TEST(Clip_LabelBothSides_EqualsPerVoxelReference);
+  MITK_TEST(Clip_PlaneParallelToRows_EqualsPerVoxelReference);
+  MITK_TEST(Clip_AutoOrientLabels_ClipsLeftMostSide);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ItkImageType;
+
+  mitk::Image::Pointer m_Image;
+  mitk::Point3D m_Center;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(const mitk::Vector3D &normal) const
+  {
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializePlane(m_Center, normal);
+    return plane;
+  }
+
+  mitk::Image::Pointer Clip(const mitk::PlaneGeometry *plane, bool above, bool labelBothSides, bool autoOrientLabels) const
+  {
+    auto filter = mitk::GeometryClipImageFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetClippingGeometry(plane);
+    filter->SetClipPartAboveGeometry(above);
+    filter->SetOutsideValue(0);
+    filter->SetLabelBothSides(labelBothSides);
+    filter->SetAboveGeometryLabel(7);
+    filter->SetBelowGeometryLabel(3);
+    filter->SetAutoOrientLabels(autoOrientLabels);
+    filter->Update();
+    return filter->GetOutput();
+  }
+
+  /** Compares the output with the per-voxel evaluation of the plane the filter used before the row-wise clipping */
+  void CheckAgainstPerVoxelReference(const mitk::Image *output, const mitk::PlaneGeometry *plane, bool above, bool labelBothSides) const
+  {
+    ItkImageType::Pointer itkInput;
+    mitk::CastToItkImage(m_Image, itkInput);
+    ItkImageType::Pointer itkOutput;
+    mitk::CastToItkImage(output, itkOutput);
+    CPPUNIT_ASSERT(itkInput->GetLargestPossibleRegion() == itkOutput->GetLargestPossibleRegion());
+
+    unsigned int numberOfClippedVoxels = 0;
+    unsigned int numberOfKeptVoxels = 0;
+
+    itk::ImageRegionConstIteratorWithIndex<ItkImageType> inputIt(itkInput, itkInput->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ItkImageType> outputIt(itkOutput, itkOutput->GetLargestPossibleRegion());
+    for (; !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+      mitk::Point3D indexPt, pointInMM;
+      for (unsigned int i = 0; i < 3; ++i)
+        indexPt[i] = inputIt.GetIndex()[i];
+      m_Image->GetGeometry()->IndexToWorld(indexPt, pointInMM);
+
+      // voxels on the plane may end up on either side due to rounding
+      if (std::abs(plane->SignedDistanceFromPlane(pointInMM)) < 1e-6)
+        continue;
+
+      short expected;
+      if (inputIt.Get() == 0)
+        expected = 0;
+      else if (plane->IsAbove(pointInMM) == above)
+        expected = labelBothSides ? 7 : 0;
+      else
+        expected = labelBothSides ? 3 : inputIt.Get();
+
+      CPPUNIT_ASSERT_EQUAL(expected, outputIt.Get());
+
+      if (plane->IsAbove(pointInMM) == above)
+        ++numberOfClippedVoxels;
+      else
+        ++numberOfKeptVoxels;
+    }
+
+    // the plane has to cut through the image
+    CPPUNIT_ASSERT(numberOfClippedVoxels > 0);
+    CPPUNIT_ASSERT(numberOfKeptVoxels > 0);
+  }
+
+  static void CheckEqualImages(const mitk::Image *expected, const mitk::Image *actual)
+  {
+    ItkImageType::Pointer itkExpected;
+    mitk::CastToItkImage(expected, itkExpected);
+    ItkImageType::Pointer itkActual;
+    mitk::CastToItkImage(actual, itkActual);
+
+    itk::ImageRegionConstIterator<ItkImageType> expectedIt(itkExpected, itkExpected->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ItkImageType> actualIt(itkActual, itkActual->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+    {
+      CPPUNIT_ASSERT_EQUAL(expectedIt.Get(), actualIt.Get());
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    auto itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{23, 19, 17}};
+    ItkImageType::SpacingType spacing;
+    spacing[0] = 0.8;
+    spacing[1] = 1.3;
+    spacing[2] = 2.1;
+    ItkImageType::PointType origin;
+    origin[0] = -30.0;
+    origin[1] = -25.0;
+    origin[2] = -20.0;
+
+    // the rows of the image are not aligned with the world axes
+    const double angle = 0.35;
+    ItkImageType::DirectionType direction;
+    direction.SetIdentity();
+    direction(0, 0) = std::cos(angle);
+    direction(0, 1) = -std::sin(angle);
+    direction(1, 0) = std::sin(angle);
+    direction(1, 1) = std::cos(angle);
+
+    itkImage->SetRegions(size);
+    itkImage->SetSpacing(spacing);
+    itkImage->SetOrigin(origin);
+    itkImage->SetDirection(direction);
+    itkImage->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ItkImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      // some voxels already have the outside value
+      it.Set(index[0] % 7 == 0 ? 0 : static_cast<short>(1 + (index[0] + 2 * index[1] + 3 * index[2]) % 50));
+    }
+
+    mitk::CastToMitkImage(itkImage, m_Image);
+    m_Center = m_Image->GetGeometry()->GetCenter();
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void Clip_ObliquePlane_EqualsPerVoxelReference()
+  {
+    mitk::Vector3D normal;
+    normal[0] = 0.6;
+    normal[1] = -0.5;
+    normal[2] = 0.62;
+    auto plane = CreatePlane(normal);
+
+    CheckAgainstPerVoxelReference(Clip(plane, true, false, false), plane, true, false);
+  }
+
+  void Clip_ObliquePlaneBelow_EqualsPerVoxelReference()
+  {
+    mitk::Vector3D normal;
+    normal[0] = -0.3;
+    normal[1] = 0.9;
+    normal[2] = 0.2;
+    auto plane = CreatePlane(normal);
+
+    CheckAgainstPerVoxelReference(Clip(plane, false, false, false), plane, false, false);
+  }
+
+  void Clip_LabelBothSides_EqualsPerVoxelReference()
+  {
+    mitk::Vector3D normal;
+    normal[0] = 0.6;
+    normal[1] = -0.5;
+    normal[2] = 0.62;
+    auto plane = CreatePlane(normal);
+
+    CheckAgainstPerVoxelReference(Clip(plane, true, true, false), plane, true, true);
+  }
+
+  void Clip_PlaneParallelToRows_EqualsPerVoxelReference()
+  {
+    // the normal is perpendicular to the rows, so every row lies completely on one side of the plane
+    mitk::Vector3D normal;
+    normal[0] = -std::sin(0.35);
+    normal[1] = std::cos(0.35);
+    normal[2] = 0.4;
+    auto plane = CreatePlane(normal);
+
+    CheckAgainstPerVoxelReference(Clip(plane, true, false, false), plane, true, false);
+  }
+
+  void Clip_AutoOrientLabels_ClipsLeftMostSide()
+  {
+    // the plane lies at negative coordinates, so the world origin is above the plane,
+    // but the left-most point is below it
+    mitk::Vector3D normal;
+    normal[0] = 0.6;
+    normal[1] = 0.5;
+    normal[2] = 0.62;
+    auto plane = CreatePlane(normal);
+    mitk::Point3D worldOrigin;
+    worldOrigin.Fill(0.0);
+    CPPUNIT_ASSERT(plane->IsAbove(worldOrigin));
+
+    auto output = Clip(plane, true, false, true);
+    CheckAgainstPerVoxelReference(output, plane, false, false);
+
+    // the same side is clipped for the flipped plane
+    auto flippedPlane = CreatePlane(-normal);
+    CheckEqualImages(output, Clip(flippedPlane, true, false, true));
+    CheckEqualImages(output, Clip(flippedPlane, false, false, true));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGeometryClipImageFilter)
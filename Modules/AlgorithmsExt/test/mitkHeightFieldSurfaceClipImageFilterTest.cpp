@@ -0,0 +1,185 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+// MITK includes
+#include <mitkHeightFieldSurfaceClipImageFilter.h>
+#include <mitkImageCast.h>
+#include <mitkSurface.h>
+
+// ITK includes
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+// VTK includes
+#include <vtkPlaneSource.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+
+class mitkHeightFieldSurfaceClipImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkHeightFieldSurfaceClipImageFilterTestSuite);
+  MITK_TEST(Clip_Constant_EqualsPerVoxelReference);
+  MITK_TEST(Clip_MultiplyByFactor_EqualsPerVoxelReference);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ItkImageType;
+
+  // the height field is a flat surface at height m_Height above [0, 20] x [0, 15]
+  const double m_Bounds[4] = { 0.0, 20.0, 0.0, 15.0 };
+  const double m_Height = 1.5;
+  const unsigned int m_Resolution = 256;
+
+  mitk::Image::Pointer m_Image;
+  mitk::Surface::Pointer m_Surface;
+
+  /** Compares the output with the per-voxel evaluation of the height field that the filter used before
+   *  clipping rows span-wise. Voxels that project onto the border of the height field, where the
+   *  interpolation of the filter degenerates, and voxels on the surface are skipped. */
+  void CheckAgainstPerVoxelReference(const mitk::Image *output, short clippedValueOffset, short clippedValueFactor) const
+  {
+    ItkImageType::Pointer itkInput;
+    mitk::CastToItkImage(m_Image, itkInput);
+    ItkImageType::Pointer itkOutput;
+    mitk::CastToItkImage(output, itkOutput);
+    CPPUNIT_ASSERT(itkInput->GetLargestPossibleRegion() == itkOutput->GetLargestPossibleRegion());
+
+    unsigned int numberOfOutsideVoxels = 0;
+    unsigned int numberOfClippedVoxels = 0;
+    unsigned int numberOfKeptVoxels = 0;
+
+    itk::ImageRegionConstIteratorWithIndex<ItkImageType> inputIt(itkInput, itkInput->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ItkImageType> outputIt(itkOutput, itkOutput->GetLargestPossibleRegion());
+    for (; !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+      mitk::Point3D indexPt, pointInMM;
+      for (unsigned int i = 0; i < 3; ++i)
+        indexPt[i] = inputIt.GetIndex()[i];
+      m_Image->GetGeometry()->IndexToWorld(indexPt, pointInMM);
+
+      // position in the height field
+      const double u = m_Resolution * (pointInMM[0] - m_Bounds[0]) / (m_Bounds[1] - m_Bounds[0]);
+      const double v = m_Resolution * (pointInMM[1] - m_Bounds[2]) / (m_Bounds[3] - m_Bounds[2]);
+
+      bool clip;
+      if (u <= -1.0 || u >= m_Resolution || v <= -1.0 || v >= m_Resolution)
+      {
+        clip = true;
+        ++numberOfOutsideVoxels;
+      }
+      else if (u >= 1.0 && u < m_Resolution - 2 && v >= 1.0 && v < m_Resolution - 2 &&
+               std::abs(pointInMM[2] - m_Height) > 1e-6)
+      {
+        clip = pointInMM[2] > m_Height;
+        if (clip)
+          ++numberOfClippedVoxels;
+        else
+          ++numberOfKeptVoxels;
+      }
+      else
+      {
+        continue;
+      }
+
+      const short expected = clip ? static_cast<short>(clippedValueOffset + clippedValueFactor * inputIt.Get()) : inputIt.Get();
+      CPPUNIT_ASSERT_EQUAL(expected, outputIt.Get());
+    }
+
+    // rows cross the border of the height field as well as the surface
+    CPPUNIT_ASSERT(numberOfOutsideVoxels > 0);
+    CPPUNIT_ASSERT(numberOfClippedVoxels > 0);
+    CPPUNIT_ASSERT(numberOfKeptVoxels > 0);
+  }
+
+public:
+  void setUp() override
+  {
+    auto itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{30, 25, 12}};
+    ItkImageType::SpacingType spacing;
+    spacing.Fill(1.0);
+    ItkImageType::PointType origin;
+    origin[0] = -4.3;
+    origin[1] = -5.2;
+    origin[2] = -4.1;
+
+    // the rows are tilted against the height field, so they cross the surface
+    const double angle = 0.3;
+    ItkImageType::DirectionType direction;
+    direction.SetIdentity();
+    direction(0, 0) = std::cos(angle);
+    direction(0, 2) = -std::sin(angle);
+    direction(2, 0) = std::sin(angle);
+    direction(2, 2) = std::cos(angle);
+
+    itkImage->SetRegions(size);
+    itkImage->SetSpacing(spacing);
+    itkImage->SetOrigin(origin);
+    itkImage->SetDirection(direction);
+    itkImage->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ItkImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      it.Set(static_cast<short>(1 + (index[0] + 2 * index[1] + 3 * index[2]) % 50));
+    }
+    mitk::CastToMitkImage(itkImage, m_Image);
+
+    auto planeSource = vtkSmartPointer<vtkPlaneSource>::New();
+    planeSource->SetOrigin(m_Bounds[0], m_Bounds[2], m_Height);
+    planeSource->SetPoint1(m_Bounds[1], m_Bounds[2], m_Height);
+    planeSource->SetPoint2(m_Bounds[0], m_Bounds[3], m_Height);
+    planeSource->SetResolution(4, 3);
+    planeSource->Update();
+
+    m_Surface = mitk::Surface::New();
+    m_Surface->SetVtkPolyData(planeSource->GetOutput());
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Surface = nullptr;
+  }
+
+  void Clip_Constant_EqualsPerVoxelReference()
+  {
+    auto filter = mitk::HeightFieldSurfaceClipImageFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetClippingSurface(m_Surface);
+    filter->SetClippingModeToConstant();
+    filter->SetClippingConstant(-1);
+    filter->Update();
+
+    CheckAgainstPerVoxelReference(filter->GetOutput(), -1, 0);
+  }
+
+  void Clip_MultiplyByFactor_EqualsPerVoxelReference()
+  {
+    auto filter = mitk::HeightFieldSurfaceClipImageFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetClippingSurface(m_Surface);
+    filter->SetClippingModeToMultiplyByFactor();
+    filter->SetMultiplicationFactor(2.0);
+    filter->Update();
+
+    CheckAgainstPerVoxelReference(filter->GetOutput(), 0, 2);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkHeightFieldSurfaceClipImageFilter)
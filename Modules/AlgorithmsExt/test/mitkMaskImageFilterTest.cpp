@@ -0,0 +1,86 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+// Testing
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+// MITK includes
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkMaskImageFilter.h>
+
+#include <array>
+
+namespace
+{
+  const unsigned int NumberOfVoxels = 4 * 3 * 2;
+  const unsigned int NumberOfTimeSteps = 3;
+}
+
+class mitkMaskImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMaskImageFilterTestSuite);
+  MITK_TEST(Filter_3Dt);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  template <typename TPixel>
+  static mitk::Image::Pointer CreateImage(TPixel (*value)(unsigned int voxel, unsigned int timeStep))
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    std::array<unsigned int, 4> dimensions = {{4, 3, 2, NumberOfTimeSteps}};
+    image->Initialize(mitk::MakeScalarPixelType<TPixel>(), 4, dimensions.data());
+
+    mitk::ImageWriteAccessor writeAccess(image);
+    auto *data = static_cast<TPixel *>(writeAccess.GetData());
+    for (unsigned int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+      for (unsigned int i = 0; i < NumberOfVoxels; ++i)
+        data[t * NumberOfVoxels + i] = value(i, t);
+    }
+    return image;
+  }
+
+  static short InputValue(unsigned int voxel, unsigned int timeStep) { return 100 * (timeStep + 1) + voxel; }
+  static unsigned char MaskValue(unsigned int voxel, unsigned int timeStep) { return (voxel + timeStep) % 2; }
+
+public:
+  void Filter_3Dt()
+  {
+    auto input = CreateImage<short>(&InputValue);
+    auto mask = CreateImage<unsigned char>(&MaskValue);
+
+    // the filter writes every time step of its output through an image time selector
+    mitk::MaskImageFilter::Pointer filter = mitk::MaskImageFilter::New();
+    filter->SetInput(input);
+    filter->SetMask(mask);
+    filter->SetOverrideOutsideValue(true);
+    filter->SetOutsideValue(-1);
+    filter->Update();
+
+    mitk::Image::Pointer output = filter->GetOutput();
+    CPPUNIT_ASSERT_EQUAL(NumberOfTimeSteps, output->GetTimeSteps());
+
+    for (unsigned int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+      mitk::ImageReadAccessor readAccess(output, output->GetVolumeData(t));
+      auto *data = static_cast<const short *>(readAccess.GetData());
+      for (unsigned int i = 0; i < NumberOfVoxels; ++i)
+      {
+        const short expected = MaskValue(i, t) > 0 ? InputValue(i, t) : -1;
+        CPPUNIT_ASSERT_EQUAL(expected, data[i]);
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMaskImageFilter)
@@ -16,6 +16,8 @@ found in the LICENSE file.
 
 #include <mitkTransformationOperation.h>
 
+#include <sstream>
+
 static bool ConvertToBool(std::map<std::string, us::Any> &data, std::string name)
 {
   if (!data.count(name))
@@ -31,6 +33,21 @@ static bool ConvertToBool(std::map<std::string, us::Any> &data, std::string name
   }
 }
 
+static std::vector<std::string> SplitList(const std::string &list)
+{
+  std::vector<std::string> items;
+  std::istringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ';'))
+  {
+    if (!item.empty())
+    {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
 int main(int argc, char* argv[])
 {
   mitkCommandLineParser parser;
@@ -46,7 +63,8 @@ int main(int argc, char* argv[])
   parser.addArgument("image", "i", mitkCommandLineParser::File, "Input image:", "Input Image", us::Any(), false, false, false, mitkCommandLineParser::Input);
   parser.addArgument("output", "o", mitkCommandLineParser::File, "Output file:", "Output Mask", us::Any(), false, false, false, mitkCommandLineParser::Output);
 
-  parser.addArgument("sigma", "s", mitkCommandLineParser::Float, "Sigma for Gaussian", "Sigma for Gaussian", us::Any(), false);
+  parser.addArgument("sigma", "s", mitkCommandLineParser::Float, "Sigma for Gaussian", "Sigma for Gaussian", us::Any(), true);
+  parser.addArgument("sigmas", "ss", mitkCommandLineParser::String, "Sigmas for Gaussian", "Semicolon separated list of sigmas, replaces --sigma. All responses are computed from one FFT of the input and saved as double images named <output>_sigma_<sigma>.<extension>", us::Any(), true);
   parser.addArgument("as-double", "double", mitkCommandLineParser::Bool, "Result Image as Type Double", "Result Image as Type Double", us::Any(false), true);
 
   std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
@@ -78,9 +96,36 @@ int main(int argc, char* argv[])
     return 0;
   }
 
-  double sigma = us::any_cast<float>(parsedArgs["sigma"]);
-
+  if (parsedArgs.count("sigmas"))
+  {
+    auto sigmas = SplitList(us::any_cast<std::string>(parsedArgs["sigmas"]));
+
+    mitk::FrequencyFilterBank filterBank;
+    filterBank.SetBorderCondition(mitk::BorderCondition::ZeroFluxNeumann);
+    for (const auto &sigma : sigmas)
+    {
+      filterBank.AddLaplacianOfGaussian(std::stod(sigma));
+    }
+
+    std::size_t fileNameStart = outputFilename.find_last_of("/\\");
+    fileNameStart = (fileNameStart == std::string::npos) ? 0 : fileNameStart + 1;
+    std::size_t extensionStart = outputFilename.find('.', fileNameStart);
+    std::string outputBase = outputFilename.substr(0, extensionStart);
+    std::string extension = (extensionStart == std::string::npos) ? std::string() : outputFilename.substr(extensionStart);
+
+    std::size_t responseIndex = 0;
+    filterBank.Execute(image, [&](const std::string &, mitk::Image::Pointer response) {
+      mitk::IOUtil::Save(response, outputBase + "_sigma_" + sigmas[responseIndex++] + extension);
+    });
+    return EXIT_SUCCESS;
+  }
 
+  if (!parsedArgs.count("sigma"))
+  {
+    MITK_INFO << "Either --sigma or --sigmas is required";
+    return EXIT_FAILURE;
+  }
+  double sigma = us::any_cast<float>(parsedArgs["sigma"]);
 
   bool asDouble = ConvertToBool(parsedArgs, "as-double");
   mitk::Image::Pointer tmpImage = mitk::TransformationOperation::LaplacianOfGaussian(image, sigma, asDouble);
@@ -0,0 +1,177 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef itkSeparableResampleImageFilter_h
+#define itkSeparableResampleImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+
+#include <vector>
+
+namespace itk
+{
+  /** \class SeparableResampleImageFilter
+  * \brief Resamples an image onto a grid that differs from the input grid only in spacing, origin and size.
+  *
+  * Because the output grid shares the direction of the input, every output axis only depends on the same
+  * input axis and the resampling is done as one one-dimensional pass per axis. The source indices and
+  * weights of all output positions along an axis are computed once per pass and applied to every line of
+  * the image; the lines are distributed over the threads. Shrinking axes are processed first to keep the
+  * intermediate images small.
+  *
+  * The kernels match the interpolators used by mitk::ImageMappingHelper: nearest neighbor, linear,
+  * cubic B-spline and windowed sinc with a Hamming or Welch window of radius 4 (with weights normalized
+  * to one). Output positions outside of the input image are set to the default pixel value.
+  *
+  * In label mode the input is treated as a label image. Every label is interpolated as a binary
+  * indicator and each output voxel gets the label with the largest weight, so labels are never mixed.
+  *
+  * Use IsAxisAligned() to check if a target grid can be reached with this filter, otherwise use
+  * itk::ResampleImageFilter.
+  */
+  template< typename TInputImage, typename TOutputImage = TInputImage >
+  class ITK_TEMPLATE_EXPORT SeparableResampleImageFilter :
+    public ImageToImageFilter< TInputImage, TOutputImage >
+  {
+  public:
+    /** Standard Self typedef */
+    typedef SeparableResampleImageFilter                     Self;
+    typedef ImageToImageFilter< TInputImage, TOutputImage >  Superclass;
+    typedef SmartPointer< Self >                             Pointer;
+    typedef SmartPointer< const Self >                       ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self);
+
+    /** Runtime information support. */
+    itkTypeMacro(SeparableResampleImageFilter, ImageToImageFilter);
+
+    /** Image related typedefs. */
+    itkStaticConstMacro(ImageDimension, unsigned int,
+      TInputImage::ImageDimension);
+
+    typedef TInputImage                          InputImageType;
+    typedef TOutputImage                         OutputImageType;
+    typedef typename TInputImage::PixelType      InputPixelType;
+    typedef typename TOutputImage::PixelType     OutputPixelType;
+    typedef typename TOutputImage::SizeType      SizeType;
+    typedef typename TOutputImage::IndexType     IndexType;
+    typedef typename TOutputImage::SpacingType   SpacingType;
+    typedef typename TOutputImage::PointType     PointType;
+    typedef typename TOutputImage::RegionType    RegionType;
+    typedef ImageBase< itkGetStaticConstMacro(ImageDimension) > ImageBaseType;
+
+    enum InterpolatorType
+    {
+      NearestNeighbor,
+      Linear,
+      BSpline,
+      WindowedSincHamming,
+      WindowedSincWelch
+    };
+
+    itkSetMacro(Interpolator, InterpolatorType);
+    itkGetConstMacro(Interpolator, InterpolatorType);
+
+    itkSetMacro(OutputSpacing, SpacingType);
+    itkGetConstReferenceMacro(OutputSpacing, SpacingType);
+
+    itkSetMacro(OutputOrigin, PointType);
+    itkGetConstReferenceMacro(OutputOrigin, PointType);
+
+    itkSetMacro(Size, SizeType);
+    itkGetConstReferenceMacro(Size, SizeType);
+
+    itkSetMacro(OutputStartIndex, IndexType);
+    itkGetConstReferenceMacro(OutputStartIndex, IndexType);
+
+    itkSetMacro(DefaultPixelValue, OutputPixelType);
+    itkGetConstMacro(DefaultPixelValue, OutputPixelType);
+
+    itkSetMacro(LabelMode, bool);
+    itkGetConstMacro(LabelMode, bool);
+    itkBooleanMacro(LabelMode);
+
+    /** Takes spacing, origin, size and start index of the output from the given image. */
+    void SetOutputParametersFromImage(const ImageBaseType *image);
+
+    /** Returns true if both grids share their direction, which is what this filter requires. */
+    static bool IsAxisAligned(const ImageBaseType *input, const ImageBaseType *reference);
+
+  protected:
+    SeparableResampleImageFilter();
+    ~SeparableResampleImageFilter() ITK_OVERRIDE {}
+    void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+    void GenerateOutputInformation() ITK_OVERRIDE;
+
+    // Override since the filter needs all the data for the algorithm
+    void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+    // Override since the filter produces all of its output
+    void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
+
+    void GenerateData() ITK_OVERRIDE;
+
+  private:
+    ITK_DISALLOW_COPY_AND_ASSIGN(SeparableResampleImageFilter);
+
+    /** Source indices and weights of all output positions along one axis. */
+    struct AxisWeights
+    {
+      unsigned int NumberOfTaps;
+      std::vector<SizeValueType> Indices;
+      std::vector<double> Weights;
+      std::vector<bool> Inside;
+      bool Prefilter;
+    };
+
+    /** Parameters of one pass, shared by all threads. */
+    struct PassStruct
+    {
+      const AxisWeights *Axis;
+      const double *Input;
+      double *Output;
+      SizeValueType InputLength;
+      SizeValueType OutputLength;
+      SizeValueType Stride;
+      SizeValueType NumberOfLines;
+    };
+
+    void ComputeAxisWeights(unsigned int axis, AxisWeights &weights) const;
+
+    /** Resamples a buffer of the input size along all axes into a buffer of the output size. */
+    void ResampleBuffer(std::vector<double> &buffer, const std::vector<AxisWeights> &axes);
+
+    static ITK_THREAD_RETURN_TYPE ResampleLinesCallback(void *arg);
+
+    /** Converts the line into cubic B-spline coefficients (mirror boundary). */
+    static void ComputeBSplineCoefficients(double *line, SizeValueType length);
+
+    static OutputPixelType CastValue(double value);
+
+    InterpolatorType m_Interpolator;
+    SpacingType      m_OutputSpacing;
+    PointType        m_OutputOrigin;
+    SizeType         m_Size;
+    IndexType        m_OutputStartIndex;
+    OutputPixelType  m_DefaultPixelValue;
+    bool             m_LabelMode;
+  }; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSeparableResampleImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,512 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef itkSeparableResampleImageFilter_cpp
+#define itkSeparableResampleImageFilter_cpp
+
+#include <itkSeparableResampleImageFilter.h>
+
+#include <itkImageRegionConstIterator.h>
+#include <itkMath.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+  template< typename TInputImage, typename TOutputImage >
+  SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::SeparableResampleImageFilter() :
+    m_Interpolator(Linear),
+    m_DefaultPixelValue(NumericTraits< OutputPixelType >::ZeroValue()),
+    m_LabelMode(false)
+  {
+    m_OutputSpacing.Fill(1.0);
+    m_OutputOrigin.Fill(0.0);
+    m_Size.Fill(0);
+    m_OutputStartIndex.Fill(0);
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::SetOutputParametersFromImage(const ImageBaseType *image)
+  {
+    this->SetOutputSpacing(image->GetSpacing());
+    this->SetOutputOrigin(image->GetOrigin());
+    this->SetSize(image->GetLargestPossibleRegion().GetSize());
+    this->SetOutputStartIndex(image->GetLargestPossibleRegion().GetIndex());
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  bool
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::IsAxisAligned(const ImageBaseType *input, const ImageBaseType *reference)
+  {
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        if (std::abs(input->GetDirection()[i][j] - reference->GetDirection()[i][j]) > 1e-6)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::GenerateOutputInformation()
+  {
+    Superclass::GenerateOutputInformation();
+
+    OutputImageType *output = this->GetOutput();
+    const InputImageType *input = this->GetInput();
+    if (!output || !input)
+    {
+      return;
+    }
+
+    output->SetLargestPossibleRegion(RegionType(m_OutputStartIndex, m_Size));
+    output->SetSpacing(m_OutputSpacing);
+    output->SetOrigin(m_OutputOrigin);
+    output->SetDirection(input->GetDirection());
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::GenerateInputRequestedRegion()
+  {
+    Superclass::GenerateInputRequestedRegion();
+
+    InputImageType *input = const_cast< InputImageType * >(this->GetInput());
+    if (input)
+    {
+      input->SetRequestedRegionToLargestPossibleRegion();
+    }
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::EnlargeOutputRequestedRegion(DataObject *data)
+  {
+    Superclass::EnlargeOutputRequestedRegion(data);
+    data->SetRequestedRegionToLargestPossibleRegion();
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::ComputeAxisWeights(unsigned int axis, AxisWeights &weights) const
+  {
+    const InputImageType *input = this->GetInput();
+    const RegionType inputRegion = input->GetLargestPossibleRegion();
+    const long inputLength = static_cast< long >(inputRegion.GetSize()[axis]);
+    const SizeValueType outputLength = m_Size[axis];
+
+    // Both grids share the direction, so the output origin in input index space gives the offset
+    // and the ratio of the spacings the step along this axis.
+    const typename InputImageType::DirectionType inverseDirection = input->GetInverseDirection();
+    double originOffset = 0.0;
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      originOffset += inverseDirection[axis][j] * (m_OutputOrigin[j] - input->GetOrigin()[j]);
+    }
+    const double offset = originOffset / input->GetSpacing()[axis] + m_OutputStartIndex[axis] * m_OutputSpacing[axis] / input->GetSpacing()[axis] - inputRegion.GetIndex()[axis];
+    const double step = m_OutputSpacing[axis] / input->GetSpacing()[axis];
+
+    const long radius = 4;
+    switch (m_Interpolator)
+    {
+    case NearestNeighbor:
+      weights.NumberOfTaps = 1;
+      break;
+    case Linear:
+      weights.NumberOfTaps = 2;
+      break;
+    case BSpline:
+      weights.NumberOfTaps = 4;
+      break;
+    default:
+      weights.NumberOfTaps = 2 * radius;
+      break;
+    }
+    weights.Prefilter = (m_Interpolator == BSpline && inputLength > 1);
+    weights.Indices.assign(outputLength * weights.NumberOfTaps, 0);
+    weights.Weights.assign(outputLength * weights.NumberOfTaps, 0.0);
+    weights.Inside.assign(outputLength, false);
+
+    for (SizeValueType position = 0; position < outputLength; ++position)
+    {
+      const double index = offset + position * step;
+      weights.Inside[position] = (index >= -0.5 && index < inputLength - 0.5);
+
+      SizeValueType *indices = &weights.Indices[position * weights.NumberOfTaps];
+      double *tapWeights = &weights.Weights[position * weights.NumberOfTaps];
+      long first = 0;
+      switch (m_Interpolator)
+      {
+      case NearestNeighbor:
+        first = static_cast< long >(std::floor(index + 0.5));
+        tapWeights[0] = 1.0;
+        break;
+      case Linear:
+        {
+          first = static_cast< long >(std::floor(index));
+          const double t = index - first;
+          tapWeights[0] = 1.0 - t;
+          tapWeights[1] = t;
+        }
+        break;
+      case BSpline:
+        {
+          first = static_cast< long >(std::floor(index)) - 1;
+          const double t = index - (first + 1);
+          tapWeights[0] = (1.0 - t) * (1.0 - t) * (1.0 - t) / 6.0;
+          tapWeights[1] = (4.0 - 6.0 * t * t + 3.0 * t * t * t) / 6.0;
+          tapWeights[2] = (1.0 + 3.0 * t + 3.0 * t * t - 3.0 * t * t * t) / 6.0;
+          tapWeights[3] = t * t * t / 6.0;
+        }
+        break;
+      default:
+        {
+          first = static_cast< long >(std::floor(index)) - radius + 1;
+          double sum = 0.0;
+          for (unsigned int tap = 0; tap < weights.NumberOfTaps; ++tap)
+          {
+            const double x = index - (first + static_cast< long >(tap));
+            const double sinc = (x == 0.0) ? 1.0 : std::sin(Math::pi * x) / (Math::pi * x);
+            const double window = (m_Interpolator == WindowedSincWelch) ?
+              1.0 - x * x / (radius * radius) :
+              0.54 + 0.46 * std::cos(Math::pi * x / radius);
+            tapWeights[tap] = sinc * window;
+            sum += tapWeights[tap];
+          }
+          for (unsigned int tap = 0; tap < weights.NumberOfTaps; ++tap)
+          {
+            tapWeights[tap] /= sum;
+          }
+        }
+        break;
+      }
+
+      for (unsigned int tap = 0; tap < weights.NumberOfTaps; ++tap)
+      {
+        long sourceIndex = first + static_cast< long >(tap);
+        if (m_Interpolator == BSpline && inputLength > 1)
+        {
+          // B-spline coefficients are mirrored at the border, like in itk::BSplineInterpolateImageFunction
+          const long period = 2 * inputLength - 2;
+          sourceIndex = std::abs(sourceIndex) % period;
+          if (sourceIndex >= inputLength)
+          {
+            sourceIndex = period - sourceIndex;
+          }
+        }
+        else
+        {
+          sourceIndex = std::min(std::max(sourceIndex, 0L), inputLength - 1);
+        }
+        indices[tap] = static_cast< SizeValueType >(sourceIndex);
+      }
+    }
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::ComputeBSplineCoefficients(double *line, SizeValueType length)
+  {
+    const double z = std::sqrt(3.0) - 2.0;
+    const double lambda = (1.0 - z) * (1.0 - 1.0 / z);
+    for (SizeValueType k = 0; k < length; ++k)
+    {
+      line[k] *= lambda;
+    }
+
+    // Initial causal coefficient with mirror boundary
+    const SizeValueType horizon = static_cast< SizeValueType >(std::ceil(std::log(1e-10) / std::log(std::abs(z))));
+    double sum = line[0];
+    if (horizon < length)
+    {
+      double zn = z;
+      for (SizeValueType k = 1; k < horizon; ++k)
+      {
+        sum += zn * line[k];
+        zn *= z;
+      }
+    }
+    else
+    {
+      double zn = z;
+      const double iz = 1.0 / z;
+      double z2n = std::pow(z, static_cast< double >(length - 1));
+      sum = line[0] + z2n * line[length - 1];
+      z2n *= z2n * iz;
+      for (SizeValueType k = 1; k + 1 < length; ++k)
+      {
+        sum += (zn + z2n) * line[k];
+        zn *= z;
+        z2n *= iz;
+      }
+      sum /= (1.0 - zn * zn);
+    }
+    line[0] = sum;
+
+    for (SizeValueType k = 1; k < length; ++k)
+    {
+      line[k] += z * line[k - 1];
+    }
+
+    line[length - 1] = (z / (z * z - 1.0)) * (z * line[length - 2] + line[length - 1]);
+    for (SizeValueType k = length - 1; k > 0; --k)
+    {
+      line[k - 1] = z * (line[k] - line[k - 1]);
+    }
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  ITK_THREAD_RETURN_TYPE
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::ResampleLinesCallback(void *arg)
+  {
+    const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >(arg);
+    const PassStruct *pass = static_cast< PassStruct * >(info->UserData);
+    const AxisWeights &axis = *pass->Axis;
+
+    const SizeValueType firstLine = pass->NumberOfLines * info->ThreadID / info->NumberOfThreads;
+    const SizeValueType lastLine = pass->NumberOfLines * (info->ThreadID + 1) / info->NumberOfThreads;
+
+    // Lines are copied into a contiguous buffer, every input value is read by several taps
+    std::vector<double> line(pass->InputLength);
+    for (SizeValueType lineIndex = firstLine; lineIndex < lastLine; ++lineIndex)
+    {
+      const SizeValueType inner = lineIndex % pass->Stride;
+      const SizeValueType outer = lineIndex / pass->Stride;
+      const double *input = pass->Input + outer * pass->Stride * pass->InputLength + inner;
+      double *output = pass->Output + outer * pass->Stride * pass->OutputLength + inner;
+
+      for (SizeValueType k = 0; k < pass->InputLength; ++k)
+      {
+        line[k] = input[k * pass->Stride];
+      }
+      if (axis.Prefilter)
+      {
+        ComputeBSplineCoefficients(line.data(), pass->InputLength);
+      }
+
+      const SizeValueType *indices = axis.Indices.data();
+      const double *weights = axis.Weights.data();
+      for (SizeValueType position = 0; position < pass->OutputLength; ++position)
+      {
+        double value = 0.0;
+        for (unsigned int tap = 0; tap < axis.NumberOfTaps; ++tap)
+        {
+          value += weights[tap] * line[indices[tap]];
+        }
+        output[position * pass->Stride] = value;
+        indices += axis.NumberOfTaps;
+        weights += axis.NumberOfTaps;
+      }
+    }
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::ResampleBuffer(std::vector<double> &buffer, const std::vector<AxisWeights> &axes)
+  {
+    SizeType size = this->GetInput()->GetLargestPossibleRegion().GetSize();
+
+    // Shrinking axes first, so the following passes work on fewer lines
+    std::vector<unsigned int> order(ImageDimension);
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&size, this](unsigned int a, unsigned int b)
+    {
+      return static_cast< double >(m_Size[a]) / size[a] < static_cast< double >(m_Size[b]) / size[b];
+    });
+
+    std::vector<double> target;
+    for (unsigned int axis : order)
+    {
+      SizeValueType stride = 1;
+      for (unsigned int i = 0; i < axis; ++i)
+      {
+        stride *= size[i];
+      }
+      SizeValueType outerLines = 1;
+      for (unsigned int i = axis + 1; i < ImageDimension; ++i)
+      {
+        outerLines *= size[i];
+      }
+
+      PassStruct pass;
+      pass.Axis = &axes[axis];
+      pass.InputLength = size[axis];
+      pass.OutputLength = m_Size[axis];
+      pass.Stride = stride;
+      pass.NumberOfLines = stride * outerLines;
+
+      target.resize(pass.NumberOfLines * pass.OutputLength);
+      pass.Input = buffer.data();
+      pass.Output = target.data();
+
+      this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+      this->GetMultiThreader()->SetSingleMethod(Self::ResampleLinesCallback, &pass);
+      this->GetMultiThreader()->SingleMethodExecute();
+
+      buffer.swap(target);
+      size[axis] = m_Size[axis];
+    }
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  typename SeparableResampleImageFilter< TInputImage, TOutputImage >::OutputPixelType
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::CastValue(double value)
+  {
+    // Clamp to the range of the output type, like itk::ResampleImageFilter
+    const double minimum = static_cast< double >(NumericTraits< OutputPixelType >::NonpositiveMin());
+    const double maximum = static_cast< double >(NumericTraits< OutputPixelType >::max());
+    return static_cast< OutputPixelType >(std::min(std::max(value, minimum), maximum));
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::GenerateData()
+  {
+    const InputImageType *input = this->GetInput();
+    OutputImageType *output = this->GetOutput();
+
+    this->AllocateOutputs();
+
+    std::vector<AxisWeights> axes(ImageDimension);
+    for (unsigned int axis = 0; axis < ImageDimension; ++axis)
+    {
+      this->ComputeAxisWeights(axis, axes[axis]);
+    }
+
+    const RegionType inputRegion = input->GetLargestPossibleRegion();
+    const SizeValueType numberOfInputPixels = inputRegion.GetNumberOfPixels();
+    const SizeValueType numberOfOutputPixels = output->GetLargestPossibleRegion().GetNumberOfPixels();
+
+    std::vector<double> values;
+    if (!m_LabelMode || m_Interpolator == NearestNeighbor)
+    {
+      values.reserve(numberOfInputPixels);
+      for (ImageRegionConstIterator< InputImageType > it(input, inputRegion); !it.IsAtEnd(); ++it)
+      {
+        values.push_back(static_cast< double >(it.Get()));
+      }
+      this->ResampleBuffer(values, axes);
+    }
+    else
+    {
+      std::vector<InputPixelType> labels;
+      for (ImageRegionConstIterator< InputImageType > it(input, inputRegion); !it.IsAtEnd(); ++it)
+      {
+        labels.push_back(it.Get());
+      }
+      std::vector<InputPixelType> labelValues(labels);
+      std::sort(labelValues.begin(), labelValues.end());
+      labelValues.erase(std::unique(labelValues.begin(), labelValues.end()), labelValues.end());
+
+      // Background is not resampled, its weight is what the other labels leave over
+      std::vector<double> bestWeights(numberOfOutputPixels, 0.0);
+      std::vector<double> totalWeights(numberOfOutputPixels, 0.0);
+      values.assign(numberOfOutputPixels, 0.0);
+      std::vector<double> indicator;
+      for (const InputPixelType &label : labelValues)
+      {
+        if (label == NumericTraits< InputPixelType >::ZeroValue())
+        {
+          continue;
+        }
+
+        indicator.resize(numberOfInputPixels);
+        for (SizeValueType i = 0; i < numberOfInputPixels; ++i)
+        {
+          indicator[i] = (labels[i] == label) ? 1.0 : 0.0;
+        }
+        this->ResampleBuffer(indicator, axes);
+
+        for (SizeValueType i = 0; i < numberOfOutputPixels; ++i)
+        {
+          totalWeights[i] += indicator[i];
+          if (indicator[i] >= bestWeights[i] && indicator[i] > 0.0)
+          {
+            bestWeights[i] = indicator[i];
+            values[i] = static_cast< double >(label);
+          }
+        }
+      }
+
+      for (SizeValueType i = 0; i < numberOfOutputPixels; ++i)
+      {
+        if (bestWeights[i] < 1.0 - totalWeights[i])
+        {
+          values[i] = 0.0;
+        }
+      }
+    }
+
+    // Write the result, positions outside of the input along any axis get the default value
+    OutputPixelType *outputBuffer = output->GetBufferPointer();
+    IndexType position;
+    position.Fill(0);
+    for (SizeValueType i = 0; i < numberOfOutputPixels; ++i)
+    {
+      bool inside = true;
+      for (unsigned int axis = 0; axis < ImageDimension && inside; ++axis)
+      {
+        inside = axes[axis].Inside[position[axis]];
+      }
+      outputBuffer[i] = inside ? CastValue(values[i]) : m_DefaultPixelValue;
+
+      for (unsigned int axis = 0; axis < ImageDimension; ++axis)
+      {
+        if (static_cast< SizeValueType >(++position[axis]) < m_Size[axis])
+        {
+          break;
+        }
+        position[axis] = 0;
+      }
+    }
+  }
+
+  template< typename TInputImage, typename TOutputImage >
+  void
+    SeparableResampleImageFilter< TInputImage, TOutputImage >
+    ::PrintSelf(std::ostream & os, Indent indent) const
+  {
+    Superclass::PrintSelf(os, indent);
+
+    os << indent << "Interpolator: " << m_Interpolator << std::endl;
+    os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
+    os << indent << "OutputOrigin: " << m_OutputOrigin << std::endl;
+    os << indent << "Size: " << m_Size << std::endl;
+    os << indent << "OutputStartIndex: " << m_OutputStartIndex << std::endl;
+    os << indent << "LabelMode: " << m_LabelMode << std::endl;
+  }
+} // end namespace itk
+
+#endif
@@ -17,6 +17,12 @@ found in the LICENSE file.
 #include <MitkBasicImageProcessingExports.h>
 #include <mitkImageMappingHelper.h>
 
+#include <itkImage.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace mitk
 {
 
@@ -53,11 +59,97 @@ namespace mitk
     static Image::Pointer LaplacianOfGaussian(Image::Pointer & image, double sigma, bool outputAsDouble = false);
     static std::vector<Image::Pointer> WaveletForward(Image::Pointer & image, unsigned int numberOfLevels, unsigned int numberOfBands, BorderCondition condition, WaveletType waveletType);
 
+    /** \brief Resamples the image to the given spacing.
+    *
+    * All interpolators except UserDefined are computed with itk::SeparableResampleImageFilter, UserDefined
+    * uses the MatchPoint mapper of mitk::ImageMappingHelper.
+    */
     static Image::Pointer ResampleImage(Image::Pointer &image, mitk::Vector3D spacing, mitk::ImageMappingInterpolator::Type interpolator, GridInterpolationPositionType position, bool returnAsDouble, bool roundOutput);
+
+    /** \brief Resamples the mask to the given spacing.
+    *
+    * Nearest neighbor interpolation keeps the pixel type and the values. Other interpolators except
+    * UserDefined interpolate every label on its own and assign the label with the largest weight, so the
+    * result has the pixel type and the label values of the input. Binary masks give the same voxels as a
+    * threshold of 0.5 on the interpolated mask. UserDefined interpolates the mask as double and thresholds
+    * it at 0.5, which returns a double image with the values 0 and 1.
+    */
     static Image::Pointer ResampleMask(Image::Pointer &image, mitk::Vector3D spacing, mitk::ImageMappingInterpolator::Type interpolator, GridInterpolationPositionType position);
 
   };
 
+  /** \brief Computes several filter responses of one image from a shared forward FFT
+  *
+  * The input is cast to double, padded according to the border condition and transformed into the
+  * frequency domain once. Each Laplacian of Gaussian and band-pass response is obtained by multiplying
+  * this spectrum with a kernel, followed by one inverse FFT. The kernels are evaluated while the spectrum is
+  * multiplied, from tables of the frequencies along each axis. The Laplacian of Gaussian kernel is the
+  * product of one exponential per axis, so no kernel of the size of the spectrum is stored.
+  *
+  * Because the spectrum is periodic, the input is padded by four times the largest Laplacian of Gaussian
+  * sigma on every side before it is padded to a size suitable for the FFT. The Laplacian of Gaussian
+  * responses therefore do not wrap around at the image border and equal the output of
+  * itk::LaplacianRecursiveGaussianImageFilter (TransformationOperation::LaplacianOfGaussian() with double
+  * output), up to the approximation error of the recursive filter and its own border handling. The ideal
+  * band-pass has no finite support; its responses use the same padding and may wrap around at the border.
+  *
+  * Wavelet decompositions are computed from a spectrum without that margin and give the same results as
+  * TransformationOperation::WaveletForward(). A bank that contains both wavelets and Laplacian of Gaussian
+  * filters therefore computes two forward FFTs.
+  *
+  * The responses are passed to the callback one after the other, so only one response is kept in memory
+  * at a time unless the callback stores it.
+  */
+  class MITKBASICIMAGEPROCESSING_EXPORT FrequencyFilterBank {
+  public:
+    typedef std::function<void(const std::string &name, Image::Pointer response)> ResponseCallbackType;
+
+    FrequencyFilterBank();
+
+    void SetBorderCondition(BorderCondition condition);
+
+    /** \brief Adds a Laplacian of Gaussian response, sigma is given in mm */
+    void AddLaplacianOfGaussian(double sigma);
+
+    /** \brief Adds an ideal band-pass response, the frequencies are given in cycles per mm */
+    void AddBandPass(double lowerFrequency, double upperFrequency);
+
+    /** \brief Adds all responses of a wavelet decomposition */
+    void AddWavelet(unsigned int numberOfLevels, unsigned int numberOfBands, WaveletType waveletType);
+
+    /** \brief Computes the responses of all added filters and passes them to the callback */
+    void Execute(const Image *image, const ResponseCallbackType &callback);
+
+    /** \brief Computes and returns the responses of all added filters in the order they were added */
+    std::vector<Image::Pointer> Execute(const Image *image);
+
+  private:
+    enum FilterType
+    {
+      LaplacianOfGaussianFilter,
+      BandPassFilter,
+      WaveletFilter
+    };
+
+    struct Filter
+    {
+      FilterType Type;
+      std::string Name;
+      double Sigma;
+      double LowerFrequency;
+      double UpperFrequency;
+      unsigned int NumberOfLevels;
+      unsigned int NumberOfBands;
+      WaveletType Wavelet;
+    };
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void ExecuteByItk(const itk::Image<TPixel, VImageDimension> *image, const ResponseCallbackType &callback);
+
+    std::vector<Filter> m_Filters;
+    BorderCondition m_BorderCondition;
+  };
+
 
 }
 #endif // mitkArithmeticOperation_h
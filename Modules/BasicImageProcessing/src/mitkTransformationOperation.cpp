@@ -35,11 +35,19 @@ found in the LICENSE file.
 #include "itkConstantBoundaryCondition.h"
 //#include <itkComplexToRealImageFilter.h>
 #include "itkCastImageFilter.h"
+#include <itkRegionOfInterestImageFilter.h>
+#include <itkPadImageFilter.h>
+#include <itkChangeInformationImageFilter.h>
 
 #include "itkUnaryFunctorImageFilter.h"
 #include <mitkImageMappingHelper.h>
 #include <mitkMAPAlgorithmHelper.h>
 #include <itkImageDuplicator.h>
+#include <itkSeparableResampleImageFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 namespace mitk
 {
@@ -176,31 +184,18 @@ mitk::Image::Pointer mitk::TransformationOperation::LaplacianOfGaussian(Image::P
 
 
 
-template<typename TInputPixel, typename TOutputPixel, unsigned int VImageDimension, typename TWaveletFunction >
-static void ExecuteSpecificWaveletTransformation(itk::Image<TInputPixel, VImageDimension>* image, unsigned int numberOfLevels, unsigned int numberOfBands, mitk::BorderCondition condition, std::vector<mitk::Image::Pointer> &resultImages)
+/** Pads the image by margin voxels on every side and to a size suitable for the FFT, both according to the
+border condition, and returns its spectrum. The spectrum starts at index 0, so the input lies at index margin. */
+template<typename TPixel, unsigned int VImageDimension>
+static typename itk::Image<std::complex<double>, VImageDimension>::Pointer ExecutePaddedForwardFFT(const itk::Image<TPixel, VImageDimension>* image, mitk::BorderCondition condition, const typename itk::Image<TPixel, VImageDimension>::SizeType &margin)
 {
-  const unsigned int Dimension = VImageDimension;
-  typedef TInputPixel                               PixelType;
-  typedef TOutputPixel                              OutputPixelType;
-  typedef itk::Image< PixelType, Dimension >        ImageType;
-  typedef itk::Image< double, Dimension >           DoubleImageType;
-  typedef itk::Image< OutputPixelType, Dimension >  OutputImageType;
-
-  typedef itk::CastImageFilter< ImageType, DoubleImageType >                                          CastFilterType;
-  typedef itk::FFTPadPositiveIndexImageFilter< DoubleImageType >                                      FFTPadType;
-  typedef itk::ForwardFFTImageFilter< DoubleImageType, itk::Image< std::complex<double>, Dimension> > FFTFilterType;
-  typedef typename FFTFilterType::OutputImageType                                                     ComplexImageType;
-
-  typedef TWaveletFunction                                                                            WaveletFunctionType;
-  typedef itk::WaveletFrequencyFilterBankGenerator< ComplexImageType, WaveletFunctionType >           WaveletFilterBankType;
-  typedef itk::WaveletFrequencyForward< ComplexImageType, ComplexImageType, WaveletFilterBankType >   ForwardWaveletType;
-
-  typedef itk::InverseFFTImageFilter< ComplexImageType, OutputImageType > InverseFFTFilterType;
-
-  // Convert input parameter
-  unsigned int highSubBands = numberOfBands; //inputBands;
-  unsigned int levels = numberOfLevels;
-
+  typedef itk::Image< TPixel, VImageDimension >                                             ImageType;
+  typedef itk::Image< double, VImageDimension >                                             DoubleImageType;
+  typedef itk::CastImageFilter< ImageType, DoubleImageType >                                CastFilterType;
+  typedef itk::PadImageFilter< DoubleImageType, DoubleImageType >                           MarginPadType;
+  typedef itk::ChangeInformationImageFilter< DoubleImageType >                              ShiftIndexType;
+  typedef itk::FFTPadPositiveIndexImageFilter< DoubleImageType >                            FFTPadType;
+  typedef itk::ForwardFFTImageFilter< DoubleImageType, itk::Image< std::complex<double>, VImageDimension> > FFTFilterType;
 
   // Perform FFT on input image
   typename CastFilterType::Pointer castFilter = CastFilterType::New();
@@ -212,31 +207,84 @@ static void ExecuteSpecificWaveletTransformation(itk::Image<TInputPixel, VImageD
   itk::ConstantBoundaryCondition< DoubleImageType > constantBoundaryCondition;
   itk::PeriodicBoundaryCondition< DoubleImageType > periodicBoundaryCondition;
   itk::ZeroFluxNeumannBoundaryCondition< DoubleImageType > zeroFluxNeumannBoundaryCondition;
+  itk::ImageBoundaryCondition< DoubleImageType > *boundaryCondition = &zeroFluxNeumannBoundaryCondition;
   switch (condition)
   {
   case mitk::BorderCondition::Constant:
-    fftpad->SetBoundaryCondition(&constantBoundaryCondition);
+    boundaryCondition = &constantBoundaryCondition;
     break;
   case mitk::BorderCondition::Periodic:
-    fftpad->SetBoundaryCondition(&periodicBoundaryCondition);
+    boundaryCondition = &periodicBoundaryCondition;
     break;
   case mitk::BorderCondition::ZeroFluxNeumann:
-    fftpad->SetBoundaryCondition(&zeroFluxNeumannBoundaryCondition);
+    boundaryCondition = &zeroFluxNeumannBoundaryCondition;
     break;
   default:
     break;
   }
-  fftpad->SetInput(castFilter->GetOutput());
+  fftpad->SetBoundaryCondition(boundaryCondition);
+
+  typename MarginPadType::Pointer marginPad = MarginPadType::New();
+  typename ShiftIndexType::Pointer shiftIndex = ShiftIndexType::New();
+  bool hasMargin = false;
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    hasMargin = hasMargin || margin[i] > 0;
+  }
+  if (hasMargin)
+  {
+    typename ShiftIndexType::OutputImageOffsetType offset;
+    for (unsigned int i = 0; i < VImageDimension; ++i)
+    {
+      offset[i] = margin[i];
+    }
+    marginPad->SetInput(castFilter->GetOutput());
+    marginPad->SetPadLowerBound(margin);
+    marginPad->SetPadUpperBound(margin);
+    marginPad->SetBoundaryCondition(boundaryCondition);
+    shiftIndex->SetInput(marginPad->GetOutput());
+    shiftIndex->SetOutputOffset(offset);
+    shiftIndex->ChangeRegionOn();
+    fftpad->SetInput(shiftIndex->GetOutput());
+  }
+  else
+  {
+    fftpad->SetInput(castFilter->GetOutput());
+  }
 
   typename FFTFilterType::Pointer fftFilter = FFTFilterType::New();
   fftFilter->SetInput(fftpad->GetOutput());
+  fftFilter->Update();
+
+  typename FFTFilterType::OutputImageType::Pointer spectrum = fftFilter->GetOutput();
+  spectrum->DisconnectPipeline();
+  return spectrum;
+}
+
+template<typename TInputPixel, typename TOutputPixel, unsigned int VImageDimension, typename TWaveletFunction >
+static void ExecuteSpecificWaveletTransformation(const itk::Image<TInputPixel, VImageDimension>* image, itk::Image<std::complex<double>, VImageDimension>* spectrum, unsigned int numberOfLevels, unsigned int numberOfBands, const std::string &name, const mitk::FrequencyFilterBank::ResponseCallbackType &callback)
+{
+  const unsigned int Dimension = VImageDimension;
+  typedef TOutputPixel                              OutputPixelType;
+  typedef itk::Image< OutputPixelType, Dimension >  OutputImageType;
+  typedef itk::Image< std::complex<double>, Dimension > ComplexImageType;
+
+  typedef TWaveletFunction                                                                            WaveletFunctionType;
+  typedef itk::WaveletFrequencyFilterBankGenerator< ComplexImageType, WaveletFunctionType >           WaveletFilterBankType;
+  typedef itk::WaveletFrequencyForward< ComplexImageType, ComplexImageType, WaveletFilterBankType >   ForwardWaveletType;
+
+  typedef itk::InverseFFTImageFilter< ComplexImageType, OutputImageType > InverseFFTFilterType;
+
+  // Convert input parameter
+  unsigned int highSubBands = numberOfBands; //inputBands;
+  unsigned int levels = numberOfLevels;
 
   // Calculate forward transformation
   typename ForwardWaveletType::Pointer forwardWavelet = ForwardWaveletType::New();
 
   forwardWavelet->SetHighPassSubBands(highSubBands);
   forwardWavelet->SetLevels(levels);
-  forwardWavelet->SetInput(fftFilter->GetOutput());
+  forwardWavelet->SetInput(spectrum);
   forwardWavelet->Update();
 
   // Obtain target spacing, size and origin
@@ -248,7 +296,7 @@ static void ExecuteSpecificWaveletTransformation(itk::Image<TInputPixel, VImageD
   typename ComplexImageType::SpacingType expectedSpacing = inputSpacing;
   typename ComplexImageType::PointType inputOrigin = image->GetOrigin();
   typename ComplexImageType::PointType expectedOrigin = inputOrigin;
-  typename ComplexImageType::SizeType inputSize = fftFilter->GetOutput()->GetLargestPossibleRegion().GetSize();
+  typename ComplexImageType::SizeType inputSize = spectrum->GetLargestPossibleRegion().GetSize();
   typename ComplexImageType::SizeType expectedSize = inputSize;
 
   // Inverse FFT to obtain filtered images
@@ -265,10 +313,14 @@ static void ExecuteSpecificWaveletTransformation(itk::Image<TInputPixel, VImageD
     for (unsigned int band = 0; band < highSubBands; ++band)
     {
       unsigned int nOutput = level * forwardWavelet->GetHighPassSubBands() + band;
+      std::ostringstream responseName;
+      responseName << name << "_level_" << level << "_band_" << band;
       // Do not compute bands in low-pass level.
       if (level == numberOfLevels && band == 0)
       {
         nOutput = forwardWavelet->GetTotalOutputs() - 1;
+        responseName.str("");
+        responseName << name << "_lowpass";
       }
       else if (level == numberOfLevels && band != 0)
       {
@@ -282,13 +334,13 @@ static void ExecuteSpecificWaveletTransformation(itk::Image<TInputPixel, VImageD
       itkOutputImage->SetSpacing(expectedSpacing);
       mitk::Image::Pointer outputImage = mitk::Image::New();
       CastToMitkImage(itkOutputImage, outputImage);
-      resultImages.push_back(outputImage);
+      callback(responseName.str(), outputImage);
     }
   }
 }
 
 template<typename TPixel, unsigned int VImageDimension>
-static void ExecuteWaveletTransformation(itk::Image<TPixel, VImageDimension>* image, unsigned int numberOfLevels, unsigned int numberOfBands, mitk::BorderCondition condition, mitk::WaveletType waveletType, std::vector<mitk::Image::Pointer> &resultImages)
+static void ExecuteWaveletTransformation(const itk::Image<TPixel, VImageDimension>* image, itk::Image<std::complex<double>, VImageDimension>* spectrum, unsigned int numberOfLevels, unsigned int numberOfBands, mitk::WaveletType waveletType, const std::string &name, const mitk::FrequencyFilterBank::ResponseCallbackType &callback)
 {
   typedef itk::Point< double, VImageDimension >                                   PointType;
   typedef itk::HeldIsotropicWavelet< double, VImageDimension, PointType >       HeldIsotropicWaveletType;
@@ -299,30 +351,247 @@ static void ExecuteWaveletTransformation(itk::Image<TPixel, VImageDimension>* im
   switch (waveletType)
   {
   case mitk::WaveletType::Held:
-    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, HeldIsotropicWaveletType >(image, numberOfLevels, numberOfBands, condition, resultImages);
+    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, HeldIsotropicWaveletType >(image, spectrum, numberOfLevels, numberOfBands, name, callback);
     break;
   case mitk::WaveletType::Shannon:
-    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, ShannonIsotropicWaveletType >(image, numberOfLevels, numberOfBands, condition, resultImages);
+    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, ShannonIsotropicWaveletType >(image, spectrum, numberOfLevels, numberOfBands, name, callback);
     break;
   case mitk::WaveletType::Simoncelli:
-    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, SimoncelliIsotropicWaveletType >(image, numberOfLevels, numberOfBands, condition, resultImages);
+    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, SimoncelliIsotropicWaveletType >(image, spectrum, numberOfLevels, numberOfBands, name, callback);
     break;
   case mitk::WaveletType::Vow:
-    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, VowIsotropicWaveletType >(image, numberOfLevels, numberOfBands, condition, resultImages);
+    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, VowIsotropicWaveletType >(image, spectrum, numberOfLevels, numberOfBands, name, callback);
     break;
   default:
-    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, ShannonIsotropicWaveletType >(image, numberOfLevels, numberOfBands, condition, resultImages);
+    ExecuteSpecificWaveletTransformation<TPixel, double, VImageDimension, ShannonIsotropicWaveletType >(image, spectrum, numberOfLevels, numberOfBands, name, callback);
     break;
   }
 }
 
 std::vector<mitk::Image::Pointer> mitk::TransformationOperation::WaveletForward(Image::Pointer & image, unsigned int numberOfLevels, unsigned int numberOfBands, mitk::BorderCondition condition, mitk::WaveletType waveletType)
+{
+  FrequencyFilterBank filterBank;
+  filterBank.SetBorderCondition(condition);
+  filterBank.AddWavelet(numberOfLevels, numberOfBands, waveletType);
+  return filterBank.Execute(image);
+}
+
+
+mitk::FrequencyFilterBank::FrequencyFilterBank()
+  : m_BorderCondition(mitk::BorderCondition::Constant)
+{
+}
+
+void mitk::FrequencyFilterBank::SetBorderCondition(BorderCondition condition)
+{
+  m_BorderCondition = condition;
+}
+
+void mitk::FrequencyFilterBank::AddLaplacianOfGaussian(double sigma)
+{
+  Filter filter = Filter();
+  filter.Type = LaplacianOfGaussianFilter;
+  filter.Sigma = sigma;
+  std::ostringstream name;
+  name << "LoG_sigma_" << sigma;
+  filter.Name = name.str();
+  m_Filters.push_back(filter);
+}
+
+void mitk::FrequencyFilterBank::AddBandPass(double lowerFrequency, double upperFrequency)
+{
+  Filter filter = Filter();
+  filter.Type = BandPassFilter;
+  filter.LowerFrequency = lowerFrequency;
+  filter.UpperFrequency = upperFrequency;
+  std::ostringstream name;
+  name << "BandPass_" << lowerFrequency << "_" << upperFrequency;
+  filter.Name = name.str();
+  m_Filters.push_back(filter);
+}
+
+void mitk::FrequencyFilterBank::AddWavelet(unsigned int numberOfLevels, unsigned int numberOfBands, WaveletType waveletType)
+{
+  Filter filter = Filter();
+  filter.Type = WaveletFilter;
+  filter.NumberOfLevels = numberOfLevels;
+  filter.NumberOfBands = numberOfBands;
+  filter.Wavelet = waveletType;
+  const char *waveletNames[] = { "Held", "Vow", "Simoncelli", "Shannon" };
+  filter.Name = std::string("Wavelet_") + waveletNames[waveletType];
+  m_Filters.push_back(filter);
+}
+
+void mitk::FrequencyFilterBank::Execute(const Image *image, const ResponseCallbackType &callback)
+{
+  AccessByItk_n(image, ExecuteByItk, (callback));
+}
+
+std::vector<mitk::Image::Pointer> mitk::FrequencyFilterBank::Execute(const Image *image)
 {
   std::vector<Image::Pointer> resultImages;
-  AccessByItk_n(image, ExecuteWaveletTransformation, (numberOfLevels, numberOfBands, condition, waveletType, resultImages));
+  this->Execute(image, [&resultImages](const std::string &, Image::Pointer response) { resultImages.push_back(response); });
   return resultImages;
 }
 
+template<typename TPixel, unsigned int VImageDimension>
+void mitk::FrequencyFilterBank::ExecuteByItk(const itk::Image<TPixel, VImageDimension> *image, const ResponseCallbackType &callback)
+{
+  typedef itk::Image< TPixel, VImageDimension >                                 ImageType;
+  typedef itk::Image< double, VImageDimension >                                 DoubleImageType;
+  typedef itk::Image< std::complex<double>, VImageDimension >                   ComplexImageType;
+  typedef itk::InverseFFTImageFilter< ComplexImageType, DoubleImageType >       InverseFFTFilterType;
+  typedef itk::RegionOfInterestImageFilter< DoubleImageType, DoubleImageType >  CropFilterType;
+
+  // The Laplacian of Gaussian kernels decay within four sigma, a margin of that size avoids wrap-around
+  double maximumSigma = 0.0;
+  bool hasKernelFilters = false;
+  bool hasWaveletFilters = false;
+  for (const auto &filter : m_Filters)
+  {
+    hasKernelFilters = hasKernelFilters || filter.Type != WaveletFilter;
+    hasWaveletFilters = hasWaveletFilters || filter.Type == WaveletFilter;
+    if (filter.Type == LaplacianOfGaussianFilter)
+      maximumSigma = std::max(maximumSigma, filter.Sigma);
+  }
+
+  typename ImageType::SizeType noMargin;
+  noMargin.Fill(0);
+  typename ImageType::SizeType margin = noMargin;
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    margin[i] = static_cast<typename ImageType::SizeValueType>(std::ceil(4.0 * maximumSigma / image->GetSpacing()[i]));
+  }
+
+  // The wavelets use the spectrum without margin, as TransformationOperation::WaveletForward() does
+  typename ComplexImageType::Pointer waveletSpectrum;
+  if (hasWaveletFilters)
+  {
+    waveletSpectrum = ExecutePaddedForwardFFT(image, m_BorderCondition, noMargin);
+  }
+  typename ComplexImageType::Pointer spectrum = waveletSpectrum;
+  if (hasKernelFilters && (spectrum.IsNull() || margin != noMargin))
+  {
+    spectrum = ExecutePaddedForwardFFT(image, m_BorderCondition, margin);
+  }
+  if (spectrum.IsNull())
+  {
+    return;
+  }
+
+  const typename ComplexImageType::RegionType spectrumRegion = spectrum->GetLargestPossibleRegion();
+  const typename ComplexImageType::SpacingType spacing = spectrum->GetSpacing();
+  const std::size_t numberOfPixels = spectrumRegion.GetNumberOfPixels();
+
+  const std::size_t rowLength = spectrumRegion.GetSize()[0];
+  const std::size_t numberOfRows = numberOfPixels / rowLength;
+  const double twoPiSquared = 4.0 * itk::Math::pi * itk::Math::pi;
+
+  // Squared frequency of every index along every axis in cycles per mm
+  std::vector<std::vector<double>> axisSquaredFrequencies(VImageDimension);
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    const long size = static_cast<long>(spectrumRegion.GetSize()[i]);
+    for (long k = 0; k < size; ++k)
+    {
+      const double frequency = (k < (size + 1) / 2 ? k : k - size) / (size * spacing[i]);
+      axisSquaredFrequencies[i].push_back(frequency * frequency);
+    }
+  }
+
+  // Buffer for the filtered spectrum, reused for all kernels
+  typename ComplexImageType::Pointer filteredSpectrum;
+  typename InverseFFTFilterType::Pointer inverseFFT = InverseFFTFilterType::New();
+
+  for (std::size_t filterIndex = 0; filterIndex < m_Filters.size(); ++filterIndex)
+  {
+    const Filter &filter = m_Filters[filterIndex];
+    if (filter.Type == WaveletFilter)
+    {
+      ExecuteWaveletTransformation(image, waveletSpectrum.GetPointer(), filter.NumberOfLevels, filter.NumberOfBands, filter.Wavelet, filter.Name, callback);
+      continue;
+    }
+
+    if (filteredSpectrum.IsNull())
+    {
+      filteredSpectrum = ComplexImageType::New();
+      filteredSpectrum->CopyInformation(spectrum);
+      filteredSpectrum->SetRegions(spectrumRegion);
+      filteredSpectrum->Allocate();
+    }
+
+    // exp(-sigma^2 * w_i^2 / 2) along every axis, their product is the Gaussian of the kernel
+    std::vector<std::vector<double>> axisGaussians(VImageDimension);
+    if (filter.Type == LaplacianOfGaussianFilter)
+    {
+      for (unsigned int i = 0; i < VImageDimension; ++i)
+      {
+        for (const double squaredFrequency : axisSquaredFrequencies[i])
+          axisGaussians[i].push_back(std::exp(-0.5 * filter.Sigma * filter.Sigma * twoPiSquared * squaredFrequency));
+      }
+    }
+
+    const std::complex<double> *input = spectrum->GetBufferPointer();
+    std::complex<double> *output = filteredSpectrum->GetBufferPointer();
+    std::vector<std::size_t> position(VImageDimension, 0);
+    for (std::size_t row = 0; row < numberOfRows; ++row)
+    {
+      double rowSquaredFrequency = 0.0;
+      double rowGaussian = 1.0;
+      for (unsigned int i = 1; i < VImageDimension; ++i)
+      {
+        rowSquaredFrequency += axisSquaredFrequencies[i][position[i]];
+        if (filter.Type == LaplacianOfGaussianFilter)
+          rowGaussian *= axisGaussians[i][position[i]];
+      }
+
+      const std::complex<double> *rowInput = input + row * rowLength;
+      std::complex<double> *rowOutput = output + row * rowLength;
+      if (filter.Type == LaplacianOfGaussianFilter)
+      {
+        // Fourier transform of the Laplacian of a Gaussian: -|w|^2 * exp(-sigma^2 * |w|^2 / 2)
+        for (std::size_t k = 0; k < rowLength; ++k)
+        {
+          const double squaredAngularFrequency = twoPiSquared * (rowSquaredFrequency + axisSquaredFrequencies[0][k]);
+          rowOutput[k] = rowInput[k] * (-squaredAngularFrequency * rowGaussian * axisGaussians[0][k]);
+        }
+      }
+      else
+      {
+        for (std::size_t k = 0; k < rowLength; ++k)
+        {
+          const double frequency = std::sqrt(rowSquaredFrequency + axisSquaredFrequencies[0][k]);
+          rowOutput[k] = rowInput[k] * ((frequency >= filter.LowerFrequency && frequency < filter.UpperFrequency) ? 1.0 : 0.0);
+        }
+      }
+
+      for (unsigned int i = 1; i < VImageDimension && ++position[i] == spectrumRegion.GetSize()[i]; ++i)
+        position[i] = 0;
+    }
+    filteredSpectrum->Modified();
+
+    inverseFFT->SetInput(filteredSpectrum);
+    inverseFFT->Update();
+
+    // Remove the padding, the input lies at index margin of the spectrum
+    typename DoubleImageType::RegionType inputRegion = image->GetLargestPossibleRegion();
+    for (unsigned int i = 0; i < VImageDimension; ++i)
+    {
+      inputRegion.SetIndex(i, static_cast<typename DoubleImageType::IndexValueType>(margin[i]));
+    }
+    typename CropFilterType::Pointer cropFilter = CropFilterType::New();
+    cropFilter->SetInput(inverseFFT->GetOutput());
+    cropFilter->SetRegionOfInterest(inputRegion);
+    cropFilter->Update();
+
+    typename DoubleImageType::Pointer response = cropFilter->GetOutput();
+    response->SetOrigin(image->GetOrigin());
+    mitk::Image::Pointer outputImage = mitk::Image::New();
+    CastToMitkImage(response, outputImage);
+    callback(filter.Name, outputImage);
+  }
+}
+
 
 template<typename TPixel, unsigned int VImageDimension>
 static void ExecuteImageTypeToDouble(itk::Image<TPixel, VImageDimension>* image, mitk::Image::Pointer &outputImage)
@@ -359,15 +628,8 @@ static void ExecuteRoundImage(itk::Image<TPixel, VImageDimension>* /*image*/, mi
   CastToMitkImage(filter->GetOutput(), outputImage);
 }
 
-mitk::Image::Pointer mitk::TransformationOperation::ResampleImage(Image::Pointer &image, mitk::Vector3D spacingVector, mitk::ImageMappingInterpolator::Type interpolator, GridInterpolationPositionType position, bool returnAsDouble, bool roundOutput)
+static mitk::BaseGeometry::Pointer ComputeResampledGeometry(const mitk::Image* image, const mitk::Vector3D &spacingVector, mitk::GridInterpolationPositionType position)
 {
-  // Convert image to double if required
-  mitk::Image::Pointer tmpImage = image;
-  if (returnAsDouble)
-  {
-    AccessByItk_n(image, ExecuteImageTypeToDouble, (tmpImage));
-  }
-
   auto newGeometry = image->GetGeometry()->Clone();
   mitk::Vector3D spacing;
   mitk::BaseGeometry::BoundsArrayType bounds = newGeometry->GetBounds();
@@ -403,17 +665,85 @@ mitk::Image::Pointer mitk::TransformationOperation::ResampleImage(Image::Pointer
   newGeometry->SetSpacing(spacing);
   newGeometry->SetOrigin(origin);
   newGeometry->SetBounds(bounds);
+  return newGeometry;
+}
 
-  mitk::Image::Pointer tmpResult = ImageMappingHelper::map(
-    tmpImage,
-    mitk::GenerateIdentityRegistration3D().GetPointer(),
-    false,
-    0.0, //Padding Value
-    newGeometry.GetPointer(),
-    false,
-    0, //Error Value
-    interpolator
-  );
+template<typename TPixel, unsigned int VImageDimension>
+static void ExecuteSeparableResampling(itk::Image<TPixel, VImageDimension>* image, const mitk::BaseGeometry* geometry, mitk::ImageMappingInterpolator::Type interpolator, bool labelMode, mitk::Image::Pointer &outputImage)
+{
+  typedef itk::Image< TPixel, VImageDimension >                   ImageType;
+  typedef itk::SeparableResampleImageFilter< ImageType, ImageType > ResampleFilterType;
+
+  typename ResampleFilterType::Pointer resampler = ResampleFilterType::New();
+  switch (interpolator)
+  {
+  case mitk::ImageMappingInterpolator::NearestNeighbor:
+    resampler->SetInterpolator(ResampleFilterType::NearestNeighbor);
+    break;
+  case mitk::ImageMappingInterpolator::BSpline_3:
+    resampler->SetInterpolator(ResampleFilterType::BSpline);
+    break;
+  case mitk::ImageMappingInterpolator::WSinc_Hamming:
+    resampler->SetInterpolator(ResampleFilterType::WindowedSincHamming);
+    break;
+  case mitk::ImageMappingInterpolator::WSinc_Welch:
+    resampler->SetInterpolator(ResampleFilterType::WindowedSincWelch);
+    break;
+  default:
+    resampler->SetInterpolator(ResampleFilterType::Linear);
+    break;
+  }
+
+  typename ImageType::SpacingType spacing;
+  typename ImageType::PointType origin;
+  typename ImageType::SizeType size;
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    spacing[i] = geometry->GetSpacing()[i];
+    origin[i] = geometry->GetOrigin()[i];
+    size[i] = static_cast<itk::SizeValueType>(std::round(geometry->GetBounds()[i * 2 + 1] - geometry->GetBounds()[i * 2]));
+  }
+  resampler->SetOutputSpacing(spacing);
+  resampler->SetOutputOrigin(origin);
+  resampler->SetSize(size);
+  resampler->SetLabelMode(labelMode);
+  resampler->SetInput(image);
+  resampler->Update();
+
+  CastToMitkImage(resampler->GetOutput(), outputImage);
+}
+
+mitk::Image::Pointer mitk::TransformationOperation::ResampleImage(Image::Pointer &image, mitk::Vector3D spacingVector, mitk::ImageMappingInterpolator::Type interpolator, GridInterpolationPositionType position, bool returnAsDouble, bool roundOutput)
+{
+  // Convert image to double if required
+  mitk::Image::Pointer tmpImage = image;
+  if (returnAsDouble)
+  {
+    AccessByItk_n(image, ExecuteImageTypeToDouble, (tmpImage));
+  }
+
+  auto newGeometry = ComputeResampledGeometry(image, spacingVector, position);
+
+  // Only spacing, origin and bounds differ from the input geometry, so the grids are
+  // axis aligned and the separable resampler can be used for all fixed interpolators.
+  mitk::Image::Pointer tmpResult;
+  if (interpolator == mitk::ImageMappingInterpolator::UserDefined)
+  {
+    tmpResult = ImageMappingHelper::map(
+      tmpImage,
+      mitk::GenerateIdentityRegistration3D().GetPointer(),
+      false,
+      0.0, //Padding Value
+      newGeometry.GetPointer(),
+      false,
+      0, //Error Value
+      interpolator
+    );
+  }
+  else
+  {
+    AccessByItk_n(tmpImage, ExecuteSeparableResampling, (newGeometry.GetPointer(), interpolator, false, tmpResult));
+  }
 
   mitk::Image::Pointer result = mitk::Image::New();
 
@@ -453,6 +783,14 @@ mitk::Image::Pointer mitk::TransformationOperation::ResampleMask(Image::Pointer
   {
     result = TransformationOperation::ResampleImage(image, spacingVector, interpolator, position, false, false);
   }
+  else if (interpolator != mitk::ImageMappingInterpolator::UserDefined)
+  {
+    // Every label is interpolated on its own, so masks with several labels keep their values
+    mitk::Image::Pointer labelImage = mitk::Image::New();
+    auto newGeometry = ComputeResampledGeometry(image, spacingVector, position);
+    AccessByItk_n(image, ExecuteSeparableResampling, (newGeometry.GetPointer(), interpolator, true, labelImage));
+    result = labelImage;
+  }
   else
   {
     auto tmpResult = TransformationOperation::ResampleImage(image, spacingVector, interpolator, position, true, false);
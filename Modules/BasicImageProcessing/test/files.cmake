@@ -0,0 +1,4 @@
+set(MODULE_TESTS
+  mitkFrequencyFilterBankTest.cpp
+  mitkSeparableResampleImageFilterTest.cpp
+)
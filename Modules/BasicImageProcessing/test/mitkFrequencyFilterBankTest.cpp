@@ -0,0 +1,225 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkImageCast.h>
+#include <mitkTransformationOperation.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <itkConstantBoundaryCondition.h>
+#include <itkFFTPadPositiveIndexImageFilter.h>
+#include <itkForwardFFTImageFilter.h>
+#include <itkHeldIsotropicWavelet.h>
+#include <itkInverseFFTImageFilter.h>
+#include <itkWaveletFrequencyFilterBankGenerator.h>
+#include <itkWaveletFrequencyForward.h>
+
+#include <algorithm>
+#include <cmath>
+
+class mitkFrequencyFilterBankTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkFrequencyFilterBankTestSuite);
+  MITK_TEST(LaplacianOfGaussian_EqualsLaplacianRecursiveGaussian);
+  MITK_TEST(LaplacianOfGaussian_NoWrapAround);
+  MITK_TEST(Wavelet_EqualsWaveletFrequencyForward);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> DoubleImageType;
+  typedef itk::Image<std::complex<double>, 3> ComplexImageType;
+
+  /** Image with a Gaussian blob of the given width (in mm) around the given voxel */
+  static mitk::Image::Pointer CreateBlobImage(const DoubleImageType::SizeType &size,
+                                              const DoubleImageType::SpacingType &spacing,
+                                              const DoubleImageType::IndexType &center,
+                                              double width)
+  {
+    auto itkImage = DoubleImageType::New();
+    itkImage->SetRegions(size);
+    itkImage->SetSpacing(spacing);
+    itkImage->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<DoubleImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      double squaredDistance = 0.0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double distance = (it.GetIndex()[i] - center[i]) * spacing[i];
+        squaredDistance += distance * distance;
+      }
+      it.Set(100.0 * std::exp(-0.5 * squaredDistance / (width * width)));
+    }
+
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(itkImage, image);
+    return image;
+  }
+
+  static DoubleImageType::Pointer ToItk(const mitk::Image::Pointer &image)
+  {
+    DoubleImageType::Pointer itkImage;
+    mitk::CastToItkImage(image, itkImage);
+    return itkImage;
+  }
+
+  static double GetMaximumAbsoluteValue(const DoubleImageType *image)
+  {
+    double maximum = 0.0;
+    itk::ImageRegionConstIterator<DoubleImageType> it(image, image->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      maximum = std::max(maximum, std::abs(it.Get()));
+    }
+    return maximum;
+  }
+
+  static void CheckEqualBuffers(const DoubleImageType *expected, const DoubleImageType *actual, double tolerance)
+  {
+    CPPUNIT_ASSERT(expected->GetLargestPossibleRegion().GetSize() == actual->GetLargestPossibleRegion().GetSize());
+
+    itk::ImageRegionConstIterator<DoubleImageType> expectedIt(expected, expected->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<DoubleImageType> actualIt(actual, actual->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedIt.Get(), actualIt.Get(), tolerance);
+    }
+  }
+
+public:
+  void LaplacianOfGaussian_EqualsLaplacianRecursiveGaussian()
+  {
+    DoubleImageType::SizeType size = {{30, 28, 22}};
+    DoubleImageType::SpacingType spacing;
+    spacing[0] = 1.0;
+    spacing[1] = 1.2;
+    spacing[2] = 1.5;
+    DoubleImageType::IndexType center = {{15, 13, 11}};
+    auto image = CreateBlobImage(size, spacing, center, 3.0);
+
+    mitk::FrequencyFilterBank filterBank;
+    filterBank.SetBorderCondition(mitk::BorderCondition::ZeroFluxNeumann);
+    filterBank.AddLaplacianOfGaussian(1.5);
+    filterBank.AddLaplacianOfGaussian(2.5);
+    auto responses = filterBank.Execute(image);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), responses.size());
+
+    const double sigmas[] = { 1.5, 2.5 };
+    for (std::size_t i = 0; i < responses.size(); ++i)
+    {
+      auto expected = ToItk(mitk::TransformationOperation::LaplacianOfGaussian(image, sigmas[i], true));
+      auto actual = ToItk(responses[i]);
+
+      CPPUNIT_ASSERT(expected->GetOrigin() == actual->GetOrigin());
+      CPPUNIT_ASSERT(expected->GetSpacing() == actual->GetSpacing());
+
+      // the recursive filter approximates the Gaussian derivatives
+      CheckEqualBuffers(expected, actual, 0.03 * GetMaximumAbsoluteValue(expected));
+    }
+  }
+
+  void LaplacianOfGaussian_NoWrapAround()
+  {
+    // 32 voxels need no padding to an FFT size, the slab at x < 4 would wrap around to the right border
+    DoubleImageType::SizeType size = {{32, 8, 8}};
+    auto itkImage = DoubleImageType::New();
+    itkImage->SetRegions(size);
+    itkImage->Allocate();
+    itk::ImageRegionIteratorWithIndex<DoubleImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      it.Set(it.GetIndex()[0] < 4 ? 100.0 : 0.0);
+    }
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(itkImage, image);
+
+    mitk::FrequencyFilterBank filterBank;
+    filterBank.SetBorderCondition(mitk::BorderCondition::Constant);
+    filterBank.AddLaplacianOfGaussian(2.0);
+    auto response = ToItk(filterBank.Execute(image)[0]);
+
+    const double maximum = GetMaximumAbsoluteValue(response);
+    CPPUNIT_ASSERT(maximum > 1.0);
+
+    itk::ImageRegionConstIteratorWithIndex<DoubleImageType> responseIt(response, response->GetLargestPossibleRegion());
+    for (responseIt.GoToBegin(); !responseIt.IsAtEnd(); ++responseIt)
+    {
+      if (responseIt.GetIndex()[0] >= 24)
+      {
+        CPPUNIT_ASSERT(std::abs(responseIt.Get()) < 1e-3 * maximum);
+      }
+    }
+  }
+
+  void Wavelet_EqualsWaveletFrequencyForward()
+  {
+    DoubleImageType::SizeType size = {{32, 32, 32}};
+    DoubleImageType::SpacingType spacing;
+    spacing.Fill(1.0);
+    DoubleImageType::IndexType center = {{12, 16, 18}};
+    auto image = CreateBlobImage(size, spacing, center, 4.0);
+
+    const unsigned int levels = 2;
+    const unsigned int bands = 2;
+
+    // a Laplacian of Gaussian in the same bank must not change the wavelet responses
+    mitk::FrequencyFilterBank filterBank;
+    filterBank.SetBorderCondition(mitk::BorderCondition::Constant);
+    filterBank.AddLaplacianOfGaussian(2.0);
+    filterBank.AddWavelet(levels, bands, mitk::WaveletType::Held);
+    auto responses = filterBank.Execute(image);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1 + levels * bands + 1), responses.size());
+
+    // reference: the ITK wavelet pipeline as used by TransformationOperation::WaveletForward() before the bank
+    typedef itk::HeldIsotropicWavelet<double, 3, itk::Point<double, 3>> WaveletFunctionType;
+    typedef itk::WaveletFrequencyFilterBankGenerator<ComplexImageType, WaveletFunctionType> WaveletFilterBankType;
+    typedef itk::WaveletFrequencyForward<ComplexImageType, ComplexImageType, WaveletFilterBankType> ForwardWaveletType;
+
+    auto pad = itk::FFTPadPositiveIndexImageFilter<DoubleImageType>::New();
+    itk::ConstantBoundaryCondition<DoubleImageType> constantBoundaryCondition;
+    pad->SetSizeGreatestPrimeFactor(4);
+    pad->SetBoundaryCondition(&constantBoundaryCondition);
+    pad->SetInput(ToItk(image));
+    auto fft = itk::ForwardFFTImageFilter<DoubleImageType, ComplexImageType>::New();
+    fft->SetInput(pad->GetOutput());
+    auto forwardWavelet = ForwardWaveletType::New();
+    forwardWavelet->SetHighPassSubBands(bands);
+    forwardWavelet->SetLevels(levels);
+    forwardWavelet->SetInput(fft->GetOutput());
+    forwardWavelet->Update();
+
+    std::vector<unsigned int> outputs;
+    for (unsigned int i = 0; i < levels * bands; ++i)
+      outputs.push_back(i);
+    outputs.push_back(forwardWavelet->GetTotalOutputs() - 1);
+
+    auto wavelets = mitk::TransformationOperation::WaveletForward(image, levels, bands, mitk::BorderCondition::Constant, mitk::WaveletType::Held);
+    CPPUNIT_ASSERT_EQUAL(outputs.size(), wavelets.size());
+
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+      auto inverseFFT = itk::InverseFFTImageFilter<ComplexImageType, DoubleImageType>::New();
+      inverseFFT->SetInput(forwardWavelet->GetOutput(outputs[i]));
+      inverseFFT->Update();
+
+      CheckEqualBuffers(inverseFFT->GetOutput(), ToItk(responses[i + 1]), 1e-9);
+      CheckEqualBuffers(inverseFFT->GetOutput(), ToItk(wavelets[i]), 1e-9);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFrequencyFilterBank)
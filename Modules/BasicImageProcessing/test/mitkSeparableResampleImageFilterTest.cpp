@@ -0,0 +1,259 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkImageCast.h>
+#include <mitkTransformationOperation.h>
+
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkIdentityTransform.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+#include <itkResampleImageFilter.h>
+#include <itkSeparableResampleImageFilter.h>
+#include <itkWindowedSincInterpolateImageFunction.h>
+
+#include <cmath>
+#include <set>
+
+class mitkSeparableResampleImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSeparableResampleImageFilterTestSuite);
+  MITK_TEST(NearestNeighbor_EqualsResampleImageFilter);
+  MITK_TEST(Linear_EqualsResampleImageFilter);
+  MITK_TEST(BSpline_EqualsResampleImageFilter);
+  MITK_TEST(WindowedSincHamming_EqualsResampleImageFilter);
+  MITK_TEST(WindowedSincWelch_EqualsResampleImageFilter);
+  MITK_TEST(ResampleMask_MultiLabel_KeepsLabelsAndPixelType);
+  MITK_TEST(ResampleMask_Binary_EqualsThresholdedInterpolation);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> MaskType;
+  typedef itk::SeparableResampleImageFilter<ImageType, ImageType> SeparableFilterType;
+  typedef itk::ResampleImageFilter<ImageType, ImageType> ResampleFilterType;
+
+  ImageType::Pointer m_Image;
+  ImageType::SpacingType m_OutputSpacing;
+  ImageType::PointType m_OutputOrigin;
+  ImageType::SizeType m_OutputSize;
+
+  /** Resamples m_Image onto the output grid with both filters and compares the results. */
+  void CheckAgainstResampleImageFilter(SeparableFilterType::InterpolatorType interpolatorType,
+                                       ResampleFilterType::InterpolatorType *interpolator,
+                                       double tolerance)
+  {
+    auto separable = SeparableFilterType::New();
+    separable->SetInput(m_Image);
+    separable->SetInterpolator(interpolatorType);
+    separable->SetOutputSpacing(m_OutputSpacing);
+    separable->SetOutputOrigin(m_OutputOrigin);
+    separable->SetSize(m_OutputSize);
+    separable->Update();
+
+    auto resampler = ResampleFilterType::New();
+    resampler->SetInput(m_Image);
+    resampler->SetTransform(itk::IdentityTransform<double, 3>::New());
+    resampler->SetInterpolator(interpolator);
+    resampler->SetOutputSpacing(m_OutputSpacing);
+    resampler->SetOutputOrigin(m_OutputOrigin);
+    resampler->SetOutputDirection(m_Image->GetDirection());
+    resampler->SetSize(m_OutputSize);
+    resampler->SetDefaultPixelValue(0.0);
+    resampler->Update();
+
+    const ImageType *actual = separable->GetOutput();
+    const ImageType *expected = resampler->GetOutput();
+    CPPUNIT_ASSERT(expected->GetLargestPossibleRegion() == actual->GetLargestPossibleRegion());
+    CPPUNIT_ASSERT(expected->GetOrigin() == actual->GetOrigin());
+    CPPUNIT_ASSERT(expected->GetSpacing() == actual->GetSpacing());
+
+    unsigned int numberOfOutsideVoxels = 0;
+    itk::ImageRegionConstIteratorWithIndex<ImageType> expectedIt(expected, expected->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ImageType> actualIt(actual, actual->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedIt.Get(), actualIt.Get(), tolerance);
+      if (expectedIt.Get() == 0.0)
+        ++numberOfOutsideVoxels;
+    }
+
+    // the output grid reaches beyond the input, so both filters have to agree on the default value as well
+    CPPUNIT_ASSERT(numberOfOutsideVoxels > 0);
+  }
+
+  static mitk::Image::Pointer CreateLabelMask(bool binary)
+  {
+    auto mask = MaskType::New();
+    MaskType::SizeType size = {{20, 20, 20}};
+    mask->SetRegions(size);
+    mask->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<MaskType> it(mask, mask->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      it.Set(GetLabel(it.GetIndex()[0], it.GetIndex()[2], binary));
+    }
+
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(mask, image);
+    return image;
+  }
+
+  /** Label at the continuous input index (x, z) of the mask created by CreateLabelMask() */
+  static unsigned short GetLabel(double x, double z, bool binary)
+  {
+    if (z < 3.5)
+      return 0;
+    if (binary)
+      return x < 9.5 ? 1 : 0;
+    if (x < 6.5)
+      return 1;
+    return x < 13.5 ? 2 : 5;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = ImageType::New();
+    ImageType::SizeType size = {{20, 18, 16}};
+    ImageType::SpacingType spacing;
+    spacing[0] = 1.0;
+    spacing[1] = 1.5;
+    spacing[2] = 2.0;
+    ImageType::PointType origin;
+    origin[0] = -3.2;
+    origin[1] = 5.1;
+    origin[2] = 10.7;
+    m_Image->SetRegions(size);
+    m_Image->SetSpacing(spacing);
+    m_Image->SetOrigin(origin);
+    m_Image->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(m_Image, m_Image->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      it.Set(50.0 + 20.0 * std::sin(0.3 * index[0]) * std::cos(0.2 * index[1]) + 0.5 * index[2]);
+    }
+
+    // finer along x, coarser along y; the grid starts before the input along y and ends behind it along z
+    m_OutputSpacing[0] = 0.7;
+    m_OutputSpacing[1] = 2.3;
+    m_OutputSpacing[2] = 1.3;
+    m_OutputOrigin[0] = origin[0] + 1.13;
+    m_OutputOrigin[1] = origin[1] - 0.77;
+    m_OutputOrigin[2] = origin[2] + 2.41;
+    m_OutputSize[0] = 24;
+    m_OutputSize[1] = 12;
+    m_OutputSize[2] = 22;
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void NearestNeighbor_EqualsResampleImageFilter()
+  {
+    auto interpolator = itk::NearestNeighborInterpolateImageFunction<ImageType, double>::New();
+    CheckAgainstResampleImageFilter(SeparableFilterType::NearestNeighbor, interpolator, 0.0);
+  }
+
+  void Linear_EqualsResampleImageFilter()
+  {
+    auto interpolator = itk::LinearInterpolateImageFunction<ImageType, double>::New();
+    CheckAgainstResampleImageFilter(SeparableFilterType::Linear, interpolator, 1e-9);
+  }
+
+  void BSpline_EqualsResampleImageFilter()
+  {
+    auto interpolator = itk::BSplineInterpolateImageFunction<ImageType, double, double>::New();
+    interpolator->SetSplineOrder(3);
+    CheckAgainstResampleImageFilter(SeparableFilterType::BSpline, interpolator, 1e-5);
+  }
+
+  void WindowedSincHamming_EqualsResampleImageFilter()
+  {
+    // ITK does not normalize the sinc weights to one, which causes differences of up to a few percent
+    auto interpolator = itk::WindowedSincInterpolateImageFunction<ImageType, 4, itk::Function::HammingWindowFunction<4>>::New();
+    CheckAgainstResampleImageFilter(SeparableFilterType::WindowedSincHamming, interpolator, 0.03 * 80.0);
+  }
+
+  void WindowedSincWelch_EqualsResampleImageFilter()
+  {
+    auto interpolator = itk::WindowedSincInterpolateImageFunction<ImageType, 4, itk::Function::WelchWindowFunction<4>>::New();
+    CheckAgainstResampleImageFilter(SeparableFilterType::WindowedSincWelch, interpolator, 0.03 * 80.0);
+  }
+
+  void ResampleMask_MultiLabel_KeepsLabelsAndPixelType()
+  {
+    auto mask = CreateLabelMask(false);
+    mitk::Vector3D spacing;
+    spacing.Fill(0.7);
+
+    auto result = mitk::TransformationOperation::ResampleMask(mask, spacing, mitk::ImageMappingInterpolator::Linear, mitk::GridInterpolationPositionType::OriginAligned);
+    CPPUNIT_ASSERT(result.IsNotNull());
+    CPPUNIT_ASSERT(mask->GetPixelType() == result->GetPixelType());
+
+    MaskType::Pointer itkResult;
+    mitk::CastToItkImage(result, itkResult);
+
+    std::set<unsigned short> labels;
+    itk::ImageRegionConstIteratorWithIndex<MaskType> it(itkResult, itkResult->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const unsigned short label = it.Get();
+      labels.insert(label);
+
+      // the input starts at the origin with spacing 1, so positions are input indices
+      const double x = 0.7 * it.GetIndex()[0];
+      const double z = 0.7 * it.GetIndex()[2];
+      const bool awayFromLabelBorders = std::abs(x - 6.5) > 1.0 && std::abs(x - 13.5) > 1.0 && std::abs(z - 3.5) > 1.0;
+      if (awayFromLabelBorders && x <= 19.0 && z <= 19.0)
+      {
+        CPPUNIT_ASSERT_EQUAL(GetLabel(x, z, false), label);
+      }
+    }
+
+    // no blended values between the labels
+    const std::set<unsigned short> expectedLabels = { 0, 1, 2, 5 };
+    CPPUNIT_ASSERT(expectedLabels == labels);
+  }
+
+  void ResampleMask_Binary_EqualsThresholdedInterpolation()
+  {
+    auto mask = CreateLabelMask(true);
+    mitk::Vector3D spacing;
+    spacing.Fill(0.7);
+
+    auto result = mitk::TransformationOperation::ResampleMask(mask, spacing, mitk::ImageMappingInterpolator::Linear, mitk::GridInterpolationPositionType::OriginAligned);
+    auto interpolated = mitk::TransformationOperation::ResampleImage(mask, spacing, mitk::ImageMappingInterpolator::Linear, mitk::GridInterpolationPositionType::OriginAligned, true, false);
+
+    MaskType::Pointer itkResult;
+    mitk::CastToItkImage(result, itkResult);
+    ImageType::Pointer itkInterpolated;
+    mitk::CastToItkImage(interpolated, itkInterpolated);
+    CPPUNIT_ASSERT(itkResult->GetLargestPossibleRegion() == itkInterpolated->GetLargestPossibleRegion());
+
+    itk::ImageRegionConstIterator<MaskType> resultIt(itkResult, itkResult->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ImageType> interpolatedIt(itkInterpolated, itkInterpolated->GetLargestPossibleRegion());
+    for (; !resultIt.IsAtEnd(); ++resultIt, ++interpolatedIt)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(interpolatedIt.Get() >= 0.5 ? 1 : 0), resultIt.Get());
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSeparableResampleImageFilter)
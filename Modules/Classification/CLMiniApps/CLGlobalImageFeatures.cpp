@@ -21,6 +21,7 @@ found in the LICENSE file.
 
 #include <mitkSplitParameterToVector.h>
 #include <mitkGlobalImageFeaturesParameter.h>
+#include <mitkGlobalImageFeaturesCalculation.h>
 
 #include <mitkGIFCooccurenceMatrix.h>
 #include <mitkGIFCooccurenceMatrix2.h>
@@ -45,15 +46,19 @@ found in the LICENSE file.
 
 #include <mitkCLResultWriter.h>
 #include <mitkCLResultXMLWriter.h>
+#include <mitkParallelFor.h>
 #include <mitkVersion.h>
 
+#include <algorithm>
 #include <iostream>
 #include <locale>
+#include <memory>
 
 #include <itkImageDuplicator.h>
 #include <itkImageRegionIterator.h>
 
 
+#include "itkMultiThreader.h"
 #include "itkNearestNeighborInterpolateImageFunction.h"
 #include "itkResampleImageFilter.h"
 
@@ -69,6 +74,9 @@ found in the LICENSE file.
 typedef itk::Image< double, 3 >                 FloatImageType;
 typedef itk::Image< unsigned short, 3 >          MaskImageType;
 
+typedef mitk::AbstractGlobalImageFeature::FeatureListType FeatureListType;
+typedef mitk::cl::FeatureClassListType FeatureClassListType;
+
 template <class charT>
 class punct_facet : public std::numpunct<charT> {
 public:
@@ -359,7 +367,8 @@ void SaveSliceOrImageAsPNG(mitk::Image::Pointer image, mitk::Image::Pointer mask
   }
 }
 
-int main(int argc, char* argv[])
+
+static FeatureClassListType CreateFeatureClasses()
 {
   // Commented : Updated to a common interface, include, if possible, mask is type unsigned short, uses Quantification, Comments
   //                                 Name follows standard scheme with Class Name::Feature Name
@@ -381,7 +390,7 @@ int main(int argc, char* argv[])
   mitk::GIFNeighbourhoodGreyToneDifferenceFeatures::Pointer ngtdCalculator = mitk::GIFNeighbourhoodGreyToneDifferenceFeatures::New(); //Commented 2, Tested
   mitk::GIFCurvatureStatistic::Pointer curvCalculator = mitk::GIFCurvatureStatistic::New(); //Commented 2, Tested
 
-  std::vector<mitk::AbstractGlobalImageFeature::Pointer> features;
+  FeatureClassListType features;
   features.push_back(volCalculator.GetPointer());
   features.push_back(voldenCalculator.GetPointer());
   features.push_back(curvCalculator.GetPointer());
@@ -398,11 +407,83 @@ int main(int argc, char* argv[])
   features.push_back(gldzCalculator.GetPointer());
   features.push_back(ipCalculator.GetPointer());
   features.push_back(ngtdCalculator.GetPointer());
+  return features;
+}
+
+static void ConfigureFeatureClasses(const FeatureClassListType &features,
+                                    const mitk::cl::GlobalImageFeaturesParameter &param,
+                                    const std::map<std::string, us::Any> &parsedArgs,
+                                    int direction)
+{
+  for (auto cFeature : features)
+  {
+    if (param.defineGlobalMinimumIntensity)
+    {
+      cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
+      cFeature->SetUseMinimumIntensity(true);
+    }
+    if (param.defineGlobalMaximumIntensity)
+    {
+      cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
+      cFeature->SetUseMaximumIntensity(true);
+    }
+    if (param.defineGlobalNumberOfBins)
+    {
+      cFeature->SetBins(param.globalNumberOfBins);
+    }
+    cFeature->SetParameters(parsedArgs);
+    cFeature->SetDirection(direction);
+    cFeature->SetEncodeParametersInFeaturePrefix(param.encodeParameter);
+  }
+}
+
+/** Reads a cohort file. Every line holds the paths of image, mask and optionally morphological mask, separated by ';'.
+*   Empty lines and lines starting with '#' are skipped. */
+static bool ReadCohort(const std::string &path, std::vector<std::vector<std::string>> &cases)
+{
+  std::ifstream file(path);
+  if (!file.good())
+  {
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+    {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+
+    std::vector<std::string> paths;
+    std::stringstream ss(line);
+    std::string path;
+    while (std::getline(ss, path, ';'))
+    {
+      paths.push_back(path);
+    }
+    if (paths.size() < 2 || paths.size() > 3)
+    {
+      MITK_ERROR << "Invalid line in cohort file: " << line;
+      return false;
+    }
+    cases.push_back(paths);
+  }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  FeatureClassListType features = CreateFeatureClasses();
 
   mitkCommandLineParser parser;
   parser.setArgumentPrefix("--", "-");
   mitk::cl::GlobalImageFeaturesParameter param;
-  param.AddParameter(parser);
+  param.AddParameter(parser, false);
 
   parser.addArgument("--","-", mitkCommandLineParser::String, "---", "---", us::Any(),true);
   for (auto cFeature : features)
@@ -416,6 +497,10 @@ int main(int argc, char* argv[])
   parser.addArgument("slice-wise", "slice", mitkCommandLineParser::String, "Int", "Allows to specify if the image is processed slice-wise (number giving direction) ", us::Any());
   parser.addArgument("output-mode", "omode", mitkCommandLineParser::Int, "Int", "Defines the format of the output. 0: (Default) results of an image / slice are written in a single row;"
     " 1: results of an image / slice are written in a single column; 2: store the result of on image as structured radiomocs report (XML).");
+  parser.addArgument("cohort", "cohort", mitkCommandLineParser::File, "Cohort file", "Text file with one case per line, given as 'image;mask' or 'image;mask;morph-mask'. "
+    "All cases are processed with the same settings and written to the same output. Replaces --image and --mask; "
+    "--morph-mask is used for cases without an own morphological mask.", us::Any(), true, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("threads", "threads", mitkCommandLineParser::Int, "Int", "Number of slices that are calculated concurrently in slice-wise mode. Default: number of cores.", us::Any());
 
   // Miniapp Infos
   parser.setCategory("Classification Tools");
@@ -424,7 +509,6 @@ int main(int argc, char* argv[])
   parser.setContributor("German Cancer Research Center (DKFZ)");
 
   std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
-  param.ParseParameter(parsedArgs);
 
   if (parsedArgs.size()==0)
   {
@@ -434,6 +518,23 @@ int main(int argc, char* argv[])
   {
     return EXIT_SUCCESS;
   }
+  param.ParseParameter(parsedArgs);
+
+  std::vector<std::vector<std::string>> cases;
+  const bool cohortMode = parsedArgs.count("cohort") > 0;
+  if (cohortMode)
+  {
+    if (!ReadCohort(parsedArgs["cohort"].ToString(), cases) || cases.empty())
+    {
+      MITK_ERROR << "Could not read cases from cohort file " << parsedArgs["cohort"].ToString();
+      return EXIT_FAILURE;
+    }
+  }
+  else if (param.imagePath.empty() || param.maskPath.empty())
+  {
+    MITK_ERROR << "Either --image and --mask or --cohort have to be given";
+    return EXIT_FAILURE;
+  }
 
   //bool savePNGofSlices = true;
   //std::string folderForPNGOfSlices = "E:\\tmp\\bonekamp\\fig\\";
@@ -445,167 +546,57 @@ int main(int argc, char* argv[])
   if (param.useLogfile)
   {
     log.open(param.logfilePath, std::ios::app);
-    log << std::endl;
-    log << version;
-    log << "Image: " << param.imagePath;
-    log << "Mask: " << param.maskPath;
   }
 
-
   if (param.useDecimalPoint)
   {
     std::cout.imbue(std::locale(std::cout.getloc(), new punct_facet<char>(param.decimalPoint)));
   }
 
-
-  //representing the original loaded image data without any prepropcessing that might come.
-  mitk::Image::Pointer loadedImage = mitk::IOUtil::Load<mitk::Image>(param.imagePath);
-  //representing the original loaded mask data without any prepropcessing that might come.
-  mitk::Image::Pointer loadedMask = mitk::IOUtil::Load<mitk::Image>(param.maskPath);
-
-  mitk::Image::Pointer image = loadedImage;
-  mitk::Image::Pointer mask = loadedMask;
-
-  mitk::Image::Pointer tmpImage = loadedImage;
-  mitk::Image::Pointer tmpMask = loadedMask;
-
-  mitk::Image::Pointer morphMask = mask;
-  if (param.useMorphMask)
-  {
-    morphMask = mitk::IOUtil::Load<mitk::Image>(param.morphPath);
-  }
-
-  log << " Check for Dimensions -";
-  if ((image->GetDimension() != mask->GetDimension()))
-  {
-    MITK_INFO << "Dimension of image does not match. ";
-    MITK_INFO << "Correct one image, may affect the result";
-    if (image->GetDimension() == 2)
-    {
-      mitk::Convert2Dto3DImageFilter::Pointer multiFilter2 = mitk::Convert2Dto3DImageFilter::New();
-      multiFilter2->SetInput(tmpImage);
-      multiFilter2->Update();
-      image = multiFilter2->GetOutput();
-    }
-    if (mask->GetDimension() == 2)
-    {
-      mitk::Convert2Dto3DImageFilter::Pointer multiFilter3 = mitk::Convert2Dto3DImageFilter::New();
-      multiFilter3->SetInput(tmpMask);
-      multiFilter3->Update();
-      mask = multiFilter3->GetOutput();
-    }
-  }
-
   int writeDirection = 0;
   if (parsedArgs.count("output-mode"))
   {
     writeDirection = us::any_cast<int>(parsedArgs["output-mode"]);
   }
 
-  log << " Check for Resolution -";
-  if (param.resampleToFixIsotropic)
-  {
-    mitk::Image::Pointer newImage = mitk::Image::New();
-    AccessByItk_2(image, ResampleImage, param.resampleResolution, newImage);
-    image = newImage;
-  }
-
-  log << " Resample if required -";
-  if (param.resampleMask)
-  {
-    mitk::Image::Pointer newMaskImage = mitk::Image::New();
-    AccessByItk_2(mask, ResampleMask, image, newMaskImage);
-    mask = newMaskImage;
-  }
-
-  if ( ! mitk::Equal(mask->GetGeometry(0)->GetOrigin(), image->GetGeometry(0)->GetOrigin()))
-  {
-    MITK_INFO << "Not equal Origins";
-    if (param.ensureSameSpace)
-    {
-      MITK_INFO << "Warning!";
-      MITK_INFO << "The origin of the input image and the mask do not match. They are";
-      MITK_INFO << "now corrected. Please check to make sure that the images still match";
-      image->GetGeometry(0)->SetOrigin(mask->GetGeometry(0)->GetOrigin());
-    } else
-    {
-      return -1;
-    }
-  }
-
-  log << " Check for Equality -";
-  if ( ! mitk::Equal(mask->GetGeometry(0)->GetSpacing(), image->GetGeometry(0)->GetSpacing()))
-  {
-    MITK_INFO << "Not equal Spacing";
-    if (param.ensureSameSpace)
-    {
-      MITK_INFO << "Warning!";
-      MITK_INFO << "The spacing of the mask was set to match the spacing of the input image.";
-      MITK_INFO << "This might cause unintended spacing of the mask image";
-      image->GetGeometry(0)->SetSpacing(mask->GetGeometry(0)->GetSpacing());
-    } else
-    {
-      MITK_INFO << "The spacing of the mask and the input images is not equal.";
-      MITK_INFO << "Terminating the programm. You may use the '-fi' option";
-      return -1;
-    }
-  }
-
   int direction = 0;
   if (parsedArgs.count("direction"))
   {
     direction = mitk::cl::splitDouble(parsedArgs["direction"].ToString(), ';')[0];
   }
 
-  MITK_INFO << "Start creating Mask without NaN";
-
-  mitk::Image::Pointer maskNoNaN = mitk::Image::New();
-  AccessByItk_2(image, CreateNoNaNMask,  mask, maskNoNaN);
-  //CreateNoNaNMask(mask, image, maskNoNaN);
-
-
   bool sliceWise = false;
   int sliceDirection = 0;
-  unsigned int currentSlice = 0;
-  bool imageToProcess = true;
-
-  std::vector<mitk::Image::Pointer> floatVector;
-  std::vector<mitk::Image::Pointer> maskVector;
-  std::vector<mitk::Image::Pointer> maskNoNaNVector;
-  std::vector<mitk::Image::Pointer> morphMaskVector;
-
-  if ((parsedArgs.count("slice-wise")) && image->GetDimension() > 2)
+  if (parsedArgs.count("slice-wise"))
   {
-    MITK_INFO << "Enabled slice-wise";
     sliceWise = true;
     sliceDirection = mitk::cl::splitDouble(parsedArgs["slice-wise"].ToString(), ';')[0];
-    MITK_INFO << sliceDirection;
-    ExtractSlicesFromImages(image, mask, maskNoNaN, morphMask, sliceDirection, floatVector, maskVector, maskNoNaNVector, morphMaskVector);
-    MITK_INFO << "Slice";
+  }
+
+  unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads();
+  if (parsedArgs.count("threads"))
+  {
+    numberOfThreads = std::max(1, us::any_cast<int>(parsedArgs["threads"]));
+  }
+
+  if (cohortMode && !param.outputXMLPath.empty())
+  {
+    MITK_ERROR << "Xml output is not supported in cohort mode";
+    return EXIT_FAILURE;
   }
 
   log << " Configure features -";
-  for (auto cFeature : features)
+  if (param.defineGlobalNumberOfBins)
   {
-    if (param.defineGlobalMinimumIntensity)
-    {
-      cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
-      cFeature->SetUseMinimumIntensity(true);
-    }
-    if (param.defineGlobalMaximumIntensity)
-    {
-      cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
-      cFeature->SetUseMaximumIntensity(true);
-    }
-    if (param.defineGlobalNumberOfBins)
-    {
-      cFeature->SetBins(param.globalNumberOfBins);
-      MITK_INFO << param.globalNumberOfBins;
-    }
-    cFeature->SetParameters(parsedArgs);
-    cFeature->SetDirection(direction);
-    cFeature->SetEncodeParametersInFeaturePrefix(param.encodeParameter);
+    MITK_INFO << param.globalNumberOfBins;
   }
+  ConfigureFeatureClasses(features, param, parsedArgs, direction);
+  auto createFeatureClasses = [&]()
+  {
+    FeatureClassListType workerFeatures = CreateFeatureClasses();
+    ConfigureFeatureClasses(workerFeatures, param, parsedArgs, direction);
+    return workerFeatures;
+  };
 
   bool addDescription = parsedArgs.count("description");
   mitk::cl::FeatureResultWriter writer(param.outputPath, writeDirection);
@@ -621,11 +612,6 @@ int main(int argc, char* argv[])
     description = parsedArgs["description"].ToString();
   }
 
-  mitk::Image::Pointer cImage = image;
-  mitk::Image::Pointer cMask = mask;
-  mitk::Image::Pointer cMaskNoNaN = maskNoNaN;
-  mitk::Image::Pointer cMorphMask = morphMask;
-
   if (param.useHeader)
   {
     writer.AddColumn("SoftwareVersion");
@@ -636,147 +622,294 @@ int main(int argc, char* argv[])
 
   // Create a QTApplication and a Datastorage
   // This is necessary in order to save screenshots of
-  // each image / slice.
-  QApplication qtapplication(argc, argv);
-  QmitkRegisterClasses();
-
-  std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> allStats;
+  // each image / slice. Runs without screenshots do not need the GUI.
+  std::unique_ptr<QApplication> qtapplication;
+  if (param.writePNGScreenshots)
+  {
+    qtapplication.reset(new QApplication(argc, argv));
+    QmitkRegisterClasses();
+  }
 
-  log << " Begin Processing -";
-  while (imageToProcess)
+  auto processCase = [&]() -> int
   {
-    if (sliceWise)
-    {
-      cImage = floatVector[currentSlice];
-      cMask = maskVector[currentSlice];
-      cMaskNoNaN = maskNoNaNVector[currentSlice];
-      cMorphMask = morphMaskVector[currentSlice];
-      imageToProcess = (floatVector.size()-1 > (currentSlice)) ? true : false ;
-    }
-    else
+    if (param.useLogfile)
     {
-      imageToProcess = false;
+      log << std::endl;
+      log << version;
+      log << "Image: " << param.imagePath;
+      log << "Mask: " << param.maskPath;
     }
 
-    if (param.writePNGScreenshots)
+    //representing the original loaded image data without any prepropcessing that might come.
+    mitk::Image::Pointer loadedImage = mitk::IOUtil::Load<mitk::Image>(param.imagePath);
+    //representing the original loaded mask data without any prepropcessing that might come.
+    mitk::Image::Pointer loadedMask = mitk::IOUtil::Load<mitk::Image>(param.maskPath);
+
+    mitk::Image::Pointer image = loadedImage;
+    mitk::Image::Pointer mask = loadedMask;
+
+    mitk::Image::Pointer tmpImage = loadedImage;
+    mitk::Image::Pointer tmpMask = loadedMask;
+
+    mitk::Image::Pointer morphMask = mask;
+    if (param.useMorphMask)
     {
-      SaveSliceOrImageAsPNG(cImage, cMask, param.pngScreenshotsPath, currentSlice);
+      morphMask = mitk::IOUtil::Load<mitk::Image>(param.morphPath);
     }
-    if (param.writeAnalysisImage)
+
+    log << " Check for Dimensions -";
+    if ((image->GetDimension() != mask->GetDimension()))
     {
-      mitk::IOUtil::Save(cImage, param.anaylsisImagePath);
+      MITK_INFO << "Dimension of image does not match. ";
+      MITK_INFO << "Correct one image, may affect the result";
+      if (image->GetDimension() == 2)
+      {
+        mitk::Convert2Dto3DImageFilter::Pointer multiFilter2 = mitk::Convert2Dto3DImageFilter::New();
+        multiFilter2->SetInput(tmpImage);
+        multiFilter2->Update();
+        image = multiFilter2->GetOutput();
+      }
+      if (mask->GetDimension() == 2)
+      {
+        mitk::Convert2Dto3DImageFilter::Pointer multiFilter3 = mitk::Convert2Dto3DImageFilter::New();
+        multiFilter3->SetInput(tmpMask);
+        multiFilter3->Update();
+        mask = multiFilter3->GetOutput();
+      }
     }
-    if (param.writeAnalysisMask)
+
+    log << " Check for Resolution -";
+    if (param.resampleToFixIsotropic)
     {
-      mitk::IOUtil::Save(cMask, param.analysisMaskPath);
+      mitk::Image::Pointer newImage = mitk::Image::New();
+      AccessByItk_2(image, ResampleImage, param.resampleResolution, newImage);
+      image = newImage;
     }
 
-    mitk::AbstractGlobalImageFeature::FeatureListType stats;
-
-    for (auto cFeature : features)
+    log << " Resample if required -";
+    if (param.resampleMask)
     {
-      log << " Calculating " << cFeature->GetFeatureClassName() << " -";
-      cFeature->SetMorphMask(cMorphMask);
-      cFeature->CalculateAndAppendFeatures(cImage, cMask, cMaskNoNaN, stats, !param.calculateAllFeatures);
+      mitk::Image::Pointer newMaskImage = mitk::Image::New();
+      AccessByItk_2(mask, ResampleMask, image, newMaskImage);
+      mask = newMaskImage;
     }
 
-    for (std::size_t i = 0; i < stats.size(); ++i)
+    if ( ! mitk::Equal(mask->GetGeometry(0)->GetOrigin(), image->GetGeometry(0)->GetOrigin()))
     {
-      std::cout << stats[i].first.legacyName << " - " << stats[i].second << std::endl;
+      MITK_INFO << "Not equal Origins";
+      if (param.ensureSameSpace)
+      {
+        MITK_INFO << "Warning!";
+        MITK_INFO << "The origin of the input image and the mask do not match. They are";
+        MITK_INFO << "now corrected. Please check to make sure that the images still match";
+        image->GetGeometry(0)->SetOrigin(mask->GetGeometry(0)->GetOrigin());
+      } else
+      {
+        return -1;
+      }
     }
 
-    writer.AddHeader(description, currentSlice, stats, param.useHeader, addDescription);
-    if (true)
+    log << " Check for Equality -";
+    if ( ! mitk::Equal(mask->GetGeometry(0)->GetSpacing(), image->GetGeometry(0)->GetSpacing()))
     {
-      writer.AddSubjectInformation(MITK_REVISION);
-      writer.AddSubjectInformation(param.imageFolder);
-      writer.AddSubjectInformation(param.imageName);
-      writer.AddSubjectInformation(param.maskName);
+      MITK_INFO << "Not equal Spacing";
+      if (param.ensureSameSpace)
+      {
+        MITK_INFO << "Warning!";
+        MITK_INFO << "The spacing of the mask was set to match the spacing of the input image.";
+        MITK_INFO << "This might cause unintended spacing of the mask image";
+        image->GetGeometry(0)->SetSpacing(mask->GetGeometry(0)->GetSpacing());
+      } else
+      {
+        MITK_INFO << "The spacing of the mask and the input images is not equal.";
+        MITK_INFO << "Terminating the programm. You may use the '-fi' option";
+        return -1;
+      }
     }
-    writer.AddResult(description, currentSlice, stats, param.useHeader, addDescription);
 
-    allStats.push_back(stats);
-    ++currentSlice;
-  }
+    MITK_INFO << "Start creating Mask without NaN";
 
-  log << " Process Slicewise -";
-  if (sliceWise)
-  {
-    mitk::AbstractGlobalImageFeature::FeatureListType statMean, statStd;
-    for (std::size_t i = 0; i < allStats[0].size(); ++i)
-    {
-      auto cElement1 = allStats[0][i];
-      cElement1.first.legacyName = "SliceWise Mean " + cElement1.first.legacyName;
-      cElement1.second = 0.0;
-      auto cElement2 = allStats[0][i];
-      cElement2.first.legacyName = "SliceWise Var. " + cElement2.first.legacyName;
-      cElement2.second = 0.0;
-      statMean.push_back(cElement1);
-      statStd.push_back(cElement2);
-    }
+    mitk::Image::Pointer maskNoNaN = mitk::Image::New();
+    AccessByItk_2(image, CreateNoNaNMask,  mask, maskNoNaN);
+    //CreateNoNaNMask(mask, image, maskNoNaN);
 
-    for (auto cStat : allStats)
+    std::vector<mitk::cl::GlobalImageFeaturesInput> analysisImages;
+    const bool processSliceWise = sliceWise && image->GetDimension() > 2;
+    if (processSliceWise)
     {
-      for (std::size_t i = 0; i < cStat.size(); ++i)
+      MITK_INFO << "Enabled slice-wise";
+      MITK_INFO << sliceDirection;
+      std::vector<mitk::Image::Pointer> floatVector;
+      std::vector<mitk::Image::Pointer> maskVector;
+      std::vector<mitk::Image::Pointer> maskNoNaNVector;
+      std::vector<mitk::Image::Pointer> morphMaskVector;
+      ExtractSlicesFromImages(image, mask, maskNoNaN, morphMask, sliceDirection, floatVector, maskVector, maskNoNaNVector, morphMaskVector);
+      for (std::size_t i = 0; i < floatVector.size(); ++i)
       {
-        statMean[i].second += cStat[i].second / (1.0*allStats.size());
+        analysisImages.push_back({ floatVector[i], maskVector[i], maskNoNaNVector[i], morphMaskVector[i] });
       }
+      MITK_INFO << "Slice";
+    }
+    else
+    {
+      analysisImages.push_back({ image, mask, maskNoNaN, morphMask });
     }
 
-    for (auto cStat : allStats)
+    for (std::size_t currentSlice = 0; currentSlice < analysisImages.size(); ++currentSlice)
     {
-      for (std::size_t i = 0; i < cStat.size(); ++i)
+      if (param.writePNGScreenshots)
       {
-        statStd[i].second += (cStat[i].second - statMean[i].second)*(cStat[i].second - statMean[i].second) / (1.0*allStats.size());
+        SaveSliceOrImageAsPNG(analysisImages[currentSlice].image, analysisImages[currentSlice].mask, param.pngScreenshotsPath, static_cast<int>(currentSlice));
+      }
+      if (param.writeAnalysisImage)
+      {
+        mitk::IOUtil::Save(analysisImages[currentSlice].image, param.anaylsisImagePath);
+      }
+      if (param.writeAnalysisMask)
+      {
+        mitk::IOUtil::Save(analysisImages[currentSlice].mask, param.analysisMaskPath);
       }
     }
 
-    for (std::size_t i = 0; i < statMean.size(); ++i)
+    // images and slices are calculated concurrently, so the ITK filters inside of the feature classes share the cores
+    const auto numberOfWorkers = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, analysisImages.size())));
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(std::max(1u, mitk::GetParallelForNumberOfThreads() / numberOfWorkers));
+
+    log << " Begin Processing -";
+    auto logCalculation = [&log](const mitk::AbstractGlobalImageFeature *cFeature)
+    {
+      log << " Calculating " << cFeature->GetFeatureClassName() << " -";
+    };
+    std::vector<FeatureListType> allStats = mitk::cl::CalculateGlobalImageFeatures(analysisImages, features, createFeatureClasses, numberOfThreads, !param.calculateAllFeatures, logCalculation);
+
+    int currentSlice = 0;
+    for (auto &stats : allStats)
     {
-      std::cout << statMean[i].first.legacyName << " - " << statMean[i].second << std::endl;
-      std::cout << statStd[i].first.legacyName << " - " << statStd[i].second << std::endl;
+      for (std::size_t i = 0; i < stats.size(); ++i)
+      {
+        std::cout << stats[i].first.legacyName << " - " << stats[i].second << std::endl;
+      }
+
+      writer.AddHeader(description, currentSlice, stats, param.useHeader, addDescription);
+      if (true)
+      {
+        writer.AddSubjectInformation(MITK_REVISION);
+        writer.AddSubjectInformation(param.imageFolder);
+        writer.AddSubjectInformation(param.imageName);
+        writer.AddSubjectInformation(param.maskName);
+      }
+      writer.AddResult(description, currentSlice, stats, param.useHeader, addDescription);
+      ++currentSlice;
     }
-    if (true)
+
+    log << " Process Slicewise -";
+    if (processSliceWise && !allStats.empty())
     {
-      writer.AddSubjectInformation(MITK_REVISION);
-      writer.AddSubjectInformation(param.imageFolder);
-      writer.AddSubjectInformation(param.imageName);
-      writer.AddSubjectInformation(param.maskName + " - Mean");
+      FeatureListType statMean, statStd;
+      for (std::size_t i = 0; i < allStats[0].size(); ++i)
+      {
+        auto cElement1 = allStats[0][i];
+        cElement1.first.legacyName = "SliceWise Mean " + cElement1.first.legacyName;
+        cElement1.second = 0.0;
+        auto cElement2 = allStats[0][i];
+        cElement2.first.legacyName = "SliceWise Var. " + cElement2.first.legacyName;
+        cElement2.second = 0.0;
+        statMean.push_back(cElement1);
+        statStd.push_back(cElement2);
+      }
+
+      for (auto cStat : allStats)
+      {
+        for (std::size_t i = 0; i < cStat.size(); ++i)
+        {
+          statMean[i].second += cStat[i].second / (1.0*allStats.size());
+        }
+      }
+
+      for (auto cStat : allStats)
+      {
+        for (std::size_t i = 0; i < cStat.size(); ++i)
+        {
+          statStd[i].second += (cStat[i].second - statMean[i].second)*(cStat[i].second - statMean[i].second) / (1.0*allStats.size());
+        }
+      }
+
+      for (std::size_t i = 0; i < statMean.size(); ++i)
+      {
+        std::cout << statMean[i].first.legacyName << " - " << statMean[i].second << std::endl;
+        std::cout << statStd[i].first.legacyName << " - " << statStd[i].second << std::endl;
+      }
+      if (true)
+      {
+        writer.AddSubjectInformation(MITK_REVISION);
+        writer.AddSubjectInformation(param.imageFolder);
+        writer.AddSubjectInformation(param.imageName);
+        writer.AddSubjectInformation(param.maskName + " - Mean");
+      }
+      writer.AddResult(description, currentSlice, statMean, param.useHeader, addDescription);
+      if (true)
+      {
+        writer.AddSubjectInformation(MITK_REVISION);
+        writer.AddSubjectInformation(param.imageFolder);
+        writer.AddSubjectInformation(param.imageName);
+        writer.AddSubjectInformation(param.maskName + " - Var.");
+      }
+      writer.AddResult(description, currentSlice, statStd, param.useHeader, addDescription);
     }
-    writer.AddResult(description, currentSlice, statMean, param.useHeader, addDescription);
-    if (true)
+
+    if (!param.outputXMLPath.empty())
     {
-      writer.AddSubjectInformation(MITK_REVISION);
-      writer.AddSubjectInformation(param.imageFolder);
-      writer.AddSubjectInformation(param.imageName);
-      writer.AddSubjectInformation(param.maskName + " - Var.");
+      if (processSliceWise)
+      {
+        MITK_ERROR << "Xml output is not supported in slicewise mode";
+        return EXIT_FAILURE;
+      }
+      else
+      {
+        mitk::cl::CLResultXMLWriter xmlWriter;
+        xmlWriter.SetCLIArgs(parsedArgs);
+        xmlWriter.SetFeatures(allStats.front());
+        xmlWriter.SetImage(loadedImage);
+        xmlWriter.SetMask(loadedMask);
+        xmlWriter.SetMethodName("CLGlobalImageFeatures");
+        xmlWriter.SetMethodVersion(version + "(mitk: " MITK_VERSION_STRING+")");
+        xmlWriter.SetOrganisation("German Cancer Research Center (DKFZ)");
+        xmlWriter.SetPipelineUID(param.pipelineUID);
+        xmlWriter.write(param.outputXMLPath);
+      }
     }
-    writer.AddResult(description, currentSlice, statStd, param.useHeader, addDescription);
-  }
+    return EXIT_SUCCESS;
+  };
 
   int returnCode = EXIT_SUCCESS;
 
-  if (!param.outputXMLPath.empty())
+  if (cohortMode)
   {
-    if (sliceWise)
-    {
-      MITK_ERROR << "Xml output is not supported in slicewise mode";
-      returnCode = EXIT_FAILURE;
-    }
-    else
+    // configuration and feature classes are reused, only the images are loaded per case
+    const std::string globalMorphPath = param.useMorphMask ? param.morphPath : std::string();
+    for (std::size_t i = 0; i < cases.size(); ++i)
     {
-      mitk::cl::CLResultXMLWriter xmlWriter;
-      xmlWriter.SetCLIArgs(parsedArgs);
-      xmlWriter.SetFeatures(allStats.front());
-      xmlWriter.SetImage(loadedImage);
-      xmlWriter.SetMask(loadedMask);
-      xmlWriter.SetMethodName("CLGlobalImageFeatures");
-      xmlWriter.SetMethodVersion(version + "(mitk: " MITK_VERSION_STRING+")");
-      xmlWriter.SetOrganisation("German Cancer Research Center (DKFZ)");
-      xmlWriter.SetPipelineUID(param.pipelineUID);
-      xmlWriter.write(param.outputXMLPath);
+      param.SetInput(cases[i][0], cases[i][1], cases[i].size() > 2 ? cases[i][2] : globalMorphPath);
+      MITK_INFO << "Case " << i + 1 << " of " << cases.size() << ": " << param.imagePath;
+      try
+      {
+        if (processCase() != EXIT_SUCCESS)
+        {
+          MITK_ERROR << "Failed to process " << param.imagePath << " with " << param.maskPath;
+          returnCode = EXIT_FAILURE;
+        }
+      }
+      catch (const std::exception &e)
+      {
+        MITK_ERROR << "Failed to process " << param.imagePath << " with " << param.maskPath << ": " << e.what();
+        returnCode = EXIT_FAILURE;
+      }
     }
   }
+  else
+  {
+    returnCode = processCase();
+  }
 
   if (param.useLogfile)
   {
@@ -26,6 +26,7 @@ found in the LICENSE file.
 #include "itkNearestNeighborInterpolateImageFunction.h"
 #include "itkIdentityTransform.h"
 #include "itkResampleImageFilter.h"
+#include <itkSeparableResampleImageFilter.h>
 
 
 template<typename TPixel, unsigned int VImageDimension>
@@ -50,24 +51,42 @@ ResampleImageToReferenceFunction(itk::Image<TPixel, VImageDimension>* itkReferen
 
   typename InputImageType::Pointer itkMoving = InputImageType::New();
   mitk::CastToItkImage(moving,itkMoving);
-  typedef itk::ResampleImageFilter<InputImageType, InputImageType>  ResampleFilterType;
 
-  typename ResampleFilterType::Pointer resampler = ResampleFilterType::New();
-  resampler->SetInput(itkMoving);
-  resampler->SetReferenceImage( itkReference );
-  resampler->UseReferenceImageOn();
-  resampler->SetTransform(_pTransform);
-  //if ( sincInterpol)
-  //  resampler->SetInterpolator(sinc_interpolator);
-  //else
-    resampler->SetInterpolator(lin_interpolator);
+  typename InputImageType::Pointer itkResult;
 
-  resampler->Update();
+  // Grids that only differ in spacing, origin and size are resampled axis by axis
+  typedef itk::SeparableResampleImageFilter<InputImageType, InputImageType>  SeparableResampleFilterType;
+  if (SeparableResampleFilterType::IsAxisAligned(itkMoving, itkReference))
+  {
+    typename SeparableResampleFilterType::Pointer separableResampler = SeparableResampleFilterType::New();
+    separableResampler->SetInput(itkMoving);
+    separableResampler->SetOutputParametersFromImage(itkReference);
+    separableResampler->SetInterpolator(SeparableResampleFilterType::Linear);
+    separableResampler->Update();
+    itkResult = separableResampler->GetOutput();
+  }
+  else
+  {
+    typedef itk::ResampleImageFilter<InputImageType, InputImageType>  ResampleFilterType;
+
+    typename ResampleFilterType::Pointer resampler = ResampleFilterType::New();
+    resampler->SetInput(itkMoving);
+    resampler->SetReferenceImage( itkReference );
+    resampler->UseReferenceImageOn();
+    resampler->SetTransform(_pTransform);
+    //if ( sincInterpol)
+    //  resampler->SetInterpolator(sinc_interpolator);
+    //else
+      resampler->SetInterpolator(lin_interpolator);
+
+    resampler->Update();
+    itkResult = resampler->GetOutput();
+  }
 
   // Convert back to mitk
   mitk::Image::Pointer result = mitk::Image::New();
-  result->InitializeByItk(resampler->GetOutput());
-  GrabItkImageMemory(resampler->GetOutput(), result);
+  result->InitializeByItk(itkResult.GetPointer());
+  GrabItkImageMemory(itkResult, result);
   MITK_INFO << "writing result to: " << ergPath;
   mitk::IOUtil::Save(result, ergPath);
   //return result;
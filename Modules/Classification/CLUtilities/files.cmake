@@ -29,6 +29,7 @@ set(CPP_FILES
   GlobalImageFeatures/mitkGIFNeighbourhoodGreyToneDifferenceFeatures.cpp
   GlobalImageFeatures/mitkGIFCurvatureStatistic.cpp
 
+  MiniAppUtils/mitkGlobalImageFeaturesCalculation.cpp
   MiniAppUtils/mitkGlobalImageFeaturesParameter.cpp
   MiniAppUtils/mitkSplitParameterToVector.cpp
 
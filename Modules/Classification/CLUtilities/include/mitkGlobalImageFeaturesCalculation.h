@@ -0,0 +1,60 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkGlobalImageFeaturesCalculation_h
+#define mitkGlobalImageFeaturesCalculation_h
+
+#include "MitkCLUtilitiesExports.h"
+#include <mitkAbstractGlobalImageFeature.h>
+
+#include <functional>
+#include <vector>
+
+namespace mitk
+{
+  namespace cl
+  {
+    /** Image, mask, mask without NaN voxels and morphological mask of one analysed image or slice */
+    struct GlobalImageFeaturesInput
+    {
+      Image::Pointer image;
+      Image::Pointer mask;
+      Image::Pointer maskNoNaN;
+      Image::Pointer morphMask;
+    };
+
+    typedef std::vector<AbstractGlobalImageFeature::Pointer> FeatureClassListType;
+
+    /**
+    * Calculates the features of all inputs with all feature classes and returns them per input, in the
+    * order of the feature classes.
+    *
+    * The inputs are distributed over at most numberOfThreads threads of mitk::ParallelFor(). Each thread
+    * calculates all feature classes of an input, so no image is used by two threads at the same time.
+    * Inputs that are calculated at the same time use different instances of the feature classes: features
+    * and up to numberOfThreads - 1 sets created by createFeatureClasses. The results do not depend on the
+    * number of threads.
+    *
+    * calculationStarted, if given, is called before a feature class is calculated for an input. The calls
+    * are serialized. The first exception thrown by a feature class is rethrown after all threads finished.
+    */
+    std::vector<AbstractGlobalImageFeature::FeatureListType> MITKCLUTILITIES_EXPORT CalculateGlobalImageFeatures(
+      const std::vector<GlobalImageFeaturesInput> &inputs,
+      const FeatureClassListType &features,
+      const std::function<FeatureClassListType()> &createFeatureClasses,
+      unsigned int numberOfThreads,
+      bool checkParameterActivation,
+      const std::function<void(const AbstractGlobalImageFeature *)> &calculationStarted = nullptr);
+  }
+}
+
+#endif //mitkGlobalImageFeaturesCalculation_h
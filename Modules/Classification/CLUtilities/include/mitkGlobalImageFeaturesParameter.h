@@ -25,9 +25,14 @@ namespace mitk
     class MITKCLUTILITIES_EXPORT GlobalImageFeaturesParameter
     {
     public:
-      void AddParameter(mitkCommandLineParser &parser);
+      /** Adds the common arguments. If inputRequired is false, image and mask are optional and the
+       *  app has to provide them through SetInput(). */
+      void AddParameter(mitkCommandLineParser &parser, bool inputRequired = true);
       void ParseParameter(std::map<std::string, us::Any> parsedArgs);
 
+      /** Sets image, mask and (if not empty) morphological mask of the analysed case. */
+      void SetInput(const std::string &image, const std::string &mask, const std::string &morphMask = "");
+
       std::string imagePath;
       std::string imageName;
       std::string imageFolder;
@@ -0,0 +1,82 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkGlobalImageFeaturesCalculation.h>
+
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <mutex>
+
+std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> mitk::cl::CalculateGlobalImageFeatures(
+  const std::vector<GlobalImageFeaturesInput> &inputs,
+  const FeatureClassListType &features,
+  const std::function<FeatureClassListType()> &createFeatureClasses,
+  unsigned int numberOfThreads,
+  bool checkParameterActivation,
+  const std::function<void(const AbstractGlobalImageFeature *)> &calculationStarted)
+{
+  std::vector<AbstractGlobalImageFeature::FeatureListType> results(inputs.size());
+
+  const auto threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, inputs.size())));
+
+  // one set of feature classes per thread; an input takes a free set and returns it when it is done
+  std::vector<FeatureClassListType> featureSets;
+  featureSets.push_back(features);
+  while (featureSets.size() < threads)
+  {
+    featureSets.push_back(createFeatureClasses());
+  }
+
+  std::mutex mutex;
+  std::vector<std::size_t> freeFeatureSets;
+  for (std::size_t i = featureSets.size(); i > 0; --i)
+  {
+    freeFeatureSets.push_back(i - 1);
+  }
+
+  mitk::ParallelFor(inputs.size(), [&](std::size_t i)
+  {
+    std::size_t featureSet;
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      featureSet = freeFeatureSets.back();
+      freeFeatureSets.pop_back();
+    }
+
+    const GlobalImageFeaturesInput &input = inputs[i];
+    try
+    {
+      for (auto cFeature : featureSets[featureSet])
+      {
+        if (calculationStarted)
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          calculationStarted(cFeature);
+        }
+        cFeature->SetMorphMask(input.morphMask);
+        cFeature->CalculateAndAppendFeatures(input.image, input.mask, input.maskNoNaN, results[i], checkParameterActivation);
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      freeFeatureSets.push_back(featureSet);
+      throw;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    freeFeatureSets.push_back(featureSet);
+  }, threads);
+
+  return results;
+}
@@ -27,11 +27,11 @@ static bool fileExists(const std::string& filename)
 }
 
 
-void mitk::cl::GlobalImageFeaturesParameter::AddParameter(mitkCommandLineParser &parser)
+void mitk::cl::GlobalImageFeaturesParameter::AddParameter(mitkCommandLineParser &parser, bool inputRequired)
 {
   // Required Parameter
-  parser.addArgument("image",   "i", mitkCommandLineParser::Image, "Input Image", "Path to the input image file", us::Any(), false, false, false, mitkCommandLineParser::Input);
-  parser.addArgument("mask", "m", mitkCommandLineParser::Image, "Input Mask", "Path to the mask Image that specifies the area over for the statistic (Values = 1)", us::Any(), false, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("image",   "i", mitkCommandLineParser::Image, "Input Image", "Path to the input image file", us::Any(), !inputRequired, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("mask", "m", mitkCommandLineParser::Image, "Input Mask", "Path to the mask Image that specifies the area over for the statistic (Values = 1)", us::Any(), !inputRequired, false, false, mitkCommandLineParser::Input);
   parser.addArgument("morph-mask", "morph", mitkCommandLineParser::Image, "Morphological Image Mask", "Path to the mask Image that specifies the area over for the statistic (Values = 1)", us::Any(), true, false, false, mitkCommandLineParser::Input);
   parser.addArgument("output",  "o", mitkCommandLineParser::File, "Output text file", "Path to output file. The output statistic is appended to this file.", us::Any(), false, false, false, mitkCommandLineParser::Output);
 
@@ -75,22 +75,22 @@ void mitk::cl::GlobalImageFeaturesParameter::ParseFileLocations(std::map<std::st
   //
   // Read input and output file informations
   //
-  imagePath = parsedArgs["image"].ToString();
-  maskPath = parsedArgs["mask"].ToString();
   outputPath = parsedArgs["output"].ToString();
 
-  imageFolder = itksys::SystemTools::GetFilenamePath(imagePath);
-  imageName = itksys::SystemTools::GetFilenameName(imagePath);
-  maskFolder = itksys::SystemTools::GetFilenamePath(maskPath);
-  maskName = itksys::SystemTools::GetFilenameName(maskPath);
-
-  useMorphMask = false;
+  std::string image, mask, morphMask;
+  if (parsedArgs.count("image"))
+  {
+    image = parsedArgs["image"].ToString();
+  }
+  if (parsedArgs.count("mask"))
+  {
+    mask = parsedArgs["mask"].ToString();
+  }
   if (parsedArgs.count("morph-mask"))
   {
-    useMorphMask = true;
-    morphPath = parsedArgs["morph-mask"].ToString();
-    morphName = itksys::SystemTools::GetFilenameName(morphPath);
+    morphMask = parsedArgs["morph-mask"].ToString();
   }
+  SetInput(image, mask, morphMask);
 
   outputXMLPath = "";
   if (parsedArgs.count("xml-output"))
@@ -99,6 +99,21 @@ void mitk::cl::GlobalImageFeaturesParameter::ParseFileLocations(std::map<std::st
   }
 }
 
+void mitk::cl::GlobalImageFeaturesParameter::SetInput(const std::string &image, const std::string &mask, const std::string &morphMask)
+{
+  imagePath = image;
+  maskPath = mask;
+
+  imageFolder = itksys::SystemTools::GetFilenamePath(imagePath);
+  imageName = itksys::SystemTools::GetFilenameName(imagePath);
+  maskFolder = itksys::SystemTools::GetFilenamePath(maskPath);
+  maskName = itksys::SystemTools::GetFilenameName(maskPath);
+
+  useMorphMask = !morphMask.empty();
+  morphPath = morphMask;
+  morphName = itksys::SystemTools::GetFilenameName(morphPath);
+}
+
 void mitk::cl::GlobalImageFeaturesParameter::ParseAdditionalOutputs(std::map<std::string, us::Any> &parsedArgs)
 {
 
@@ -0,0 +1,148 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+#include <cmath>
+
+#include <mitkGlobalImageFeaturesCalculation.h>
+#include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkGIFFirstOrderStatistics.h>
+#include <mitkGIFVolumetricStatistics.h>
+
+#include <stdexcept>
+
+class mitkGlobalImageFeaturesCalculationTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGlobalImageFeaturesCalculationTestSuite);
+
+  MITK_TEST(CalculateGlobalImageFeatures_SequentialAndConcurrentResultsEqual);
+  MITK_TEST(CalculateGlobalImageFeatures_ExceptionIsRethrown);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Small;
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Small;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+  static mitk::cl::FeatureClassListType CreateFeatureClasses()
+  {
+    mitk::cl::FeatureClassListType features;
+    features.push_back(mitk::GIFVolumetricStatistics::New().GetPointer());
+    features.push_back(mitk::GIFFirstOrderStatistics::New().GetPointer());
+    features.push_back(mitk::GIFCooccurenceMatrix2::New().GetPointer());
+    for (auto cFeature : features)
+    {
+      cFeature->SetUseBinsize(true);
+      cFeature->SetBinsize(1.0);
+      cFeature->SetUseMinimumIntensity(true);
+      cFeature->SetUseMaximumIntensity(true);
+      cFeature->SetMinimumIntensity(0.5);
+      cFeature->SetMaximumIntensity(6.5);
+    }
+    return features;
+  }
+
+  std::vector<mitk::cl::GlobalImageFeaturesInput> CreateInputs()
+  {
+    // mask and morphological mask are the same image, as in CLGlobalImageFeatures without --morph-mask
+    std::vector<mitk::cl::GlobalImageFeaturesInput> inputs;
+    for (int i = 0; i < 3; ++i)
+    {
+      inputs.push_back({ m_IBSI_Phantom_Image_Large->Clone(), m_IBSI_Phantom_Mask_Large->Clone(), m_IBSI_Phantom_Mask_Large->Clone(), nullptr });
+      inputs.back().morphMask = inputs.back().mask;
+      inputs.push_back({ m_IBSI_Phantom_Image_Small->Clone(), m_IBSI_Phantom_Mask_Small->Clone(), m_IBSI_Phantom_Mask_Small->Clone(), nullptr });
+      inputs.back().morphMask = inputs.back().mask;
+    }
+    return inputs;
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Small = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Small.nrrd"));
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Small = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Small.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void tearDown(void) override
+  {
+    m_IBSI_Phantom_Image_Small = nullptr;
+    m_IBSI_Phantom_Image_Large = nullptr;
+    m_IBSI_Phantom_Mask_Small = nullptr;
+    m_IBSI_Phantom_Mask_Large = nullptr;
+  }
+
+  void CalculateGlobalImageFeatures_SequentialAndConcurrentResultsEqual()
+  {
+    auto inputs = CreateInputs();
+
+    unsigned int numberOfCalculations = 0;
+    auto countCalculations = [&numberOfCalculations](const mitk::AbstractGlobalImageFeature *) { ++numberOfCalculations; };
+
+    auto sequential = mitk::cl::CalculateGlobalImageFeatures(inputs, CreateFeatureClasses(), CreateFeatureClasses, 1, false, countCalculations);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), sequential.size());
+    CPPUNIT_ASSERT_EQUAL(18u, numberOfCalculations);
+
+    numberOfCalculations = 0;
+    auto concurrent = mitk::cl::CalculateGlobalImageFeatures(inputs, CreateFeatureClasses(), CreateFeatureClasses, 4, false, countCalculations);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), concurrent.size());
+    CPPUNIT_ASSERT_EQUAL(18u, numberOfCalculations);
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+      CPPUNIT_ASSERT(!sequential[i].empty());
+      CPPUNIT_ASSERT_EQUAL(sequential[i].size(), concurrent[i].size());
+      for (std::size_t j = 0; j < sequential[i].size(); ++j)
+      {
+        CPPUNIT_ASSERT_EQUAL(sequential[i][j].first.name, concurrent[i][j].first.name);
+        if (std::isnan(sequential[i][j].second))
+        {
+          CPPUNIT_ASSERT(std::isnan(concurrent[i][j].second));
+        }
+        else
+        {
+          CPPUNIT_ASSERT_EQUAL_MESSAGE(sequential[i][j].first.name, sequential[i][j].second, concurrent[i][j].second);
+        }
+      }
+    }
+
+    // inputs of the same phantom get the same features, independent of the thread that calculated them
+    for (std::size_t i = 2; i < inputs.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(concurrent[i % 2].size(), concurrent[i].size());
+      for (std::size_t j = 0; j < concurrent[i].size(); ++j)
+      {
+        if (!std::isnan(concurrent[i][j].second))
+        {
+          CPPUNIT_ASSERT_EQUAL(concurrent[i % 2][j].second, concurrent[i][j].second);
+        }
+      }
+    }
+  }
+
+  void CalculateGlobalImageFeatures_ExceptionIsRethrown()
+  {
+    auto inputs = CreateInputs();
+    auto throwOnCalculation = [](const mitk::AbstractGlobalImageFeature *) { throw std::runtime_error("calculation failed"); };
+
+    CPPUNIT_ASSERT_THROW(mitk::cl::CalculateGlobalImageFeatures(inputs, CreateFeatureClasses(), CreateFeatureClasses, 4, false, throwOnCalculation),
+                         std::runtime_error);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGlobalImageFeaturesCalculation)
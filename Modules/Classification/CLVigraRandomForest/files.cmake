@@ -11,6 +11,7 @@ set(CPP_FILES
     Algorithm/itkStructureTensorEigenvalueImageFilter.cpp
 
     Splitter/mitkAdditionalRFData.cpp
+    Splitter/mitkFeatureBins.cpp
     Splitter/mitkImpurityLoss.cpp
     Splitter/mitkPUImpurityLoss.cpp
     Splitter/mitkLinearSplitting.cpp
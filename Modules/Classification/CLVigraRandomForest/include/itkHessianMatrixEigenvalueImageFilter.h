@@ -14,16 +14,31 @@ found in the LICENSE file.
 #define ITKHESSIANMATRIXEIGENVALUEIMAGEFILTER_H
 
 #include <itkImageToImageFilter.h>
+#include <itkMultiThreader.h>
+
+#include <vector>
 
 namespace itk
 {
+  /**
+  * \brief Eigenvalues of the slice wise 2D Hessian matrix of the masked input
+  *
+  * The filter only works on the bounding box of the mask, padded by the kernel radius. Inside of the
+  * bounding box the eigenvalues are the same as for the whole masked slice, voxels outside of it are
+  * set to zero. Without a mask the whole image is processed. Slices are distributed over the threads.
+  *
+  * Several sigmas can be computed in one update. Each sigma adds three outputs (the eigenvalue
+  * representation of vigra::tensorEigenRepresentation), output 3 * i + j belongs to the i-th sigma.
+  * The sigmas share the bounding box and the masked copy of each slice, the Hessian itself is computed
+  * directly for every sigma, so the outputs are the same as for separate updates.
+  */
   template< class TInputImageType, class TOutputImageType = TInputImageType, class TMaskImageType = itk::Image<short,3> >
   class HessianMatrixEigenvalueImageFilter
     : public itk::ImageToImageFilter<TInputImageType, TOutputImageType>
   {
   public:
 
-    typedef HessianMatrixEigenvalueImageFilter< TInputImageType, TOutputImageType > Self;
+    typedef HessianMatrixEigenvalueImageFilter< TInputImageType, TOutputImageType, TMaskImageType > Self;
     typedef SmartPointer<Self>                      Pointer;
     typedef SmartPointer<const Self>                ConstPointer;
     typedef ImageToImageFilter<  TInputImageType, TOutputImageType  > Superclass;
@@ -33,18 +48,33 @@ namespace itk
 
     void SetImageMask(TMaskImageType * maskimage);
 
-    itkSetMacro(Sigma,double);
+    /** Computes a single sigma, same as SetSigmas() with one element */
+    void SetSigma(double sigma);
+
+    /** First of the sigmas */
+    double GetSigma();
+
+    void SetSigmas(const std::vector<double> &sigmas);
 
-    itkGetMacro(Sigma,double);
+    itkGetConstReferenceMacro(Sigmas, std::vector<double>);
 
   private:
 
+    typedef typename TInputImageType::RegionType RegionType;
+
     typename TMaskImageType::Pointer m_ImageMask;
-    double m_Sigma;
+    std::vector<double> m_Sigmas;
+
+    /** Slices of the mask bounding box that are processed and the padded xy region read around them */
+    RegionType m_BoundingBox;
+    RegionType m_PaddedBoundingBox;
 
     void GenerateData() override;
     void GenerateOutputInformation() override;
 
+    static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+    void ProcessSlices(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
     HessianMatrixEigenvalueImageFilter();
     ~HessianMatrixEigenvalueImageFilter() override;
   };
@@ -14,9 +14,25 @@ found in the LICENSE file.
 #define ITKSTRUCTURETENSOREIGENVALUEIMAGEFILTER_H
 
 #include <itkImageToImageFilter.h>
+#include <itkMultiThreader.h>
+
+#include <vector>
 
 namespace itk
 {
+  /**
+  * \brief Eigenvalues of the slice wise 2D structure tensor of the input
+  *
+  * The input is not masked, but the filter only works on the bounding box of the mask, padded by the
+  * kernel radius. Inside of the bounding box the eigenvalues are the same as for the whole slice,
+  * voxels outside of it are set to zero. Without a mask the whole image is processed. Slices are
+  * distributed over the threads.
+  *
+  * Several outer scales can be computed in one update. Each outer scale adds three outputs (the
+  * eigenvalue representation of vigra::tensorEigenRepresentation), output 3 * i + j belongs to the
+  * i-th outer scale. The gradient at the inner scale and its products are computed once per slice and
+  * smoothed with every outer scale, as vigra::structureTensor does for a single one.
+  */
   template< class TInputImageType,
   class TOutputImageType = TInputImageType,
   class TMaskImageType = itk::Image<short,3> >
@@ -25,7 +41,7 @@ namespace itk
   {
   public:
 
-    typedef StructureTensorEigenvalueImageFilter< TInputImageType, TOutputImageType > Self;
+    typedef StructureTensorEigenvalueImageFilter< TInputImageType, TOutputImageType, TMaskImageType > Self;
     typedef SmartPointer<Self>                      Pointer;
     typedef SmartPointer<const Self>                ConstPointer;
     typedef ImageToImageFilter<  TInputImageType, TOutputImageType  > Superclass;
@@ -39,18 +55,34 @@ namespace itk
 
     itkGetMacro(InnerScale,double);
 
-    itkSetMacro(OuterScale,double);
+    /** Computes a single outer scale, same as SetOuterScales() with one element */
+    void SetOuterScale(double outerScale);
+
+    /** First of the outer scales */
+    double GetOuterScale();
+
+    void SetOuterScales(const std::vector<double> &outerScales);
 
-    itkGetMacro(OuterScale,double);
+    itkGetConstReferenceMacro(OuterScales, std::vector<double>);
 
   private:
 
+    typedef typename TInputImageType::RegionType RegionType;
+
     typename TMaskImageType::Pointer m_ImageMask;
-    double m_InnerScale, m_OuterScale;
+    double m_InnerScale;
+    std::vector<double> m_OuterScales;
+
+    /** Slices of the mask bounding box that are processed and the padded xy region read around them */
+    RegionType m_BoundingBox;
+    RegionType m_PaddedBoundingBox;
 
     void GenerateData() override;
     void GenerateOutputInformation() override;
 
+    static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+    void ProcessSlices(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
     StructureTensorEigenvalueImageFilter();
     ~StructureTensorEigenvalueImageFilter() override;
   };
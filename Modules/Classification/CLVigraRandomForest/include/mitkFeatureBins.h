@@ -0,0 +1,73 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkFeatureBins_h
+#define mitkFeatureBins_h
+
+#include <MitkCLVigraRandomForestExports.h>
+
+#include <vigra/multi_array.hxx>
+
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Quantized copy of a feature matrix for histogram based split search.
+  *
+  * Every feature column is sorted once and mapped to at most 256 bins. The bin
+  * boundaries lie between distinct feature values and are chosen such that every
+  * bin holds roughly the same number of samples. If a column has no more distinct
+  * values than bins, every value gets a bin of its own.
+  *
+  * Samples in the bins 0 to b have feature values below GetThresholds(feature)[b],
+  * so a split between two bins is a split with that threshold.
+  */
+  class MITKCLVIGRARANDOMFOREST_EXPORT FeatureBins
+  {
+  public:
+    typedef unsigned char BinType;
+
+    static const unsigned int MaximumNumberOfBins = 256;
+
+    FeatureBins(vigra::MultiArrayView<2, double> const &features, unsigned int numberOfBins = MaximumNumberOfBins);
+
+    std::ptrdiff_t GetNumberOfSamples() const { return m_NumberOfSamples; }
+    std::ptrdiff_t GetNumberOfFeatures() const { return m_NumberOfFeatures; }
+
+    /** Number of bins used for the given feature, at least 1. */
+    unsigned int GetNumberOfBins(std::ptrdiff_t feature) const
+    {
+      return static_cast<unsigned int>(m_Thresholds[feature].size()) + 1;
+    }
+
+    /** Bin index of every sample for the given feature. */
+    const BinType *GetBins(std::ptrdiff_t feature) const
+    {
+      return m_Bins.data() + feature * m_NumberOfSamples;
+    }
+
+    /** Thresholds between the bins of the given feature, GetNumberOfBins(feature) - 1 values. */
+    const std::vector<double> &GetThresholds(std::ptrdiff_t feature) const
+    {
+      return m_Thresholds[feature];
+    }
+
+  private:
+    std::ptrdiff_t m_NumberOfSamples;
+    std::ptrdiff_t m_NumberOfFeatures;
+    std::vector<BinType> m_Bins;
+    std::vector<std::vector<double>> m_Thresholds;
+  };
+}
+
+#endif //mitkFeatureBins_h
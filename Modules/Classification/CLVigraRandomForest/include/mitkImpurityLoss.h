@@ -39,6 +39,13 @@ namespace mitk
         template <class TDataIterator>
         double Decrement(TDataIterator begin, TDataIterator end);
 
+        // Add or remove the class counts of a whole group of samples, e.g. a histogram bin
+        template <class TCountIterator>
+        double IncrementCounts(TCountIterator counts);
+
+        template <class TCountIterator>
+        double DecrementCounts(TCountIterator counts);
+
         template <class TArray>
         double Init(TArray initCounts);
 
@@ -56,6 +56,18 @@ namespace mitk
                       TDataIterator &end,
                       TArray const &regionResponse);
 
+      /** Line search over a class histogram instead of sorted samples.
+          @p histogram holds @p binSizes.size() bins of class counts, one after another,
+          @p thresholds the feature values between neighbouring bins.
+          The minimum index is the first bin of the right child. */
+      template <class TDataSourceLabel,
+                class TArray>
+      void SearchHistogram(TDataSourceLabel const &labels,
+                           std::vector<double> const &histogram,
+                           std::vector<std::size_t> const &binSizes,
+                           std::vector<double> const &thresholds,
+                           TArray const &regionResponse);
+
       template <class TDataSourceLabel,
                 class TDataIterator,
                 class TArray>
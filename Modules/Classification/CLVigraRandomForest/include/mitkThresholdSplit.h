@@ -16,6 +16,9 @@ found in the LICENSE file.
 #include <vigra/multi_array.hxx>
 #include <vigra/random_forest.hxx>
 #include <mitkAdditionalRFData.h>
+#include <mitkFeatureBins.h>
+
+#include <memory>
 
 namespace mitk
 {
@@ -50,6 +53,15 @@ namespace mitk
         void SetWeights(vigra::MultiArrayView<2, double> weights);
         vigra::MultiArrayView<2, double> GetWeights() const;
 
+        // Quantized features of the training data. If set, splits are searched on
+        // per-node class histograms of these bins instead of sorting the samples.
+        void SetFeatureBins(std::shared_ptr<const FeatureBins> bins);
+        std::shared_ptr<const FeatureBins> GetFeatureBins() const;
+
+        // Number of threads used to evaluate the features of a node in parallel (histogram search only)
+        void SetNumberOfThreads(unsigned int numberOfThreads);
+        unsigned int GetNumberOfThreads() const;
+
         // From vigra::ThresholdSplit
         double minGini() const;
         int bestSplitColumn() const;
@@ -72,6 +84,11 @@ namespace mitk
         // From vigra::ThresholdSplit
         typedef vigra::SplitBase<TTag> SB;
 
+        template<class T2, class C2, class Region>
+        double findBestHistogramSplit(vigra::MultiArrayView<2, T2, C2> labels,
+                                      Region & region,
+                                      vigra::ArrayVector<Region>& childRegions);
+
        // splitter parameters (used by copy constructor)
         bool m_CalculatingFeature;
         bool m_UseWeights;
@@ -80,6 +97,8 @@ namespace mitk
         int m_MaximumTreeDepth;
         TFeatureCalculator m_FeatureCalculator;
         vigra::MultiArrayView<2, double> m_Weights;
+        std::shared_ptr<const FeatureBins> m_FeatureBins;
+        unsigned int m_NumberOfThreads;
 
         // variabels to work with
         vigra::ArrayVector<vigra::Int32> splitColumns;
@@ -56,6 +56,9 @@ namespace mitk
     void SetPrecision(double);
     void SetSamplesPerTree(double);
     void UseSampleWithReplacement(bool);
+    /** Search splits on class histograms of quantized features (at most 256 bins per feature)
+        instead of sorting the samples at every node. Much faster for large training sets. */
+    void UseHistogramSplit(bool);
     void SetTreeCount(int);
     void SetWeightLambda(double);
 
@@ -19,113 +19,182 @@ found in the LICENSE file.
 #include <vigra/convolution.hxx>
 #include <mitkCLUtil.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::GenerateOutputInformation()
 {
   Superclass::GenerateOutputInformation();
-  this->GetOutput(0)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(0)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(0)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(0)->Allocate();
-
-  this->GetOutput(1)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(1)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(1)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(1)->Allocate();
-
-  this->GetOutput(2)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(2)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(2)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(2)->Allocate();
+  for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+  {
+    this->GetOutput(i)->SetDirection(this->GetInput()->GetDirection());
+    this->GetOutput(i)->SetSpacing(this->GetInput()->GetSpacing());
+    this->GetOutput(i)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
+  }
 }
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::GenerateData()
 {
-
-  typedef typename TInputImageType::PixelType InputPixelType;
-
   typename TInputImageType::RegionType region = this->GetInput()->GetLargestPossibleRegion();
-  unsigned int xdim = region.GetSize(0);
-  unsigned int ydim = region.GetSize(1);
-  unsigned int zdim = region.GetSize(2);
+  const unsigned int xdim = region.GetSize(0);
+  const unsigned int ydim = region.GetSize(1);
+  const unsigned int zdim = region.GetSize(2);
 
-  typename TInputImageType::Pointer maske_input = TInputImageType::New();
-  maske_input->SetDirection(this->GetInput()->GetDirection());
-  maske_input->SetSpacing(this->GetInput()->GetSpacing());
-  maske_input->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  maske_input->Allocate();
-
-  itk::ImageRegionConstIterator<TInputImageType> iit(this->GetInput(), this->GetInput()->GetLargestPossibleRegion());
-  itk::ImageRegionIterator<TInputImageType> miit(maske_input, maske_input->GetLargestPossibleRegion());
-  itk::ImageRegionConstIterator<TMaskImageType> mit(m_ImageMask, m_ImageMask->GetLargestPossibleRegion());
-
-  while(!miit.IsAtEnd())
+  for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
   {
-    if(mit.Value()!=0)
-      miit.Set(iit.Value());
-    else
-      miit.Set(0);
-
-    ++miit;
-    ++mit;
-    ++iit;
+    this->GetOutput(i)->Allocate();
+    this->GetOutput(i)->FillBuffer(0);
   }
 
+  // Bounding box of the mask, everything outside of it stays zero
+  unsigned int lower[3] = { xdim, ydim, zdim };
+  unsigned int upper[3] = { 0, 0, 0 };
+  if (m_ImageMask.IsNotNull())
+  {
+    const typename TMaskImageType::PixelType *mask = m_ImageMask->GetBufferPointer();
+    for (unsigned int z = 0; z < zdim; ++z)
+      for (unsigned int y = 0; y < ydim; ++y)
+        for (unsigned int x = 0; x < xdim; ++x, ++mask)
+        {
+          if (*mask != 0)
+          {
+            lower[0] = std::min(lower[0], x); upper[0] = std::max(upper[0], x + 1);
+            lower[1] = std::min(lower[1], y); upper[1] = std::max(upper[1], y + 1);
+            lower[2] = std::min(lower[2], z); upper[2] = std::max(upper[2], z + 1);
+          }
+        }
+    if (upper[0] == 0)
+      return;
+  }
+  else
+  {
+    lower[0] = lower[1] = lower[2] = 0;
+    upper[0] = xdim; upper[1] = ydim; upper[2] = zdim;
+  }
 
-  vigra::Shape3 shape(xdim,ydim,zdim);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > input_image_view(
-        shape ,
-        maske_input->GetBufferPointer());
-
-
-  vigra::MultiArray<3, vigra::TinyVector<InputPixelType, 3> > hessian_image(shape);
-  vigra::MultiArray<3, vigra::TinyVector<InputPixelType, 3> > eigenvalues_image(shape);
+  // Reach of the second derivative of Gaussian kernel of the largest sigma
+  const double maxSigma = *std::max_element(m_Sigmas.begin(), m_Sigmas.end());
+  const unsigned int margin = static_cast<unsigned int>(std::ceil(3.0 * maxSigma + 2.0));
 
-  for(unsigned int i = 0 ; i < zdim; ++i )
+  for (unsigned int i = 0; i < 3; ++i)
   {
-    vigra::Shape2 slice_shape(xdim,ydim);
-    vigra::MultiArrayView<2, InputPixelType, vigra::StridedArrayTag > image_slice(
-          slice_shape,
-          input_image_view.data()+ (i*xdim*ydim));
+    m_BoundingBox.SetIndex(i, lower[i]);
+    m_BoundingBox.SetSize(i, upper[i] - lower[i]);
+  }
+  // The Hessian is computed per slice, so only x and y need the margin
+  m_PaddedBoundingBox = m_BoundingBox;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    const unsigned int paddedLower = lower[i] > margin ? lower[i] - margin : 0;
+    const unsigned int paddedUpper = std::min(upper[i] + margin, static_cast<unsigned int>(region.GetSize(i)));
+    m_PaddedBoundingBox.SetIndex(i, paddedLower);
+    m_PaddedBoundingBox.SetSize(i, paddedUpper - paddedLower);
+  }
 
-    vigra::MultiArrayView<2, vigra::TinyVector<InputPixelType, 3> > hessian_slice(
-          slice_shape,
-          hessian_image.data() + (i*xdim*ydim));
+  this->GetMultiThreader()->SetNumberOfThreads(std::min<ThreadIdType>(this->GetNumberOfThreads(), m_BoundingBox.GetSize(2)));
+  this->GetMultiThreader()->SetSingleMethod(Self::ThreaderCallback, this);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
 
-    //    vigra::hessianMatrixOfGaussian(input_image_slice_view, hessian_image_slice_view, sigma);
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+ITK_THREAD_RETURN_TYPE itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::ThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  static_cast<Self *>(info->UserData)->ProcessSlices(info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
 
-    //    vigra::hessianMatrixOfGaussian(image_slice,hessian_slice,sigma);
-    vigra::hessianMatrixOfGaussian(image_slice,
-                                   hessian_slice.bindElementChannel(0),
-                                   hessian_slice.bindElementChannel(1),
-                                   hessian_slice.bindElementChannel(2),
-                                   m_Sigma);
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::ProcessSlices(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  typedef typename TInputImageType::PixelType InputPixelType;
+  typedef typename TOutputImageType::PixelType OutputPixelType;
 
-    vigra::MultiArrayView<2, vigra::TinyVector<InputPixelType, 3> > eigenvalues_image_slice_view(
-          slice_shape,
-          eigenvalues_image.data() + (i*xdim*ydim));
+  typename TInputImageType::RegionType region = this->GetInput()->GetLargestPossibleRegion();
+  const std::size_t xdim = region.GetSize(0);
+  const std::size_t ydim = region.GetSize(1);
 
-    vigra::tensorEigenRepresentation(hessian_slice, eigenvalues_image_slice_view);
-  }
+  const std::size_t x0 = m_PaddedBoundingBox.GetIndex(0);
+  const std::size_t y0 = m_PaddedBoundingBox.GetIndex(1);
+  const std::size_t width = m_PaddedBoundingBox.GetSize(0);
+  const std::size_t height = m_PaddedBoundingBox.GetSize(1);
 
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev1_image = eigenvalues_image.bindElementChannel(0);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev2_image = eigenvalues_image.bindElementChannel(1);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev3_image = eigenvalues_image.bindElementChannel(2);
+  const InputPixelType *input = this->GetInput()->GetBufferPointer();
+  const typename TMaskImageType::PixelType *mask = m_ImageMask.IsNotNull() ? m_ImageMask->GetBufferPointer() : nullptr;
 
+  vigra::Shape2 slice_shape(width, height);
+  vigra::MultiArray<2, InputPixelType> image_slice(slice_shape);
+  vigra::MultiArray<2, vigra::TinyVector<InputPixelType, 3> > hessian_slice(slice_shape);
+  vigra::MultiArray<2, vigra::TinyVector<InputPixelType, 3> > eigenvalues_slice(slice_shape);
 
-  for(unsigned int x = 0 ; x < xdim; ++x)
-    for(unsigned int y = 0 ; y < ydim; ++y)
-      for(unsigned int z = 0 ; z < zdim; ++z)
+  const std::size_t firstSlice = m_BoundingBox.GetIndex(2);
+  const std::size_t lastSlice = firstSlice + m_BoundingBox.GetSize(2);
+  for (std::size_t z = firstSlice + threadId; z < lastSlice; z += numberOfThreads)
+  {
+    for (std::size_t y = 0; y < height; ++y)
+    {
+      const std::size_t offset = (z * ydim + y0 + y) * xdim + x0;
+      for (std::size_t x = 0; x < width; ++x)
       {
-        itk::Index<3> indx = {{x,y,z}};
-        this->GetOutput(0)->operator [](indx) = ev1_image(x,y,z);
-        this->GetOutput(1)->operator [](indx) = ev2_image(x,y,z);
-        this->GetOutput(2)->operator [](indx) = ev3_image(x,y,z);
+        image_slice(x, y) = (mask == nullptr || mask[offset + x] != 0) ? input[offset + x] : 0;
       }
+    }
+
+    // The masked slice is shared, the Hessian is computed directly for every sigma
+    for (std::size_t i = 0; i < m_Sigmas.size(); ++i)
+    {
+      vigra::hessianMatrixOfGaussian(image_slice,
+                                     hessian_slice.bindElementChannel(0),
+                                     hessian_slice.bindElementChannel(1),
+                                     hessian_slice.bindElementChannel(2),
+                                     m_Sigmas[i]);
+      vigra::tensorEigenRepresentation(hessian_slice, eigenvalues_slice);
+
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        OutputPixelType *output = this->GetOutput(3 * i + c)->GetBufferPointer();
+        for (std::size_t y = m_BoundingBox.GetIndex(1); y < m_BoundingBox.GetIndex(1) + m_BoundingBox.GetSize(1); ++y)
+        {
+          OutputPixelType *row = output + (z * ydim + y) * xdim;
+          for (std::size_t x = m_BoundingBox.GetIndex(0); x < m_BoundingBox.GetIndex(0) + m_BoundingBox.GetSize(0); ++x)
+          {
+            row[x] = eigenvalues_slice(x - x0, y - y0)[c];
+          }
+        }
+      }
+    }
+  }
+}
 
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::SetSigma(double sigma)
+{
+  this->SetSigmas(std::vector<double>(1, sigma));
+}
+
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+double itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::GetSigma()
+{
+  return m_Sigmas.front();
+}
 
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::SetSigmas(const std::vector<double> &sigmas)
+{
+  if (sigmas.empty() || sigmas == m_Sigmas)
+    return;
+
+  m_Sigmas = sigmas;
+  this->SetNumberOfIndexedOutputs(3 * m_Sigmas.size());
+  for (unsigned int i = 0; i < 3 * m_Sigmas.size(); ++i)
+  {
+    if (this->GetOutput(i) == nullptr)
+      this->SetNthOutput(i, this->MakeOutput(i));
+  }
+  this->Modified();
 }
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
@@ -136,6 +205,7 @@ void itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TM
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 itk::HessianMatrixEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::HessianMatrixEigenvalueImageFilter()
+  : m_Sigmas(1, 1.0)
 {
   this->SetNumberOfIndexedOutputs(3);
   this->SetNumberOfIndexedInputs(1);
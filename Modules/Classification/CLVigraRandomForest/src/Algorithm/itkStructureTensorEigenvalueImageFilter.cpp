@@ -18,85 +18,195 @@ found in the LICENSE file.
 #include <vigra/tensorutilities.hxx>
 #include <vigra/convolution.hxx>
 
+#include <algorithm>
+#include <cmath>
+
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::GenerateOutputInformation()
 {
   Superclass::GenerateOutputInformation();
-  this->GetOutput(0)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(0)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(0)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(0)->Allocate();
-
-  this->GetOutput(1)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(1)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(1)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(1)->Allocate();
-
-  this->GetOutput(2)->SetDirection(this->GetInput()->GetDirection());
-  this->GetOutput(2)->SetSpacing(this->GetInput()->GetSpacing());
-  this->GetOutput(2)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
-  this->GetOutput(2)->Allocate();
+  for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+  {
+    this->GetOutput(i)->SetDirection(this->GetInput()->GetDirection());
+    this->GetOutput(i)->SetSpacing(this->GetInput()->GetSpacing());
+    this->GetOutput(i)->SetRegions(this->GetInput()->GetLargestPossibleRegion());
+  }
 }
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::GenerateData()
 {
+  typename TInputImageType::RegionType region = this->GetInput()->GetLargestPossibleRegion();
+  const unsigned int xdim = region.GetSize(0);
+  const unsigned int ydim = region.GetSize(1);
+  const unsigned int zdim = region.GetSize(2);
 
+  for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+  {
+    this->GetOutput(i)->Allocate();
+    this->GetOutput(i)->FillBuffer(0);
+  }
 
+  // Bounding box of the mask, everything outside of it stays zero
+  unsigned int lower[3] = { xdim, ydim, zdim };
+  unsigned int upper[3] = { 0, 0, 0 };
+  if (m_ImageMask.IsNotNull())
+  {
+    const typename TMaskImageType::PixelType *mask = m_ImageMask->GetBufferPointer();
+    for (unsigned int z = 0; z < zdim; ++z)
+      for (unsigned int y = 0; y < ydim; ++y)
+        for (unsigned int x = 0; x < xdim; ++x, ++mask)
+        {
+          if (*mask != 0)
+          {
+            lower[0] = std::min(lower[0], x); upper[0] = std::max(upper[0], x + 1);
+            lower[1] = std::min(lower[1], y); upper[1] = std::max(upper[1], y + 1);
+            lower[2] = std::min(lower[2], z); upper[2] = std::max(upper[2], z + 1);
+          }
+        }
+    if (upper[0] == 0)
+      return;
+  }
+  else
+  {
+    lower[0] = lower[1] = lower[2] = 0;
+    upper[0] = xdim; upper[1] = ydim; upper[2] = zdim;
+  }
 
-  typedef typename TInputImageType::PixelType InputPixelType;
-
-  typename TInputImageType::RegionType region = this->GetInput()->GetLargestPossibleRegion();
-  unsigned int xdim = region.GetSize(0);
-  unsigned int ydim = region.GetSize(1);
-  unsigned int zdim = region.GetSize(2);
-
+  // Reach of the gradient plus the smoothing of the gradient products with the largest outer scale
+  const double maxOuterScale = *std::max_element(m_OuterScales.begin(), m_OuterScales.end());
+  const unsigned int margin = static_cast<unsigned int>(std::ceil(3.0 * m_InnerScale + 2.0)) +
+                              static_cast<unsigned int>(std::ceil(3.0 * maxOuterScale + 2.0));
 
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    m_BoundingBox.SetIndex(i, lower[i]);
+    m_BoundingBox.SetSize(i, upper[i] - lower[i]);
+  }
+  // The structure tensor is computed per slice, so only x and y need the margin
+  m_PaddedBoundingBox = m_BoundingBox;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    const unsigned int paddedLower = lower[i] > margin ? lower[i] - margin : 0;
+    const unsigned int paddedUpper = std::min(upper[i] + margin, static_cast<unsigned int>(region.GetSize(i)));
+    m_PaddedBoundingBox.SetIndex(i, paddedLower);
+    m_PaddedBoundingBox.SetSize(i, paddedUpper - paddedLower);
+  }
 
-  vigra::Shape3 shape(xdim,ydim,zdim);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > input_image_view(
-        shape ,
-        this->GetInput()->GetBufferPointer());
+  this->GetMultiThreader()->SetNumberOfThreads(std::min<ThreadIdType>(this->GetNumberOfThreads(), m_BoundingBox.GetSize(2)));
+  this->GetMultiThreader()->SetSingleMethod(Self::ThreaderCallback, this);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
 
-  vigra::MultiArray<3, vigra::TinyVector<InputPixelType, 3> > structuretensor_image(shape);
-  vigra::MultiArray<3, vigra::TinyVector<InputPixelType, 3> > eigenvalues_image(shape);
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+ITK_THREAD_RETURN_TYPE itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::ThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  static_cast<Self *>(info->UserData)->ProcessSlices(info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
 
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::ProcessSlices(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  typedef typename TInputImageType::PixelType InputPixelType;
+  typedef typename TOutputImageType::PixelType OutputPixelType;
 
-  for(unsigned int i = 0 ; i < zdim; ++i )
+  typename TInputImageType::RegionType region = this->GetInput()->GetLargestPossibleRegion();
+  const std::size_t xdim = region.GetSize(0);
+  const std::size_t ydim = region.GetSize(1);
+
+  const std::size_t x0 = m_PaddedBoundingBox.GetIndex(0);
+  const std::size_t y0 = m_PaddedBoundingBox.GetIndex(1);
+  const std::size_t width = m_PaddedBoundingBox.GetSize(0);
+  const std::size_t height = m_PaddedBoundingBox.GetSize(1);
+
+  const InputPixelType *input = this->GetInput()->GetBufferPointer();
+
+  vigra::Shape2 slice_shape(width, height);
+  vigra::MultiArray<2, InputPixelType> image_slice(slice_shape);
+  vigra::MultiArray<2, InputPixelType> gradient_x(slice_shape);
+  vigra::MultiArray<2, InputPixelType> gradient_y(slice_shape);
+  vigra::MultiArray<2, vigra::TinyVector<InputPixelType, 3> > gradient_products(slice_shape);
+  vigra::MultiArray<2, vigra::TinyVector<InputPixelType, 3> > tensor_slice(slice_shape);
+  vigra::MultiArray<2, vigra::TinyVector<InputPixelType, 3> > eigenvalues_slice(slice_shape);
+
+  const std::size_t firstSlice = m_BoundingBox.GetIndex(2);
+  const std::size_t lastSlice = firstSlice + m_BoundingBox.GetSize(2);
+  for (std::size_t z = firstSlice + threadId; z < lastSlice; z += numberOfThreads)
   {
-    vigra::Shape2 slice_shape(xdim,ydim);
-    vigra::MultiArrayView<2, InputPixelType, vigra::StridedArrayTag > input_image_slice_view(
-          slice_shape,
-          input_image_view.data()+ (i*xdim*ydim));
+    for (std::size_t y = 0; y < height; ++y)
+    {
+      const InputPixelType *row = input + (z * ydim + y0 + y) * xdim + x0;
+      for (std::size_t x = 0; x < width; ++x)
+      {
+        image_slice(x, y) = row[x];
+      }
+    }
 
-    vigra::MultiArrayView<2, vigra::TinyVector<InputPixelType, 3> > structuretensor_image_slice_view(
-          slice_shape,
-          structuretensor_image.data() + (i*xdim*ydim));
+    // Same steps as vigra::structureTensor, but the gradient products are shared by all outer scales
+    vigra::gaussianGradient(image_slice, gradient_x, gradient_y, m_InnerScale);
+    for (std::size_t y = 0; y < height; ++y)
+    {
+      for (std::size_t x = 0; x < width; ++x)
+      {
+        gradient_products(x, y)[0] = gradient_x(x, y) * gradient_x(x, y);
+        gradient_products(x, y)[1] = gradient_x(x, y) * gradient_y(x, y);
+        gradient_products(x, y)[2] = gradient_y(x, y) * gradient_y(x, y);
+      }
+    }
 
-    vigra::structureTensor(input_image_slice_view, structuretensor_image_slice_view, m_InnerScale, m_OuterScale);
+    for (std::size_t i = 0; i < m_OuterScales.size(); ++i)
+    {
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        vigra::gaussianSmoothing(gradient_products.bindElementChannel(c), tensor_slice.bindElementChannel(c), m_OuterScales[i]);
+      }
+      vigra::tensorEigenRepresentation(tensor_slice, eigenvalues_slice);
 
-    vigra::MultiArrayView<2, vigra::TinyVector<InputPixelType, 3> > eigenvalues_image_slice_view(
-          slice_shape,
-          eigenvalues_image.data() + (i*xdim*ydim));
-    vigra::tensorEigenRepresentation(structuretensor_image_slice_view, eigenvalues_image_slice_view);
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        OutputPixelType *output = this->GetOutput(3 * i + c)->GetBufferPointer();
+        for (std::size_t y = m_BoundingBox.GetIndex(1); y < m_BoundingBox.GetIndex(1) + m_BoundingBox.GetSize(1); ++y)
+        {
+          OutputPixelType *row = output + (z * ydim + y) * xdim;
+          for (std::size_t x = m_BoundingBox.GetIndex(0); x < m_BoundingBox.GetIndex(0) + m_BoundingBox.GetSize(0); ++x)
+          {
+            row[x] = eigenvalues_slice(x - x0, y - y0)[c];
+          }
+        }
+      }
+    }
   }
+}
 
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev1_image = eigenvalues_image.bindElementChannel(0);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev2_image = eigenvalues_image.bindElementChannel(1);
-  vigra::MultiArrayView<3, InputPixelType, vigra::StridedArrayTag > ev3_image = eigenvalues_image.bindElementChannel(2);
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::SetOuterScale(double outerScale)
+{
+  this->SetOuterScales(std::vector<double>(1, outerScale));
+}
 
-  for(unsigned int x = 0 ; x < xdim; ++x)
-    for(unsigned int y = 0 ; y < ydim; ++y)
-      for(unsigned int z = 0 ; z < zdim; ++z)
-      {
-        itk::Index<3> indx = {{x,y,z}};
-        this->GetOutput(0)->operator [](indx) = ev1_image(x,y,z);
-        this->GetOutput(1)->operator [](indx) = ev2_image(x,y,z);
-        this->GetOutput(2)->operator [](indx) = ev3_image(x,y,z);
-      }
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+double itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::GetOuterScale()
+{
+  return m_OuterScales.front();
+}
 
+template< class TInputImageType, class TOutputImageType, class TMaskImageType>
+void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType, TMaskImageType>::SetOuterScales(const std::vector<double> &outerScales)
+{
+  if (outerScales.empty() || outerScales == m_OuterScales)
+    return;
 
+  m_OuterScales = outerScales;
+  this->SetNumberOfIndexedOutputs(3 * m_OuterScales.size());
+  for (unsigned int i = 0; i < 3 * m_OuterScales.size(); ++i)
+  {
+    if (this->GetOutput(i) == nullptr)
+      this->SetNthOutput(i, this->MakeOutput(i));
+  }
+  this->Modified();
 }
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
@@ -107,6 +217,7 @@ void itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType,
 
 template< class TInputImageType, class TOutputImageType, class TMaskImageType>
 itk::StructureTensorEigenvalueImageFilter<TInputImageType,TOutputImageType,TMaskImageType>::StructureTensorEigenvalueImageFilter()
+  : m_InnerScale(1.0), m_OuterScales(1, 1.0)
 {
   this->SetNumberOfIndexedOutputs(3);
   this->SetNumberOfIndexedInputs(1);
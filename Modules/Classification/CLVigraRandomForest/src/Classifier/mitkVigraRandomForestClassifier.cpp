@@ -15,7 +15,9 @@ found in the LICENSE file.
 #include <mitkThresholdSplit.h>
 #include <mitkImpurityLoss.h>
 #include <mitkLinearSplitting.h>
+#include <mitkFeatureBins.h>
 #include <mitkProperties.h>
+#include <mitkParallelFor.h>
 
 // Vigra includes
 #include <vigra/random_forest.hxx>
@@ -26,6 +28,9 @@ found in the LICENSE file.
 #include <itkMultiThreader.h>
 #include <itkCommand.h>
 
+// STL includes
+#include <memory>
+
 typedef mitk::ThresholdSplit<mitk::LinearSplitting< mitk::ImpurityLoss<> >,int,vigra::ClassificationTag> DefaultSplitType;
 
 struct mitk::VigraRandomForestClassifier::Parameter
@@ -34,6 +39,7 @@ struct mitk::VigraRandomForestClassifier::Parameter
   bool SampleWithReplacement;
   bool UseRandomSplit;
   bool UsePointBasedWeights;
+  bool UseHistogramSplit;
   int TreeCount;
   int MinimumSplitNodeSize;
   int TreeDepth;
@@ -132,6 +138,18 @@ void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, cons
   splitter.SetPrecision(m_Parameter->Precision);
   splitter.SetMaximumTreeDepth(m_Parameter->TreeDepth);
 
+  vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
+  vigra::MultiArrayView<2, int> Y(vigra::Shape2(Y_in.rows(),Y_in.cols()),Y_in.data());
+
+  if (m_Parameter->UseHistogramSplit)
+  {
+    // Quantize the features once for all trees. Threads not busy with trees evaluate features in parallel.
+    splitter.SetFeatureBins(std::make_shared<const FeatureBins>(X));
+
+    const unsigned int treeThreads = std::max(1, std::min(static_cast<int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()), m_Parameter->TreeCount));
+    splitter.SetNumberOfThreads(std::max(1u, mitk::GetParallelForNumberOfThreads() / treeThreads));
+  }
+
   // Weights handled as member variable
   if (m_Parameter->UsePointBasedWeights)
   {
@@ -142,9 +160,6 @@ void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, cons
     splitter.SetWeights(W);
   }
 
-  vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
-  vigra::MultiArrayView<2, int> Y(vigra::Shape2(Y_in.rows(),Y_in.cols()),Y_in.data());
-
   m_RandomForest.set_options().tree_count(1); // Number of trees that are calculated;
 
   m_RandomForest.set_options().use_stratification(m_Parameter->Stratification);
@@ -271,6 +286,8 @@ ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::TrainTreesCallback(voi
     splitter.SetPrecision(data->m_Splitter.GetPrecision());
     splitter.SetMaximumTreeDepth(data->m_Splitter.GetMaximumTreeDepth());
     splitter.SetWeights(data->m_Splitter.GetWeights());
+    splitter.SetFeatureBins(data->m_Splitter.GetFeatureBins());
+    splitter.SetNumberOfThreads(data->m_Splitter.GetNumberOfThreads());
 
     rf.trees_.clear();
     rf.set_options().tree_count(numberOfTreesToCalculate);
@@ -456,6 +473,7 @@ void  mitk::VigraRandomForestClassifier::ConvertParameter()
   MITK_INFO("VigraRandomForestClassifier") << "Convert Parameter";
   if(!this->GetPropertyList()->Get("usepointbasedweight",this->m_Parameter->UsePointBasedWeights))      this->m_Parameter->UsePointBasedWeights = false;
   if(!this->GetPropertyList()->Get("userandomsplit",this->m_Parameter->UseRandomSplit))                 this->m_Parameter->UseRandomSplit = false;
+  if(!this->GetPropertyList()->Get("usehistogramsplit",this->m_Parameter->UseHistogramSplit))           this->m_Parameter->UseHistogramSplit = false;
   if(!this->GetPropertyList()->Get("treedepth",this->m_Parameter->TreeDepth))                           this->m_Parameter->TreeDepth = 20;
   if(!this->GetPropertyList()->Get("treecount",this->m_Parameter->TreeCount))                           this->m_Parameter->TreeCount = 100;
   if(!this->GetPropertyList()->Get("minimalsplitnodesize",this->m_Parameter->MinimumSplitNodeSize))     this->m_Parameter->MinimumSplitNodeSize = 5;
@@ -488,6 +506,11 @@ void mitk::VigraRandomForestClassifier::PrintParameter(std::ostream & str)
   else
     str << "userandomsplit\t" << this->m_Parameter->UseRandomSplit << "\n";
 
+  if(!this->GetPropertyList()->Get("usehistogramsplit",this->m_Parameter->UseHistogramSplit))
+    str << "usehistogramsplit\tNOT SET (default " << this->m_Parameter->UseHistogramSplit << ")" << "\n";
+  else
+    str << "usehistogramsplit\t" << this->m_Parameter->UseHistogramSplit << "\n";
+
   if(!this->GetPropertyList()->Get("treedepth",this->m_Parameter->TreeDepth))
     str << "treedepth\t\tNOT SET (default " << this->m_Parameter->TreeDepth << ")" << "\n";
   else
@@ -558,6 +581,11 @@ void mitk::VigraRandomForestClassifier::UseSampleWithReplacement(bool val)
   this->GetPropertyList()->SetBoolProperty("samplewithreplacement",val);
 }
 
+void mitk::VigraRandomForestClassifier::UseHistogramSplit(bool val)
+{
+  this->GetPropertyList()->SetBoolProperty("usehistogramsplit",val);
+}
+
 void mitk::VigraRandomForestClassifier::SetTreeCount(int val)
 {
   this->GetPropertyList()->SetIntProperty("treecount",val);
@@ -0,0 +1,66 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkFeatureBins.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+
+mitk::FeatureBins::FeatureBins(vigra::MultiArrayView<2, double> const &features, unsigned int numberOfBins)
+  : m_NumberOfSamples(features.shape(0)),
+    m_NumberOfFeatures(features.shape(1)),
+    m_Bins(features.shape(0) * features.shape(1)),
+    m_Thresholds(features.shape(1))
+{
+  numberOfBins = std::max(1u, std::min(numberOfBins, MaximumNumberOfBins));
+
+  auto quantizeFeature = [&](std::ptrdiff_t feature)
+  {
+    std::vector<double> sorted(m_NumberOfSamples);
+    for (std::ptrdiff_t i = 0; i < m_NumberOfSamples; ++i)
+      sorted[i] = features(i, feature);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Number of samples with a value less or equal to each distinct value
+    std::vector<double> values;
+    std::vector<std::size_t> cumulativeCounts;
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+    {
+      if (values.empty() || sorted[i] != values.back())
+      {
+        values.push_back(sorted[i]);
+        cumulativeCounts.push_back(0);
+      }
+      cumulativeCounts.back() = i + 1;
+    }
+
+    // Close a bin behind a distinct value as soon as it holds its share of the samples.
+    // Thresholds are the midpoints between neighbouring values, as in mitk::LinearSplitting.
+    std::vector<double> &thresholds = m_Thresholds[feature];
+    const std::size_t numberOfSamples = sorted.size();
+    const bool binPerValue = values.size() <= numberOfBins;
+    for (std::size_t i = 0; i + 1 < values.size() && thresholds.size() + 1 < numberOfBins; ++i)
+    {
+      if (binPerValue || cumulativeCounts[i] * numberOfBins >= (thresholds.size() + 1) * numberOfSamples)
+        thresholds.push_back((values[i] + values[i + 1]) / 2.0);
+    }
+
+    BinType *bins = m_Bins.data() + feature * m_NumberOfSamples;
+    for (std::ptrdiff_t i = 0; i < m_NumberOfSamples; ++i)
+    {
+      bins[i] = static_cast<BinType>(
+        std::upper_bound(thresholds.begin(), thresholds.end(), features(i, feature)) - thresholds.begin());
+    }
+  };
+
+  mitk::ParallelFor(m_NumberOfFeatures, [&](std::size_t feature) { quantizeFeature(static_cast<std::ptrdiff_t>(feature)); });
+}
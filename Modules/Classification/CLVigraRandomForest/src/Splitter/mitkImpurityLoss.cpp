@@ -72,6 +72,32 @@ mitk::ImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::Decrement(
     return m_LossFunction(m_Counts, m_ClassWeights, m_TotalCount);
 }
 
+template <class TLossFunction, class TLabelContainer, class TWeightContainer>
+template <class TCountIterator>
+double
+mitk::ImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::IncrementCounts(TCountIterator counts)
+{
+    for (std::size_t i = 0; i < m_Counts.size(); ++i, ++counts)
+    {
+        m_Counts[i] += *counts;
+        m_TotalCount += *counts;
+    }
+    return m_LossFunction(m_Counts, m_ClassWeights, m_TotalCount);
+}
+
+template <class TLossFunction, class TLabelContainer, class TWeightContainer>
+template <class TCountIterator>
+double
+mitk::ImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::DecrementCounts(TCountIterator counts)
+{
+    for (std::size_t i = 0; i < m_Counts.size(); ++i, ++counts)
+    {
+        m_Counts[i] -= *counts;
+        m_TotalCount -= *counts;
+    }
+    return m_LossFunction(m_Counts, m_ClassWeights, m_TotalCount);
+}
+
 template <class TLossFunction, class TLabelContainer, class TWeightContainer>
 template <class TArray>
 double
@@ -16,6 +16,8 @@ found in the LICENSE file.
 #include <mitkLinearSplitting.h>
 #include <mitkPUImpurityLoss.h>
 
+#include <numeric>
+
 template<class TLossAccumulator>
 mitk::LinearSplitting<TLossAccumulator>::LinearSplitting() :
     m_UsePointWeights(false),
@@ -175,6 +177,54 @@ mitk::LinearSplitting<TLossAccumulator>::operator()(TDataSourceFeature const &co
     }
 }
 
+template<class TLossAccumulator>
+template <class TDataSourceLabel, class TArray>
+void
+mitk::LinearSplitting<TLossAccumulator>::SearchHistogram(TDataSourceLabel const &labels,
+                std::vector<double> const &histogram,
+                std::vector<std::size_t> const &binSizes,
+                std::vector<double> const &thresholds,
+                TArray const &regionResponse)
+{
+    typedef TLossAccumulator LineSearchLoss;
+
+    // The histogram already contains the point weights
+    LineSearchLoss left(labels, m_ExtParameter, m_AdditionalData);
+    LineSearchLoss right(labels, m_ExtParameter, m_AdditionalData);
+
+    m_MinimumLoss = right.Init(regionResponse);
+    m_MinimumThreshold = thresholds.empty() ? 0.0 : thresholds.front();
+    m_MinimumIndex = 0;
+
+    const std::size_t classCount = regionResponse.size();
+    std::size_t remainingSamples = std::accumulate(binSizes.begin(), binSizes.end(), std::size_t(0));
+
+    for (std::size_t bin = 0; bin + 1 < binSizes.size(); ++bin)
+    {
+        // Only split between bins that actually contain samples of this region
+        if (binSizes[bin] == 0)
+            continue;
+        remainingSamples -= binSizes[bin];
+        if (remainingSamples == 0)
+            break;
+
+        // Move the whole bin from the right to the left side
+        auto binCounts = histogram.begin() + bin * classCount;
+        double rightLoss = right.DecrementCounts(binCounts);
+        double leftLoss = left.IncrementCounts(binCounts);
+        double currentLoss = rightLoss + leftLoss;
+
+        if (currentLoss < m_MinimumLoss)
+        {
+            m_BestCurrentCounts[0] = left.Response();
+            m_BestCurrentCounts[1] = right.Response();
+            m_MinimumLoss = currentLoss;
+            m_MinimumIndex = bin + 1;
+            m_MinimumThreshold = thresholds[bin];
+        }
+    }
+}
+
 template<class TLossAccumulator>
 template <class TDataSourceLabel, class TDataIterator, class TArray>
 double
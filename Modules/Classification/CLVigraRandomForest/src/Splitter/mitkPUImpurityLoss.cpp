@@ -96,6 +96,34 @@ mitk::PUImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::Decremen
     return m_LossFunction(m_PUCounts, m_ClassWeights, m_PUTotalCount);
 }
 
+template <class TLossFunction, class TLabelContainer, class TWeightContainer>
+template <class TCountIterator>
+double
+mitk::PUImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::IncrementCounts(TCountIterator counts)
+{
+    for (std::size_t i = 0; i < m_Counts.size(); ++i, ++counts)
+    {
+        m_Counts[i] += *counts;
+        m_TotalCount += *counts;
+    }
+    UpdatePUCounts();
+    return m_LossFunction(m_PUCounts, m_ClassWeights, m_PUTotalCount);
+}
+
+template <class TLossFunction, class TLabelContainer, class TWeightContainer>
+template <class TCountIterator>
+double
+mitk::PUImpurityLoss<TLossFunction, TLabelContainer, TWeightContainer>::DecrementCounts(TCountIterator counts)
+{
+    for (std::size_t i = 0; i < m_Counts.size(); ++i, ++counts)
+    {
+        m_Counts[i] -= *counts;
+        m_TotalCount -= *counts;
+    }
+    UpdatePUCounts();
+    return m_LossFunction(m_PUCounts, m_ClassWeights, m_PUTotalCount);
+}
+
 template <class TLossFunction, class TLabelContainer, class TWeightContainer>
 template <class TArray>
 double
@@ -14,6 +14,9 @@ found in the LICENSE file.
 #define mitkThresholdSplit_cpp
 
 #include <mitkThresholdSplit.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
 
 template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
 mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::ThresholdSplit() :
@@ -22,6 +25,7 @@ mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::Threshol
   m_UseRandomSplit(false),
   m_Precision(0.0),
   m_MaximumTreeDepth(1000),
+  m_NumberOfThreads(1),
   m_AdditionalData(nullptr)
 {
 }
@@ -139,6 +143,34 @@ mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::GetWeigh
   return m_Weights;
 }
 
+template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
+void
+mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::SetFeatureBins(std::shared_ptr<const FeatureBins> bins)
+{
+  m_FeatureBins = bins;
+}
+
+template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
+std::shared_ptr<const mitk::FeatureBins>
+mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::GetFeatureBins() const
+{
+  return m_FeatureBins;
+}
+
+template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
+void
+mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+  m_NumberOfThreads = std::max(1u, numberOfThreads);
+}
+
+template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
+unsigned int
+mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
 template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
 double
 mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::minGini() const
@@ -240,28 +272,37 @@ mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::findBest
   // find the split with the best evaluation value
   bestSplitIndex = 0;
   double currentMiniGini = region_gini_;
-  int numberOfTrials = features.shape(1);
-  for (int k = 0; k < numberOfTrials; ++k)
+  if (m_FeatureBins && !m_UseRandomSplit &&
+      m_FeatureBins->GetNumberOfSamples() == features.shape(0) &&
+      m_FeatureBins->GetNumberOfFeatures() == features.shape(1))
+  {
+    currentMiniGini = this->findBestHistogramSplit(labels, region, childRegions);
+  }
+  else
   {
-    bgfunc(columnVector(features, splitColumns[k]),
-           labels,
-           region.begin(), region.end(),
-           region.classCounts());
-    min_gini_[k] = bgfunc.GetMinimumLoss();
-    min_indices_[k] = bgfunc.GetMinimumIndex();
-    min_thresholds_[k] = bgfunc.GetMinimumThreshold();
-
-    // removed classifier test section, because not necessary
-    if (bgfunc.GetMinimumLoss() < currentMiniGini)
+    int numberOfTrials = features.shape(1);
+    for (int k = 0; k < numberOfTrials; ++k)
     {
-      currentMiniGini = bgfunc.GetMinimumLoss();
-      childRegions[0].classCounts() = bgfunc.GetBestCurrentCounts()[0];
-      childRegions[1].classCounts() = bgfunc.GetBestCurrentCounts()[1];
-      childRegions[0].classCountsIsValid = true;
-      childRegions[1].classCountsIsValid = true;
-
-      bestSplitIndex = k;
-      numberOfTrials = SB::ext_param_.actual_mtry_;
+      bgfunc(columnVector(features, splitColumns[k]),
+             labels,
+             region.begin(), region.end(),
+             region.classCounts());
+      min_gini_[k] = bgfunc.GetMinimumLoss();
+      min_indices_[k] = bgfunc.GetMinimumIndex();
+      min_thresholds_[k] = bgfunc.GetMinimumThreshold();
+
+      // removed classifier test section, because not necessary
+      if (bgfunc.GetMinimumLoss() < currentMiniGini)
+      {
+        currentMiniGini = bgfunc.GetMinimumLoss();
+        childRegions[0].classCounts() = bgfunc.GetBestCurrentCounts()[0];
+        childRegions[1].classCounts() = bgfunc.GetBestCurrentCounts()[1];
+        childRegions[0].classCountsIsValid = true;
+        childRegions[1].classCountsIsValid = true;
+
+        bestSplitIndex = k;
+        numberOfTrials = SB::ext_param_.actual_mtry_;
+      }
     }
   }
 
@@ -294,6 +335,107 @@ mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::findBest
   return 0;
 }
 
+template<class TColumnDecisionFunctor, class TFeatureCalculator, class TTag>
+template<class T2, class C2, class Region>
+double
+mitk::ThresholdSplit<TColumnDecisionFunctor, TFeatureCalculator, TTag>::findBestHistogramSplit(vigra::MultiArrayView<2, T2, C2> labels,
+                                                                                               Region & region,
+                                                                                               vigra::ArrayVector<Region>& childRegions)
+{
+  // Below this number of samples per thread, evaluating the features of a node in parallel does not pay off
+  const std::ptrdiff_t minimumSamplesPerThread = 4096;
+
+  const int numberOfFeatures = static_cast<int>(m_FeatureBins->GetNumberOfFeatures());
+  const int mtry = std::min(SB::ext_param_.actual_mtry_, numberOfFeatures);
+  const std::size_t classCount = region.classCounts().size();
+  const std::ptrdiff_t regionSize = region.end() - region.begin();
+
+  // class counts of both children for the best split of each evaluated column
+  std::vector<vigra::ArrayVector<double> > childCounts(2 * numberOfFeatures);
+
+  auto evaluateColumns = [&](int begin, int end)
+  {
+    const std::ptrdiff_t numberOfChunks = std::max<std::ptrdiff_t>(1,
+      std::min<std::ptrdiff_t>({ static_cast<std::ptrdiff_t>(m_NumberOfThreads), end - begin, regionSize / minimumSamplesPerThread }));
+
+    mitk::ParallelFor(numberOfChunks, [&](std::size_t chunk)
+    {
+      // every chunk of columns uses its own line search and histogram buffers
+      TColumnDecisionFunctor lineSearch(bgfunc);
+      std::vector<double> histogram;
+      std::vector<std::size_t> binSizes;
+
+      const int chunkBegin = begin + static_cast<int>(chunk * (end - begin) / numberOfChunks);
+      const int chunkEnd = begin + static_cast<int>((chunk + 1) * (end - begin) / numberOfChunks);
+      for (int k = chunkBegin; k < chunkEnd; ++k)
+      {
+        const int column = splitColumns[k];
+        const FeatureBins::BinType * bins = m_FeatureBins->GetBins(column);
+
+        histogram.assign(m_FeatureBins->GetNumberOfBins(column) * classCount, 0.0);
+        binSizes.assign(m_FeatureBins->GetNumberOfBins(column), 0);
+        for (typename Region::IndexIterator iter = region.begin(); iter != region.end(); ++iter)
+        {
+          double probability = 1.0;
+          if (m_UseWeights)
+          {
+            probability = m_Weights(*iter, 0);
+          }
+          const std::size_t bin = bins[*iter];
+          histogram[bin * classCount + labels(*iter, 0)] += probability;
+          ++binSizes[bin];
+        }
+
+        lineSearch.SearchHistogram(labels, histogram, binSizes, m_FeatureBins->GetThresholds(column), region.classCounts());
+        min_gini_[k] = lineSearch.GetMinimumLoss();
+        min_indices_[k] = lineSearch.GetMinimumIndex();
+        min_thresholds_[k] = lineSearch.GetMinimumThreshold();
+        childCounts[2 * k] = lineSearch.GetBestCurrentCounts()[0];
+        childCounts[2 * k + 1] = lineSearch.GetBestCurrentCounts()[1];
+      }
+    });
+  };
+
+  double currentMiniGini = region_gini_;
+  auto selectColumn = [&](int k)
+  {
+    currentMiniGini = min_gini_[k];
+    childRegions[0].classCounts() = childCounts[2 * k];
+    childRegions[1].classCounts() = childCounts[2 * k + 1];
+    childRegions[0].classCountsIsValid = true;
+    childRegions[1].classCountsIsValid = true;
+    bestSplitIndex = k;
+  };
+
+  // Same selection as the sorting line search: the best of the first mtry
+  // columns, or else the first further column that improves the region.
+  evaluateColumns(0, mtry);
+  for (int k = 0; k < mtry; ++k)
+  {
+    if (min_gini_[k] < currentMiniGini)
+    {
+      selectColumn(k);
+    }
+  }
+
+  const int chunkSize = static_cast<int>(m_NumberOfThreads);
+  for (int begin = mtry; begin < numberOfFeatures && !(currentMiniGini < region_gini_); begin += chunkSize)
+  {
+    const int end = std::min(numberOfFeatures, begin + chunkSize);
+    evaluateColumns(begin, end);
+    for (int k = begin; k < end; ++k)
+    {
+      if (min_gini_[k] < currentMiniGini)
+      {
+        selectColumn(k);
+        break;
+      }
+    }
+  }
+
+  return currentMiniGini;
+}
+
 //template<class TRegion, class TRegionIterator, class TLabelHolder, class TWeightsHolder>
 //static void UpdateRegionCounts(TRegion & region, TRegionIterator begin, TRegionIterator end, TLabelHolder labels, TWeightsHolder weights)
 //{
@@ -1,3 +1,5 @@
 set(MODULE_TESTS
   mitkVigraRandomForestTest.cpp
+  mitkEigenvalueImageFilterTest.cpp
+  mitkThresholdSplitTest.cpp
 )
@@ -0,0 +1,342 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <itkHessianMatrixEigenvalueImageFilter.h>
+#include <itkStructureTensorEigenvalueImageFilter.h>
+
+#include <vigra/convolution.hxx>
+#include <vigra/tensorutilities.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class mitkEigenvalueImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkEigenvalueImageFilterTestSuite);
+  MITK_TEST(Hessian_InsideMaskBoundingBox_EqualsWholeSlice);
+  MITK_TEST(Hessian_MaskAtImageBorder_EqualsWholeSlice);
+  MITK_TEST(Hessian_WithoutMask_EqualsWholeSlice);
+  MITK_TEST(Hessian_Threads_GiveSameResult);
+  MITK_TEST(Hessian_EmptyMask_GivesZero);
+  MITK_TEST(Hessian_SeveralSigmas_EqualsSingleSigmas);
+  MITK_TEST(StructureTensor_InsideMaskBoundingBox_EqualsWholeSlice);
+  MITK_TEST(StructureTensor_MaskAtImageBorder_EqualsWholeSlice);
+  MITK_TEST(StructureTensor_Threads_GiveSameResult);
+  MITK_TEST(StructureTensor_SeveralOuterScales_EqualsSingleScales);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> DoubleImageType;
+  typedef itk::Image<short, 3> ShortImageType;
+  typedef itk::HessianMatrixEigenvalueImageFilter<DoubleImageType> HessianFilterType;
+  typedef itk::StructureTensorEigenvalueImageFilter<DoubleImageType> StructureTensorFilterType;
+  typedef vigra::MultiArray<3, vigra::TinyVector<double, 3> > EigenvaluesType;
+
+  static const unsigned int XDim = 48;
+  static const unsigned int YDim = 40;
+  static const unsigned int ZDim = 9;
+
+  DoubleImageType::Pointer m_Image;
+
+  static DoubleImageType::RegionType CreateRegion()
+  {
+    DoubleImageType::RegionType region;
+    region.SetSize(0, XDim);
+    region.SetSize(1, YDim);
+    region.SetSize(2, ZDim);
+    return region;
+  }
+
+  /** Ellipse of the given center and radii in the slices [firstSlice, lastSlice) */
+  static ShortImageType::Pointer CreateMask(double cx, double cy, double rx, double ry, unsigned int firstSlice, unsigned int lastSlice)
+  {
+    ShortImageType::Pointer mask = ShortImageType::New();
+    mask->SetRegions(CreateRegion());
+    mask->Allocate();
+    mask->FillBuffer(0);
+
+    short *buffer = mask->GetBufferPointer();
+    for (unsigned int z = firstSlice; z < lastSlice; ++z)
+      for (unsigned int y = 0; y < YDim; ++y)
+        for (unsigned int x = 0; x < XDim; ++x)
+        {
+          const double dx = (x - cx) / rx;
+          const double dy = (y - cy) / ry;
+          if (dx * dx + dy * dy <= 1.0)
+            buffer[(z * YDim + y) * XDim + x] = 1;
+        }
+    return mask;
+  }
+
+  /** The computation before the filters were bounded to the mask: every slice as a whole */
+  template <class TSliceFunction>
+  static EigenvaluesType ComputeWholeSlices(const DoubleImageType *image, const ShortImageType *mask, TSliceFunction sliceFunction)
+  {
+    vigra::Shape2 sliceShape(XDim, YDim);
+    vigra::MultiArray<2, double> slice(sliceShape);
+    vigra::MultiArray<2, vigra::TinyVector<double, 3> > tensor(sliceShape);
+    EigenvaluesType eigenvalues(vigra::Shape3(XDim, YDim, ZDim));
+
+    for (unsigned int z = 0; z < ZDim; ++z)
+    {
+      for (unsigned int y = 0; y < YDim; ++y)
+        for (unsigned int x = 0; x < XDim; ++x)
+        {
+          const std::size_t offset = (z * YDim + y) * XDim + x;
+          slice(x, y) = (mask == nullptr || mask->GetBufferPointer()[offset] != 0) ? image->GetBufferPointer()[offset] : 0;
+        }
+
+      sliceFunction(slice, tensor);
+      vigra::tensorEigenRepresentation(tensor, eigenvalues.bindOuter(z));
+    }
+    return eigenvalues;
+  }
+
+  static EigenvaluesType ComputeHessian(const DoubleImageType *image, const ShortImageType *mask, double sigma)
+  {
+    return ComputeWholeSlices(image, mask, [sigma](const vigra::MultiArray<2, double> &slice, vigra::MultiArray<2, vigra::TinyVector<double, 3> > &tensor) {
+      vigra::hessianMatrixOfGaussian(slice, tensor.bindElementChannel(0), tensor.bindElementChannel(1), tensor.bindElementChannel(2), sigma);
+    });
+  }
+
+  static EigenvaluesType ComputeStructureTensor(const DoubleImageType *image, double innerScale, double outerScale)
+  {
+    return ComputeWholeSlices(image, nullptr, [innerScale, outerScale](const vigra::MultiArray<2, double> &slice, vigra::MultiArray<2, vigra::TinyVector<double, 3> > &tensor) {
+      vigra::structureTensor(slice, tensor, innerScale, outerScale);
+    });
+  }
+
+  /** Bounding box [lower, upper) of the mask, the whole image without a mask */
+  static void ComputeBoundingBox(const ShortImageType *mask, unsigned int *lower, unsigned int *upper)
+  {
+    if (mask == nullptr)
+    {
+      lower[0] = lower[1] = lower[2] = 0;
+      upper[0] = XDim; upper[1] = YDim; upper[2] = ZDim;
+      return;
+    }
+
+    lower[0] = XDim; lower[1] = YDim; lower[2] = ZDim;
+    upper[0] = upper[1] = upper[2] = 0;
+    const short *buffer = mask->GetBufferPointer();
+    for (unsigned int z = 0; z < ZDim; ++z)
+      for (unsigned int y = 0; y < YDim; ++y)
+        for (unsigned int x = 0; x < XDim; ++x, ++buffer)
+        {
+          if (*buffer != 0)
+          {
+            lower[0] = std::min(lower[0], x); upper[0] = std::max(upper[0], x + 1);
+            lower[1] = std::min(lower[1], y); upper[1] = std::max(upper[1], y + 1);
+            lower[2] = std::min(lower[2], z); upper[2] = std::max(upper[2], z + 1);
+          }
+        }
+  }
+
+  /** The outputs, starting at firstOutput, equal the expected eigenvalues inside of the bounding box of the mask and are zero outside */
+  template <class TFilterType>
+  static void CheckOutputs(TFilterType *filter, const ShortImageType *mask, const EigenvaluesType &expected, unsigned int firstOutput = 0)
+  {
+    unsigned int lower[3];
+    unsigned int upper[3];
+    ComputeBoundingBox(mask, lower, upper);
+
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      const double *output = filter->GetOutput(firstOutput + c)->GetBufferPointer();
+      for (unsigned int z = 0; z < ZDim; ++z)
+        for (unsigned int y = 0; y < YDim; ++y)
+          for (unsigned int x = 0; x < XDim; ++x, ++output)
+          {
+            const bool inside = x >= lower[0] && x < upper[0] && y >= lower[1] && y < upper[1] && z >= lower[2] && z < upper[2];
+            const double value = inside ? expected(x, y, z)[c] : 0.0;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(value, *output, 1e-10 * (1.0 + std::abs(value)));
+          }
+    }
+  }
+
+  static HessianFilterType::Pointer RunHessian(DoubleImageType *image, ShortImageType *mask, double sigma, unsigned int numberOfThreads)
+  {
+    HessianFilterType::Pointer filter = HessianFilterType::New();
+    filter->SetInput(image);
+    if (mask != nullptr)
+      filter->SetImageMask(mask);
+    filter->SetSigma(sigma);
+    filter->SetNumberOfThreads(numberOfThreads);
+    filter->Update();
+    return filter;
+  }
+
+  static StructureTensorFilterType::Pointer RunStructureTensor(DoubleImageType *image, ShortImageType *mask, double innerScale, double outerScale, unsigned int numberOfThreads)
+  {
+    StructureTensorFilterType::Pointer filter = StructureTensorFilterType::New();
+    filter->SetInput(image);
+    filter->SetImageMask(mask);
+    filter->SetInnerScale(innerScale);
+    filter->SetOuterScale(outerScale);
+    filter->SetNumberOfThreads(numberOfThreads);
+    filter->Update();
+    return filter;
+  }
+
+  template <class TFilterType>
+  static void CheckEqualOutputs(TFilterType *filter, TFilterType *otherFilter)
+  {
+    const std::size_t numberOfPixels = XDim * YDim * ZDim;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      const double *output = filter->GetOutput(c)->GetBufferPointer();
+      const double *otherOutput = otherFilter->GetOutput(c)->GetBufferPointer();
+      for (std::size_t i = 0; i < numberOfPixels; ++i)
+        CPPUNIT_ASSERT_EQUAL(output[i], otherOutput[i]);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = DoubleImageType::New();
+    m_Image->SetRegions(CreateRegion());
+    m_Image->Allocate();
+
+    // structure on several scales, so that all eigenvalues differ from zero
+    double *buffer = m_Image->GetBufferPointer();
+    for (unsigned int z = 0; z < ZDim; ++z)
+      for (unsigned int y = 0; y < YDim; ++y)
+        for (unsigned int x = 0; x < XDim; ++x, ++buffer)
+          *buffer = 100.0 * std::sin(0.31 * x + 0.1 * z) * std::cos(0.17 * y) + 20.0 * std::sin(1.3 * x * y + z) + 0.5 * x * y;
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+  }
+
+  void Hessian_InsideMaskBoundingBox_EqualsWholeSlice()
+  {
+    ShortImageType::Pointer mask = CreateMask(24.0, 20.0, 8.0, 6.0, 2, 6);
+    for (double sigma : { 0.7, 1.5, 2.5 })
+    {
+      HessianFilterType::Pointer filter = RunHessian(m_Image, mask, sigma, 1);
+      CheckOutputs(filter.GetPointer(), mask, ComputeHessian(m_Image, mask, sigma));
+    }
+  }
+
+  void Hessian_MaskAtImageBorder_EqualsWholeSlice()
+  {
+    ShortImageType::Pointer mask = CreateMask(2.0, 37.0, 9.0, 7.0, 0, ZDim);
+    HessianFilterType::Pointer filter = RunHessian(m_Image, mask, 2.0, 1);
+    CheckOutputs(filter.GetPointer(), mask, ComputeHessian(m_Image, mask, 2.0));
+  }
+
+  void Hessian_WithoutMask_EqualsWholeSlice()
+  {
+    HessianFilterType::Pointer filter = RunHessian(m_Image, nullptr, 1.5, 1);
+    CheckOutputs(filter.GetPointer(), nullptr, ComputeHessian(m_Image, nullptr, 1.5));
+  }
+
+  void Hessian_Threads_GiveSameResult()
+  {
+    ShortImageType::Pointer mask = CreateMask(20.0, 18.0, 12.0, 10.0, 1, 8);
+    HessianFilterType::Pointer filter = RunHessian(m_Image, mask, 1.5, 1);
+    // more threads than slices in the bounding box
+    for (unsigned int numberOfThreads : { 2u, 3u, 16u })
+    {
+      HessianFilterType::Pointer threadedFilter = RunHessian(m_Image, mask, 1.5, numberOfThreads);
+      CheckEqualOutputs(filter.GetPointer(), threadedFilter.GetPointer());
+    }
+  }
+
+  void Hessian_EmptyMask_GivesZero()
+  {
+    ShortImageType::Pointer mask = CreateMask(24.0, 20.0, 8.0, 6.0, 0, 0);
+    HessianFilterType::Pointer filter = RunHessian(m_Image, mask, 1.5, 2);
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      const double *output = filter->GetOutput(c)->GetBufferPointer();
+      for (std::size_t i = 0; i < XDim * YDim * ZDim; ++i)
+        CPPUNIT_ASSERT_EQUAL(0.0, output[i]);
+    }
+  }
+
+  void Hessian_SeveralSigmas_EqualsSingleSigmas()
+  {
+    ShortImageType::Pointer mask = CreateMask(12.0, 20.0, 8.0, 6.0, 2, 7);
+    // unsorted, the outputs follow the order of the sigmas
+    const std::vector<double> sigmas = { 2.5, 0.7, 1.5 };
+
+    HessianFilterType::Pointer filter = HessianFilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetImageMask(mask);
+    filter->SetSigmas(sigmas);
+    filter->SetNumberOfThreads(2);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(9), filter->GetNumberOfIndexedOutputs());
+    for (unsigned int i = 0; i < sigmas.size(); ++i)
+      CheckOutputs(filter.GetPointer(), mask, ComputeHessian(m_Image, mask, sigmas[i]), 3 * i);
+
+    // a single sigma gives three outputs again
+    filter->SetSigma(1.5);
+    filter->Update();
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(3), filter->GetNumberOfIndexedOutputs());
+    CheckOutputs(filter.GetPointer(), mask, ComputeHessian(m_Image, mask, 1.5));
+  }
+
+  void StructureTensor_InsideMaskBoundingBox_EqualsWholeSlice()
+  {
+    ShortImageType::Pointer mask = CreateMask(24.0, 20.0, 8.0, 6.0, 2, 6);
+    StructureTensorFilterType::Pointer filter = RunStructureTensor(m_Image, mask, 1.0, 2.5, 1);
+    CheckOutputs(filter.GetPointer(), mask, ComputeStructureTensor(m_Image, 1.0, 2.5));
+  }
+
+  void StructureTensor_MaskAtImageBorder_EqualsWholeSlice()
+  {
+    ShortImageType::Pointer mask = CreateMask(45.0, 1.0, 9.0, 7.0, 0, ZDim);
+    StructureTensorFilterType::Pointer filter = RunStructureTensor(m_Image, mask, 1.5, 3.0, 1);
+    CheckOutputs(filter.GetPointer(), mask, ComputeStructureTensor(m_Image, 1.5, 3.0));
+  }
+
+  void StructureTensor_Threads_GiveSameResult()
+  {
+    ShortImageType::Pointer mask = CreateMask(20.0, 18.0, 12.0, 10.0, 1, 8);
+    StructureTensorFilterType::Pointer filter = RunStructureTensor(m_Image, mask, 1.0, 2.0, 1);
+    for (unsigned int numberOfThreads : { 2u, 3u, 16u })
+    {
+      StructureTensorFilterType::Pointer threadedFilter = RunStructureTensor(m_Image, mask, 1.0, 2.0, numberOfThreads);
+      CheckEqualOutputs(filter.GetPointer(), threadedFilter.GetPointer());
+    }
+  }
+
+  void StructureTensor_SeveralOuterScales_EqualsSingleScales()
+  {
+    ShortImageType::Pointer mask = CreateMask(36.0, 20.0, 8.0, 6.0, 2, 7);
+    const std::vector<double> outerScales = { 3.0, 1.0, 2.0 };
+
+    StructureTensorFilterType::Pointer filter = StructureTensorFilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetImageMask(mask);
+    filter->SetInnerScale(1.5);
+    filter->SetOuterScales(outerScales);
+    filter->SetNumberOfThreads(2);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(9), filter->GetNumberOfIndexedOutputs());
+    for (unsigned int i = 0; i < outerScales.size(); ++i)
+      CheckOutputs(filter.GetPointer(), mask, ComputeStructureTensor(m_Image, 1.5, outerScales[i]), 3 * i);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkEigenvalueImageFilter)
@@ -0,0 +1,182 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkFeatureBins.h>
+#include <mitkImpurityLoss.h>
+#include <mitkLinearSplitting.h>
+#include <mitkThresholdSplit.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+class mitkThresholdSplitTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkThresholdSplitTestSuite);
+  MITK_TEST(FindBestSplit_AllColumns_HistogramEqualsSorting);
+  MITK_TEST(FindBestSplit_SingleColumn_HistogramEqualsSorting);
+  MITK_TEST(FindBestSplit_SubsetOfSamples_HistogramEqualsSorting);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ThresholdSplit<mitk::LinearSplitting<mitk::ImpurityLoss<> >, int, vigra::ClassificationTag> SplitType;
+  typedef vigra::DT_StackEntry<vigra::ArrayVector<vigra::Int32>::iterator> RegionType;
+
+  static const int NumberOfSamples = 150;
+  static const int NumberOfFeatures = 5;
+  static const int ClassCount = 3;
+
+  vigra::MultiArray<2, double> m_Features;
+  vigra::MultiArray<2, int> m_Labels;
+
+  struct SplitResult
+  {
+    int column;
+    double threshold;
+    double gini;
+    std::vector<vigra::Int32> leftSamples;
+  };
+
+  /** Runs the split search of a single node, with the histogram search if bins are given */
+  SplitResult FindBestSplit(std::shared_ptr<const mitk::FeatureBins> bins, const std::vector<vigra::Int32> &samples, int mtry)
+  {
+    vigra::ProblemSpec<int> problemSpec;
+    problemSpec.column_count_ = NumberOfFeatures;
+    problemSpec.class_count_ = ClassCount;
+    problemSpec.row_count_ = NumberOfSamples;
+    problemSpec.actual_mtry_ = mtry;
+    problemSpec.class_weights_.resize(ClassCount, 1.0);
+
+    SplitType splitter;
+    splitter.set_external_parameters(problemSpec);
+    splitter.SetFeatureBins(bins);
+    splitter.SetNumberOfThreads(2);
+
+    vigra::ArrayVector<vigra::Int32> indices(samples.begin(), samples.end());
+    RegionType region(indices.begin(), indices.end(), ClassCount);
+    vigra::ArrayVector<RegionType> childRegions(2, region);
+
+    // the same seed for both searches, so that they evaluate the columns in the same order
+    vigra::RandomMT19937 random(42);
+    vigra::UniformIntRandomFunctor<vigra::RandomMT19937> randint(random);
+
+    const int nodeType = splitter.findBestSplit(vigra::MultiArrayView<2, double>(m_Features),
+                                                vigra::MultiArrayView<2, int>(m_Labels),
+                                                region,
+                                                childRegions,
+                                                randint);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(vigra::i_ThresholdNode), nodeType);
+
+    SplitResult result;
+    result.column = splitter.bestSplitColumn();
+    result.threshold = splitter.bestSplitThreshold();
+    result.gini = splitter.minGini();
+    result.leftSamples.assign(childRegions[0].begin(), childRegions[0].end());
+    std::sort(result.leftSamples.begin(), result.leftSamples.end());
+    return result;
+  }
+
+  /** Both searches choose the same column and partition of the samples. The thresholds are the midpoints
+      between the neighbouring values of the node for the sorting search, but between the neighbouring values
+      of the whole data set for the histogram search, so they only agree if the node holds all samples. */
+  void CheckHistogramEqualsSorting(const std::vector<vigra::Int32> &samples, int mtry)
+  {
+    // less than 256 distinct values per column, so every value gets a bin of its own
+    auto bins = std::make_shared<const mitk::FeatureBins>(vigra::MultiArrayView<2, double>(m_Features));
+
+    const SplitResult sorting = FindBestSplit(nullptr, samples, mtry);
+    const SplitResult histogram = FindBestSplit(bins, samples, mtry);
+
+    CPPUNIT_ASSERT_EQUAL(sorting.column, histogram.column);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sorting.gini, histogram.gini, 1e-10);
+    CPPUNIT_ASSERT(sorting.leftSamples == histogram.leftSamples);
+
+    if (samples.size() == static_cast<std::size_t>(NumberOfSamples))
+    {
+      CPPUNIT_ASSERT_EQUAL(sorting.threshold, histogram.threshold);
+    }
+    else
+    {
+      // the threshold still separates the samples of the node in the same way
+      for (vigra::Int32 sample : samples)
+      {
+        const bool left = std::binary_search(sorting.leftSamples.begin(), sorting.leftSamples.end(), sample);
+        CPPUNIT_ASSERT_EQUAL(left, m_Features(sample, histogram.column) < histogram.threshold);
+      }
+    }
+  }
+
+  static std::vector<vigra::Int32> AllSamples()
+  {
+    std::vector<vigra::Int32> samples(NumberOfSamples);
+    for (int i = 0; i < NumberOfSamples; ++i)
+      samples[i] = i;
+    return samples;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Features.reshape(vigra::Shape2(NumberOfSamples, NumberOfFeatures));
+    m_Labels.reshape(vigra::Shape2(NumberOfSamples, 1));
+
+    std::mt19937 generator(7);
+    for (int i = 0; i < NumberOfSamples; ++i)
+    {
+      const int label = static_cast<int>(generator() % ClassCount);
+      m_Labels(i, 0) = label;
+
+      // noise with many equal values
+      m_Features(i, 0) = static_cast<double>(generator() % 20);
+      // informative, the classes overlap
+      m_Features(i, 1) = 10.0 * label + static_cast<double>(generator() % 15);
+      // continuous noise
+      m_Features(i, 2) = static_cast<double>(generator()) / generator.max();
+      // weakly informative with fractional values
+      m_Features(i, 3) = 0.25 * label + 0.1 * static_cast<double>(generator() % 9);
+      // constant, cannot be split
+      m_Features(i, 4) = 3.0;
+    }
+  }
+
+  void tearDown() override
+  {
+  }
+
+  void FindBestSplit_AllColumns_HistogramEqualsSorting()
+  {
+    CheckHistogramEqualsSorting(AllSamples(), NumberOfFeatures);
+  }
+
+  void FindBestSplit_SingleColumn_HistogramEqualsSorting()
+  {
+    // only the first randomly chosen column is evaluated, unless it does not improve the node
+    CheckHistogramEqualsSorting(AllSamples(), 1);
+    CheckHistogramEqualsSorting(AllSamples(), 2);
+  }
+
+  void FindBestSplit_SubsetOfSamples_HistogramEqualsSorting()
+  {
+    // a child node: many bins of the whole data set are empty
+    std::vector<vigra::Int32> samples;
+    for (int i = 0; i < NumberOfSamples; i += 3)
+      samples.push_back(i);
+    samples.push_back(1);
+    CheckHistogramEqualsSorting(samples, NumberOfFeatures);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkThresholdSplit)
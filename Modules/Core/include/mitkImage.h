@@ -672,6 +672,16 @@ namespace mitk
     virtual ImageDataItemPointer AllocateChannelData(
       int n = 0, void *data = nullptr, ImportMemoryManagementType importMemoryManagement = CopyMemory) const;
 
+    /** \brief Gives the image an own copy of all image data that it shares with other images
+     * (see ImageDataItem::IsShared()), so that it can be modified (copy-on-write).
+     *
+     * The data items of the image are kept and only moved to the copied memory.
+     * @return true, if any data was copied */
+    bool MakeDataUnique() const;
+
+    /** \brief Returns true, if the image shares any of its data with other images (see MakeDataUnique()). */
+    bool IsDataShared() const;
+
     Image();
 
     Image(const Image &other);
@@ -728,6 +738,8 @@ namespace mitk
     bool IsVolumeSet_unlocked(int t, int n) const;
     bool IsChannelSet_unlocked(int n) const;
 
+    bool MakeDataUnique_unlocked() const;
+
     /** Stores all existing ImageReadAccessors */
     mutable std::vector<ImageAccessorBase *> m_Readers;
     /** Stores all existing ImageWriteAccessors */
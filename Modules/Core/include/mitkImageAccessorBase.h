@@ -141,6 +141,9 @@ namespace mitk
     /** \brief Prevents a recursive mutex lock by comparing thread ids of competing image accessors */
     void PreventRecursiveMutexLock(ImageAccessorBase *iAB);
 
+    /** \brief Returns true, if iAB was created by the calling thread */
+    bool IsOwnedByCurrentThread(const ImageAccessorBase *iAB);
+
     virtual const Image *GetImage() const = 0;
 
   private:
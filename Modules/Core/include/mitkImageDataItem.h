@@ -20,6 +20,9 @@ found in the LICENSE file.
 #include "mitkImageDescriptor.h"
 //#include "mitkImageVtkAccessor.h"
 
+#include <memory>
+#include <vector>
+
 class vtkImageData;
 
 namespace mitk
@@ -42,6 +45,11 @@ namespace mitk
   //## The class is mainly used to extract sub-images inside of mitk::Image, like single slices etc.
   //## It should not be used outside of this.
   //##
+  //## The memory of the image data is reference counted and shared by all items that look at it:
+  //## sub-images reference the memory of their parent item, and copies (see Clone()) reference the memory
+  //## of the item they were copied from. An image that acquires write access to memory that is also
+  //## referenced by another image gets an own copy of it first (copy-on-write, see IsShared()).
+  //##
   //## @param manageMemory Determines if image data is removed while destruction of ImageDataItem or not.
   //## @ingroup Data
   class MITKCORE_EXPORT ImageDataItem : public itk::LightObject
@@ -86,6 +94,8 @@ namespace mitk
                   void *data,
                   bool manageMemory);
 
+    /** Creates an item that shares the memory of \a other. The memory is copied as soon as one of the
+     *  images referencing it is written (copy-on-write). */
     ImageDataItem(const ImageDataItem &other);
 
     /**
@@ -97,7 +107,9 @@ namespace mitk
     int GetOffset() const { return m_Offset; }
     PixelType GetPixelType() const { return *m_PixelType; }
     void SetTimestep(int t) { m_Timestep = t; }
-    void SetManageMemory(bool b) { m_ManageMemory = b; }
+    /** An item that does not manage its memory is a view of the memory of another image: writes through the item
+     *  go into that memory and are not copied on write. */
+    void SetManageMemory(bool b);
     int GetDimension() const { return m_Dimension; }
     int GetDimension(int i) const
     {
@@ -130,6 +142,11 @@ namespace mitk
     size_t GetSize() const { return m_Size; }
     virtual void Modified() const;
 
+    /** Returns true, if the memory of this item is also referenced by another image. Write access through
+     *  ImageWriteAccessor, Image::GetData() and Image::GetVtkImageData() copies shared memory first, direct
+     *  writes via ImageDataItem::GetData() do not. */
+    bool IsShared() const;
+
   protected:
     unsigned char *m_Data;
 
@@ -147,8 +164,26 @@ namespace mitk
     size_t m_Size;
 
   private:
+    struct MemoryBlock;
+    typedef std::shared_ptr<MemoryBlock> MemoryBlockPointer;
+
     void ComputeItemSize(const unsigned int *dimensions, unsigned int dimension);
 
+    /** Lets the item reference data inside of block. A holder references the block on behalf of its image,
+     *  sub-images inside of the same image are no holders. */
+    void SetMemory(const MemoryBlockPointer &block, unsigned char *data, bool isMemoryHolder);
+
+    /** Allocates m_Size bytes through mitk::ImageMemory and lets this item hold them. */
+    void AllocateMemory();
+
+    /** If the memory of this item is shared, copies it and moves this item and all items in itemsOfImage
+     *  that reference parts of it to the copy. Returns true, if the memory was copied. */
+    bool MakeUnique(const std::vector<ImageDataItem *> &itemsOfImage);
+
+    MemoryBlockPointer m_MemoryBlock;
+
+    bool m_IsMemoryHolder;
+
     ImageDataItem::ConstPointer m_Parent;
 
     unsigned int m_Dimension;
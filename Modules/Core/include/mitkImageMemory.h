@@ -0,0 +1,156 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkImageMemory_h
+#define mitkImageMemory_h
+
+#include <MitkCoreExports.h>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace mitk
+{
+  /**
+   * \brief Interface of the allocators used for the pixel buffers of images.
+   *
+   * Allocate() returns nullptr if the memory could not be allocated. Deallocate() is called with the
+   * pointer and the size that were passed to and returned by Allocate() of the same allocator.
+   */
+  class MITKCORE_EXPORT ImageBufferAllocator
+  {
+  public:
+    virtual ~ImageBufferAllocator();
+
+    virtual void *Allocate(std::size_t size) = 0;
+    virtual void Deallocate(void *data, std::size_t size) = 0;
+  };
+
+  /**
+   * \brief Default allocator of image buffers.
+   *
+   * Buffers are aligned to the given alignment (64 bytes by default, which covers a cache line and
+   * AVX-512 vectors). If huge pages are enabled, buffers of at least the huge page threshold are aligned
+   * to 2 MiB and marked for transparent huge page backing (Linux only, ignored elsewhere).
+   */
+  class MITKCORE_EXPORT AlignedImageBufferAllocator : public ImageBufferAllocator
+  {
+  public:
+    static const std::size_t DefaultAlignment = 64;
+    static const std::size_t HugePageSize = 2 * 1024 * 1024;
+
+    explicit AlignedImageBufferAllocator(std::size_t alignment = DefaultAlignment,
+                                         bool useHugePages = false,
+                                         std::size_t hugePageThreshold = 64 * 1024 * 1024);
+
+    void *Allocate(std::size_t size) override;
+    void Deallocate(void *data, std::size_t size) override;
+
+    std::size_t GetAlignment() const { return m_Alignment; }
+    bool GetUseHugePages() const { return m_UseHugePages; }
+    std::size_t GetHugePageThreshold() const { return m_HugePageThreshold; }
+
+  private:
+    std::size_t m_Alignment;
+    bool m_UseHugePages;
+    std::size_t m_HugePageThreshold;
+  };
+
+  /**
+   * \brief Allocation and accounting of the pixel memory of images.
+   *
+   * All buffers allocated by mitk::ImageDataItem are obtained from the allocator set here and accounted
+   * under the category that is active in the allocating thread (see CategoryScope, "Image" by default).
+   * Tools can query the accounted bytes in total or per category.
+   *
+   * If a soft budget is set and an allocation would exceed it, the registered eviction callbacks are
+   * asked to release memory (previews, caches, undo history, ...) before the allocation is done. The
+   * budget is soft: the allocation is done even if the callbacks could not free enough memory. If an
+   * allocation fails, the callbacks are asked to release the requested size and the allocation is
+   * retried once before itk::MemoryAllocationError is thrown.
+   *
+   * Memory passed to images by the caller is not accounted.
+   *
+   * The budget and huge pages can be configured with environment variables, which are read before
+   * the first allocation and by ConfigureFromEnvironment():
+   * - MITK_IMAGE_MEMORY_SOFT_BUDGET: soft budget in MiB
+   * - MITK_IMAGE_MEMORY_HUGE_PAGES: ON or 1 to use huge pages for large buffers (see AlignedImageBufferAllocator)
+   */
+  class MITKCORE_EXPORT ImageMemory
+  {
+  public:
+    /** Memory obtained by Allocate(). It has to be returned with Release(). */
+    struct Allocation
+    {
+      Allocation() : Data(nullptr), Size(0) {}
+
+      unsigned char *Data;
+      std::size_t Size;
+      std::string Category;
+      std::shared_ptr<ImageBufferAllocator> Allocator;
+    };
+
+    /** Is called with the number of bytes that should be released and returns the number of bytes
+     *  that were actually released. Callbacks may release images themselves. */
+    typedef std::function<std::size_t(std::size_t bytesToRelease)> EvictionCallback;
+    typedef unsigned long EvictionCallbackId;
+
+    /** Sets the category of all allocations of the current thread while the scope exists. */
+    class MITKCORE_EXPORT CategoryScope
+    {
+    public:
+      explicit CategoryScope(const std::string &category);
+      ~CategoryScope();
+
+      CategoryScope(const CategoryScope &) = delete;
+      CategoryScope &operator=(const CategoryScope &) = delete;
+
+    private:
+      std::string m_PreviousCategory;
+    };
+
+    /** Allocates size bytes under the current category. Throws itk::MemoryAllocationError on failure. */
+    static Allocation Allocate(std::size_t size);
+
+    /** Returns memory obtained by Allocate() and resets the allocation. */
+    static void Release(Allocation &allocation);
+
+    /** Sets the allocator of all following allocations. nullptr restores the default allocator. */
+    static void SetAllocator(std::shared_ptr<ImageBufferAllocator> allocator);
+    static std::shared_ptr<ImageBufferAllocator> GetAllocator();
+
+    static std::string GetCurrentCategory();
+
+    static std::size_t GetAllocatedBytes();
+    static std::size_t GetAllocatedBytes(const std::string &category);
+    static std::map<std::string, std::size_t> GetAllocatedBytesPerCategory();
+
+    /** Sets the soft budget in bytes. 0 (default) disables the budget. */
+    static void SetSoftBudget(std::size_t bytes);
+    static std::size_t GetSoftBudget();
+
+    static EvictionCallbackId AddEvictionCallback(const EvictionCallback &callback);
+    static void RemoveEvictionCallback(EvictionCallbackId id);
+
+    /** Sets the soft budget and the allocator from the environment variables, if they are set. */
+    static void ConfigureFromEnvironment();
+
+  private:
+    /** Asks the eviction callbacks to release bytesToRelease bytes, returns the number of released bytes. */
+    static std::size_t Evict(std::size_t bytesToRelease);
+  };
+}
+
+#endif
@@ -55,10 +55,17 @@ namespace mitk
     /** \brief manages a consistent write access and locks the ordered image part */
     void OrganizeWriteAccess();
 
+    /** \brief gives the image an own copy of data it shares with other images (copy-on-write).
+     *  Must be called with m_ReadWriteLock locked and without other accessors of the image. */
+    void MakeDataUnique();
+
     ImageWriteAccessor &operator=(const ImageWriteAccessor &); // Not implemented on purpose.
     ImageWriteAccessor(const ImageWriteAccessor &);
 
     ImagePointer m_Image;
+
+    /** the accessed image part, whose memory may move when the image stops sharing it */
+    const ImageDataItem *m_ImageDataItem;
   };
 }
 #endif // MITKIMAGEWRITEACCESSOR_H
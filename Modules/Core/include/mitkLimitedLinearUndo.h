@@ -81,6 +81,10 @@ namespace mitk
     //## @brief Clears the RedoList
     void ClearRedoList() override;
 
+    //##Documentation
+    //## @brief Clears UndoList and RedoList, or marks them to be cleared when the running Undo or Redo returns
+    bool ClearWhenIdle() override;
+
     //##Documentation
     //## @brief True, if RedoList is empty
     bool RedoListEmpty() override;
@@ -135,8 +139,14 @@ namespace mitk
   private:
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
 
+    //## @brief Counts the running Undo/Redo calls and clears the lists after the last one if it was requested
+    class ExecutionScope;
+
     std::size_t m_UndoLimit;
 
+    unsigned int m_ExecutionDepth;
+    bool m_ClearWhenIdle;
+
   };
 
 #pragma GCC visibility push(default)
@@ -0,0 +1,64 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkParallelFor_h
+#define mitkParallelFor_h
+
+#include <MitkCoreExports.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace mitk
+{
+  /**
+   * \brief Calls processItem(i) for every i in [0, numberOfItems) on the threads of a process-wide pool.
+   *
+   * The worker threads of the pool are started with the first call and are reused by all later calls,
+   * so ParallelFor() may be used in code that runs for every update or render pass. The calling thread
+   * processes items as well and the function returns after all items were processed. Items are handed
+   * out one at a time, in ascending order, to the next free thread.
+   *
+   * Calls from several threads at the same time share the pool. Calls from inside of processItem are
+   * allowed; they never wait for a free worker, because the calling thread processes all items that no
+   * worker took.
+   *
+   * If processItem throws, the items that were not started yet are skipped and the first exception is
+   * rethrown on the calling thread after all running items finished.
+   *
+   * \param maximumNumberOfThreads Upper bound of the threads processing the items, including the calling
+   * thread. 0 uses all threads of the pool, 1 processes all items on the calling thread.
+   */
+  MITKCORE_EXPORT void ParallelFor(std::size_t numberOfItems,
+                                   const std::function<void(std::size_t)> &processItem,
+                                   unsigned int maximumNumberOfThreads = 0);
+
+  /**
+   * \brief Calls processItem(i, workerIndex) for every i in [0, numberOfItems), like the overload above.
+   *
+   * workerIndex identifies the thread that processes the item within this call. It is 0 for the calling
+   * thread and less than GetParallelForNumberOfThreads() for all threads. Items with the same index are
+   * never processed at the same time, so processItem may use buffers indexed by workerIndex without
+   * locking, e.g. to reuse them for all items of a thread.
+   */
+  MITKCORE_EXPORT void ParallelFor(std::size_t numberOfItems,
+                                   const std::function<void(std::size_t, unsigned int)> &processItem,
+                                   unsigned int maximumNumberOfThreads = 0);
+
+  /**
+   * \brief Returns the number of threads used by ParallelFor(), including the calling thread. This is
+   * the number of hardware threads, or 1 if it is unknown.
+   */
+  MITKCORE_EXPORT unsigned int GetParallelForNumberOfThreads();
+}
+
+#endif
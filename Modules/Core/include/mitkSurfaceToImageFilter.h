@@ -18,6 +18,8 @@ found in the LICENSE file.
 #include "mitkImageSource.h"
 #include "mitkSurface.h"
 
+#include <vector>
+
 class vtkPolyData;
 
 namespace mitk
@@ -28,17 +30,20 @@ namespace mitk
    * image, which header information defines the output image.
    *
    * The resulting image has the same dimension, size, and Geometry3D
-   * as the input image. The image is cut using a vtkStencil.
-   * The user can decide if he wants to keep the original values or create a
+   * as the input image. The surface is voxelized by a scanline stencil
+   * (vtkPolyDataToImageStencil) that is restricted to the bounding box of the
+   * surface in index space; the inside spans are written in parallel over
+   * the slices of that bounding box.
+   * The user can decide if he wants to keep the pixel type of the input image or create a
    * binary image by setting MakeBinaryOutputOn (default is \a false). If
    * set to \a true all voxels inside the surface are set to one and all
-   * outside voxel are set to zero.
+   * outside voxel are set to zero. Otherwise voxels inside the surface are
+   * set to one and all outside voxels are set to the background value.
    *
-   * NOTE: Since the reference input image is passed to the vtkStencil in
-   * any case, the image needs to be initialized with pixel values greater than
-   * the numerical minimum of the used pixel type (e.g. at least -127 for
-   * unsigned char images, etc.) to produce a correct binary image
-   * representation of the surface in MakeOutputBinary mode.
+   * Several surfaces can be voxelized into one label image in a single update
+   * by adding them with AddSurface(). In binary mode, voxels inside a surface get the label of
+   * that surface (see SetSurfaceLabel() for the surface passed by SetInput()), later surfaces
+   * overwrite earlier ones. Use UShortBinaryPixelTypeOn() for labels larger than 255.
    *
    * @ingroup SurfaceFilters
    * @ingroup Process
@@ -78,6 +83,16 @@ namespace mitk
 
     const mitk::Image *GetImage(void);
 
+    /** \brief Adds a further surface that is voxelized into the same output with the given label. */
+    void AddSurface(const mitk::Surface *surface, unsigned short label);
+
+    /** \brief Label of the surface passed by SetInput() in binary mode (default: 1). */
+    void SetSurfaceLabel(unsigned short label);
+    itkGetConstMacro(SurfaceLabel, unsigned short);
+
+    /** \brief Number of surfaces to voxelize, including the one passed by SetInput(). */
+    unsigned int GetNumberOfSurfaces() const;
+
   protected:
     SurfaceToImageFilter();
 
@@ -85,11 +100,21 @@ namespace mitk
 
     void Stencil3DImage(int time = 0);
 
+    const mitk::Surface *GetSurface(unsigned int index) const;
+
+    unsigned short GetSurfaceLabel(unsigned int index) const;
+
+    /** \brief Writes value into count consecutive pixels (all components) of the given pixel type. */
+    static void FillPixels(const PixelType &pixelType, void *data, std::size_t count, double value);
+
     bool m_MakeOutputBinary;
     bool m_UShortBinaryPixelType;
 
     float m_BackgroundValue;
     double m_Tolerance;
+
+    unsigned short m_SurfaceLabel;
+    std::vector<unsigned short> m_SurfaceLabels;
   };
 
 } // namespace mitk
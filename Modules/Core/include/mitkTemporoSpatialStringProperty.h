@@ -20,7 +20,9 @@ found in the LICENSE file.
 
 #include "mitkTimeGeometry.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace mitk
 {
@@ -29,8 +31,24 @@ namespace mitk
 #pragma warning(disable : 4522)
 #endif
 
+  namespace PropertyPersistenceSerialization
+  {
+    /** Serialization of a TemporoSpatialStringProperty into a JSON string.*/
+    MITKCORE_EXPORT::std::string serializeTemporoSpatialStringPropertyToJSON(const mitk::BaseProperty *prop);
+  }
+
+  namespace PropertyPersistenceDeserialization
+  {
+    /**Deserialize a passed JSON string into a TemporoSpatialStringProperty.*/
+    MITKCORE_EXPORT mitk::BaseProperty::Pointer deserializeJSONToTemporoSpatialStringProperty(const std::string &value);
+  }
+
   /**
    * @brief Property for time and space resolved string values
+   *
+   * The values of a time step are stored as runs of consecutive slices that either share the same value or
+   * hold integers that progress by a constant step (e.g. instance numbers). Values are interned, so equal
+   * strings are stored only once, even across properties. Looking up a slice takes O(log(number of runs)).
    * @ingroup DataManagement
    */
   class MITKCORE_EXPORT TemporoSpatialStringProperty : public BaseProperty
@@ -90,8 +108,19 @@ namespace mitk
     using BaseProperty::operator=;
 
   protected:
-    typedef std::map<IndexValueType, std::string> SliceMapType;
-    typedef std::map<TimeStepType, SliceMapType> TimeMapType;
+    /** Consecutive slices [First, Last] with identical values (Step == 0) or with integer values that
+     *  progress by Step from slice to slice. Value is the interned value of the first slice. */
+    struct SliceRun
+    {
+      IndexValueType First;
+      IndexValueType Last;
+      std::shared_ptr<const std::string> Value;
+      bool IsNumeric;
+      long long Number;
+      long long Step;
+    };
+    typedef std::vector<SliceRun> SliceRunsType;
+    typedef std::map<TimeStepType, SliceRunsType> TimeMapType;
 
     TimeMapType m_Values;
 
@@ -105,7 +134,17 @@ namespace mitk
                                           bool allowCloseTime = false,
                                           bool allowCloseSlice = false) const;
 
+    /** Returns the run that contains slice, nullptr if there is none. */
+    static const SliceRun *FindRun(const SliceRunsType &runs, const IndexValueType &slice);
+    static ValueType GetRunValue(const SliceRun &run, const IndexValueType &slice);
+    static void SetRunsValue(SliceRunsType &runs, const IndexValueType &slice, const ValueType &value);
+
   private:
+    friend ::std::string PropertyPersistenceSerialization::serializeTemporoSpatialStringPropertyToJSON(
+      const mitk::BaseProperty *prop);
+    friend mitk::BaseProperty::Pointer PropertyPersistenceDeserialization::deserializeJSONToTemporoSpatialStringProperty(
+      const std::string &value);
+
     // purposely not implemented
     TemporoSpatialStringProperty &operator=(const TemporoSpatialStringProperty &);
 
@@ -115,18 +154,6 @@ namespace mitk
     bool Assign(const BaseProperty &property) override;
   };
 
-  namespace PropertyPersistenceSerialization
-  {
-    /** Serialization of a TemporoSpatialStringProperty into a JSON string.*/
-    MITKCORE_EXPORT::std::string serializeTemporoSpatialStringPropertyToJSON(const mitk::BaseProperty *prop);
-  }
-
-  namespace PropertyPersistenceDeserialization
-  {
-    /**Deserialize a passed JSON string into a TemporoSpatialStringProperty.*/
-    MITKCORE_EXPORT mitk::BaseProperty::Pointer deserializeJSONToTemporoSpatialStringProperty(const std::string &value);
-  }
-
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
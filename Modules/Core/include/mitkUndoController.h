@@ -116,6 +116,19 @@ namespace mitk
     //## especially to retrieve text descriptions of the undo/redo stack
     static UndoModel *GetCurrentUndoModel();
 
+    //##Documentation
+    //## @brief Category of the image memory held by undo operations (see mitk::ImageMemory::CategoryScope)
+    static const char *const ImageMemoryCategory;
+
+    //##Documentation
+    //## @brief Clears the undo and redo lists of all UndoModels if they hold image memory
+    //##
+    //## Eviction callback for mitk::ImageMemory. The UndoModels are not thread-safe, so this may only be
+    //## called from the thread that uses them. If the allocation happens during an Undo or Redo, the lists
+    //## of that UndoModel are cleared after it returned (see UndoModel::ClearWhenIdle()).
+    //## @return the number of released bytes of image memory
+    static std::size_t ReleaseImageMemory(std::size_t bytesToRelease);
+
   private:
     //##Documentation
     //## current selected UndoModel
@@ -48,6 +48,18 @@ namespace mitk
     //## @brief clears undo and Redolist
     virtual void Clear() = 0;
 
+    //##Documentation
+    //## @brief Clears undo and RedoList, unless an Undo or Redo of this model is running
+    //##
+    //## While operations of the model are executed, the lists are only marked and cleared after the
+    //## execution returned, so no executing OperationEvent is deleted. The default implementation calls Clear().
+    //## @return true if the lists were cleared right away
+    virtual bool ClearWhenIdle()
+    {
+      this->Clear();
+      return true;
+    }
+
     //##Documentation
     //## @brief clears the RedoList
     virtual void ClearRedoList() = 0;
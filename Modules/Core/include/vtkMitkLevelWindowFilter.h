@@ -18,6 +18,8 @@ class vtkPiecewiseFunction;
 #include <vtkImageData.h>
 #include <vtkThreadedImageAlgorithm.h>
 
+#include <vector>
+
 #include <MitkCoreExports.h>
 /** Documentation
 * \brief Applies the grayvalue or color/opacity level window to scalar or RGB(A) images.
@@ -28,6 +30,15 @@ class vtkPiecewiseFunction;
 *
 * The filter is also able to apply an opacity level window to RGBA images.
 *
+* Scalar pixels are mapped with vtkScalarsToColors::MapValue(), so the below range, above range and NaN
+* colors of a vtkLookupTable are used. A vtkColorTransferFunction is combined with the opacity function.
+* For images with 8 or 16 bit integer pixels the mapping of every possible value is baked into a dense
+* RGBA table before the threads are started. For all other pixel types and a linear vtkLookupTable, the
+* colors of the lookup table are copied into a quantized table with additional below range, above range
+* and NaN entries, which is indexed like vtkLookupTable::MapValue() does. The tables are only rebuilt if
+* the pixel type or the lookup table changed, e.g. not while scrolling through slices. Other lookup tables
+* (e.g. logarithmic or indexed ones) are mapped per pixel.
+*
 * \ingroup Renderer
 */
 class MITKCORE_EXPORT vtkMitkLevelWindowFilter : public vtkThreadedImageAlgorithm
@@ -79,6 +90,11 @@ protected:
   int RequestInformation(vtkInformation *request,
                          vtkInformationVector **inputVector,
                          vtkInformationVector *outputVector) override;
+  /** \brief Bakes the lookup table for the scalar type of the input before the threads are started. */
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
   //  /** Standard VTK filter method to apply the filter. See VTK documentation. Not used at the moment.*/
   //  void ExecuteInformation(vtkImageData *vtkNotUsed(inData), vtkImageData *vtkNotUsed(outData));
 
@@ -93,5 +109,38 @@ private:
   double m_MaxOpacity;
 
   double m_ClippingBounds[4];
+
+  /** \brief Fills m_BakedTable for the given scalar type if the lookup table or the type changed.
+   * Returns false if the type is not baked (all types except 8 and 16 bit integers). */
+  bool BakeLookupTable(int scalarType);
+  /** \brief Fills m_QuantizedTable if the lookup table changed. Returns false if the lookup table is
+   * not a linear vtkLookupTable. Then the lookup table is applied per pixel. */
+  bool BuildQuantizedLookupTable();
+  /** \brief Latest modification time of the lookup table and the opacity function, including setting them. */
+  vtkMTimeType GetLookupTableMTime();
+  /** \brief Maps a scalar value to its RGBA value exactly like the per pixel mapping, packed in the
+   * byte order of the output. */
+  vtkTypeUInt32 MapScalarToRGBA(double value);
+
+  /** RGBA values of the baked lookup table, one entry per value of the scalar type. */
+  std::vector<vtkTypeUInt32> m_BakedTable;
+  /** Scalar type m_BakedTable was built for, -1 if it is not valid. */
+  int m_BakedTableScalarType;
+  /** Time m_BakedTable was built. */
+  vtkTimeStamp m_BakedTableTime;
+
+  /** Colors of the linear lookup table, followed by the below range, above range and NaN colors. */
+  std::vector<vtkTypeUInt32> m_QuantizedTable;
+  /** Table range, shift and scale of the value to index mapping of m_QuantizedTable. */
+  double m_QuantizedTableRange[2];
+  double m_QuantizedTableShift;
+  double m_QuantizedTableScale;
+  /** Whether m_QuantizedTable is valid for the current lookup table. */
+  bool m_QuantizedTableValid;
+  /** Time m_QuantizedTable was built. */
+  vtkTimeStamp m_QuantizedTableTime;
+
+  /** Time the lookup table or the opacity function were set. */
+  vtkTimeStamp m_LookupTableSetTime;
 };
 #endif
@@ -68,6 +68,7 @@ void mitk::ImageTimeSelector::GenerateData()
   // do we really need a complete volume at a time?
   if (requestedRegion.GetSize(2) > 1)
   {
+    // the output is a view of the input memory: filters write their results through it
     mitk::ImageDataItem::Pointer im = this->GetVolumeData(m_TimeNr, m_ChannelNr)->Clone();
     im->SetTimestep(0);
     im->SetManageMemory(false);
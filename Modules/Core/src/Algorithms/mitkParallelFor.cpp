@@ -0,0 +1,193 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  /** Items of one ParallelFor() call. Lives on the stack of the calling thread. */
+  struct Job
+  {
+    Job(std::size_t numberOfItems,
+        const std::function<void(std::size_t, unsigned int)> &processItem,
+        unsigned int maximumNumberOfHelpers)
+      : NumberOfItems(numberOfItems),
+        ProcessItem(processItem),
+        NextItem(0),
+        MaximumNumberOfHelpers(maximumNumberOfHelpers),
+        NumberOfHelpers(0),
+        NumberOfActiveHelpers(0)
+    {
+    }
+
+    void Process(unsigned int workerIndex)
+    {
+      for (std::size_t i = NextItem++; i < NumberOfItems; i = NextItem++)
+      {
+        try
+        {
+          ProcessItem(i, workerIndex);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> guard(ErrorMutex);
+          if (!Error)
+            Error = std::current_exception();
+          NextItem = NumberOfItems;
+        }
+      }
+    }
+
+    const std::size_t NumberOfItems;
+    const std::function<void(std::size_t, unsigned int)> &ProcessItem;
+    std::atomic<std::size_t> NextItem;
+
+    // guarded by the mutex of the pool, the helpers are numbered from 1 in the order they join
+    const unsigned int MaximumNumberOfHelpers;
+    unsigned int NumberOfHelpers;
+    unsigned int NumberOfActiveHelpers;
+    std::condition_variable HelpersFinished;
+
+    std::mutex ErrorMutex;
+    std::exception_ptr Error;
+  };
+
+  class ThreadPool
+  {
+  public:
+    static ThreadPool &GetInstance()
+    {
+      static ThreadPool pool;
+      return pool;
+    }
+
+    static unsigned int GetNumberOfHardwareThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+    /** Processes the items of job on the calling thread and on up to job.MaximumNumberOfHelpers workers. */
+    void Run(Job &job)
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_Mutex);
+        m_Jobs.push_back(&job);
+      }
+
+      const auto numberOfHelpers = std::min<std::size_t>(job.MaximumNumberOfHelpers, m_Workers.size());
+      for (std::size_t i = 0; i < numberOfHelpers; ++i)
+        m_WorkAvailable.notify_one();
+
+      job.Process(0);
+
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      auto position = std::find(m_Jobs.begin(), m_Jobs.end(), &job);
+      if (position != m_Jobs.end())
+        m_Jobs.erase(position);
+
+      job.HelpersFinished.wait(lock, [&job] { return job.NumberOfActiveHelpers == 0; });
+    }
+
+  private:
+    ThreadPool() : m_Stop(false)
+    {
+      const unsigned int numberOfWorkers = GetNumberOfHardwareThreads() - 1;
+      m_Workers.reserve(numberOfWorkers);
+      for (unsigned int i = 0; i < numberOfWorkers; ++i)
+        m_Workers.emplace_back(&ThreadPool::Work, this);
+    }
+
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_Mutex);
+        m_Stop = true;
+      }
+      m_WorkAvailable.notify_all();
+
+      for (auto &worker : m_Workers)
+        worker.join();
+    }
+
+    void Work()
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      while (true)
+      {
+        m_WorkAvailable.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+        if (m_Stop)
+          return;
+
+        Job *job = m_Jobs.front();
+        ++job->NumberOfActiveHelpers;
+        const unsigned int workerIndex = ++job->NumberOfHelpers;
+        if (workerIndex >= job->MaximumNumberOfHelpers)
+          m_Jobs.pop_front();
+
+        lock.unlock();
+        job->Process(workerIndex);
+        lock.lock();
+
+        // the calling thread of the job waits for this notification before it releases the job
+        if (--job->NumberOfActiveHelpers == 0)
+          job->HelpersFinished.notify_all();
+      }
+    }
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::deque<Job *> m_Jobs;
+    bool m_Stop;
+    std::vector<std::thread> m_Workers;
+  };
+}
+
+void mitk::ParallelFor(std::size_t numberOfItems,
+                       const std::function<void(std::size_t)> &processItem,
+                       unsigned int maximumNumberOfThreads)
+{
+  ParallelFor(numberOfItems, [&processItem](std::size_t i, unsigned int) { processItem(i); }, maximumNumberOfThreads);
+}
+
+void mitk::ParallelFor(std::size_t numberOfItems,
+                       const std::function<void(std::size_t, unsigned int)> &processItem,
+                       unsigned int maximumNumberOfThreads)
+{
+  auto numberOfThreads = static_cast<std::size_t>(ThreadPool::GetNumberOfHardwareThreads());
+  if (maximumNumberOfThreads != 0)
+    numberOfThreads = std::min<std::size_t>(numberOfThreads, maximumNumberOfThreads);
+  numberOfThreads = std::min(numberOfThreads, numberOfItems);
+
+  if (numberOfThreads < 2)
+  {
+    for (std::size_t i = 0; i < numberOfItems; ++i)
+      processItem(i, 0);
+    return;
+  }
+
+  Job job(numberOfItems, processItem, static_cast<unsigned int>(numberOfThreads - 1));
+  ThreadPool::GetInstance().Run(job);
+
+  if (job.Error)
+    std::rethrow_exception(job.Error);
+}
+
+unsigned int mitk::GetParallelForNumberOfThreads()
+{
+  return ThreadPool::GetNumberOfHardwareThreads();
+}
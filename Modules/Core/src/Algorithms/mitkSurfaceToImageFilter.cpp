@@ -13,11 +13,10 @@ found in the LICENSE file.
 #include "mitkSurfaceToImageFilter.h"
 #include "mitkImageWriteAccessor.h"
 #include "mitkTimeHelper.h"
-#include <mitkImageReadAccessor.h>
+#include <mitkExceptionMacro.h>
+#include <mitkParallelFor.h>
 
-#include <vtkImageData.h>
-#include <vtkImageStencil.h>
-#include <vtkPointData.h>
+#include <vtkImageStencilData.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyDataToImageStencil.h>
@@ -25,8 +24,17 @@ found in the LICENSE file.
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 mitk::SurfaceToImageFilter::SurfaceToImageFilter()
-  : m_MakeOutputBinary(false), m_UShortBinaryPixelType(false), m_BackgroundValue(-10000), m_Tolerance(0.0)
+  : m_MakeOutputBinary(false),
+    m_UShortBinaryPixelType(false),
+    m_BackgroundValue(-10000),
+    m_Tolerance(0.0),
+    m_SurfaceLabel(1)
 {
 }
 
@@ -105,61 +113,69 @@ void mitk::SurfaceToImageFilter::GenerateData()
 void mitk::SurfaceToImageFilter::Stencil3DImage(int time)
 {
   mitk::Image::Pointer output = this->GetOutput();
-  mitk::Image::Pointer binaryImage = mitk::Image::New();
 
-  unsigned int size = sizeof(unsigned char);
-  if (m_MakeOutputBinary)
-  {
-    if (m_UShortBinaryPixelType)
-    {
-      binaryImage->Initialize(mitk::MakeScalarPixelType<unsigned short>(), *this->GetImage()->GetTimeGeometry(), 1, 1);
-      size = sizeof(unsigned short);
-    }
-    else
-    {
-      binaryImage->Initialize(mitk::MakeScalarPixelType<unsigned char>(), *this->GetImage()->GetTimeGeometry(), 1, 1);
-    }
-  }
-  else
-  {
-    binaryImage->Initialize(this->GetImage()->GetPixelType(), *this->GetImage()->GetTimeGeometry(), 1, 1);
-    size = this->GetImage()->GetPixelType().GetSize();
-  }
+  const PixelType pixelType = output->GetPixelType();
+  const std::size_t pixelSize = pixelType.GetSize();
+  const int dimensions[3] = {static_cast<int>(output->GetDimension(0)),
+                             static_cast<int>(output->GetDimension(1)),
+                             static_cast<int>(output->GetDimension(2))};
+  const std::size_t numberOfPixels = static_cast<std::size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
 
-  for (unsigned int i = 0; i < binaryImage->GetDimension(); ++i)
-  {
-    size *= binaryImage->GetDimension(i);
-  }
+  mitk::ImageWriteAccessor accessor(output, output->GetVolumeData(time));
+  auto *outputData = static_cast<char *>(accessor.GetData());
 
-  mitk::ImageWriteAccessor accessor(binaryImage);
-  memset(accessor.GetData(), 1, size);
+  // everything outside of the surfaces is background
+  FillPixels(pixelType, outputData, numberOfPixels, m_MakeOutputBinary ? 0.0 : m_BackgroundValue);
 
-  const mitk::TimeGeometry *surfaceTimeGeometry = GetInput()->GetTimeGeometry();
   const mitk::TimeGeometry *imageTimeGeometry = GetImage()->GetTimeGeometry();
+  const mitk::TimePointType matchingTimePoint = imageTimeGeometry->TimeStepToTimePoint(time);
 
-  // Convert time step from image time-frame to surface time-frame
-  mitk::TimePointType matchingTimePoint = imageTimeGeometry->TimeStepToTimePoint(time);
-  mitk::TimeStepType surfaceTimeStep = surfaceTimeGeometry->TimePointToTimeStep(matchingTimePoint);
-
-  vtkPolyData *polydata = ((mitk::Surface *)GetInput())->GetVtkPolyData(surfaceTimeStep);
-  if (polydata)
+  for (unsigned int surfaceIndex = 0; surfaceIndex < this->GetNumberOfSurfaces(); ++surfaceIndex)
   {
+    const mitk::Surface *surface = this->GetSurface(surfaceIndex);
+    if (surface == nullptr)
+      continue;
+
+    // Convert time step from image time-frame to surface time-frame
+    const mitk::TimeGeometry *surfaceTimeGeometry = surface->GetTimeGeometry();
+    mitk::TimeStepType surfaceTimeStep = surfaceTimeGeometry->TimePointToTimeStep(matchingTimePoint);
+
+    vtkPolyData *polydata = const_cast<mitk::Surface *>(surface)->GetVtkPolyData(surfaceTimeStep);
+    if (polydata == nullptr || polydata->GetNumberOfPoints() == 0)
+      continue;
+
     vtkSmartPointer<vtkTransformPolyDataFilter> move = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
     move->SetInputData(polydata);
-    move->ReleaseDataFlagOn();
 
     vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
     BaseGeometry *geometry = surfaceTimeGeometry->GetGeometryForTimeStep(surfaceTimeStep);
     if (!geometry)
     {
-      geometry = GetInput()->GetGeometry();
+      geometry = surface->GetGeometry();
     }
     transform->PostMultiply();
     transform->Concatenate(geometry->GetVtkTransform()->GetMatrix());
-    // take image geometry into account. vtk-Image information will be changed to unit spacing and zero origin below.
+    // take image geometry into account, the surface is voxelized in index coordinates (unit spacing, zero origin)
     BaseGeometry *imageGeometry = imageTimeGeometry->GetGeometryForTimeStep(time);
     transform->Concatenate(imageGeometry->GetVtkTransform()->GetLinearInverse());
     move->SetTransform(transform);
+    move->Update();
+
+    // only the bounding box of the surface in index space has to be voxelized
+    double bounds[6];
+    move->GetOutput()->GetBounds(bounds);
+
+    int extent[6];
+    bool empty = false;
+    for (int i = 0; i < 3; ++i)
+    {
+      extent[2 * i] = std::max(0, static_cast<int>(std::floor(bounds[2 * i] - m_Tolerance)));
+      extent[2 * i + 1] = std::min(dimensions[i] - 1, static_cast<int>(std::ceil(bounds[2 * i + 1] + m_Tolerance)));
+      empty = empty || extent[2 * i] > extent[2 * i + 1];
+    }
+
+    if (empty)
+      continue;
 
     vtkSmartPointer<vtkPolyDataNormals> normalsFilter = vtkSmartPointer<vtkPolyDataNormals>::New();
     normalsFilter->SetFeatureAngle(50);
@@ -172,38 +188,76 @@ void mitk::SurfaceToImageFilter::Stencil3DImage(int time)
 
     vtkSmartPointer<vtkPolyDataToImageStencil> surfaceConverter = vtkSmartPointer<vtkPolyDataToImageStencil>::New();
     surfaceConverter->SetTolerance(m_Tolerance);
-    surfaceConverter->ReleaseDataFlagOn();
-
+    surfaceConverter->SetOutputOrigin(0.0, 0.0, 0.0);
+    surfaceConverter->SetOutputSpacing(1.0, 1.0, 1.0);
+    surfaceConverter->SetOutputWholeExtent(extent);
     surfaceConverter->SetInputConnection(normalsFilter->GetOutputPort());
+    surfaceConverter->Update();
+
+    vtkImageStencilData *stencil = surfaceConverter->GetOutput();
+
+    // the foreground value is prepared once, spans of inside voxels are filled by copying it
+    std::vector<char> foreground(pixelSize);
+    FillPixels(pixelType, foreground.data(), 1, m_MakeOutputBinary ? this->GetSurfaceLabel(surfaceIndex) : 1.0);
+
+    // scanline spans of the stencil are written in parallel over the slices of the bounding box
+    const int numberOfSlices = std::max(0, extent[5] - extent[4] + 1);
+    mitk::ParallelFor(numberOfSlices, [&](std::size_t slice) {
+      const int z = extent[4] + static_cast<int>(slice);
+      for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+        char *row = outputData + (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0] * pixelSize;
+        int iter = 0;
+        int r1, r2;
+
+        while (stencil->GetNextExtent(r1, r2, extent[0], extent[1], y, z, iter))
+        {
+          for (int x = r1; x <= r2; ++x)
+            std::memcpy(row + x * pixelSize, foreground.data(), pixelSize);
+        }
+      }
+    });
+  }
+}
 
-    vtkImageData *image = m_MakeOutputBinary ? binaryImage->GetVtkImageData() :
-                                               const_cast<mitk::Image *>(this->GetImage())->GetVtkImageData(time);
-
-    // fill the image with foreground voxels:
-    unsigned char inval = 1;
-    vtkIdType count = image->GetNumberOfPoints();
-    for (vtkIdType i = 0; i < count; ++i)
-    {
-      image->GetPointData()->GetScalars()->SetTuple1(i, inval);
-    }
-
-    // Create stencil and use numerical minimum of pixel type as background value
-    vtkSmartPointer<vtkImageStencil> stencil = vtkSmartPointer<vtkImageStencil>::New();
-    stencil->SetInputData(image);
-    stencil->ReverseStencilOff();
-    stencil->ReleaseDataFlagOn();
-    stencil->SetStencilConnection(surfaceConverter->GetOutputPort());
-
-    stencil->SetBackgroundValue(m_MakeOutputBinary ? 0 : m_BackgroundValue);
-    stencil->Update();
+void mitk::SurfaceToImageFilter::FillPixels(const PixelType &pixelType, void *data, std::size_t count, double value)
+{
+  const std::size_t numberOfValues = count * pixelType.GetNumberOfComponents();
 
-    output->SetVolume(stencil->GetOutput()->GetScalarPointer(), time);
-    MITK_INFO << "stencil ref count: " << stencil->GetReferenceCount() << std::endl;
-  }
-  else
+  switch (pixelType.GetComponentType())
   {
-    memset(accessor.GetData(), 0, size);
-    output->SetVolume(accessor.GetData(), time);
+    case itk::ImageIOBase::CHAR:
+      std::fill_n(static_cast<char *>(data), numberOfValues, static_cast<char>(value));
+      break;
+    case itk::ImageIOBase::UCHAR:
+      std::fill_n(static_cast<unsigned char *>(data), numberOfValues, static_cast<unsigned char>(value));
+      break;
+    case itk::ImageIOBase::SHORT:
+      std::fill_n(static_cast<short *>(data), numberOfValues, static_cast<short>(value));
+      break;
+    case itk::ImageIOBase::USHORT:
+      std::fill_n(static_cast<unsigned short *>(data), numberOfValues, static_cast<unsigned short>(value));
+      break;
+    case itk::ImageIOBase::INT:
+      std::fill_n(static_cast<int *>(data), numberOfValues, static_cast<int>(value));
+      break;
+    case itk::ImageIOBase::UINT:
+      std::fill_n(static_cast<unsigned int *>(data), numberOfValues, static_cast<unsigned int>(value));
+      break;
+    case itk::ImageIOBase::LONG:
+      std::fill_n(static_cast<long *>(data), numberOfValues, static_cast<long>(value));
+      break;
+    case itk::ImageIOBase::ULONG:
+      std::fill_n(static_cast<unsigned long *>(data), numberOfValues, static_cast<unsigned long>(value));
+      break;
+    case itk::ImageIOBase::FLOAT:
+      std::fill_n(static_cast<float *>(data), numberOfValues, static_cast<float>(value));
+      break;
+    case itk::ImageIOBase::DOUBLE:
+      std::fill_n(static_cast<double *>(data), numberOfValues, value);
+      break;
+    default:
+      mitkThrow() << "Pixel component type not supported!";
   }
 }
 
@@ -217,6 +271,41 @@ const mitk::Surface *mitk::SurfaceToImageFilter::GetInput(void)
   return static_cast<const mitk::Surface *>(this->ProcessObject::GetInput(0));
 }
 
+void mitk::SurfaceToImageFilter::AddSurface(const mitk::Surface *surface, unsigned short label)
+{
+  // input 1 is reserved for the reference image, additional surfaces start at index 2
+  const unsigned int index = std::max(2u, static_cast<unsigned int>(this->GetNumberOfIndexedInputs()));
+  this->ProcessObject::SetNthInput(index, const_cast<mitk::Surface *>(surface));
+
+  m_SurfaceLabels.resize(index - 1, 1);
+  m_SurfaceLabels[index - 2] = label;
+}
+
+void mitk::SurfaceToImageFilter::SetSurfaceLabel(unsigned short label)
+{
+  if (m_SurfaceLabel != label)
+  {
+    m_SurfaceLabel = label;
+    this->Modified();
+  }
+}
+
+unsigned int mitk::SurfaceToImageFilter::GetNumberOfSurfaces() const
+{
+  const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+  return numberOfInputs > 2 ? numberOfInputs - 1 : std::min(numberOfInputs, 1u);
+}
+
+const mitk::Surface *mitk::SurfaceToImageFilter::GetSurface(unsigned int index) const
+{
+  return static_cast<const mitk::Surface *>(this->ProcessObject::GetInput(index == 0 ? 0 : index + 1));
+}
+
+unsigned short mitk::SurfaceToImageFilter::GetSurfaceLabel(unsigned int index) const
+{
+  return index == 0 ? m_SurfaceLabel : m_SurfaceLabels[index - 1];
+}
+
 void mitk::SurfaceToImageFilter::SetInput(const mitk::Surface *input)
 {
   // Process object is not const-correct so the const_cast is required here
@@ -13,8 +13,26 @@ found in the LICENSE file.
 #include "mitkLimitedLinearUndo.h"
 #include <mitkRenderingManager.h>
 
+class mitk::LimitedLinearUndo::ExecutionScope
+{
+public:
+  explicit ExecutionScope(LimitedLinearUndo *undoModel) : m_UndoModel(undoModel) { ++m_UndoModel->m_ExecutionDepth; }
+
+  ~ExecutionScope()
+  {
+    if (--m_UndoModel->m_ExecutionDepth == 0 && m_UndoModel->m_ClearWhenIdle)
+    {
+      m_UndoModel->m_ClearWhenIdle = false;
+      m_UndoModel->Clear();
+    }
+  }
+
+private:
+  LimitedLinearUndo *m_UndoModel;
+};
+
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_ExecutionDepth(0), m_ClearWhenIdle(false)
 {
   // nothing to do
 }
@@ -92,6 +110,9 @@ bool mitk::LimitedLinearUndo::Undo(int oeid)
   if (m_UndoList.empty())
     return false;
 
+  // the executed operations may allocate image memory, which may ask to clear this history
+  ExecutionScope executionScope(this);
+
   bool rc = true;
   do
   {
@@ -133,6 +154,8 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
   if (m_RedoList.empty())
     return false;
 
+  ExecutionScope executionScope(this);
+
   do
   {
     m_RedoList.back()->ReverseAndExecute();
@@ -162,6 +185,18 @@ void mitk::LimitedLinearUndo::Clear()
   InvokeEvent(RedoEmptyEvent());
 }
 
+bool mitk::LimitedLinearUndo::ClearWhenIdle()
+{
+  if (m_ExecutionDepth > 0)
+  {
+    m_ClearWhenIdle = true;
+    return false;
+  }
+
+  this->Clear();
+  return true;
+}
+
 void mitk::LimitedLinearUndo::ClearRedoList()
 {
   this->ClearList(&m_RedoList);
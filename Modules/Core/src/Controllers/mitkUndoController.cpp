@@ -11,16 +11,21 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkUndoController.h"
+#include "mitkImageMemory.h"
 #include "mitkInteractionConst.h"
 #include "mitkLimitedLinearUndo.h"
 #include "mitkRenderingManager.h"
 #include "mitkVerboseLimitedLinearUndo.h"
 
+#include <mitkLogMacros.h>
+
 // static member-variables init.
 mitk::UndoModel::Pointer mitk::UndoController::m_CurUndoModel;
 mitk::UndoController::UndoModelMap mitk::UndoController::m_UndoModelList;
 mitk::UndoController::UndoType mitk::UndoController::m_CurUndoType;
 
+const char *const mitk::UndoController::ImageMemoryCategory = "Undo";
+
 // const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = LIMITEDLINEARUNDO;
 const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = VERBOSE_LIMITEDLINEARUNDO;
 
@@ -211,3 +216,22 @@ mitk::UndoModel *mitk::UndoController::GetCurrentUndoModel()
 {
   return m_CurUndoModel;
 }
+
+std::size_t mitk::UndoController::ReleaseImageMemory(std::size_t)
+{
+  const std::size_t heldBytes = ImageMemory::GetAllocatedBytes(ImageMemoryCategory);
+  if (heldBytes == 0)
+    return 0;
+
+  // an undo or redo that is running right now is finished first, its history is cleared afterwards
+  bool deferred = false;
+  for (auto &undoModel : m_UndoModelList)
+    deferred = !undoModel.second->ClearWhenIdle() || deferred;
+
+  const std::size_t remainingBytes = ImageMemory::GetAllocatedBytes(ImageMemoryCategory);
+  const std::size_t releasedBytes = heldBytes > remainingBytes ? heldBytes - remainingBytes : 0;
+  MITK_WARN << "Cleared the undo history to release " << releasedBytes << " bytes of image memory."
+            << (deferred ? " The history of a running undo/redo is cleared when it returns." : "");
+
+  return releasedBytes;
+}
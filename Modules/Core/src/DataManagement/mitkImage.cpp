@@ -68,22 +68,16 @@ mitk::Image::Image(const Image &other)
   TimeGeometry::Pointer cloned = other.GetTimeGeometry()->Clone();
   this->SetTimeGeometry(cloned.GetPointer());
 
-  if (this->GetDimension() > 3)
-  {
-    const unsigned int time_steps = this->GetDimension(3);
-
-    for (unsigned int i = 0u; i < time_steps; ++i)
-    {
-      ImageDataItemPointer volume = other.GetVolumeData(i);
+  // The volumes share the memory of other until one of the images is written (copy-on-write)
+  const unsigned int time_steps = this->GetDimension() > 3 ? this->GetDimension(3) : 1;
 
-      this->SetVolume(volume->GetData(), i);
-    }
-  }
-  else
+  for (unsigned int i = 0u; i < time_steps; ++i)
   {
-    ImageDataItemPointer volume = other.GetVolumeData(0);
+    ImageDataItemPointer volume = other.GetVolumeData(i);
 
-    this->SetVolume(volume->GetData(), 0);
+    ImageDataItemPointer sharedVolume = volume->Clone();
+    m_Volumes[this->GetVolumeIndex(i)] = sharedVolume;
+    this->m_ImageDescriptor->GetChannelDescriptor(0).SetData(sharedVolume->GetData());
   }
 }
 
@@ -126,6 +120,9 @@ void *mitk::Image::GetData()
   }
   m_CompleteData = GetChannelData();
 
+  // the caller may write through the returned pointer
+  MakeDataUnique();
+
   // update channel's data
   // if data was not available at creation point, the m_Data of channel descriptor is nullptr
   // if data present, it won't be overwritten
@@ -224,7 +221,12 @@ vtkImageData *mitk::Image::GetVtkImageData(int t, int n)
       GetSource()->UpdateOutputInformation();
   }
   ImageDataItemPointer volume = GetVolumeData(t, n);
-  return volume.GetPointer() == nullptr ? nullptr : volume->GetVtkImageAccessor(this)->GetVtkImageData();
+  if (volume.GetPointer() == nullptr)
+    return nullptr;
+
+  // the caller may write through the returned vtkImageData
+  MakeDataUnique();
+  return volume->GetVtkImageAccessor(this)->GetVtkImageData();
 }
 
 const vtkImageData *mitk::Image::GetVtkImageData(int t, int n) const
@@ -682,6 +684,9 @@ bool mitk::Image::SetImportSlice(void *data, int s, int t, int n, ImportMemoryMa
 {
   if (IsValidSlice(s, t, n) == false)
     return false;
+
+  // the data is written below, so it must not be shared with other images
+  MakeDataUnique();
   ImageDataItemPointer sl;
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
@@ -718,6 +723,9 @@ bool mitk::Image::SetImportVolume(void *data, int t, int n, ImportMemoryManageme
   if (IsValidVolume(t, n) == false)
     return false;
 
+  // the data is written below, so it must not be shared with other images
+  MakeDataUnique();
+
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
   ImageDataItemPointer vol;
   if (IsVolumeSet(t, n))
@@ -763,6 +771,9 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   if (IsValidChannel(n) == false)
     return false;
 
+  // the data is written below, so it must not be shared with other images
+  MakeDataUnique();
+
   // channel descriptor
 
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
@@ -1306,6 +1317,49 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateChannelData_unlocked(
   return ch;
 }
 
+bool mitk::Image::MakeDataUnique() const
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  return MakeDataUnique_unlocked();
+}
+
+bool mitk::Image::IsDataShared() const
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  for (const ImageDataItemPointerArray *itemArray : {&m_Channels, &m_Volumes, &m_Slices})
+  {
+    for (const auto &item : *itemArray)
+    {
+      if (item.IsNotNull() && item->IsShared())
+        return true;
+    }
+  }
+  return m_CompleteData.IsNotNull() && m_CompleteData->IsShared();
+}
+
+bool mitk::Image::MakeDataUnique_unlocked() const
+{
+  std::vector<ImageDataItem *> items;
+  for (const ImageDataItemPointerArray *itemArray : {&m_Channels, &m_Volumes, &m_Slices})
+  {
+    for (const auto &item : *itemArray)
+    {
+      if (item.IsNotNull())
+        items.push_back(item.GetPointer());
+    }
+  }
+  if (m_CompleteData.IsNotNull())
+    items.push_back(m_CompleteData.GetPointer());
+
+  bool copied = false;
+  for (ImageDataItem *item : items)
+  {
+    if (item->MakeUnique(items))
+      copied = true;
+  }
+  return copied;
+}
+
 unsigned int *mitk::Image::GetDimensions() const
 {
   return m_Dimensions;
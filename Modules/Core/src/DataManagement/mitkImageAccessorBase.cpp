@@ -182,3 +182,8 @@ void mitk::ImageAccessorBase::PreventRecursiveMutexLock(mitk::ImageAccessorBase
   }
 #endif
 }
+
+bool mitk::ImageAccessorBase::IsOwnedByCurrentThread(const ImageAccessorBase *iAB)
+{
+  return CompareThreadHandles(CurrentThreadHandle(), iAB->m_Thread);
+}
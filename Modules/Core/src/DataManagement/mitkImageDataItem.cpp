@@ -11,7 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkImageDataItem.h"
-#include "mitkMemoryUtilities.h"
+#include "mitkImageMemory.h"
 #include <vtkImageData.h>
 #include <vtkPointData.h>
 
@@ -31,6 +31,37 @@ found in the LICENSE file.
 #include <mitkImageVtkReadAccessor.h>
 #include <mitkImageVtkWriteAccessor.h>
 
+#include <atomic>
+#include <cstring>
+
+/** Memory of image data, shared by all items that reference it */
+struct mitk::ImageDataItem::MemoryBlock
+{
+  MemoryBlock(unsigned char *data, bool manageMemory) : m_Data(data), m_ManageMemory(manageMemory), m_NumberOfHolders(0) {}
+
+  explicit MemoryBlock(const ImageMemory::Allocation &allocation)
+    : m_Data(allocation.Data), m_ManageMemory(true), m_Allocation(allocation), m_NumberOfHolders(0)
+  {
+  }
+
+  ~MemoryBlock()
+  {
+    if (m_Allocation.Data != nullptr)
+      ImageMemory::Release(m_Allocation);
+    else if (m_ManageMemory)
+      delete[] m_Data; // memory passed in by the caller
+  }
+
+  unsigned char *m_Data;
+  bool m_ManageMemory;
+
+  /** set, if the memory was allocated through ImageMemory */
+  ImageMemory::Allocation m_Allocation;
+
+  /** number of items that reference the memory on behalf of an image */
+  std::atomic<unsigned int> m_NumberOfHolders;
+};
+
 mitk::ImageDataItem::ImageDataItem(const ImageDataItem &aParent,
                                    const mitk::ImageDescriptor::Pointer desc,
                                    int timestep,
@@ -47,6 +78,8 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &aParent,
     m_Offset(offset),
     m_IsComplete(false),
     m_Size(0),
+    m_MemoryBlock(aParent.m_MemoryBlock),
+    m_IsMemoryHolder(false),
     m_Parent(&aParent),
     m_Dimension(dimension),
     m_Timestep(timestep)
@@ -87,10 +120,10 @@ mitk::ImageDataItem::~ImageDataItem()
     delete m_VtkImageWriteAccessor;
   }
 
-  if (m_Parent.IsNull())
+  // the memory itself is released together with the last item referencing it
+  if (m_IsMemoryHolder)
   {
-    if (m_ManageMemory)
-      delete[] m_Data;
+    --m_MemoryBlock->m_NumberOfHolders;
   }
   delete m_PixelType;
 }
@@ -108,6 +141,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
     m_Offset(0),
     m_IsComplete(false),
     m_Size(0),
+    m_IsMemoryHolder(false),
     m_Dimension(desc->GetNumberOfDimensions()),
     m_Timestep(timestep)
 {
@@ -122,8 +156,11 @@ mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
 
   if (m_Data == nullptr)
   {
-    m_Data = mitk::MemoryUtilities::AllocateElements<unsigned char>(m_Size);
-    m_ManageMemory = true;
+    this->AllocateMemory();
+  }
+  else
+  {
+    this->SetMemory(std::make_shared<MemoryBlock>(m_Data, m_ManageMemory), m_Data, true);
   }
 
   m_ReferenceCount = 0;
@@ -144,6 +181,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
     m_Offset(0),
     m_IsComplete(false),
     m_Size(0),
+    m_IsMemoryHolder(false),
     m_Parent(nullptr),
     m_Dimension(dimension),
     m_Timestep(timestep)
@@ -157,8 +195,11 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
 
   if (m_Data == nullptr)
   {
-    m_Data = mitk::MemoryUtilities::AllocateElements<unsigned char>(m_Size);
-    m_ManageMemory = true;
+    this->AllocateMemory();
+  }
+  else
+  {
+    this->SetMemory(std::make_shared<MemoryBlock>(m_Data, m_ManageMemory), m_Data, true);
   }
 
   m_ReferenceCount = 0;
@@ -172,14 +213,17 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
     m_VtkImageData(nullptr),
     m_VtkImageReadAccessor(nullptr),
     m_VtkImageWriteAccessor(nullptr),
-    m_Offset(other.m_Offset),
+    m_Offset(0),
     m_IsComplete(other.m_IsComplete),
     m_Size(other.m_Size),
-    m_Parent(other.m_Parent),
+    m_IsMemoryHolder(false),
+    m_Parent(nullptr),
     m_Dimension(other.m_Dimension),
     m_Timestep(other.m_Timestep)
 {
-  // copy m_Data ??
+  // m_Data is not copied: the copy references the memory of other until one of them is written
+  this->SetMemory(other.m_MemoryBlock, other.m_Data, true);
+
   for (int i = 0; i < MAX_IMAGE_DIMENSIONS; ++i)
     m_Dimensions[i] = other.m_Dimensions[i];
 }
@@ -191,6 +235,82 @@ itk::LightObject::Pointer mitk::ImageDataItem::InternalClone() const
   return newGeometry.GetPointer();
 }
 
+void mitk::ImageDataItem::SetManageMemory(bool b)
+{
+  m_ManageMemory = b;
+
+  // a view keeps the memory alive, but neither counts as a holder nor gets an own copy on write
+  if (!b && m_IsMemoryHolder)
+  {
+    this->SetMemory(m_MemoryBlock, m_Data, false);
+  }
+}
+
+bool mitk::ImageDataItem::IsShared() const
+{
+  return m_MemoryBlock != nullptr && m_MemoryBlock->m_NumberOfHolders > 1;
+}
+
+void mitk::ImageDataItem::SetMemory(const MemoryBlockPointer &block, unsigned char *data, bool isMemoryHolder)
+{
+  if (m_IsMemoryHolder)
+  {
+    --m_MemoryBlock->m_NumberOfHolders;
+  }
+
+  m_MemoryBlock = block;
+  m_Data = data;
+  m_IsMemoryHolder = isMemoryHolder;
+
+  if (m_IsMemoryHolder)
+  {
+    ++m_MemoryBlock->m_NumberOfHolders;
+  }
+
+  // an existing vtkImageData has to look at the new memory as well
+  if (m_VtkImageData != nullptr && m_VtkImageData->GetPointData()->GetScalars() != nullptr)
+  {
+    vtkDataArray *scalars = m_VtkImageData->GetPointData()->GetScalars();
+    scalars->SetVoidArray(m_Data, scalars->GetNumberOfTuples() * scalars->GetNumberOfComponents(), 1);
+    m_VtkImageData->Modified();
+  }
+}
+
+void mitk::ImageDataItem::AllocateMemory()
+{
+  const MemoryBlockPointer block = std::make_shared<MemoryBlock>(ImageMemory::Allocate(m_Size));
+  m_ManageMemory = true;
+  this->SetMemory(block, block->m_Data, true);
+}
+
+bool mitk::ImageDataItem::MakeUnique(const std::vector<ImageDataItem *> &itemsOfImage)
+{
+  if (!m_IsMemoryHolder || !this->IsShared())
+    return false;
+
+  const MemoryBlockPointer sharedBlock = m_MemoryBlock;
+  unsigned char *sharedBegin = m_Data;
+  unsigned char *sharedEnd = m_Data + m_Size;
+
+  const MemoryBlockPointer block = std::make_shared<MemoryBlock>(ImageMemory::Allocate(m_Size));
+  unsigned char *data = block->m_Data;
+  std::memcpy(data, sharedBegin, m_Size);
+
+  // sub-images of the same image (and further holders inside of this item) move along with this item
+  for (ImageDataItem *item : itemsOfImage)
+  {
+    if (item != this && item->m_MemoryBlock == sharedBlock && item->m_Data >= sharedBegin &&
+        item->m_Data + item->m_Size <= sharedEnd)
+    {
+      item->SetMemory(block, data + (item->m_Data - sharedBegin), false);
+    }
+  }
+
+  this->SetMemory(block, data, true);
+  m_ManageMemory = true;
+  return true;
+}
+
 void mitk::ImageDataItem::ComputeItemSize(const unsigned int *dimensions, unsigned int dimension)
 {
   m_Size = m_PixelType->GetSize();
@@ -0,0 +1,381 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImageMemory.h"
+
+#include <mitkLogMacros.h>
+
+#include <itkMacro.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+  const char *const DefaultCategory = "Image";
+
+  struct ImageMemoryState
+  {
+    ImageMemoryState()
+      : Allocator(std::make_shared<mitk::AlignedImageBufferAllocator>()),
+        TotalBytes(0),
+        SoftBudget(0),
+        BudgetWarningIssued(false),
+        NextCallbackId(1)
+    {
+    }
+
+    std::mutex Mutex;
+    std::shared_ptr<mitk::ImageBufferAllocator> Allocator;
+    std::map<std::string, std::size_t> BytesPerCategory;
+    std::size_t TotalBytes;
+    std::size_t SoftBudget;
+    bool BudgetWarningIssued;
+    std::map<mitk::ImageMemory::EvictionCallbackId, mitk::ImageMemory::EvictionCallback> EvictionCallbacks;
+    mitk::ImageMemory::EvictionCallbackId NextCallbackId;
+  };
+
+  const char *const SoftBudgetVariable = "MITK_IMAGE_MEMORY_SOFT_BUDGET";
+  const char *const HugePagesVariable = "MITK_IMAGE_MEMORY_HUGE_PAGES";
+
+  void ApplyEnvironment(ImageMemoryState &state)
+  {
+    if (const char *budget = std::getenv(SoftBudgetVariable))
+    {
+      char *end = nullptr;
+      const double megaBytes = std::strtod(budget, &end);
+      if (end != budget && megaBytes >= 0.0)
+      {
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        state.SoftBudget = static_cast<std::size_t>(megaBytes * 1024.0 * 1024.0);
+        state.BudgetWarningIssued = false;
+      }
+      else
+      {
+        MITK_WARN << "Ignoring invalid value \"" << budget << "\" of " << SoftBudgetVariable << ".";
+      }
+    }
+
+    if (const char *hugePages = std::getenv(HugePagesVariable))
+    {
+      const std::string value(hugePages);
+      const bool useHugePages = value == "1" || value == "ON" || value == "on" || value == "TRUE" || value == "true";
+      auto allocator = std::make_shared<mitk::AlignedImageBufferAllocator>(
+        mitk::AlignedImageBufferAllocator::DefaultAlignment, useHugePages);
+
+      std::lock_guard<std::mutex> lock(state.Mutex);
+      state.Allocator = allocator;
+    }
+  }
+
+  ImageMemoryState *CreateState()
+  {
+    auto *state = new ImageMemoryState;
+    ApplyEnvironment(*state);
+    return state;
+  }
+
+  // never destroyed, images may still be released during static destruction
+  ImageMemoryState &GetState()
+  {
+    static ImageMemoryState *state = CreateState();
+    return *state;
+  }
+
+  thread_local std::string CurrentCategory = DefaultCategory;
+
+  // eviction callbacks that allocate images themselves must not trigger another eviction
+  thread_local bool EvictionRunning = false;
+
+  std::size_t RoundUpToPowerOfTwo(std::size_t value)
+  {
+    std::size_t result = 1;
+    while (result < value)
+      result <<= 1;
+    return result;
+  }
+}
+
+const std::size_t mitk::AlignedImageBufferAllocator::DefaultAlignment;
+const std::size_t mitk::AlignedImageBufferAllocator::HugePageSize;
+
+mitk::ImageBufferAllocator::~ImageBufferAllocator()
+{
+}
+
+mitk::AlignedImageBufferAllocator::AlignedImageBufferAllocator(std::size_t alignment,
+                                                               bool useHugePages,
+                                                               std::size_t hugePageThreshold)
+  : m_Alignment(RoundUpToPowerOfTwo(std::max(alignment, sizeof(void *)))),
+    m_UseHugePages(useHugePages),
+    m_HugePageThreshold(hugePageThreshold)
+{
+}
+
+void *mitk::AlignedImageBufferAllocator::Allocate(std::size_t size)
+{
+  std::size_t alignment = m_Alignment;
+  bool hugePages = false;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (m_UseHugePages && size >= m_HugePageThreshold)
+  {
+    // whole huge pages, so that the kernel does not have to split the last one
+    alignment = std::max(alignment, HugePageSize);
+    size = (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+    hugePages = true;
+  }
+#endif
+
+  void *data = nullptr;
+#ifdef _MSC_VER
+  data = _aligned_malloc(size, alignment);
+#else
+  if (posix_memalign(&data, alignment, size) != 0)
+    data = nullptr;
+#endif
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // only a hint, the memory is usable without huge pages as well
+  if (data != nullptr && hugePages)
+    madvise(data, size, MADV_HUGEPAGE);
+#else
+  (void)hugePages;
+#endif
+
+  return data;
+}
+
+void mitk::AlignedImageBufferAllocator::Deallocate(void *data, std::size_t)
+{
+#ifdef _MSC_VER
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+mitk::ImageMemory::CategoryScope::CategoryScope(const std::string &category) : m_PreviousCategory(CurrentCategory)
+{
+  CurrentCategory = category;
+}
+
+mitk::ImageMemory::CategoryScope::~CategoryScope()
+{
+  CurrentCategory = m_PreviousCategory;
+}
+
+mitk::ImageMemory::Allocation mitk::ImageMemory::Allocate(std::size_t size)
+{
+  ImageMemoryState &state = GetState();
+
+  std::size_t excess = 0;
+  {
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    if (state.SoftBudget > 0 && state.TotalBytes + size > state.SoftBudget)
+      excess = state.TotalBytes + size - state.SoftBudget;
+  }
+
+  if (excess > 0)
+    Evict(excess);
+
+  Allocation allocation;
+  allocation.Allocator = GetAllocator();
+  allocation.Size = size;
+  allocation.Category = CurrentCategory;
+
+  // empty images get a valid pointer as well
+  const std::size_t allocationSize = std::max<std::size_t>(size, 1);
+  allocation.Data = static_cast<unsigned char *>(allocation.Allocator->Allocate(allocationSize));
+
+  if (allocation.Data == nullptr && Evict(size) > 0)
+    allocation.Data = static_cast<unsigned char *>(allocation.Allocator->Allocate(allocationSize));
+
+  if (allocation.Data == nullptr)
+    throw itk::MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory.", ITK_LOCATION);
+
+  bool warn = false;
+  std::size_t totalBytes = 0;
+  std::size_t budget = 0;
+  {
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.BytesPerCategory[allocation.Category] += size;
+    state.TotalBytes += size;
+
+    if (state.SoftBudget > 0 && state.TotalBytes > state.SoftBudget && !state.BudgetWarningIssued)
+    {
+      state.BudgetWarningIssued = true;
+      warn = true;
+      totalBytes = state.TotalBytes;
+      budget = state.SoftBudget;
+    }
+  }
+
+  if (warn)
+  {
+    MITK_WARN << "Image memory of " << totalBytes << " bytes exceeds the soft budget of " << budget
+              << " bytes. Release images or raise the budget.";
+  }
+
+  return allocation;
+}
+
+void mitk::ImageMemory::Release(Allocation &allocation)
+{
+  if (allocation.Data == nullptr)
+    return;
+
+  allocation.Allocator->Deallocate(allocation.Data, std::max<std::size_t>(allocation.Size, 1));
+
+  ImageMemoryState &state = GetState();
+  {
+    std::lock_guard<std::mutex> lock(state.Mutex);
+
+    auto category = state.BytesPerCategory.find(allocation.Category);
+    if (category != state.BytesPerCategory.end())
+    {
+      category->second -= std::min(category->second, allocation.Size);
+      if (category->second == 0)
+        state.BytesPerCategory.erase(category);
+    }
+    state.TotalBytes -= std::min(state.TotalBytes, allocation.Size);
+
+    if (state.TotalBytes <= state.SoftBudget)
+      state.BudgetWarningIssued = false;
+  }
+
+  allocation = Allocation();
+}
+
+void mitk::ImageMemory::SetAllocator(std::shared_ptr<ImageBufferAllocator> allocator)
+{
+  if (allocator == nullptr)
+    allocator = std::make_shared<AlignedImageBufferAllocator>();
+
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Allocator = allocator;
+}
+
+std::shared_ptr<mitk::ImageBufferAllocator> mitk::ImageMemory::GetAllocator()
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Allocator;
+}
+
+std::string mitk::ImageMemory::GetCurrentCategory()
+{
+  return CurrentCategory;
+}
+
+std::size_t mitk::ImageMemory::GetAllocatedBytes()
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.TotalBytes;
+}
+
+std::size_t mitk::ImageMemory::GetAllocatedBytes(const std::string &category)
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  auto bytes = state.BytesPerCategory.find(category);
+  return bytes != state.BytesPerCategory.end() ? bytes->second : 0;
+}
+
+std::map<std::string, std::size_t> mitk::ImageMemory::GetAllocatedBytesPerCategory()
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.BytesPerCategory;
+}
+
+void mitk::ImageMemory::SetSoftBudget(std::size_t bytes)
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.SoftBudget = bytes;
+  state.BudgetWarningIssued = false;
+}
+
+std::size_t mitk::ImageMemory::GetSoftBudget()
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.SoftBudget;
+}
+
+mitk::ImageMemory::EvictionCallbackId mitk::ImageMemory::AddEvictionCallback(const EvictionCallback &callback)
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  const EvictionCallbackId id = state.NextCallbackId++;
+  state.EvictionCallbacks[id] = callback;
+  return id;
+}
+
+void mitk::ImageMemory::RemoveEvictionCallback(EvictionCallbackId id)
+{
+  ImageMemoryState &state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.EvictionCallbacks.erase(id);
+}
+
+std::size_t mitk::ImageMemory::Evict(std::size_t bytesToRelease)
+{
+  if (EvictionRunning)
+    return 0;
+
+  std::vector<EvictionCallback> callbacks;
+  {
+    ImageMemoryState &state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    for (const auto &callback : state.EvictionCallbacks)
+      callbacks.push_back(callback.second);
+  }
+
+  // the callbacks are called without the lock, since they release images and thereby call Release()
+  EvictionRunning = true;
+  std::size_t releasedBytes = 0;
+  try
+  {
+    for (const auto &callback : callbacks)
+    {
+      if (releasedBytes >= bytesToRelease)
+        break;
+      releasedBytes += callback(bytesToRelease - releasedBytes);
+    }
+  }
+  catch (...)
+  {
+    EvictionRunning = false;
+    throw;
+  }
+  EvictionRunning = false;
+
+  return releasedBytes;
+}
+
+void mitk::ImageMemory::ConfigureFromEnvironment()
+{
+  ApplyEnvironment(GetState());
+}
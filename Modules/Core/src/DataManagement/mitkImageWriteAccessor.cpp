@@ -12,10 +12,19 @@ found in the LICENSE file.
 
 #include "mitkImageWriteAccessor.h"
 
+#include <cstddef>
+
 mitk::ImageWriteAccessor::ImageWriteAccessor(ImagePointer image, const mitk::ImageDataItem *iDI, int OptionFlags)
-  : ImageAccessorBase(image.GetPointer(), iDI, OptionFlags), m_Image(image)
+  : ImageAccessorBase(image.GetPointer(), iDI, OptionFlags), m_Image(image), m_ImageDataItem(iDI)
 
 {
+  if (m_ImageDataItem == nullptr)
+  {
+    m_Image->m_ReadWriteLock.Lock();
+    m_ImageDataItem = m_Image->GetChannelData();
+    m_Image->m_ReadWriteLock.Unlock();
+  }
+
   OrganizeWriteAccess();
 }
 
@@ -108,6 +117,30 @@ void mitk::ImageWriteAccessor::OrganizeWriteAccess()
     }   // for
   }     // if
 
+  // Data shared with other images is copied before it is written (copy-on-write). This moves the memory of the
+  // image, so accessors of other threads have to be released first. Accessors of the calling thread keep looking
+  // at the shared memory, which stays valid as long as the other images hold it.
+  if (!readOverlap && !writeOverlap && m_Image->IsDataShared())
+  {
+    for (const std::vector<ImageAccessorBase *> *accessors : {&m_Image->m_Readers, &m_Image->m_Writers})
+    {
+      for (ImageAccessorBase *a : *accessors)
+      {
+        if (!IsOwnedByCurrentThread(a))
+        {
+          writeOverlap = true;
+          overlapLock = a->m_WaitLock;
+          break;
+        }
+      }
+      if (writeOverlap)
+        break;
+    }
+
+    if (!writeOverlap)
+      this->MakeDataUnique();
+  }
+
   if (readOverlap || writeOverlap)
   {
     // Throw an exception or wait for the WriteAccessor w until it is released and start again with the request
@@ -145,3 +178,15 @@ void mitk::ImageWriteAccessor::OrganizeWriteAccess()
   // fflush(0);
   m_Image->m_ReadWriteLock.Unlock();
 }
+
+void mitk::ImageWriteAccessor::MakeDataUnique()
+{
+  const unsigned char *sharedData = m_ImageDataItem->m_Data;
+  if (!m_Image->MakeDataUnique())
+    return;
+
+  // the data item stays the same, but its memory moved
+  const std::ptrdiff_t shift = m_ImageDataItem->m_Data - sharedData;
+  m_AddressBegin = static_cast<unsigned char *>(m_AddressBegin) + shift;
+  m_AddressEnd = static_cast<unsigned char *>(m_AddressEnd) + shift;
+}
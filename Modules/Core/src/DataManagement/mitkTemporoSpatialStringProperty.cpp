@@ -10,30 +10,205 @@ found in the LICENSE file.
 
 ============================================================================*/
 
+
+#include <algorithm>
+#include <cctype>
 #include <iterator>
+#include <limits>
+#include <locale>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <unordered_map>
 
 #include "mitkTemporoSpatialStringProperty.h"
 
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
 #include <boost/type_traits/make_unsigned.hpp>
 
+namespace
+{
+  using SliceType = mitk::TemporoSpatialStringProperty::IndexValueType;
+
+  /** Pool of the values of all properties. Values are released once no property uses them any more. */
+  struct ValuePool
+  {
+    std::mutex Mutex;
+    std::unordered_map<std::string, std::weak_ptr<const std::string>> Values;
+    std::size_t PurgeSize = 1024;
+  };
+
+  std::shared_ptr<const std::string> InternValue(const std::string &value)
+  {
+    // never destroyed, properties may still be changed during static destruction
+    static ValuePool *pool = new ValuePool;
+
+    std::lock_guard<std::mutex> lock(pool->Mutex);
+    auto &entry = pool->Values[value];
+    auto interned = entry.lock();
+    if (!interned)
+    {
+      interned = std::make_shared<const std::string>(value);
+      entry = interned;
+    }
+
+    if (pool->Values.size() > pool->PurgeSize)
+    {
+      for (auto iter = pool->Values.begin(); iter != pool->Values.end();)
+      {
+        iter = iter->second.expired() ? pool->Values.erase(iter) : std::next(iter);
+      }
+      pool->PurgeSize = std::max<std::size_t>(1024, 2 * pool->Values.size());
+    }
+    return interned;
+  }
+
+  /** Parses integers in the form std::to_string() writes them, so that the value can be restored exactly. */
+  bool ParseCanonicalInteger(const std::string &value, long long &number)
+  {
+    const std::size_t start = (value.size() > 1 && value[0] == '-') ? 1 : 0;
+    const std::size_t digits = value.size() - start;
+    if (digits == 0 || digits > 18)
+      return false;
+    if (value[start] == '0' && (digits > 1 || start == 1))
+      return false;
+    for (std::size_t i = start; i < value.size(); ++i)
+    {
+      if (value[i] < '0' || value[i] > '9')
+        return false;
+    }
+    number = std::stoll(value);
+    return true;
+  }
+
+  mitk::TemporoSpatialStringProperty::ValueType GetValueAtSlice(const std::shared_ptr<const std::string> &value,
+                                                                long long number,
+                                                                long long step,
+                                                                SliceType offset)
+  {
+    return step == 0 ? *value : std::to_string(number + step * offset);
+  }
+}
+
+// SliceRun is protected, the helpers below are therefore templates on the run type
+template <typename TRun>
+TRun CreateRun(const SliceType &slice, const std::string &value)
+{
+  TRun run;
+  run.First = slice;
+  run.Last = slice;
+  run.Value = InternValue(value);
+  run.Number = 0;
+  run.IsNumeric = ParseCanonicalInteger(value, run.Number);
+  run.Step = 0;
+  return run;
+}
+
+/** Returns the part [first, last] of run. */
+template <typename TRun>
+TRun CreateSubRun(const TRun &run, const SliceType &first, const SliceType &last)
+{
+  TRun result = run;
+  result.First = first;
+  result.Last = last;
+  if (run.Step != 0)
+  {
+    result.Number = run.Number + run.Step * (first - run.First);
+    result.Value = InternValue(std::to_string(result.Number));
+    if (first == last)
+    {
+      result.Step = 0;
+    }
+  }
+  return result;
+}
+
+/** Appends the directly following run successor to run, if the values continue the run. */
+template <typename TRun>
+bool MergeRuns(TRun &run, const TRun &successor)
+{
+  if (run.Last + 1 != successor.First)
+    return false;
+
+  if (run.Step == 0 && successor.Step == 0 && run.Value == successor.Value)
+  {
+    run.Last = successor.Last;
+    return true;
+  }
+
+  if (!run.IsNumeric || !successor.IsNumeric)
+    return false;
+
+  const long long step = successor.Number - (run.Number + run.Step * (run.Last - run.First));
+  if (step == 0 || (run.First != run.Last && run.Step != step) ||
+      (successor.First != successor.Last && successor.Step != step))
+    return false;
+
+  run.Step = step;
+  run.Last = successor.Last;
+  return true;
+}
+
+/** Checks if two lists of runs hold the same values. The runs themselves may differ, depending on the
+ *  order in which the values were set. */
+template <typename TRuns>
+bool AreEqualRuns(const TRuns &runs, const TRuns &otherRuns)
+{
+  if (runs.empty() || otherRuns.empty())
+    return runs.empty() && otherRuns.empty();
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  // start at the first slice of both lists, so that a later start of one of them is detected
+  SliceType slice = std::min(runs[0].First, otherRuns[0].First);
+  while (i < runs.size() && j < otherRuns.size())
+  {
+    const auto &run = runs[i];
+    const auto &otherRun = otherRuns[j];
+    if (run.First > slice || otherRun.First > slice)
+    {
+      if (run.First != otherRun.First)
+        return false;
+      slice = run.First;
+    }
+
+    const SliceType end = std::min(run.Last, otherRun.Last);
+    if (run.Step == 0 && otherRun.Step == 0)
+    {
+      if (*run.Value != *otherRun.Value)
+        return false;
+    }
+    else if (run.IsNumeric && otherRun.IsNumeric)
+    {
+      if (run.Number + run.Step * (slice - run.First) != otherRun.Number + otherRun.Step * (slice - otherRun.First) ||
+          (end != slice && run.Step != otherRun.Step))
+        return false;
+    }
+    else
+    {
+      // progressing runs only hold integers, which never equal a non-numeric value
+      return false;
+    }
+
+    if (run.Last == end)
+      ++i;
+    if (otherRun.Last == end)
+      ++j;
+    slice = end + 1;
+  }
+  return i == runs.size() && j == otherRuns.size();
+}
+
 mitk::TemporoSpatialStringProperty::TemporoSpatialStringProperty(const char *s)
 {
   if (s)
   {
-    SliceMapType slices{{0, s}};
-
-    m_Values.insert(std::make_pair(0, slices));
+    m_Values[0].push_back(CreateRun<SliceRun>(0, s));
   }
 }
 
 mitk::TemporoSpatialStringProperty::TemporoSpatialStringProperty(const std::string &s)
 {
-  SliceMapType slices{{0, s}};
-
-  m_Values.insert(std::make_pair(0, slices));
+  m_Values[0].push_back(CreateRun<SliceRun>(0, s));
 }
 
 mitk::TemporoSpatialStringProperty::TemporoSpatialStringProperty(const TemporoSpatialStringProperty &other)
@@ -43,7 +218,17 @@ mitk::TemporoSpatialStringProperty::TemporoSpatialStringProperty(const TemporoSp
 
 bool mitk::TemporoSpatialStringProperty::IsEqual(const BaseProperty &property) const
 {
-  return this->m_Values == static_cast<const Self &>(property).m_Values;
+  const TimeMapType &otherValues = static_cast<const Self &>(property).m_Values;
+  if (m_Values.size() != otherValues.size())
+    return false;
+
+  for (auto timeIter = m_Values.begin(), otherTimeIter = otherValues.begin(); timeIter != m_Values.end();
+       ++timeIter, ++otherTimeIter)
+  {
+    if (timeIter->first != otherTimeIter->first || !AreEqualRuns(timeIter->second, otherTimeIter->second))
+      return false;
+  }
+  return true;
 }
 
 bool mitk::TemporoSpatialStringProperty::Assign(const BaseProperty &property)
@@ -63,7 +248,9 @@ bool mitk::TemporoSpatialStringProperty::IsUniform() const
 
   for (const auto& timeStep : m_Values)
   {
-    auto finding = std::find_if_not(timeStep.second.begin(), timeStep.second.end(), [&refValue](const mitk::TemporoSpatialStringProperty::SliceMapType::value_type& val) { return val.second == refValue; });
+    auto finding = std::find_if_not(timeStep.second.begin(), timeStep.second.end(), [&refValue](const SliceRun &run) {
+      return (run.Step == 0 || run.First == run.Last) && *run.Value == refValue;
+    });
     if (finding != timeStep.second.end())
     {
       return false;
@@ -88,12 +275,76 @@ mitk::TemporoSpatialStringProperty::ValueType mitk::TemporoSpatialStringProperty
   {
     if (!m_Values.begin()->second.empty())
     {
-      result = m_Values.begin()->second.begin()->second;
+      result = *m_Values.begin()->second.front().Value;
     }
   }
   return result;
 };
 
+const mitk::TemporoSpatialStringProperty::SliceRun *mitk::TemporoSpatialStringProperty::FindRun(
+  const SliceRunsType &runs, const IndexValueType &slice)
+{
+  auto runIter = std::upper_bound(
+    runs.begin(), runs.end(), slice, [](const IndexValueType &value, const SliceRun &run) { return value < run.First; });
+  if (runIter != runs.begin() && std::prev(runIter)->Last >= slice)
+  {
+    return &*std::prev(runIter);
+  }
+  return nullptr;
+}
+
+mitk::TemporoSpatialStringProperty::ValueType mitk::TemporoSpatialStringProperty::GetRunValue(const SliceRun &run,
+                                                                                              const IndexValueType &slice)
+{
+  return GetValueAtSlice(run.Value, run.Number, run.Step, slice - run.First);
+}
+
+void mitk::TemporoSpatialStringProperty::SetRunsValue(SliceRunsType &runs,
+                                                      const IndexValueType &slice,
+                                                      const ValueType &value)
+{
+  auto runIter = std::upper_bound(
+    runs.begin(), runs.end(), slice, [](const IndexValueType &value, const SliceRun &run) { return value < run.First; });
+  std::size_t index = runIter - runs.begin();
+
+  std::vector<SliceRun> replacement;
+  std::size_t newIndex = index;
+  if (index > 0 && runs[index - 1].Last >= slice)
+  { // the slice is part of an existing run, which is split around it
+    const SliceRun run = runs[index - 1];
+    if (GetRunValue(run, slice) == value)
+      return;
+
+    --index;
+    newIndex = index;
+    runs.erase(runs.begin() + index);
+    if (run.First < slice)
+    {
+      replacement.push_back(CreateSubRun(run, run.First, slice - 1));
+      ++newIndex;
+    }
+    replacement.push_back(CreateRun<SliceRun>(slice, value));
+    if (run.Last > slice)
+    {
+      replacement.push_back(CreateSubRun(run, slice + 1, run.Last));
+    }
+  }
+  else
+  {
+    replacement.push_back(CreateRun<SliceRun>(slice, value));
+  }
+  runs.insert(runs.begin() + index, replacement.begin(), replacement.end());
+
+  if (newIndex + 1 < runs.size() && MergeRuns(runs[newIndex], runs[newIndex + 1]))
+  {
+    runs.erase(runs.begin() + newIndex + 1);
+  }
+  if (newIndex > 0 && MergeRuns(runs[newIndex - 1], runs[newIndex]))
+  {
+    runs.erase(runs.begin() + newIndex);
+  }
+}
+
 std::pair<bool, mitk::TemporoSpatialStringProperty::ValueType> mitk::TemporoSpatialStringProperty::CheckValue(
   const TimeStepType &timeStep, const IndexValueType &zSlice, bool allowCloseTime, bool allowCloseSlice) const
 {
@@ -113,22 +364,27 @@ std::pair<bool, mitk::TemporoSpatialStringProperty::ValueType> mitk::TemporoSpat
 
   if (timeIter != timeEnd)
   {
-    const SliceMapType &slices = timeIter->second;
+    const SliceRunsType &runs = timeIter->second;
 
-    auto sliceIter = slices.find(zSlice);
-    auto sliceEnd = slices.end();
-    if (sliceIter == sliceEnd && allowCloseSlice)
+    const SliceRun *run = FindRun(runs, zSlice);
+    if (run != nullptr)
+    {
+      value = GetRunValue(*run, zSlice);
+      found = true;
+    }
+    else if (allowCloseSlice && !runs.empty())
     { // search for closest slice (earlier preverd)
-      sliceIter = slices.upper_bound(zSlice);
-      if (sliceIter != slices.begin())
-      { // there is a key lower than slice
-        sliceIter = std::prev(sliceIter);
+      auto runIter = std::upper_bound(runs.begin(), runs.end(), zSlice, [](const IndexValueType &slice, const SliceRun &run) {
+        return slice < run.First;
+      });
+      if (runIter != runs.begin())
+      { // there is a slice lower than zSlice
+        value = GetRunValue(*std::prev(runIter), std::prev(runIter)->Last);
+      }
+      else
+      {
+        value = *runIter->Value;
       }
-    }
-
-    if (sliceIter != sliceEnd)
-    {
-      value = sliceIter->second;
       found = true;
     }
   }
@@ -185,9 +441,12 @@ std::vector<mitk::TemporoSpatialStringProperty::IndexValueType> mitk::TemporoSpa
 
   for (const auto& timeStep : m_Values)
   {
-    for (const auto& slice : timeStep.second)
+    for (const auto& run : timeStep.second)
     {
-      uniqueSlices.insert(slice.first);
+      for (auto slice = run.First; slice <= run.Last; ++slice)
+      {
+        uniqueSlices.insert(uniqueSlices.end(), slice);
+      }
     }
   }
 
@@ -204,9 +463,12 @@ std::vector<mitk::TemporoSpatialStringProperty::IndexValueType> mitk::TemporoSpa
 
   if (timeIter != timeEnd)
   {
-    for (auto const &element : timeIter->second)
+    for (auto const &run : timeIter->second)
     {
-      result.push_back(element.first);
+      for (auto slice = run.First; slice <= run.Last; ++slice)
+      {
+        result.push_back(slice);
+      }
     }
   }
 
@@ -231,7 +493,7 @@ std::vector<mitk::TimeStepType> mitk::TemporoSpatialStringProperty::GetAvailable
 
   for (const auto& timeStep : m_Values)
   {
-    if (timeStep.second.find(slice) != std::end(timeStep.second))
+    if (FindRun(timeStep.second, slice) != nullptr)
     {
       result.push_back(timeStep.first);
     }
@@ -244,18 +506,7 @@ void mitk::TemporoSpatialStringProperty::SetValue(const TimeStepType &timeStep,
                                                   const IndexValueType &zSlice,
                                                   const ValueType &value)
 {
-  auto timeIter = m_Values.find(timeStep);
-  auto timeEnd = m_Values.end();
-
-  if (timeIter == timeEnd)
-  {
-    SliceMapType slices{{zSlice, value}};
-    m_Values.insert(std::make_pair(timeStep, slices));
-  }
-  else
-  {
-    timeIter->second[zSlice] = value;
-  }
+  SetRunsValue(m_Values[timeStep], zSlice, value);
   this->Modified();
 };
 
@@ -327,55 +578,230 @@ std::basic_string<Ch> CreateJSONEscapes(const std::basic_string<Ch> &s)
   return result;
 }
 
-using CondensedTimeKeyType = std::pair<mitk::TimeStepType, mitk::TimeStepType>;
-using CondensedTimePointsType = std::map<CondensedTimeKeyType, std::string>;
-
-using CondensedSliceKeyType = std::pair<mitk::TemporoSpatialStringProperty::IndexValueType, mitk::TemporoSpatialStringProperty::IndexValueType>;
-using CondensedSlicesType = std::map<CondensedSliceKeyType, CondensedTimePointsType>;
-
-/** Helper function that checks if between an ID and a successing ID is no gap.*/
-template<typename TValue>
-bool isGap(const TValue& value, const TValue& successor)
+namespace
 {
-  return value<successor || value > successor + 1;
-}
+  /** Condensed time steps [MinTimeStep, MaxTimeStep] of a slice that share the same value. */
+  struct CondensedTimeSteps
+  {
+    mitk::TimeStepType MinTimeStep;
+    mitk::TimeStepType MaxTimeStep;
+    std::string Value;
 
+    bool operator==(const CondensedTimeSteps &other) const
+    {
+      return MinTimeStep == other.MinTimeStep && MaxTimeStep == other.MaxTimeStep && Value == other.Value;
+    }
+  };
 
-template<typename TNewKey, typename TNewValue, typename TMasterKey, typename TMasterValue, typename TCondensedContainer>
-void CheckAndCondenseElement(const TNewKey& newKeyMinID, const TNewValue& newValue, TMasterKey& masterKey, TMasterValue& masterValue, TCondensedContainer& condensedContainer)
-{
-  if (newValue != masterValue
-    || isGap(newKeyMinID, masterKey.second))
+  void WriteCondensedSlices(std::ostream &stream,
+                            SliceType minSlice,
+                            SliceType maxSlice,
+                            const std::vector<CondensedTimeSteps> &timeSteps,
+                            bool &first)
   {
-    condensedContainer[masterKey] = masterValue;
-    masterValue = newValue;
-    masterKey.first = newKeyMinID;
-  }
-  masterKey.second = newKeyMinID;
-}
+    for (const auto &t : timeSteps)
+    {
+      if (first)
+      {
+        first = false;
+      }
+      else
+      {
+        stream << ", ";
+      }
 
-/** Helper function that tries to condense the values of time points for a slice as much as possible and returns all slices with condensed timepoint values.*/
-CondensedSlicesType CondenseTimePointValuesOfProperty(const mitk::TemporoSpatialStringProperty* tsProp)
-{
-  CondensedSlicesType uncondensedSlices;
+      stream << "{\"z\":" << minSlice << ", ";
+      if (minSlice != maxSlice)
+      {
+        stream << "\"zmax\":" << maxSlice << ", ";
+      }
+      stream << "\"t\":" << t.MinTimeStep << ", ";
+      if (t.MinTimeStep != t.MaxTimeStep)
+      {
+        stream << "\"tmax\":" << t.MaxTimeStep << ", ";
+      }
+      stream << "\"value\":\"" << CreateJSONEscapes(t.Value) << "\"}";
+    }
+  }
 
-  auto zs = tsProp->GetAvailableSlices();
-  for (const auto z : zs)
+  /** Minimal pull parser for the JSON written by serializeTemporoSpatialStringPropertyToJSON. */
+  class JSONReader
   {
-    CondensedTimePointsType condensedTimePoints;
-    auto timePointIDs = tsProp->GetAvailableTimeSteps(z);
-    CondensedTimeKeyType condensedKey = { timePointIDs.front(),timePointIDs.front() };
-    auto refValue = tsProp->GetValue(timePointIDs.front(), z);
+  public:
+    explicit JSONReader(const std::string &text) : m_Text(text), m_Position(0) {}
 
-    for (const auto timePointID : timePointIDs)
+    void SkipWhitespace()
     {
-      const auto& newVal = tsProp->GetValue(timePointID, z);
-      CheckAndCondenseElement(timePointID, newVal, condensedKey, refValue, condensedTimePoints);
+      while (m_Position < m_Text.size() && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+        ++m_Position;
     }
-    condensedTimePoints[condensedKey] = refValue;
-    uncondensedSlices[{ z, z }] = condensedTimePoints;
-  }
-  return uncondensedSlices;
+
+    bool Consume(char c)
+    {
+      this->SkipWhitespace();
+      if (m_Position < m_Text.size() && m_Text[m_Position] == c)
+      {
+        ++m_Position;
+        return true;
+      }
+      return false;
+    }
+
+    void Expect(char c)
+    {
+      if (!this->Consume(c))
+        this->Fail(std::string("expected '") + c + "'");
+    }
+
+    std::string ReadString()
+    {
+      this->Expect('"');
+      std::string result;
+      while (true)
+      {
+        if (m_Position >= m_Text.size())
+          this->Fail("unterminated string");
+
+        const char c = m_Text[m_Position++];
+        if (c == '"')
+          return result;
+        if (c != '\\')
+        {
+          result += c;
+          continue;
+        }
+
+        if (m_Position >= m_Text.size())
+          this->Fail("unterminated escape sequence");
+        const char escaped = m_Text[m_Position++];
+        switch (escaped)
+        {
+          case 'b': result += '\b'; break;
+          case 'f': result += '\f'; break;
+          case 'n': result += '\n'; break;
+          case 'r': result += '\r'; break;
+          case 't': result += '\t'; break;
+          case 'u': this->AppendCodePoint(result, this->ReadHex4()); break;
+          default: result += escaped; break;
+        }
+      }
+    }
+
+    /** Reads a number or a string, numbers are returned as written. */
+    std::string ReadScalar()
+    {
+      this->SkipWhitespace();
+      if (m_Position < m_Text.size() && m_Text[m_Position] == '"')
+        return this->ReadString();
+
+      const std::size_t start = m_Position;
+      while (m_Position < m_Text.size() && std::string(",}] \t\r\n").find(m_Text[m_Position]) == std::string::npos)
+        ++m_Position;
+      if (start == m_Position)
+        this->Fail("expected a value");
+      return m_Text.substr(start, m_Position - start);
+    }
+
+    void SkipValue()
+    {
+      if (this->Consume('{'))
+      {
+        if (!this->Consume('}'))
+        {
+          do
+          {
+            this->ReadString();
+            this->Expect(':');
+            this->SkipValue();
+          } while (this->Consume(','));
+          this->Expect('}');
+        }
+      }
+      else if (this->Consume('['))
+      {
+        if (!this->Consume(']'))
+        {
+          do
+          {
+            this->SkipValue();
+          } while (this->Consume(','));
+          this->Expect(']');
+        }
+      }
+      else
+      {
+        this->ReadScalar();
+      }
+    }
+
+    template <typename TValue>
+    TValue ReadInteger()
+    {
+      const std::string text = this->ReadScalar();
+      std::istringstream stream(text);
+      stream.imbue(std::locale("C"));
+      TValue value;
+      if (!(stream >> value) || !stream.eof())
+        this->Fail("invalid integer '" + text + "'");
+      return value;
+    }
+
+    bool AtEnd()
+    {
+      this->SkipWhitespace();
+      return m_Position == m_Text.size();
+    }
+
+    [[noreturn]] void Fail(const std::string &message) const
+    {
+      mitkThrow() << "Cannot parse TemporoSpatialStringProperty JSON at position " << m_Position << ": " << message;
+    }
+
+  private:
+    unsigned long ReadHex4()
+    {
+      if (m_Position + 4 > m_Text.size())
+        this->Fail("incomplete unicode escape");
+      unsigned long codePoint = 0;
+      for (int i = 0; i < 4; ++i)
+      {
+        const char c = m_Text[m_Position++];
+        codePoint <<= 4;
+        if (c >= '0' && c <= '9')
+          codePoint += c - '0';
+        else if (c >= 'a' && c <= 'f')
+          codePoint += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+          codePoint += c - 'A' + 10;
+        else
+          this->Fail("invalid unicode escape");
+      }
+      return codePoint;
+    }
+
+    static void AppendCodePoint(std::string &result, unsigned long codePoint)
+    {
+      // CreateJSONEscapes escapes every byte outside of ASCII on its own, so these are restored as bytes
+      if (codePoint < 0x100)
+      {
+        result += static_cast<char>(codePoint);
+      }
+      else if (codePoint < 0x800)
+      {
+        result += static_cast<char>(0xC0 | (codePoint >> 6));
+        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      else
+      {
+        result += static_cast<char>(0xE0 | (codePoint >> 12));
+        result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+    }
+
+    const std::string &m_Text;
+    std::size_t m_Position;
+  };
 }
 
 ::std::string mitk::PropertyPersistenceSerialization::serializeTemporoSpatialStringPropertyToJSON(
@@ -393,6 +819,8 @@ CondensedSlicesType CondenseTimePointValuesOfProperty(const mitk::TemporoSpatial
     mitkThrow() << "Cannot serialize properties of types other than TemporoSpatialStringProperty.";
   }
 
+  using SliceRunsType = mitk::TemporoSpatialStringProperty::SliceRunsType;
+
   std::ostringstream stream;
   stream.imbue(std::locale("C"));
   stream << "{\"values\":[";
@@ -401,59 +829,98 @@ CondensedSlicesType CondenseTimePointValuesOfProperty(const mitk::TemporoSpatial
   //we start with condensing time points and then slices (in difference to the
   //internal layout). Reason: There is more entropy in slices (looking at DICOM)
   //than across time points for one slice, so we can "compress" to a higher rate.
-  //We don't wanted to change the internal structure of the property as it would
-  //introduce API inconvinience and subtle changes in behavior.
-  CondensedSlicesType uncondensedSlices = CondenseTimePointValuesOfProperty(tsProp);
-
-  //now condense the slices
-  CondensedSlicesType condensedSlices;
-  if(!uncondensedSlices.empty())
+  //The slices are walked in intervals in which no run of any time step starts, ends
+  //or progresses, so that all slices of an interval condense to the same time points.
+  std::vector<std::pair<mitk::TimeStepType, const SliceRunsType *>> timeSteps;
+  SliceType slice = std::numeric_limits<SliceType>::max();
+  for (const auto &timeStep : tsProp->m_Values)
   {
-    CondensedTimePointsType& masterSlice = uncondensedSlices.begin()->second;
-    CondensedSliceKeyType masterSliceKey = uncondensedSlices.begin()->first;
-
-    for (const auto& uncondensedSlice : uncondensedSlices)
+    if (!timeStep.second.empty())
     {
-      const auto& uncondensedSliceID = uncondensedSlice.first.first;
-      CheckAndCondenseElement(uncondensedSliceID, uncondensedSlice.second, masterSliceKey, masterSlice, condensedSlices);
+      timeSteps.emplace_back(timeStep.first, &timeStep.second);
+      slice = std::min(slice, timeStep.second.front().First);
     }
-    condensedSlices[masterSliceKey] = masterSlice;
   }
-
+  std::vector<std::size_t> currentRuns(timeSteps.size(), 0);
 
   bool first = true;
-  for (const auto& z : condensedSlices)
+  bool hasCondensedSlices = false;
+  SliceType minSlice = 0;
+  SliceType maxSlice = 0;
+  std::vector<CondensedTimeSteps> condensedTimeSteps;
+  std::vector<CondensedTimeSteps> currentTimeSteps;
+
+  while (!timeSteps.empty())
   {
-    for (const auto& t : z.second)
+    SliceType intervalEnd = std::numeric_limits<SliceType>::max();
+    SliceType nextSlice = std::numeric_limits<SliceType>::max();
+    bool sliceAvailable = false;
+    currentTimeSteps.clear();
+
+    for (std::size_t i = 0; i < timeSteps.size(); ++i)
     {
-      if (first)
-      {
-        first = false;
-      }
-      else
+      const SliceRunsType &runs = *timeSteps[i].second;
+      while (currentRuns[i] < runs.size() && runs[currentRuns[i]].Last < slice)
+        ++currentRuns[i];
+      if (currentRuns[i] == runs.size())
+        continue;
+
+      const auto &run = runs[currentRuns[i]];
+      if (run.First > slice)
       {
-        stream << ", ";
+        nextSlice = std::min(nextSlice, run.First);
+        intervalEnd = std::min(intervalEnd, run.First - 1);
+        continue;
       }
 
-      const auto& minSliceID = z.first.first;
-      const auto& maxSliceID = z.first.second;
-      const auto& minTimePointID = t.first.first;
-      const auto& maxTimePointID = t.first.second;
+      sliceAvailable = true;
+      intervalEnd = std::min(intervalEnd, run.Step == 0 ? run.Last : slice);
 
-      stream << "{\"z\":" << minSliceID << ", ";
-      if (minSliceID != maxSliceID)
+      const mitk::TimeStepType timeStep = timeSteps[i].first;
+      std::string value = run.Step == 0 ? *run.Value : std::to_string(run.Number + run.Step * (slice - run.First));
+      if (!currentTimeSteps.empty() && currentTimeSteps.back().MaxTimeStep + 1 == timeStep &&
+          currentTimeSteps.back().Value == value)
       {
-        stream << "\"zmax\":" << maxSliceID << ", ";
+        currentTimeSteps.back().MaxTimeStep = timeStep;
       }
-      stream << "\"t\":" << minTimePointID << ", ";
-      if (minTimePointID != maxTimePointID)
+      else
       {
-        stream << "\"tmax\":" << maxTimePointID << ", ";
+        currentTimeSteps.push_back({timeStep, timeStep, std::move(value)});
       }
+    }
+
+    if (!sliceAvailable)
+    {
+      if (nextSlice == std::numeric_limits<SliceType>::max())
+        break;
+      slice = nextSlice;
+      continue;
+    }
 
-      const auto& value = t.second;
-      stream << "\"value\":\"" << CreateJSONEscapes(value) << "\"}";
+    if (hasCondensedSlices && slice == maxSlice + 1 && currentTimeSteps == condensedTimeSteps)
+    {
+      maxSlice = intervalEnd;
     }
+    else
+    {
+      if (hasCondensedSlices)
+      {
+        WriteCondensedSlices(stream, minSlice, maxSlice, condensedTimeSteps, first);
+      }
+      hasCondensedSlices = true;
+      minSlice = slice;
+      maxSlice = intervalEnd;
+      condensedTimeSteps.swap(currentTimeSteps);
+    }
+
+    if (intervalEnd == std::numeric_limits<SliceType>::max())
+      break;
+    slice = intervalEnd + 1;
+  }
+
+  if (hasCondensedSlices)
+  {
+    WriteCondensedSlices(stream, minSlice, maxSlice, condensedTimeSteps, first);
   }
 
   stream << "]}";
@@ -469,31 +936,94 @@ mitk::BaseProperty::Pointer mitk::PropertyPersistenceDeserialization::deserializ
 
   mitk::TemporoSpatialStringProperty::Pointer prop = mitk::TemporoSpatialStringProperty::New();
 
-  boost::property_tree::ptree root;
-
-  std::istringstream stream(value);
-  stream.imbue(std::locale("C"));
-
-  boost::property_tree::read_json(stream, root);
+  JSONReader reader(value);
+  bool hasValues = false;
 
-  for (boost::property_tree::ptree::value_type &element : root.get_child("values"))
+  reader.Expect('{');
+  if (!reader.Consume('}'))
   {
-    std::string value = element.second.get("value", "");
-    mitk::TemporoSpatialStringProperty::IndexValueType z =
-      element.second.get<mitk::TemporoSpatialStringProperty::IndexValueType>("z", 0);
-    mitk::TemporoSpatialStringProperty::IndexValueType zmax =
-      element.second.get<mitk::TemporoSpatialStringProperty::IndexValueType>("zmax", z);
-    TimeStepType t = element.second.get<TimeStepType>("t", 0);
-    TimeStepType tmax = element.second.get<TimeStepType>("tmax", t);
-
-    for (auto currentT = t; currentT <= tmax; ++currentT)
+    do
     {
-      for (auto currentZ = z; currentZ <= zmax; ++currentZ)
+      const std::string key = reader.ReadString();
+      reader.Expect(':');
+      if (key != "values")
       {
-        prop->SetValue(currentT, currentZ, value);
+        reader.SkipValue();
+        continue;
       }
-    }
+
+      hasValues = true;
+      reader.Expect('[');
+      if (reader.Consume(']'))
+        continue;
+
+      do
+      {
+        std::string elementValue;
+        SliceType z = 0;
+        SliceType zmax = 0;
+        mitk::TimeStepType t = 0;
+        mitk::TimeStepType tmax = 0;
+        bool hasZMax = false;
+        bool hasTMax = false;
+
+        reader.Expect('{');
+        if (!reader.Consume('}'))
+        {
+          do
+          {
+            const std::string elementKey = reader.ReadString();
+            reader.Expect(':');
+            if (elementKey == "value")
+              elementValue = reader.ReadScalar();
+            else if (elementKey == "z")
+              z = reader.ReadInteger<SliceType>();
+            else if (elementKey == "zmax")
+            {
+              zmax = reader.ReadInteger<SliceType>();
+              hasZMax = true;
+            }
+            else if (elementKey == "t")
+              t = reader.ReadInteger<mitk::TimeStepType>();
+            else if (elementKey == "tmax")
+            {
+              tmax = reader.ReadInteger<mitk::TimeStepType>();
+              hasTMax = true;
+            }
+            else
+              reader.SkipValue();
+          } while (reader.Consume(','));
+          reader.Expect('}');
+        }
+
+        if (!hasZMax)
+          zmax = z;
+        if (!hasTMax)
+          tmax = t;
+
+        for (auto currentT = t; currentT <= tmax; ++currentT)
+        {
+          auto &runs = prop->m_Values[currentT];
+          for (auto currentZ = z; currentZ <= zmax; ++currentZ)
+          {
+            mitk::TemporoSpatialStringProperty::SetRunsValue(runs, currentZ, elementValue);
+          }
+        }
+      } while (reader.Consume(','));
+      reader.Expect(']');
+    } while (reader.Consume(','));
+    reader.Expect('}');
+  }
+
+  if (!hasValues)
+  {
+    reader.Fail("no values");
+  }
+  if (!reader.AtEnd())
+  {
+    reader.Fail("unexpected content after the values");
   }
 
+  prop->Modified();
   return prop.GetPointer();
 }
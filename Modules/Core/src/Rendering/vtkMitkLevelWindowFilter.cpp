@@ -24,6 +24,11 @@ found in the LICENSE file.
 
 // used for acos etc.
 #include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
 
 // used for PI
 #include <itkMath.h>
@@ -35,8 +40,17 @@ static const double PI = itk::Math::pi;
 vtkStandardNewMacro(vtkMitkLevelWindowFilter);
 
 vtkMitkLevelWindowFilter::vtkMitkLevelWindowFilter()
-  : m_LookupTable(nullptr), m_OpacityFunction(nullptr), m_MinOpacity(0.0), m_MaxOpacity(255.0)
+  : m_LookupTable(nullptr),
+    m_OpacityFunction(nullptr),
+    m_MinOpacity(0.0),
+    m_MaxOpacity(255.0),
+    m_BakedTableScalarType(-1),
+    m_QuantizedTableShift(0.0),
+    m_QuantizedTableScale(0.0),
+    m_QuantizedTableValid(false)
 {
+  m_QuantizedTableRange[0] = 0.0;
+  m_QuantizedTableRange[1] = 0.0;
   // MITK_INFO << "mitk level/window filter uses " << GetNumberOfThreads() << " thread(s)";
 }
 
@@ -55,6 +69,12 @@ vtkMTimeType vtkMitkLevelWindowFilter::GetMTime()
     mTime = (time > mTime ? time : mTime);
   }
 
+  if (this->m_OpacityFunction != nullptr)
+  {
+    time = this->m_OpacityFunction->GetMTime();
+    mTime = (time > mTime ? time : mTime);
+  }
+
   return mTime;
 }
 
@@ -63,6 +83,7 @@ void vtkMitkLevelWindowFilter::SetLookupTable(vtkScalarsToColors *lookupTable)
   if (m_LookupTable != lookupTable)
   {
     m_LookupTable = lookupTable;
+    m_LookupTableSetTime.Modified();
     this->Modified();
   }
 }
@@ -77,6 +98,7 @@ void vtkMitkLevelWindowFilter::SetOpacityPiecewiseFunction(vtkPiecewiseFunction
   if (m_OpacityFunction != opacityFunction)
   {
     m_OpacityFunction = opacityFunction;
+    m_LookupTableSetTime.Modified();
     this->Modified();
   }
 }
@@ -273,58 +295,201 @@ void vtkApplyLookupTableOnRGBA(vtkMitkLevelWindowFilter *self,
   }
 }
 
+// Internal helpers which should never be used anywhere else and should not be in th header.
+namespace
+{
+  /** Pixel types with at most 16 bit integer values are mapped with a baked table. */
+  template <class T>
+  struct IsBakeable
+  {
+    static const bool value = std::is_integral<T>::value && sizeof(T) <= 2;
+  };
+
+  /** Columns [begin, end) of a row of the extent that are inside of the clipping bounds. */
+  void GetClippedColumns(const int outExt[6], const double *clippingBounds, int &begin, int &end)
+  {
+    // x >= bound is equivalent to x >= ceil(bound) and x < bound to x < ceil(bound) for integer x
+    begin = static_cast<int>(std::ceil(std::max(clippingBounds[0], static_cast<double>(outExt[0]))));
+    end = static_cast<int>(std::ceil(std::min(clippingBounds[1], static_cast<double>(outExt[1] + 1))));
+    end = std::max(begin, end);
+  }
+
+  /** Fills the table with the RGBA values of all values of T, starting at the lowest value. */
+  template <class T>
+  void BakeTable(std::vector<vtkTypeUInt32> &table, const std::function<vtkTypeUInt32(double)> &mapToRGBA, std::true_type)
+  {
+    const int lowest = static_cast<int>(std::numeric_limits<T>::lowest());
+    const int highest = static_cast<int>(std::numeric_limits<T>::max());
+    table.resize(highest - lowest + 1);
+    for (int value = lowest; value <= highest; ++value)
+    {
+      table[value - lowest] = mapToRGBA(value);
+    }
+  }
+
+  template <class T>
+  void BakeTable(std::vector<vtkTypeUInt32> &, const std::function<vtkTypeUInt32(double)> &, std::false_type)
+  {
+  }
+
+  /** Maps the columns [begin, end) of a row with the baked table. */
+  template <class T>
+  void MapRow(const T *input, vtkTypeUInt32 *output, int begin, int end, const vtkTypeUInt32 *table, std::true_type)
+  {
+    const int lowest = static_cast<int>(std::numeric_limits<T>::lowest());
+    for (int x = begin; x < end; ++x)
+    {
+      output[x] = table[static_cast<int>(input[x]) - lowest];
+    }
+  }
+
+  template <class T>
+  void MapRow(const T *, vtkTypeUInt32 *, int, int, const vtkTypeUInt32 *, std::false_type)
+  {
+  }
+}
+
 // Internal method which should never be used anywhere else and should not be in th header.
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
+// Fills the baked table for the scalar type T.
+template <class T>
+void vtkBakeLookupTable(std::vector<vtkTypeUInt32> &table, const std::function<vtkTypeUInt32(double)> &mapToRGBA, T *)
+{
+  BakeTable<T>(table, mapToRGBA, std::integral_constant<bool, IsBakeable<T>::value>());
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Applies the baked table. The inner loops only load a table entry per pixel and store it.
 template <class T>
-void vtkApplyLookupTableOnScalarsFast(
-  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], T *)
+void vtkApplyBakedLookupTableOnScalars(const std::vector<vtkTypeUInt32> &bakedTable,
+                                       vtkImageData *inData,
+                                       vtkImageData *outData,
+                                       int outExt[6],
+                                       double *clippingBounds,
+                                       T *)
 {
   vtkImageIterator<T> inputIt(inData, outExt);
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
 
-  double tableRange[2];
-
-  // access vtkLookupTable
-  auto *lookupTable = dynamic_cast<vtkLookupTable *>(self->GetLookupTable());
-  lookupTable->GetTableRange(tableRange);
+  const vtkTypeUInt32 *table = bakedTable.data();
 
-  // access elements of the vtkLookupTable
-  const int *realLookupTable = reinterpret_cast<int *>(lookupTable->GetTable()->GetPointer(0));
-  int maxIndex = lookupTable->GetNumberOfColors() - 1;
+  int clippedBegin, clippedEnd;
+  GetClippedColumns(outExt, clippingBounds, clippedBegin, clippedEnd);
 
-  const float scale = (tableRange[1] - tableRange[0] > 0 ? (maxIndex + 1) / (tableRange[1] - tableRange[0]) : 0.0);
-  // ensuring that starting point is zero
-  float bias = -tableRange[0] * scale;
-  // due to later conversion to int for rounding
-  bias += 0.5f;
+  int y = outExt[2];
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    auto *outputSI = reinterpret_cast<vtkTypeUInt32 *>(outputIt.BeginSpan());
+    auto *outputSIEnd = reinterpret_cast<vtkTypeUInt32 *>(outputIt.EndSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
-    T *inputSI = inputIt.BeginSpan();
+    // do we iterate over the inner vertical clipping bounds
+    if (y >= clippingBounds[2] && y < clippingBounds[3])
+    {
+      const int width = static_cast<int>(outputSIEnd - outputSI);
+      const int begin = std::min(width, clippedBegin - outExt[0]);
+      const int end = std::min(width, clippedEnd - outExt[0]);
 
-    while (outputSI != outputSIEnd)
+      // outer horizontal clipping bounds - write transparent RGBA pixels
+      std::fill(outputSI, outputSI + begin, 0);
+      std::fill(outputSI + end, outputSIEnd, 0);
+
+      MapRow<T>(inputSI, outputSI, begin, end, table, std::integral_constant<bool, IsBakeable<T>::value>());
+    }
+    else
     {
-      // map to an index
-      auto idx = static_cast<int>(*inputSI * scale + bias);
+      // outer vertical clipping bounds - write a transparent RGBA line
+      std::fill(outputSI, outputSIEnd, 0);
+    }
+
+    inputIt.NextSpan();
+    outputIt.NextSpan();
+    y++;
+  }
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Applies the quantized table of a linear vtkLookupTable. The index is computed like vtkLookupTable::MapValue().
+template <class T>
+void vtkApplyQuantizedLookupTableOnScalars(const std::vector<vtkTypeUInt32> &quantizedTable,
+                                           const double *range,
+                                           double shift,
+                                           double scale,
+                                           vtkImageData *inData,
+                                           vtkImageData *outData,
+                                           int outExt[6],
+                                           double *clippingBounds,
+                                           T *)
+{
+  vtkImageIterator<T> inputIt(inData, outExt);
+  vtkImageIterator<unsigned char> outputIt(outData, outExt);
+
+  // the colors of the lookup table are followed by the below range, above range and NaN colors
+  const vtkTypeUInt32 *table = quantizedTable.data();
+  const auto maxIndex = static_cast<double>(quantizedTable.size() - 4);
+  const vtkTypeUInt32 belowRangeColor = table[quantizedTable.size() - 3];
+  const vtkTypeUInt32 aboveRangeColor = table[quantizedTable.size() - 2];
+  const vtkTypeUInt32 nanColor = table[quantizedTable.size() - 1];
+
+  int clippedBegin, clippedEnd;
+  GetClippedColumns(outExt, clippingBounds, clippedBegin, clippedEnd);
+
+  int y = outExt[2];
+
+  // Loop through ouput pixels
+  while (!outputIt.IsAtEnd())
+  {
+    auto *outputSI = reinterpret_cast<vtkTypeUInt32 *>(outputIt.BeginSpan());
+    auto *outputSIEnd = reinterpret_cast<vtkTypeUInt32 *>(outputIt.EndSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
-      if (idx < 0)
-        idx = 0;
-      else if (idx > maxIndex)
-        idx = maxIndex;
+    // do we iterate over the inner vertical clipping bounds
+    if (y >= clippingBounds[2] && y < clippingBounds[3])
+    {
+      const int width = static_cast<int>(outputSIEnd - outputSI);
+      const int begin = std::min(width, clippedBegin - outExt[0]);
+      const int end = std::min(width, clippedEnd - outExt[0]);
 
-      *reinterpret_cast<int *>(outputSI) = realLookupTable[idx];
+      // outer horizontal clipping bounds - write transparent RGBA pixels
+      std::fill(outputSI, outputSI + begin, 0);
+      std::fill(outputSI + end, outputSIEnd, 0);
 
-      inputSI++;
-      outputSI += 4;
+      for (int x = begin; x < end; ++x)
+      {
+        const auto value = static_cast<double>(inputSI[x]);
+        if (value < range[0])
+        {
+          outputSI[x] = belowRangeColor;
+        }
+        else if (value > range[1])
+        {
+          outputSI[x] = aboveRangeColor;
+        }
+        else if (std::isnan(value))
+        {
+          outputSI[x] = nanColor;
+        }
+        else
+        {
+          // values very close to the upper end of the range may map above the last index
+          const double index = (value + shift) * scale;
+          outputSI[x] = table[static_cast<std::size_t>(index < maxIndex ? index : maxIndex)];
+        }
+      }
+    }
+    else
+    {
+      // outer vertical clipping bounds - write a transparent RGBA line
+      std::fill(outputSI, outputSIEnd, 0);
     }
 
     inputIt.NextSpan();
     outputIt.NextSpan();
+    y++;
   }
 }
 
@@ -488,6 +653,134 @@ int vtkMitkLevelWindowFilter::RequestInformation(vtkInformation *request,
   return 1;
 }
 
+int vtkMitkLevelWindowFilter::RequestData(vtkInformation *request,
+                                          vtkInformationVector **inputVector,
+                                          vtkInformationVector *outputVector)
+{
+  vtkImageData *input = vtkImageData::GetData(inputVector[0]);
+
+  // the lookup table is prepared once here, the threads only read it
+  if (input != nullptr && input->GetNumberOfScalarComponents() <= 2 && this->GetLookupTable())
+  {
+    this->GetLookupTable()->Build();
+    if (!this->BakeLookupTable(input->GetScalarType()))
+      this->BuildQuantizedLookupTable();
+  }
+
+  return Superclass::RequestData(request, inputVector, outputVector);
+}
+
+vtkTypeUInt32 vtkMitkLevelWindowFilter::MapScalarToRGBA(double value)
+{
+  vtkTypeUInt32 rgba = 0;
+
+  auto *ctf = dynamic_cast<vtkColorTransferFunction *>(m_LookupTable);
+
+  if (ctf)
+  {
+    // same mapping as vtkApplyLookupTableOnScalarsCTF
+    double color[4];
+    ctf->GetColor(value, color); // RGB mapping
+    color[3] = 1.0;
+    if (m_OpacityFunction)
+      color[3] = m_OpacityFunction->GetValue(value); // Alpha mapping
+
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      bytes[i] = static_cast<unsigned char>(255.0 * color[i] + 0.5);
+    }
+    std::memcpy(&rgba, bytes, 4);
+  }
+  else
+  {
+    // same mapping as vtkApplyLookupTableOnScalars
+    std::memcpy(&rgba, m_LookupTable->MapValue(value), 4);
+  }
+
+  return rgba;
+}
+
+vtkMTimeType vtkMitkLevelWindowFilter::GetLookupTableMTime()
+{
+  vtkMTimeType mTime = m_LookupTableSetTime.GetMTime();
+
+  if (m_LookupTable != nullptr)
+    mTime = std::max(mTime, m_LookupTable->GetMTime());
+
+  if (m_OpacityFunction != nullptr)
+    mTime = std::max(mTime, m_OpacityFunction->GetMTime());
+
+  return mTime;
+}
+
+bool vtkMitkLevelWindowFilter::BakeLookupTable(int scalarType)
+{
+  if (scalarType == m_BakedTableScalarType && m_BakedTableTime > this->GetLookupTableMTime())
+    return true;
+
+  m_BakedTableScalarType = -1;
+
+  // a table with an entry for every value only pays off for 8 and 16 bit integers, all other
+  // pixel types are mapped per pixel
+  const bool bakeable = scalarType == VTK_CHAR || scalarType == VTK_SIGNED_CHAR || scalarType == VTK_UNSIGNED_CHAR ||
+                        scalarType == VTK_SHORT || scalarType == VTK_UNSIGNED_SHORT;
+  if (!bakeable)
+    return false;
+
+  const std::function<vtkTypeUInt32(double)> mapToRGBA = [this](double value) { return this->MapScalarToRGBA(value); };
+
+  switch (scalarType)
+  {
+    vtkTemplateMacro(vtkBakeLookupTable(m_BakedTable, mapToRGBA, static_cast<VTK_TT *>(nullptr)));
+    default:
+      return false;
+  }
+
+  m_BakedTableScalarType = scalarType;
+  m_BakedTableTime.Modified();
+  return true;
+}
+
+bool vtkMitkLevelWindowFilter::BuildQuantizedLookupTable()
+{
+  if (m_QuantizedTableTime > this->GetLookupTableMTime())
+    return m_QuantizedTableValid;
+
+  m_QuantizedTableValid = false;
+  m_QuantizedTableTime.Modified();
+
+  // only the linear mapping of a vtkLookupTable is piecewise constant with one piece per color
+  auto *lookupTable = dynamic_cast<vtkLookupTable *>(m_LookupTable);
+  if (lookupTable == nullptr || lookupTable->GetScale() != VTK_SCALE_LINEAR || lookupTable->GetIndexedLookup() ||
+      lookupTable->GetNumberOfColors() < 1)
+    return false;
+
+  const vtkIdType numberOfColors = lookupTable->GetNumberOfColors();
+  lookupTable->GetTableRange(m_QuantizedTableRange);
+
+  // same shift and scale as vtkLookupTable uses for the linear mapping
+  m_QuantizedTableShift = -m_QuantizedTableRange[0];
+  m_QuantizedTableScale = std::numeric_limits<double>::max();
+  const double rangeDelta = m_QuantizedTableRange[1] - m_QuantizedTableRange[0];
+  if (rangeDelta * m_QuantizedTableScale > numberOfColors)
+    m_QuantizedTableScale = numberOfColors / rangeDelta;
+
+  m_QuantizedTable.resize(numberOfColors + 3);
+  for (vtkIdType i = 0; i < numberOfColors; ++i)
+  {
+    std::memcpy(&m_QuantizedTable[i], lookupTable->GetPointer(i), 4);
+  }
+
+  // MapValue() decides whether the special colors or the first/last color are used
+  std::memcpy(&m_QuantizedTable[numberOfColors], lookupTable->MapValue(-std::numeric_limits<double>::infinity()), 4);
+  std::memcpy(&m_QuantizedTable[numberOfColors + 1], lookupTable->MapValue(std::numeric_limits<double>::infinity()), 4);
+  std::memcpy(&m_QuantizedTable[numberOfColors + 2], lookupTable->MapValue(std::numeric_limits<double>::quiet_NaN()), 4);
+
+  m_QuantizedTableValid = true;
+  return true;
+}
+
 // Method to run the filter in different threads.
 void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int /*id*/)
 {
@@ -502,53 +795,55 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
         return;
     }
   }
-  else
+  else if (inData->GetScalarType() == m_BakedTableScalarType)
   {
-    bool dontClip = extent[2] >= m_ClippingBounds[2] && extent[3] <= m_ClippingBounds[3] &&
-                    extent[0] >= m_ClippingBounds[0] && extent[1] <= m_ClippingBounds[1];
-
-    if (this->GetLookupTable())
-      this->GetLookupTable()->Build();
-
-    auto *vlt = dynamic_cast<vtkLookupTable *>(this->GetLookupTable());
-    auto *ctf = dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable());
-
-    bool linearLookupTable = vlt && vlt->GetScale() == VTK_SCALE_LINEAR;
-
-    bool useFast = dontClip && linearLookupTable;
-
-    if (ctf)
+    switch (inData->GetScalarType())
     {
-      switch (inData->GetScalarType())
-      {
-        vtkTemplateMacro(vtkApplyLookupTableOnScalarsCTF(
-          this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
-        default:
-          vtkErrorMacro(<< "Execute: Unknown ScalarType");
-          return;
-      }
+      vtkTemplateMacro(vtkApplyBakedLookupTableOnScalars(
+        m_BakedTable, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
     }
-    else if (useFast)
+  }
+  else if (m_QuantizedTableValid)
+  {
+    switch (inData->GetScalarType())
     {
-      switch (inData->GetScalarType())
-      {
-        vtkTemplateMacro(
-          vtkApplyLookupTableOnScalarsFast(this, inData, outData, extent, static_cast<VTK_TT *>(nullptr)));
-        default:
-          vtkErrorMacro(<< "Execute: Unknown ScalarType");
-          return;
-      }
+      vtkTemplateMacro(vtkApplyQuantizedLookupTableOnScalars(m_QuantizedTable,
+                                                             m_QuantizedTableRange,
+                                                             m_QuantizedTableShift,
+                                                             m_QuantizedTableScale,
+                                                             inData,
+                                                             outData,
+                                                             extent,
+                                                             m_ClippingBounds,
+                                                             static_cast<VTK_TT *>(nullptr)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
     }
-    else
+  }
+  else if (dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable()))
+  {
+    switch (inData->GetScalarType())
     {
-      switch (inData->GetScalarType())
-      {
-        vtkTemplateMacro(vtkApplyLookupTableOnScalars(
-          this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
-        default:
-          vtkErrorMacro(<< "Execute: Unknown ScalarType");
-          return;
-      }
+      vtkTemplateMacro(vtkApplyLookupTableOnScalarsCTF(
+        this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
+    }
+  }
+  else
+  {
+    switch (inData->GetScalarType())
+    {
+      vtkTemplateMacro(vtkApplyLookupTableOnScalars(
+        this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
     }
   }
 }
@@ -560,7 +855,11 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
 
 void vtkMitkLevelWindowFilter::SetMinOpacity(double minOpacity)
 {
-  m_MinOpacity = minOpacity;
+  if (m_MinOpacity != minOpacity)
+  {
+    m_MinOpacity = minOpacity;
+    this->Modified();
+  }
 }
 
 inline double vtkMitkLevelWindowFilter::GetMinOpacity() const
@@ -570,7 +869,11 @@ inline double vtkMitkLevelWindowFilter::GetMinOpacity() const
 
 void vtkMitkLevelWindowFilter::SetMaxOpacity(double maxOpacity)
 {
-  m_MaxOpacity = maxOpacity;
+  if (m_MaxOpacity != maxOpacity)
+  {
+    m_MaxOpacity = maxOpacity;
+    this->Modified();
+  }
 }
 
 inline double vtkMitkLevelWindowFilter::GetMaxOpacity() const
@@ -580,6 +883,10 @@ inline double vtkMitkLevelWindowFilter::GetMaxOpacity() const
 
 void vtkMitkLevelWindowFilter::SetClippingBounds(double *bounds) // TODO does double[4] work??
 {
-  for (unsigned int i = 0; i < 4; ++i)
-    m_ClippingBounds[i] = bounds[i];
+  if (std::equal(bounds, bounds + 4, m_ClippingBounds))
+    return;
+
+  // the output changes, the baked tables stay valid
+  std::copy(bounds, bounds + 4, m_ClippingBounds);
+  this->Modified();
 }
@@ -31,6 +31,7 @@ found in the LICENSE file.
 #include <mitkSurfaceStlIO.h>
 #include <mitkSurfaceVtkLegacyIO.h>
 #include <mitkSurfaceVtkXmlIO.h>
+#include <mitkUndoController.h>
 
 #include "mitkLegacyFileWriterService.h"
 #include <mitkFileWriter.h>
@@ -38,6 +39,8 @@ found in the LICENSE file.
 #include <itkGDCMImageIO.h>
 #include <itkNiftiImageIO.h>
 
+#include <thread>
+
 // PropertyRelationRules
 #include <mitkPropertyRelationRuleBase.h>
 
@@ -194,6 +197,13 @@ void MitkCoreActivator::Load(us::ModuleContext *context)
   m_PropertyRelations.reset(new mitk::PropertyRelations);
   context->RegisterService<mitk::IPropertyRelations>(m_PropertyRelations.get());
 
+  // the undo history releases its image memory when the image memory budget is exceeded, but only for
+  // allocations of this thread, because the undo models are not thread-safe
+  const std::thread::id undoThreadId = std::this_thread::get_id();
+  m_UndoEvictionCallbackId = mitk::ImageMemory::AddEvictionCallback([undoThreadId](std::size_t bytesToRelease) {
+    return std::this_thread::get_id() == undoThreadId ? mitk::UndoController::ReleaseImageMemory(bytesToRelease) : 0;
+  });
+
   m_MimeTypeProvider.reset(new mitk::MimeTypeProvider);
   m_MimeTypeProvider->Start();
   m_MimeTypeProviderReg = context->RegisterService<mitk::IMimeTypeProvider>(m_MimeTypeProvider.get());
@@ -236,6 +246,8 @@ void MitkCoreActivator::Load(us::ModuleContext *context)
 
 void MitkCoreActivator::Unload(us::ModuleContext *)
 {
+  mitk::ImageMemory::RemoveEvictionCallback(m_UndoEvictionCallbackId);
+
   for (auto &elem : m_FileReaders)
   {
     delete elem;
@@ -18,6 +18,7 @@ found in the LICENSE file.
 #include <mitkIFileReader.h>
 #include <mitkIFileWriter.h>
 
+#include <mitkImageMemory.h>
 #include <mitkMimeTypeProvider.h>
 #include <mitkPlanePositionManager.h>
 #include <mitkPropertyAliases.h>
@@ -74,6 +75,8 @@ private:
 
   us::ServiceRegistration<mitk::IMimeTypeProvider> m_MimeTypeProviderReg;
 
+  mitk::ImageMemory::EvictionCallbackId m_UndoEvictionCallbackId;
+
   us::ModuleContext *m_Context;
 };
 
@@ -19,12 +19,27 @@ found in the LICENSE file.
 
 #include <mitkPixelType.h>
 #include <mitkImage.h>
+#include <mitkImagePixelReadAccessor.h>
 #include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkImageTimeSelector.h>
+
+#include <vtkImageData.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 class mitkImageDataItemTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkImageDataItemTestSuite);
   MITK_TEST(TestAccessOnHugeImage);
+  MITK_TEST(TestCopyOnWriteOfClone);
+  MITK_TEST(TestCopyOnWriteOfOriginal);
+  MITK_TEST(TestCopyOnWriteThroughVtkImageData);
+  MITK_TEST(TestCopyOnWriteWithReaderOfOtherThread);
+  MITK_TEST(TestTimeStepIsViewOfInput);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -65,6 +80,146 @@ public:
       exit(77);
     }
   }
+
+  static mitk::Image::Pointer CreateImage(unsigned int timeSteps)
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    std::array<unsigned int, 4> dimensions = {{ 4, 3, 2, timeSteps }};
+    image->Initialize(mitk::MakeScalarPixelType<short>(), timeSteps > 1 ? 4 : 3, dimensions.data());
+
+    mitk::ImageWriteAccessor writeAccess(image);
+    auto *data = static_cast<short *>(writeAccess.GetData());
+    for (unsigned int i = 0; i < 4 * 3 * 2 * timeSteps; ++i)
+      data[i] = static_cast<short>(i);
+    return image;
+  }
+
+  static const void *GetReadAddress(const mitk::Image *image)
+  {
+    mitk::ImageReadAccessor readAccess(image);
+    return readAccess.GetData();
+  }
+
+  static short GetFirstVoxel(const mitk::Image *image)
+  {
+    mitk::ImageReadAccessor readAccess(image, image->GetVolumeData(0));
+    return *static_cast<const short *>(readAccess.GetData());
+  }
+
+  void TestCopyOnWriteOfClone()
+  {
+    mitk::Image::Pointer image = CreateImage(1);
+    mitk::Image::Pointer clone = image->Clone();
+
+    CPPUNIT_ASSERT_MESSAGE("Clone shares the memory", GetReadAddress(image) == GetReadAddress(clone));
+    CPPUNIT_ASSERT(clone->GetVolumeData(0)->IsShared());
+
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> writeAccess(clone, clone->GetVolumeData(0));
+      writeAccess.GetData()[0] = 42;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Written clone got own memory", GetReadAddress(image) != GetReadAddress(clone));
+    CPPUNIT_ASSERT(!clone->GetVolumeData(0)->IsShared());
+    CPPUNIT_ASSERT(!image->GetVolumeData(0)->IsShared());
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), GetFirstVoxel(clone));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(0), GetFirstVoxel(image));
+  }
+
+  void TestCopyOnWriteOfOriginal()
+  {
+    mitk::Image::Pointer image = CreateImage(1);
+    mitk::Image::Pointer clone = image->Clone();
+
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> writeAccess(image, image->GetVolumeData(0));
+      writeAccess.GetData()[0] = 42;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), GetFirstVoxel(image));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(0), GetFirstVoxel(clone));
+
+    // the clone keeps the memory alive when the original is gone
+    image = nullptr;
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(0), GetFirstVoxel(clone));
+  }
+
+  void TestCopyOnWriteThroughVtkImageData()
+  {
+    mitk::Image::Pointer image = CreateImage(1);
+    mitk::Image::Pointer clone = image->Clone();
+
+    vtkImageData *vtkImage = clone->GetVtkImageData(0);
+    static_cast<short *>(vtkImage->GetScalarPointer())[0] = 42;
+
+    CPPUNIT_ASSERT(!clone->GetVolumeData(0)->IsShared());
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), GetFirstVoxel(clone));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(0), GetFirstVoxel(image));
+  }
+
+  void TestCopyOnWriteWithReaderOfOtherThread()
+  {
+    mitk::Image::Pointer image = CreateImage(1);
+    mitk::Image::Pointer clone = image->Clone();
+
+    // un-sharing moves the memory of the whole image, so the write access to slice 1 has to wait
+    // until the reader of slice 0 in the other thread is gone, although their regions do not overlap
+    std::atomic<bool> readerCreated(false);
+    std::atomic<bool> readerReleased(false);
+    std::thread reader([&]() {
+      {
+        mitk::ImageReadAccessor readAccess(clone, clone->GetSliceData(0));
+        readerCreated = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        readerReleased = true;
+      }
+    });
+
+    while (!readerCreated)
+      std::this_thread::yield();
+
+    {
+      mitk::ImageWriteAccessor writeAccess(clone, clone->GetSliceData(1));
+      CPPUNIT_ASSERT(readerReleased);
+      static_cast<short *>(writeAccess.GetData())[0] = 42;
+    }
+    reader.join();
+
+    CPPUNIT_ASSERT(!clone->GetVolumeData(0)->IsShared());
+    mitk::ImageReadAccessor imageSliceAccess(image, image->GetSliceData(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(4 * 3), *static_cast<const short *>(imageSliceAccess.GetData()));
+    mitk::ImageReadAccessor cloneSliceAccess(clone, clone->GetSliceData(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), *static_cast<const short *>(cloneSliceAccess.GetData()));
+  }
+
+  void TestTimeStepIsViewOfInput()
+  {
+    mitk::Image::Pointer image = CreateImage(3);
+    const short firstVoxelOfTimeStep = 4 * 3 * 2;
+
+    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+    timeSelector->SetInput(image);
+    timeSelector->SetTimeNr(1);
+    timeSelector->Update();
+    mitk::Image::Pointer timeStep = timeSelector->GetOutput();
+
+    {
+      mitk::ImageReadAccessor imageAccess(image, image->GetVolumeData(1));
+      CPPUNIT_ASSERT_MESSAGE("Time step looks at the input memory", imageAccess.GetData() == GetReadAddress(timeStep));
+    }
+    CPPUNIT_ASSERT(!image->GetVolumeData(1)->IsShared());
+
+    // filters write their output through a time selector on the output image
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> writeAccess(timeStep, timeStep->GetVolumeData(0));
+      CPPUNIT_ASSERT_EQUAL(firstVoxelOfTimeStep, writeAccess.GetData()[0]);
+      writeAccess.GetData()[0] = 42;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), GetFirstVoxel(timeStep));
+    mitk::ImageReadAccessor imageAccess(image, image->GetVolumeData(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(42), *static_cast<const short *>(imageAccess.GetData()));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkImageDataItem)
@@ -0,0 +1,268 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImageMemory.h>
+
+#include <mitkImage.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkOperationActor.h>
+#include <mitkOperationEvent.h>
+#include <mitkPixelType.h>
+#include <mitkUndoController.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+  const std::size_t ImageSize = 10 * 20 * 30 * sizeof(short);
+
+  /** An undo operation that holds an image, like the slice operations of the segmentation */
+  class ImageOperation : public mitk::Operation
+  {
+  public:
+    ImageOperation(mitk::Image::Pointer image) : Operation(mitk::OpNOTHING), m_Image(image) {}
+
+  private:
+    mitk::Image::Pointer m_Image;
+  };
+
+  /** Allocates a new image for every executed operation, like applying a compressed slice on undo */
+  class ImageAllocatingActor : public mitk::OperationActor
+  {
+  public:
+    void ExecuteOperation(mitk::Operation *) override;
+
+    std::vector<mitk::Image::Pointer> m_Images;
+  };
+}
+
+class mitkImageMemoryTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageMemoryTestSuite);
+  MITK_TEST(TestAlignment);
+  MITK_TEST(TestAccountingPerCategory);
+  MITK_TEST(TestCopyOnWriteIsAccounted);
+  MITK_TEST(TestEvictionOnSoftBudget);
+  MITK_TEST(TestConfigureFromEnvironment);
+  MITK_TEST(TestUndoHistoryIsEvicted);
+  MITK_TEST(TestUndoWithTinyBudget);
+  MITK_TEST(TestRedoWithTinyBudget);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void tearDown() override
+  {
+    mitk::ImageMemory::SetSoftBudget(0);
+    mitk::ImageMemory::SetAllocator(nullptr);
+  }
+
+  static mitk::Image::Pointer CreateImage()
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    std::array<unsigned int, 3> dimensions = {{ 10, 20, 30 }};
+    image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions.data());
+
+    // the memory is allocated on first access
+    image->GetVolumeData(0);
+    return image;
+  }
+
+  void TestAlignment()
+  {
+    mitk::ImageMemory::SetAllocator(std::make_shared<mitk::AlignedImageBufferAllocator>(128));
+
+    auto image = CreateImage();
+    mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(0));
+    CPPUNIT_ASSERT_EQUAL(std::uintptr_t(0), reinterpret_cast<std::uintptr_t>(accessor.GetData()) % 128);
+
+    auto allocation = mitk::ImageMemory::Allocate(1000);
+    CPPUNIT_ASSERT_EQUAL(std::uintptr_t(0), reinterpret_cast<std::uintptr_t>(allocation.Data) % 128);
+    mitk::ImageMemory::Release(allocation);
+    CPPUNIT_ASSERT(allocation.Data == nullptr);
+  }
+
+  void TestAccountingPerCategory()
+  {
+    const std::size_t initialBytes = mitk::ImageMemory::GetAllocatedBytes();
+    const std::size_t initialPreviewBytes = mitk::ImageMemory::GetAllocatedBytes("Preview");
+
+    auto image = CreateImage();
+    CPPUNIT_ASSERT_EQUAL(initialBytes + ImageSize, mitk::ImageMemory::GetAllocatedBytes());
+
+    {
+      mitk::ImageMemory::CategoryScope scope("Preview");
+      CPPUNIT_ASSERT_EQUAL(std::string("Preview"), mitk::ImageMemory::GetCurrentCategory());
+
+      auto preview = CreateImage();
+      CPPUNIT_ASSERT_EQUAL(initialPreviewBytes + ImageSize, mitk::ImageMemory::GetAllocatedBytes("Preview"));
+      CPPUNIT_ASSERT_EQUAL(initialBytes + 2 * ImageSize, mitk::ImageMemory::GetAllocatedBytes());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::string("Image"), mitk::ImageMemory::GetCurrentCategory());
+    CPPUNIT_ASSERT_EQUAL(initialPreviewBytes, mitk::ImageMemory::GetAllocatedBytes("Preview"));
+
+    image = nullptr;
+    CPPUNIT_ASSERT_EQUAL(initialBytes, mitk::ImageMemory::GetAllocatedBytes());
+  }
+
+  void TestCopyOnWriteIsAccounted()
+  {
+    const std::size_t initialBytes = mitk::ImageMemory::GetAllocatedBytes();
+
+    auto image = CreateImage();
+    auto clone = image->Clone();
+    CPPUNIT_ASSERT_EQUAL(initialBytes + ImageSize, mitk::ImageMemory::GetAllocatedBytes());
+
+    {
+      mitk::ImageWriteAccessor accessor(clone, clone->GetVolumeData(0));
+    }
+    CPPUNIT_ASSERT_EQUAL(initialBytes + 2 * ImageSize, mitk::ImageMemory::GetAllocatedBytes());
+
+    image = nullptr;
+    clone = nullptr;
+    CPPUNIT_ASSERT_EQUAL(initialBytes, mitk::ImageMemory::GetAllocatedBytes());
+  }
+
+  void TestEvictionOnSoftBudget()
+  {
+    mitk::Image::Pointer cache = CreateImage();
+    std::size_t requestedBytes = 0;
+
+    auto id = mitk::ImageMemory::AddEvictionCallback([&](std::size_t bytesToRelease) -> std::size_t {
+      requestedBytes = bytesToRelease;
+      if (cache.IsNull())
+        return 0;
+      cache = nullptr;
+      return ImageSize;
+    });
+
+    // room for the cache, but not for another image
+    mitk::ImageMemory::SetSoftBudget(mitk::ImageMemory::GetAllocatedBytes() + ImageSize / 2);
+
+    auto image = CreateImage();
+    mitk::ImageMemory::RemoveEvictionCallback(id);
+
+    CPPUNIT_ASSERT(cache.IsNull());
+    CPPUNIT_ASSERT_EQUAL(ImageSize / 2, requestedBytes);
+    CPPUNIT_ASSERT(mitk::ImageMemory::GetAllocatedBytes() <= mitk::ImageMemory::GetSoftBudget());
+  }
+
+  void TestConfigureFromEnvironment()
+  {
+    itksys::SystemTools::PutEnv("MITK_IMAGE_MEMORY_SOFT_BUDGET=1.5");
+    itksys::SystemTools::PutEnv("MITK_IMAGE_MEMORY_HUGE_PAGES=ON");
+    mitk::ImageMemory::ConfigureFromEnvironment();
+    itksys::SystemTools::UnPutEnv("MITK_IMAGE_MEMORY_SOFT_BUDGET");
+    itksys::SystemTools::UnPutEnv("MITK_IMAGE_MEMORY_HUGE_PAGES");
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1536 * 1024), mitk::ImageMemory::GetSoftBudget());
+    auto allocator = std::dynamic_pointer_cast<mitk::AlignedImageBufferAllocator>(mitk::ImageMemory::GetAllocator());
+    CPPUNIT_ASSERT(allocator != nullptr);
+    CPPUNIT_ASSERT(allocator->GetUseHugePages());
+
+    // nothing changes without the variables
+    mitk::ImageMemory::SetSoftBudget(0);
+    mitk::ImageMemory::ConfigureFromEnvironment();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), mitk::ImageMemory::GetSoftBudget());
+  }
+
+  static mitk::Operation *CreateUndoImageOperation()
+  {
+    mitk::ImageMemory::CategoryScope scope(mitk::UndoController::ImageMemoryCategory);
+    return new ImageOperation(CreateImage());
+  }
+
+  void TestUndoHistoryIsEvicted()
+  {
+    mitk::UndoController undoController;
+    undoController.Clear();
+    auto id = mitk::ImageMemory::AddEvictionCallback(&mitk::UndoController::ReleaseImageMemory);
+
+    auto *operation = CreateUndoImageOperation();
+    const std::size_t undoBytes = mitk::ImageMemory::GetAllocatedBytes(mitk::UndoController::ImageMemoryCategory);
+    CPPUNIT_ASSERT(undoBytes >= ImageSize);
+    undoController.SetOperationEvent(new mitk::OperationEvent(nullptr, operation, CreateUndoImageOperation(), "image"));
+    CPPUNIT_ASSERT_EQUAL(undoBytes + ImageSize,
+                         mitk::ImageMemory::GetAllocatedBytes(mitk::UndoController::ImageMemoryCategory));
+
+    // the undo history has to make room for a new image
+    mitk::ImageMemory::SetSoftBudget(mitk::ImageMemory::GetAllocatedBytes() + ImageSize / 2);
+    auto image = CreateImage();
+    mitk::ImageMemory::RemoveEvictionCallback(id);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), mitk::ImageMemory::GetAllocatedBytes(mitk::UndoController::ImageMemoryCategory));
+  }
+
+  void TestUndoWithTinyBudget()
+  {
+    mitk::UndoController undoController;
+    undoController.Clear();
+    auto id = mitk::ImageMemory::AddEvictionCallback(&mitk::UndoController::ReleaseImageMemory);
+
+    // both events belong to the same object event, so one undo executes both
+    ImageAllocatingActor actor;
+    undoController.SetOperationEvent(
+      new mitk::OperationEvent(&actor, CreateUndoImageOperation(), CreateUndoImageOperation(), "first"));
+    undoController.SetOperationEvent(
+      new mitk::OperationEvent(&actor, CreateUndoImageOperation(), CreateUndoImageOperation(), "second"));
+
+    // every executed operation exceeds the budget and asks the undo history to make room
+    mitk::ImageMemory::SetSoftBudget(mitk::ImageMemory::GetAllocatedBytes() + ImageSize / 2);
+    CPPUNIT_ASSERT(!undoController.Undo());
+    mitk::ImageMemory::RemoveEvictionCallback(id);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), actor.m_Images.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), mitk::ImageMemory::GetAllocatedBytes(mitk::UndoController::ImageMemoryCategory));
+    CPPUNIT_ASSERT(undoController.RedoListEmpty());
+    CPPUNIT_ASSERT(!undoController.Undo());
+  }
+
+  void TestRedoWithTinyBudget()
+  {
+    mitk::UndoController undoController;
+    undoController.Clear();
+    auto id = mitk::ImageMemory::AddEvictionCallback(&mitk::UndoController::ReleaseImageMemory);
+
+    ImageAllocatingActor actor;
+    undoController.SetOperationEvent(
+      new mitk::OperationEvent(&actor, CreateUndoImageOperation(), CreateUndoImageOperation(), "first"));
+    mitk::OperationEvent::IncCurrObjectEventId();
+    undoController.SetOperationEvent(
+      new mitk::OperationEvent(&actor, CreateUndoImageOperation(), CreateUndoImageOperation(), "second"));
+    mitk::OperationEvent::IncCurrObjectEventId();
+
+    CPPUNIT_ASSERT(undoController.Undo());
+    CPPUNIT_ASSERT(!undoController.RedoListEmpty());
+
+    mitk::ImageMemory::SetSoftBudget(mitk::ImageMemory::GetAllocatedBytes() + ImageSize / 2);
+    undoController.Redo();
+    mitk::ImageMemory::RemoveEvictionCallback(id);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), actor.m_Images.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), mitk::ImageMemory::GetAllocatedBytes(mitk::UndoController::ImageMemoryCategory));
+    CPPUNIT_ASSERT(undoController.RedoListEmpty());
+  }
+};
+
+void ImageAllocatingActor::ExecuteOperation(mitk::Operation *)
+{
+  m_Images.push_back(mitkImageMemoryTestSuite::CreateImage());
+}
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageMemory)
@@ -0,0 +1,208 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkParallelFor.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class mitkParallelForTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkParallelForTestSuite);
+  MITK_TEST(ParallelFor_NoItems);
+  MITK_TEST(ParallelFor_EveryItemProcessedOnce);
+  MITK_TEST(ParallelFor_OneThreadUsesCallingThread);
+  MITK_TEST(ParallelFor_ItemsProcessedConcurrently);
+  MITK_TEST(ParallelFor_PoolThreadsAreReused);
+  MITK_TEST(ParallelFor_NestedCalls);
+  MITK_TEST(ParallelFor_ConcurrentCalls);
+  MITK_TEST(ParallelFor_ExceptionIsRethrown);
+  MITK_TEST(ParallelFor_WorkerIndices);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static void CheckEveryItemProcessedOnce(std::size_t numberOfItems, unsigned int maximumNumberOfThreads)
+  {
+    std::vector<std::atomic<unsigned int>> counts(numberOfItems);
+    for (auto &count : counts)
+      count = 0;
+
+    mitk::ParallelFor(numberOfItems, [&counts](std::size_t i) { ++counts[i]; }, maximumNumberOfThreads);
+
+    for (const auto &count : counts)
+      CPPUNIT_ASSERT_EQUAL(1u, count.load());
+  }
+
+  static std::set<std::thread::id> CollectThreads(std::size_t numberOfItems)
+  {
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    mitk::ParallelFor(numberOfItems, [&](std::size_t) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      std::lock_guard<std::mutex> guard(mutex);
+      threads.insert(std::this_thread::get_id());
+    });
+    return threads;
+  }
+
+  /** Checks that the worker indices are in range, 0 on the calling thread and never used concurrently */
+  static void CheckWorkerIndices(std::size_t numberOfItems, unsigned int maximumNumberOfThreads)
+  {
+    const unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads();
+    const auto callingThread = std::this_thread::get_id();
+    std::vector<std::atomic<bool>> busy(numberOfThreads);
+    for (auto &flag : busy)
+      flag = false;
+    std::atomic<bool> valid(true);
+
+    mitk::ParallelFor(numberOfItems, [&](std::size_t, unsigned int workerIndex) {
+      if (workerIndex >= numberOfThreads ||
+          (maximumNumberOfThreads != 0 && workerIndex >= maximumNumberOfThreads) ||
+          (workerIndex == 0) != (callingThread == std::this_thread::get_id()) ||
+          busy[workerIndex].exchange(true))
+      {
+        valid = false;
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      busy[workerIndex] = false;
+    }, maximumNumberOfThreads);
+
+    CPPUNIT_ASSERT(valid);
+  }
+
+public:
+  void ParallelFor_NoItems()
+  {
+    bool called = false;
+    mitk::ParallelFor(0, [&called](std::size_t) { called = true; });
+    CPPUNIT_ASSERT(!called);
+  }
+
+  void ParallelFor_EveryItemProcessedOnce()
+  {
+    CheckEveryItemProcessedOnce(1, 0);
+    CheckEveryItemProcessedOnce(3, 0);
+    CheckEveryItemProcessedOnce(10000, 0);
+    CheckEveryItemProcessedOnce(10000, 2);
+  }
+
+  void ParallelFor_OneThreadUsesCallingThread()
+  {
+    const auto callingThread = std::this_thread::get_id();
+    std::vector<std::size_t> order;
+    mitk::ParallelFor(100, [&](std::size_t i) {
+      CPPUNIT_ASSERT(callingThread == std::this_thread::get_id());
+      order.push_back(i);
+    }, 1);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+      CPPUNIT_ASSERT_EQUAL(i, order[i]);
+  }
+
+  void ParallelFor_ItemsProcessedConcurrently()
+  {
+    if (mitk::GetParallelForNumberOfThreads() < 2)
+      return;
+
+    // each of the two items waits for the other one, which only finishes if they run on different threads
+    std::mutex mutex;
+    std::condition_variable started;
+    unsigned int numberOfStartedItems = 0;
+    bool allStarted = true;
+
+    mitk::ParallelFor(2, [&](std::size_t) {
+      std::unique_lock<std::mutex> lock(mutex);
+      ++numberOfStartedItems;
+      started.notify_all();
+      if (!started.wait_for(lock, std::chrono::seconds(30), [&] { return numberOfStartedItems == 2; }))
+        allStarted = false;
+    });
+
+    CPPUNIT_ASSERT(allStarted);
+  }
+
+  void ParallelFor_PoolThreadsAreReused()
+  {
+    std::set<std::thread::id> allThreads;
+    for (int i = 0; i < 20; ++i)
+    {
+      auto threads = CollectThreads(4 * mitk::GetParallelForNumberOfThreads());
+      allThreads.insert(threads.begin(), threads.end());
+    }
+
+    // the calling thread and the workers of the pool, no new threads per call
+    CPPUNIT_ASSERT(allThreads.size() <= mitk::GetParallelForNumberOfThreads());
+  }
+
+  void ParallelFor_NestedCalls()
+  {
+    const std::size_t outerItems = 2 * mitk::GetParallelForNumberOfThreads();
+    const std::size_t innerItems = 50;
+
+    std::vector<std::atomic<unsigned int>> counts(outerItems * innerItems);
+    for (auto &count : counts)
+      count = 0;
+
+    mitk::ParallelFor(outerItems, [&](std::size_t i) {
+      mitk::ParallelFor(innerItems, [&](std::size_t j) { ++counts[i * innerItems + j]; });
+    });
+
+    for (const auto &count : counts)
+      CPPUNIT_ASSERT_EQUAL(1u, count.load());
+  }
+
+  void ParallelFor_ConcurrentCalls()
+  {
+    std::atomic<std::size_t> sum(0);
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 4; ++c)
+    {
+      callers.emplace_back([&sum] { mitk::ParallelFor(1000, [&sum](std::size_t i) { sum += i; }); });
+    }
+    for (auto &caller : callers)
+      caller.join();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4 * 999 * 1000 / 2), sum.load());
+  }
+
+  void ParallelFor_ExceptionIsRethrown()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::ParallelFor(1000, [](std::size_t i) {
+                           if (i == 10)
+                             throw std::runtime_error("item failed");
+                         }),
+                         std::runtime_error);
+
+    // the pool is usable after an exception
+    CheckEveryItemProcessedOnce(1000, 0);
+  }
+
+  void ParallelFor_WorkerIndices()
+  {
+    CheckWorkerIndices(1, 0);
+    CheckWorkerIndices(500, 0);
+    CheckWorkerIndices(500, 2);
+    CheckWorkerIndices(500, 1);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkParallelFor)
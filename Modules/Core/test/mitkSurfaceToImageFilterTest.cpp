@@ -26,6 +26,7 @@ class mitkSurfaceToImageFilterTestSuite : public mitk::TestFixture
   MITK_TEST(test3DSurfaceValidOutput);
   MITK_TEST(test3DSurfaceCorrect);
   MITK_TEST(test3DSurfaceIn4DImage);
+  MITK_TEST(testMultipleSurfacesToLabelImage);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -249,5 +250,38 @@ public:
 
     CPPUNIT_ASSERT_MESSAGE("SurfaceToImageFilter_BallSurfaceAsInput_Output4DCorrect", valuesCorrect == true);
   }
+
+  void testMultipleSurfacesToLabelImage()
+  {
+    mitk::SurfaceToImageFilter::Pointer surfaceToImageFilter = mitk::SurfaceToImageFilter::New();
+
+    mitk::Image::Pointer additionalInputImage = mitk::Image::New();
+    unsigned int dims[3] = {32, 32, 32};
+    additionalInputImage->Initialize(mitk::MakeScalarPixelType<unsigned int>(), 3, dims);
+    additionalInputImage->SetOrigin(m_Surface->GetGeometry()->GetOrigin());
+    additionalInputImage->GetGeometry()->SetIndexToWorldTransform(m_Surface->GetGeometry()->GetIndexToWorldTransform());
+
+    // the second surface covers the first one, so its label has to win
+    mitk::Surface::Pointer secondSurface = m_Surface->Clone();
+
+    surfaceToImageFilter->MakeOutputBinaryOn();
+    surfaceToImageFilter->UShortBinaryPixelTypeOn();
+    surfaceToImageFilter->SetInput(m_Surface);
+    surfaceToImageFilter->SetSurfaceLabel(3);
+    surfaceToImageFilter->AddSurface(secondSurface, 300);
+    surfaceToImageFilter->SetImage(additionalInputImage);
+    surfaceToImageFilter->Update();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of surfaces", 2u, surfaceToImageFilter->GetNumberOfSurfaces());
+
+    mitk::ImagePixelReadAccessor<unsigned short, 3> outputReader(surfaceToImageFilter->GetOutput());
+    itk::Index<3> idx;
+    idx[0] = 0;
+    idx[1] = 0, idx[2] = 0;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Voxel outside of all surfaces", static_cast<unsigned short>(0), outputReader.GetPixelByIndex(idx));
+    idx[0] = 15;
+    idx[1] = 15, idx[2] = 15;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Voxel inside of both surfaces", static_cast<unsigned short>(300), outputReader.GetPixelByIndex(idx));
+  }
 };
 MITK_TEST_SUITE_REGISTRATION(mitkSurfaceToImageFilter)
@@ -15,6 +15,7 @@ found in the LICENSE file.
 #include "mitkTestingMacros.h"
 
 #include <limits>
+#include <string>
 
 class mitkTemporoSpatialStringPropertyTestSuite : public mitk::TestFixture
 {
@@ -24,9 +25,13 @@ class mitkTemporoSpatialStringPropertyTestSuite : public mitk::TestFixture
   MITK_TEST(HasValue);
   MITK_TEST(SetValue);
   MITK_TEST(IsUniform);
+  MITK_TEST(NumericRuns);
+  MITK_TEST(IsEqual_DifferentFirstSlice);
 
   MITK_TEST(serializeTemporoSpatialStringPropertyToJSON);
   MITK_TEST(deserializeJSONToTemporoSpatialStringProperty);
+  MITK_TEST(EscapedValueRoundTrip);
+  MITK_TEST(deserializeInvalidJSON);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -162,6 +167,76 @@ public:
     CPPUNIT_ASSERT(refCondensibleProp->IsUniform());
   }
 
+  void NumericRuns()
+  {
+    auto prop = mitk::TemporoSpatialStringProperty::New();
+    auto reverseProp = mitk::TemporoSpatialStringProperty::New();
+    for (int i = 0; i < 100; ++i)
+    {
+      prop->SetValue(0, i, std::to_string(i + 1));
+      reverseProp->SetValue(0, 99 - i, std::to_string(100 - i));
+    }
+
+    CPPUNIT_ASSERT(prop->GetValue(0, 0) == "1");
+    CPPUNIT_ASSERT(prop->GetValue(0, 41) == "42");
+    CPPUNIT_ASSERT(prop->GetValue(0, 99) == "100");
+    CPPUNIT_ASSERT(prop->GetValue(0, 150, false, true) == "100");
+    CPPUNIT_ASSERT(!prop->HasValue(0, 100));
+    CPPUNIT_ASSERT(prop->GetAvailableSlices(0).size() == 100);
+    CPPUNIT_ASSERT(!prop->IsUniform());
+    CPPUNIT_ASSERT(*prop == *reverseProp);
+
+    // splitting and restoring a progression must not change the logical content
+    prop->SetValue(0, 50, "x");
+    CPPUNIT_ASSERT(prop->GetValue(0, 49) == "50");
+    CPPUNIT_ASSERT(prop->GetValue(0, 50) == "x");
+    CPPUNIT_ASSERT(prop->GetValue(0, 51) == "52");
+    CPPUNIT_ASSERT(!(*prop == *reverseProp));
+    prop->SetValue(0, 50, "51");
+    CPPUNIT_ASSERT(*prop == *reverseProp);
+
+    // zero padded numbers are no canonical integers and are stored as plain strings
+    prop->SetValue(0, 100, "0101");
+    CPPUNIT_ASSERT(prop->GetValue(0, 100) == "0101");
+    CPPUNIT_ASSERT(prop->GetValue(0, 99) == "100");
+
+    std::string data = mitk::PropertyPersistenceSerialization::serializeTemporoSpatialStringPropertyToJSON(prop);
+    mitk::BaseProperty::Pointer restored =
+      mitk::PropertyPersistenceDeserialization::deserializeJSONToTemporoSpatialStringProperty(data);
+    CPPUNIT_ASSERT(*restored == *prop);
+  }
+
+  void IsEqual_DifferentFirstSlice()
+  {
+    // [{5..5, "a"}] and [{3..5, "a"}]
+    auto prop = mitk::TemporoSpatialStringProperty::New();
+    prop->SetValue(0, 5, "a");
+    auto otherProp = mitk::TemporoSpatialStringProperty::New();
+    for (int i = 3; i <= 5; ++i)
+      otherProp->SetValue(0, i, "a");
+
+    CPPUNIT_ASSERT(!(*prop == *otherProp));
+    CPPUNIT_ASSERT(!(*otherProp == *prop));
+
+    // the same for a numeric progression that ends with the same value
+    auto numericProp = mitk::TemporoSpatialStringProperty::New();
+    numericProp->SetValue(0, 5, "5");
+    auto otherNumericProp = mitk::TemporoSpatialStringProperty::New();
+    for (int i = 3; i <= 5; ++i)
+      otherNumericProp->SetValue(0, i, std::to_string(i));
+
+    CPPUNIT_ASSERT(!(*numericProp == *otherNumericProp));
+    CPPUNIT_ASSERT(!(*otherNumericProp == *numericProp));
+
+    for (int i = 3; i < 5; ++i)
+    {
+      prop->SetValue(0, i, "a");
+      numericProp->SetValue(0, i, std::to_string(i));
+    }
+    CPPUNIT_ASSERT(*prop == *otherProp);
+    CPPUNIT_ASSERT(*numericProp == *otherNumericProp);
+  }
+
   void serializeTemporoSpatialStringPropertyToJSON()
   {
     std::string data = mitk::PropertyPersistenceSerialization::serializeTemporoSpatialStringPropertyToJSON(refProp);
@@ -237,6 +312,30 @@ public:
     CPPUNIT_ASSERT(tsProp->GetValue(1, 2) == "1");
     CPPUNIT_ASSERT(*tsProp == *refCondensibleProp);
   }
+
+  void EscapedValueRoundTrip()
+  {
+    const std::string value = "quote\" backslash\\ tab\t newline\n umlaut\xc3\xa4";
+    auto prop = mitk::TemporoSpatialStringProperty::New();
+    prop->SetValue(2, 3, value);
+
+    std::string data = mitk::PropertyPersistenceSerialization::serializeTemporoSpatialStringPropertyToJSON(prop);
+    mitk::BaseProperty::Pointer restored =
+      mitk::PropertyPersistenceDeserialization::deserializeJSONToTemporoSpatialStringProperty(data);
+    auto *tsProp = dynamic_cast<mitk::TemporoSpatialStringProperty *>(restored.GetPointer());
+    CPPUNIT_ASSERT(tsProp->GetValue(2, 3) == value);
+    CPPUNIT_ASSERT(*tsProp == *prop);
+  }
+
+  void deserializeInvalidJSON()
+  {
+    CPPUNIT_ASSERT_THROW(
+      mitk::PropertyPersistenceDeserialization::deserializeJSONToTemporoSpatialStringProperty("{\"values\":[{\"z\":0"),
+      mitk::Exception);
+    CPPUNIT_ASSERT_THROW(
+      mitk::PropertyPersistenceDeserialization::deserializeJSONToTemporoSpatialStringProperty("{\"other\":[]}"),
+      mitk::Exception);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTemporoSpatialStringProperty)
@@ -0,0 +1,315 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkMitkLevelWindowFilter.h>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+class vtkMitkLevelWindowFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(vtkMitkLevelWindowFilterTestSuite);
+  MITK_TEST(UnsignedChar_LookupTable_EqualsMapValue);
+  MITK_TEST(Short_LookupTable_EqualsMapValue);
+  MITK_TEST(Float_LookupTable_EqualsMapValue);
+  MITK_TEST(Double_LookupTable_EqualsMapValue);
+  MITK_TEST(Int_LookupTable_EqualsMapValue);
+  MITK_TEST(Double_LogarithmicLookupTable_EqualsMapValue);
+  MITK_TEST(UnsignedChar_ColorTransferFunction_EqualsGetColor);
+  MITK_TEST(Float_ColorTransferFunction_EqualsGetColor);
+  MITK_TEST(ChangedLookupTable_IsApplied);
+  MITK_TEST(ChangedClippingBounds_IsApplied);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef std::function<void(double, unsigned char *)> MappingType;
+
+  static const int Width = 64;
+
+  /** Image of Width columns that contains the values row by row, the last row is filled up with the first value */
+  template <class T>
+  static vtkSmartPointer<vtkImageData> CreateImage(int scalarType, const std::vector<double> &values)
+  {
+    const int height = static_cast<int>((values.size() + Width - 1) / Width);
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(Width, height, 1);
+    image->AllocateScalars(scalarType, 1);
+
+    auto *buffer = static_cast<T *>(image->GetScalarPointer());
+    for (int i = 0; i < Width * height; ++i)
+    {
+      buffer[i] = static_cast<T>(i < static_cast<int>(values.size()) ? values[i] : values[0]);
+    }
+    return image;
+  }
+
+  static vtkSmartPointer<vtkLookupTable> CreateLookupTable()
+  {
+    auto lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    lookupTable->SetTableRange(50.0, 200.0);
+    lookupTable->SetHueRange(0.0, 0.7);
+    lookupTable->SetAlphaRange(0.2, 1.0);
+    lookupTable->SetBelowRangeColor(1.0, 0.0, 0.0, 1.0);
+    lookupTable->UseBelowRangeColorOn();
+    lookupTable->SetAboveRangeColor(0.0, 1.0, 0.0, 0.5);
+    lookupTable->UseAboveRangeColorOn();
+    lookupTable->SetNanColor(0.0, 0.0, 1.0, 1.0);
+    lookupTable->Build();
+    return lookupTable;
+  }
+
+  static vtkSmartPointer<vtkColorTransferFunction> CreateColorTransferFunction()
+  {
+    auto colorTransferFunction = vtkSmartPointer<vtkColorTransferFunction>::New();
+    colorTransferFunction->AddRGBPoint(50.0, 0.0, 0.0, 0.0);
+    colorTransferFunction->AddRGBPoint(120.3, 1.0, 0.5, 0.0);
+    colorTransferFunction->AddRGBPoint(200.0, 1.0, 1.0, 1.0);
+    return colorTransferFunction;
+  }
+
+  static vtkSmartPointer<vtkPiecewiseFunction> CreateOpacityFunction()
+  {
+    auto opacityFunction = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    opacityFunction->AddPoint(60.0, 0.0);
+    opacityFunction->AddPoint(180.0, 1.0);
+    return opacityFunction;
+  }
+
+  static MappingType MapValue(vtkScalarsToColors *lookupTable)
+  {
+    return [lookupTable](double value, unsigned char *rgba) {
+      const unsigned char *mapped = lookupTable->MapValue(value);
+      std::copy(mapped, mapped + 4, rgba);
+    };
+  }
+
+  static MappingType GetColor(vtkColorTransferFunction *colorTransferFunction, vtkPiecewiseFunction *opacityFunction)
+  {
+    return [colorTransferFunction, opacityFunction](double value, unsigned char *rgba) {
+      double color[4];
+      colorTransferFunction->GetColor(value, color);
+      color[3] = opacityFunction->GetValue(value);
+      for (int i = 0; i < 4; ++i)
+        rgba[i] = static_cast<unsigned char>(255.0 * color[i] + 0.5);
+    };
+  }
+
+  /** Applies the filter once without and once with clipping and compares every pixel with the expected mapping */
+  template <class T>
+  static void CheckFilter(vtkImageData *image,
+                          vtkScalarsToColors *lookupTable,
+                          vtkPiecewiseFunction *opacityFunction,
+                          const MappingType &expectedMapping)
+  {
+    const int height = image->GetDimensions()[1];
+    const double unclipped[4] = { 0.0, static_cast<double>(Width), 0.0, static_cast<double>(height) };
+    const double clipped[4] = { 3.5, Width - 5.0, 1.0, height - 0.5 };
+
+    for (const double *bounds : { unclipped, clipped })
+    {
+      auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+      filter->SetInputData(image);
+      filter->SetLookupTable(lookupTable);
+      if (opacityFunction != nullptr)
+        filter->SetOpacityPiecewiseFunction(opacityFunction);
+      double clippingBounds[4];
+      std::copy(bounds, bounds + 4, clippingBounds);
+      filter->SetClippingBounds(clippingBounds);
+      filter->Update();
+
+      CheckOutput<T>(image, filter->GetOutput(), clippingBounds, expectedMapping);
+    }
+  }
+
+  template <class T>
+  static void CheckOutput(vtkImageData *image, vtkImageData *output, const double *clippingBounds, const MappingType &expectedMapping)
+  {
+    CPPUNIT_ASSERT_EQUAL(4, output->GetNumberOfScalarComponents());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(VTK_UNSIGNED_CHAR), output->GetScalarType());
+
+    const int height = image->GetDimensions()[1];
+    const auto *input = static_cast<const T *>(image->GetScalarPointer());
+    const auto *rgba = static_cast<const unsigned char *>(output->GetScalarPointer());
+
+    for (int y = 0; y < height; ++y)
+    {
+      for (int x = 0; x < Width; ++x, ++input, rgba += 4)
+      {
+        unsigned char expected[4] = { 0, 0, 0, 0 };
+        if (x >= clippingBounds[0] && x < clippingBounds[1] && y >= clippingBounds[2] && y < clippingBounds[3])
+          expectedMapping(static_cast<double>(*input), expected);
+
+        for (int c = 0; c < 4; ++c)
+          CPPUNIT_ASSERT_EQUAL(static_cast<int>(expected[c]), static_cast<int>(rgba[c]));
+      }
+    }
+  }
+
+  /** Values below, inside and above the range of the lookup tables, including the borders of the range */
+  static std::vector<double> CreateValues(double step)
+  {
+    std::vector<double> values;
+    for (double value = 0.0; value <= 255.0; value += step)
+      values.push_back(value);
+    return values;
+  }
+
+public:
+  void UnsignedChar_LookupTable_EqualsMapValue()
+  {
+    auto image = CreateImage<unsigned char>(VTK_UNSIGNED_CHAR, CreateValues(1.0));
+    auto lookupTable = CreateLookupTable();
+    CheckFilter<unsigned char>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  void Short_LookupTable_EqualsMapValue()
+  {
+    std::vector<double> values = CreateValues(1.0);
+    values.push_back(std::numeric_limits<short>::lowest());
+    values.push_back(-1.0);
+    values.push_back(std::numeric_limits<short>::max());
+    auto image = CreateImage<short>(VTK_SHORT, values);
+    auto lookupTable = CreateLookupTable();
+    CheckFilter<short>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  void Float_LookupTable_EqualsMapValue()
+  {
+    std::vector<double> values = CreateValues(0.37);
+    values.push_back(50.0);
+    values.push_back(200.0);
+    values.push_back(-1e20);
+    values.push_back(1e20);
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    auto image = CreateImage<float>(VTK_FLOAT, values);
+    auto lookupTable = CreateLookupTable();
+    CheckFilter<float>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  void Double_LookupTable_EqualsMapValue()
+  {
+    std::vector<double> values = CreateValues(0.37);
+    values.push_back(50.0);
+    values.push_back(std::nextafter(50.0, 0.0));
+    values.push_back(200.0);
+    values.push_back(std::nextafter(200.0, 0.0));
+    values.push_back(std::nextafter(200.0, 255.0));
+    values.push_back(-1e20);
+    values.push_back(1e20);
+    values.push_back(-std::numeric_limits<double>::infinity());
+    values.push_back(std::numeric_limits<double>::infinity());
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    auto image = CreateImage<double>(VTK_DOUBLE, values);
+    auto lookupTable = CreateLookupTable();
+    CheckFilter<double>(image, lookupTable, nullptr, MapValue(lookupTable));
+
+    // the first and last color are used outside of the range if the range colors are off
+    lookupTable->UseBelowRangeColorOff();
+    lookupTable->UseAboveRangeColorOff();
+    lookupTable->Build();
+    CheckFilter<double>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  void Int_LookupTable_EqualsMapValue()
+  {
+    std::vector<double> values = CreateValues(1.0);
+    values.push_back(std::numeric_limits<int>::lowest());
+    values.push_back(-1.0);
+    values.push_back(std::numeric_limits<int>::max());
+    auto image = CreateImage<int>(VTK_INT, values);
+    auto lookupTable = CreateLookupTable();
+    CheckFilter<int>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  /** Logarithmic lookup tables are not quantized and mapped per pixel */
+  void Double_LogarithmicLookupTable_EqualsMapValue()
+  {
+    std::vector<double> values = CreateValues(0.37);
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    auto image = CreateImage<double>(VTK_DOUBLE, values);
+    auto lookupTable = CreateLookupTable();
+    lookupTable->SetScaleToLog10();
+    lookupTable->Build();
+    CheckFilter<double>(image, lookupTable, nullptr, MapValue(lookupTable));
+  }
+
+  void UnsignedChar_ColorTransferFunction_EqualsGetColor()
+  {
+    auto image = CreateImage<unsigned char>(VTK_UNSIGNED_CHAR, CreateValues(1.0));
+    auto colorTransferFunction = CreateColorTransferFunction();
+    auto opacityFunction = CreateOpacityFunction();
+    CheckFilter<unsigned char>(image, colorTransferFunction, opacityFunction, GetColor(colorTransferFunction, opacityFunction));
+  }
+
+  void Float_ColorTransferFunction_EqualsGetColor()
+  {
+    auto image = CreateImage<float>(VTK_FLOAT, CreateValues(0.37));
+    auto colorTransferFunction = CreateColorTransferFunction();
+    auto opacityFunction = CreateOpacityFunction();
+    CheckFilter<float>(image, colorTransferFunction, opacityFunction, GetColor(colorTransferFunction, opacityFunction));
+  }
+
+  void ChangedLookupTable_IsApplied()
+  {
+    auto image = CreateImage<unsigned char>(VTK_UNSIGNED_CHAR, CreateValues(1.0));
+    auto lookupTable = CreateLookupTable();
+    double clippingBounds[4] = { 0.0, static_cast<double>(Width), 0.0, static_cast<double>(image->GetDimensions()[1]) };
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(image);
+    filter->SetLookupTable(lookupTable);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+    CheckOutput<unsigned char>(image, filter->GetOutput(), clippingBounds, MapValue(lookupTable));
+
+    // e.g. a new level window
+    lookupTable->SetTableRange(10.0, 100.0);
+    lookupTable->Build();
+    filter->Update();
+    CheckOutput<unsigned char>(image, filter->GetOutput(), clippingBounds, MapValue(lookupTable));
+  }
+
+  void ChangedClippingBounds_IsApplied()
+  {
+    auto image = CreateImage<float>(VTK_FLOAT, CreateValues(0.37));
+    auto lookupTable = CreateLookupTable();
+    double clippingBounds[4] = { 0.0, static_cast<double>(Width), 0.0, static_cast<double>(image->GetDimensions()[1]) };
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(image);
+    filter->SetLookupTable(lookupTable);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+    CheckOutput<float>(image, filter->GetOutput(), clippingBounds, MapValue(lookupTable));
+
+    // e.g. a panned render window
+    clippingBounds[0] = 10.0;
+    clippingBounds[3] = 2.0;
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+    CheckOutput<float>(image, filter->GetOutput(), clippingBounds, MapValue(lookupTable));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(vtkMitkLevelWindowFilter)
@@ -41,6 +41,8 @@ US_BEGIN_NAMESPACE
  * - \e US_DISABLE_AUTOLOADING If set, auto-loading of modules is disabled.
  * - \e US_AUTOLOAD_PATHS A ':' (Unix) or ';' (Windows) separated list of paths
  *   from which modules should be auto-loaded.
+ * - \e US_LAZY_AUTOLOADING If set, auto-loading of modules which provide an
+ *   auto-load manifest is deferred until their services are looked up.
  *
  * \remarks This class is thread safe.
  */
@@ -97,6 +99,36 @@ public:
    */
   static void SetAutoLoadingEnabled(bool enable);
 
+  /**
+   * \return \c true if lazy auto-loading of modules is enabled, \c false otherwise.
+   *
+   * If enabled, a module in an auto-load directory is not loaded together with its
+   * auto-loading module if it is accompanied by an auto-load manifest. The manifest
+   * is a JSON file named after the library file with an appended ".autoload.json"
+   * suffix, listing the service interfaces the module provides:
+   *
+   * \code
+   * { "interfaces" : [ "org.mitk.IFileReader", "org.mitk.IFileWriter" ] }
+   * \endcode
+   *
+   * The module is loaded on the first ModuleContext::GetServiceReference() or
+   * ModuleContext::GetServiceReferences() call (including the ones of service trackers)
+   * which asks for one of these interfaces. Modules without a manifest are loaded
+   * immediately.
+   *
+   * \remarks This method will always return \c false if auto-loading is not enabled.
+   */
+  static bool IsLazyAutoLoadingEnabled();
+
+  /**
+   * Enable or disable lazy auto-loading of modules with an auto-load manifest.
+   *
+   * \param enable If \c true, enable lazy auto-loading, disable it otherwise.
+   *
+   * \remarks Modules whose loading has already been deferred are not affected.
+   */
+  static void SetLazyAutoLoadingEnabled(bool enable);
+
   /**
    * \return A list of paths in the file-system from which modules will be
    * auto-loaded.
@@ -27,11 +27,52 @@
 #include "usCoreModuleContext_p.h"
 #include "usServiceRegistry_p.h"
 #include "usServiceReferenceBasePrivate.h"
+#include "usLDAPExpr_p.h"
+#include "usUtils_p.h"
 
 #include <cstdio>
 
 US_BEGIN_NAMESPACE
 
+namespace {
+
+// Loads the deferred auto-load modules which may provide services matching
+// the given class name and filter. If neither restricts the services to
+// certain interfaces, all deferred modules are loaded if loadAllIfUnrestricted
+// is set.
+void LoadDeferredModulesForLookup(const std::string& clazz, const std::string& filter,
+                                  bool loadAllIfUnrestricted = true)
+{
+#ifdef US_ENABLE_AUTOLOADING_SUPPORT
+  if (!clazz.empty())
+  {
+    LoadDeferredModules(clazz);
+    return;
+  }
+
+  LDAPExpr::ObjectClassSet matched;
+  if (!filter.empty() && LDAPExpr(filter).GetMatchedObjectClasses(matched))
+  {
+    for (LDAPExpr::ObjectClassSet::const_iterator className = matched.begin();
+         className != matched.end(); ++className)
+    {
+      LoadDeferredModules(*className);
+    }
+  }
+  else if (loadAllIfUnrestricted)
+  {
+    // Any service may match
+    LoadDeferredModules(std::string());
+  }
+#else
+  US_UNUSED(clazz);
+  US_UNUSED(filter);
+  US_UNUSED(loadAllIfUnrestricted);
+#endif
+}
+
+}
+
 class ModuleContextPrivate {
 
 public:
@@ -84,6 +125,8 @@ ServiceRegistrationU ModuleContext::RegisterService(const InterfaceMap& service,
 std::vector<ServiceReferenceU > ModuleContext::GetServiceReferences(const std::string& clazz,
                                                                     const std::string& filter)
 {
+  LoadDeferredModulesForLookup(clazz, filter);
+
   std::vector<ServiceReferenceU> result;
   std::vector<ServiceReferenceBase> refs;
   d->module->coreCtx->services.Get(clazz, filter, d->module, refs);
@@ -97,6 +140,7 @@ std::vector<ServiceReferenceU > ModuleContext::GetServiceReferences(const std::s
 
 ServiceReferenceU ModuleContext::GetServiceReference(const std::string& clazz)
 {
+  LoadDeferredModulesForLookup(clazz, std::string());
   return d->module->coreCtx->services.Get(d->module, clazz);
 }
 
@@ -128,6 +172,9 @@ void ModuleContext::AddServiceListener(const ServiceListener& delegate,
                                        const std::string& filter)
 {
   d->module->coreCtx->listeners.AddServiceListener(this, delegate, nullptr, filter);
+  // The listener is notified about the services registered by the loaded modules.
+  // Listeners for any service do not load all deferred modules, they would defeat deferring.
+  LoadDeferredModulesForLookup(std::string(), filter, false);
 }
 
 void ModuleContext::RemoveServiceListener(const ServiceListener& delegate)
@@ -149,6 +196,9 @@ void ModuleContext::AddServiceListener(const ServiceListener& delegate, void* da
                                        const std::string &filter)
 {
   d->module->coreCtx->listeners.AddServiceListener(this, delegate, data, filter);
+  // The listener is notified about the services registered by the loaded modules.
+  // Listeners for any service do not load all deferred modules, they would defeat deferring.
+  LoadDeferredModulesForLookup(std::string(), filter, false);
 }
 
 void ModuleContext::RemoveServiceListener(const ServiceListener& delegate, void* data)
@@ -80,6 +80,10 @@ ServiceTracker<S,TTT>::ServiceTracker(ModuleContext *context, _ServiceTrackerCus
 template<class S, class TTT>
 void ServiceTracker<S,TTT>::Open()
 {
+  /* Load deferred modules outside of synchronized region, their activators
+     register services which are delivered to the tracker */
+  d->LoadDeferredModules();
+
   _TrackedService* t;
   {
     US_UNUSED(typename _ServiceTrackerPrivate::Lock(d));
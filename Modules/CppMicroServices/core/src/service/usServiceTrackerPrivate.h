@@ -70,6 +70,13 @@ public:
   std::vector<ServiceReference<S> > GetInitialReferences(const std::string& className,
                                                          const std::string& filterString);
 
+  /**
+   * Loads the deferred auto-load modules which may provide the tracked
+   * services. Their activators register services and thereby call back
+   * into the tracker, so this must be called before the tracker is locked.
+   */
+  void LoadDeferredModules();
+
   void GetServiceReferences_unlocked(std::vector<ServiceReference<S> >& refs, TrackedService<S,TTT>* t) const;
 
   /* set this to true to compile in debug messages */
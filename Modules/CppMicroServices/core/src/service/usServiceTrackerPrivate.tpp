@@ -128,6 +128,24 @@ std::vector<ServiceReference<S> > ServiceTrackerPrivate<S,TTT>::GetInitialRefere
   return result;
 }
 
+template<class S, class TTT>
+void ServiceTrackerPrivate<S,TTT>::LoadDeferredModules()
+{
+#ifdef US_ENABLE_AUTOLOADING_SUPPORT
+  // A lookup loads the deferred modules matching it. Modules may have been
+  // deferred while lazy auto-loading was enabled, so this does not depend
+  // on the current setting.
+  if (!trackClass.empty())
+  {
+    context->GetServiceReferences(trackClass, std::string());
+  }
+  else if (trackReference.GetModule() == nullptr)
+  {
+    context->GetServiceReferences(std::string(), listenerFilter.empty() ? filter.ToString() : listenerFilter);
+  }
+#endif
+}
+
 template<class S, class TTT>
 void ServiceTrackerPrivate<S,TTT>::GetServiceReferences_unlocked(std::vector<ServiceReference<S> >& refs, TrackedService<S,TTT>* t) const
 {
@@ -23,12 +23,17 @@
 
 #include "usLog_p.h"
 #include "usModuleInfo.h"
+#include "usModuleManifest_p.h"
 #include "usModuleSettings.h"
+#include "usStaticInit_p.h"
+#include "usThreads_p.h"
 
 #include <string>
 #include <cstdio>
 #include <cctype>
 #include <algorithm>
+#include <fstream>
+#include <thread>
 #include <typeinfo>
 
 #ifdef US_PLATFORM_POSIX
@@ -51,6 +56,57 @@
 
 namespace {
 
+// Suffix of the auto-load manifest, which is appended to the library file name
+const char AUTOLOAD_MANIFEST_SUFFIX[] = ".autoload.json";
+
+bool has_suffix(const std::string& str, const std::string& suffix)
+{
+  return str.size() >= suffix.size() &&
+      str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Reads the service interfaces listed in the auto-load manifest of a library.
+// Returns false if there is no (valid) manifest.
+bool read_autoload_manifest(const std::string& modulePath, std::vector<std::string>& interfaces)
+{
+  std::ifstream manifestStream((modulePath + AUTOLOAD_MANIFEST_SUFFIX).c_str());
+  if (!manifestStream)
+  {
+    return false;
+  }
+
+  US_PREPEND_NAMESPACE(Any) interfacesValue;
+  try
+  {
+    US_PREPEND_NAMESPACE(ModuleManifest) manifest;
+    manifest.Parse(manifestStream);
+    interfacesValue = manifest.GetValue("interfaces");
+  }
+  catch (const std::exception& e)
+  {
+    US_WARN << "Parsing the auto-load manifest of " << modulePath << " failed: " << e.what();
+    return false;
+  }
+
+  if (interfacesValue.Type() != typeid(std::vector<US_PREPEND_NAMESPACE(Any)>))
+  {
+    US_WARN << "The auto-load manifest of " << modulePath << " does not contain an \"interfaces\" array.";
+    return false;
+  }
+
+  const std::vector<US_PREPEND_NAMESPACE(Any)>& interfaceValues =
+      US_PREPEND_NAMESPACE(ref_any_cast)<std::vector<US_PREPEND_NAMESPACE(Any)> >(interfacesValue);
+  for (std::vector<US_PREPEND_NAMESPACE(Any)>::const_iterator i = interfaceValues.begin();
+       i != interfaceValues.end(); ++i)
+  {
+    if (i->Type() == typeid(std::string))
+    {
+      interfaces.push_back(US_PREPEND_NAMESPACE(ref_any_cast)<std::string>(*i));
+    }
+  }
+  return true;
+}
+
 #if !defined(US_PLATFORM_LINUX)
 std::string library_suffix()
 {
@@ -106,6 +162,33 @@ bool load_impl(const std::string&) { return false; }
 
 US_BEGIN_NAMESPACE
 
+/**
+ * A module whose auto-loading was deferred, together with the service
+ * interfaces listed in its auto-load manifest.
+ */
+struct DeferredModule
+{
+  DeferredModule(const std::string& path, const std::vector<std::string>& interfaces)
+    : path(path), interfaces(interfaces), loading(false)
+  {}
+
+  std::string path;
+  std::vector<std::string> interfaces;
+  /** Whether the module is being loaded by loadingThread right now */
+  bool loading;
+  std::thread::id loadingThread;
+};
+
+/**
+ * Modules whose auto-loading was deferred. A module stays in the list while it
+ * is loaded, waiters are notified when it has been removed.
+ */
+struct DeferredModuleList : public MultiThreaded<MutexLockingStrategy, WaitCondition>
+{
+  std::vector<DeferredModule> modules;
+};
+US_GLOBAL_STATIC(DeferredModuleList, deferredModules)
+
 std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBasePath, const std::string& subDir)
 {
   std::vector<std::string> loadedModules;
@@ -153,6 +236,11 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
 
       std::string entryFileName(ent->d_name);
 
+      if (has_suffix(entryFileName, AUTOLOAD_MANIFEST_SUFFIX))
+      {
+        loadFile = false;
+      }
+
       // On Linux, library file names can have version numbers appended. On other platforms, we
       // check the file ending. This could be refined for Linux in the future.
 #if !defined(US_PLATFORM_LINUX)
@@ -169,6 +257,17 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
         libPath += DIR_SEP;
       }
       libPath += entryFileName;
+
+      std::vector<std::string> interfaces;
+      if (ModuleSettings::IsLazyAutoLoadingEnabled() && read_autoload_manifest(libPath, interfaces))
+      {
+        US_DEBUG << "Deferring auto-loading of module " << libPath;
+        DeferredModuleList* deferred = deferredModules();
+        DeferredModuleList::Lock lock(deferred);
+        deferred->modules.push_back(DeferredModule(libPath, interfaces));
+        continue;
+      }
+
       US_DEBUG << "Auto-loading module " << libPath;
 
       if (!load_impl(libPath))
@@ -223,6 +322,78 @@ std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo)
   return loadedModules;
 }
 
+void LoadDeferredModules(const std::string& interfaceName)
+{
+  DeferredModuleList* deferred = deferredModules();
+  const std::thread::id currentThread = std::this_thread::get_id();
+
+  for (;;)
+  {
+    std::string modulePath;
+    {
+      DeferredModuleList::Lock lock(deferred);
+      bool loadingInOtherThread = false;
+      for (std::vector<DeferredModule>::iterator i = deferred->modules.begin();
+           i != deferred->modules.end(); ++i)
+      {
+        if (!interfaceName.empty() &&
+            std::find(i->interfaces.begin(), i->interfaces.end(), interfaceName) == i->interfaces.end())
+        {
+          continue;
+        }
+
+        if (!i->loading)
+        {
+          i->loading = true;
+          i->loadingThread = currentThread;
+          modulePath = i->path;
+          break;
+        }
+
+        // A module that is loaded by this thread is looking up services from its
+        // activator. Waiting for it would never return.
+        if (i->loadingThread != currentThread)
+        {
+          loadingInOtherThread = true;
+        }
+      }
+
+      if (modulePath.empty())
+      {
+        if (!loadingInOtherThread)
+        {
+          return;
+        }
+
+        // The services of the module are available when the other thread has loaded it
+        deferred->Wait();
+        continue;
+      }
+    }
+
+    // Load the module without holding the lock, its activator may look up services itself
+    US_DEBUG << "Auto-loading deferred module " << modulePath;
+    if (!load_impl(modulePath))
+    {
+      US_WARN << "Auto-loading of module " << modulePath << " failed.";
+    }
+
+    {
+      DeferredModuleList::Lock lock(deferred);
+      for (std::vector<DeferredModule>::iterator i = deferred->modules.begin();
+           i != deferred->modules.end(); ++i)
+      {
+        if (i->loading && i->path == modulePath && i->loadingThread == currentThread)
+        {
+          deferred->modules.erase(i);
+          break;
+        }
+      }
+      deferred->NotifyAll();
+    }
+  }
+}
+
 US_END_NAMESPACE
 
 //-------------------------------------------------------------------
@@ -38,6 +38,14 @@ struct ModuleInfo;
 
 std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo);
 
+/**
+ * Loads the modules whose auto-loading has been deferred and whose auto-load
+ * manifest lists the given service interface. If the interface name is empty,
+ * all deferred modules are loaded. If another thread is loading one of these
+ * modules, the call returns after that thread has loaded it.
+ */
+void LoadDeferredModules(const std::string& interfaceName);
+
 US_END_NAMESPACE
 
 //-------------------------------------------------------------------
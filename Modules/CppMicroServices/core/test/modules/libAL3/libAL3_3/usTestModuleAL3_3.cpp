@@ -0,0 +1,47 @@
+/*============================================================================
+
+  Library: CppMicroServices
+
+  Copyright (c) German Cancer Research Center (DKFZ)
+  All rights reserved.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+============================================================================*/
+
+#include <usModuleActivator.h>
+#include <usModuleContext.h>
+#include <usGlobalConfig.h>
+
+US_BEGIN_NAMESPACE
+
+class TestModuleAL3_3Activator : public ModuleActivator
+{
+public:
+
+  void Load(ModuleContext* context) override
+  {
+    InterfaceMap service;
+    service.insert(std::make_pair(std::string("org.cppmicroservices.TestModuleAL3_3Service"),
+                                  static_cast<void*>(this)));
+    context->RegisterService(service);
+  }
+
+  void Unload(ModuleContext*) override
+  {
+  }
+};
+
+US_END_NAMESPACE
+
+US_EXPORT_MODULE_ACTIVATOR(US_PREPEND_NAMESPACE(TestModuleAL3_3Activator))
@@ -25,6 +25,8 @@
 #include <usModuleRegistry.h>
 #include <usModule.h>
 #include <usModuleSettings.h>
+#include <usServiceEvent.h>
+#include <usServiceTracker.h>
 #include <usSharedLibrary.h>
 
 #include <usTestingConfig.h>
@@ -33,6 +35,7 @@
 #include "usTestingMacros.h"
 
 #include <cassert>
+#include <thread>
 
 US_USE_NAMESPACE
 
@@ -156,6 +159,89 @@ void testCustomAutoLoadPath()
   mc->RemoveModuleListener(&listener, &TestModuleListener::ModuleChanged);
 }
 
+struct ServiceRegistrationListener
+{
+  ServiceRegistrationListener() : registeredCount(0) {}
+
+  void ServiceChanged(const ServiceEvent event)
+  {
+    if (event.GetType() == ServiceEvent::REGISTERED)
+    {
+      ++registeredCount;
+    }
+  }
+
+  int registeredCount;
+};
+
+void testLazyAutoLoad()
+{
+  ModuleContext* mc = GetModuleContext();
+  assert(mc);
+
+  ModuleSettings::SetLazyAutoLoadingEnabled(true);
+
+  SharedLibrary libAL3(LIB_PATH, "TestModuleAL3");
+
+  try
+  {
+    libAL3.Load();
+  }
+  catch (const std::exception& e)
+  {
+    US_TEST_FAILED_MSG(<< "Load module exception: " << e.what())
+  }
+
+  ModuleSettings::SetLazyAutoLoadingEnabled(false);
+
+  Module* moduleAL3 = ModuleRegistry::GetModule("TestModuleAL3");
+  US_TEST_CONDITION_REQUIRED(moduleAL3 != nullptr, "Test for existing module TestModuleAL3")
+  US_TEST_CONDITION(moduleAL3->GetProperty(Module::PROP_AUTOLOADED_MODULES()).Empty(), "Test for empty PROP_AUTOLOADED_MODULES property")
+  US_TEST_CONDITION_REQUIRED(ModuleRegistry::GetModule("TestModuleAL3_1") == nullptr, "Test for deferred module TestModuleAL3_1")
+
+#ifdef US_ENABLE_THREADING_SUPPORT
+  // A concurrent lookup of the same interface returns after the module has been loaded
+  std::vector<ServiceReferenceU> concurrentRefs;
+  std::thread lookupThread([mc, &concurrentRefs]() {
+    concurrentRefs = mc->GetServiceReferences("org.cppmicroservices.TestModuleAL3_1Service");
+  });
+#endif
+
+  std::vector<ServiceReferenceU> refs = mc->GetServiceReferences("org.cppmicroservices.TestModuleAL3_1Service");
+
+#ifdef US_ENABLE_THREADING_SUPPORT
+  lookupThread.join();
+  US_TEST_CONDITION(concurrentRefs.size() == 1, "Test for service of the deferred module in a concurrent lookup")
+#endif
+
+  Module* moduleAL3_1 = ModuleRegistry::GetModule("TestModuleAL3_1");
+  US_TEST_CONDITION_REQUIRED(moduleAL3_1 != nullptr, "Test for module TestModuleAL3_1 loaded by service lookup")
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1, "Test for service of the deferred module")
+  US_TEST_CONDITION(refs.front().GetModule() == moduleAL3_1, "Test for module of the service")
+
+  // Opening a tracker loads the deferred module while the tracker is not locked yet,
+  // the service registered by its activator is tracked
+  ServiceTracker<void> tracker(mc, "org.cppmicroservices.TestModuleAL3_2Service");
+  tracker.Open();
+
+  Module* moduleAL3_2 = ModuleRegistry::GetModule("TestModuleAL3_2");
+  US_TEST_CONDITION_REQUIRED(moduleAL3_2 != nullptr, "Test for module TestModuleAL3_2 loaded by opening a service tracker")
+  US_TEST_CONDITION(tracker.GetServiceReferences().size() == 1, "Test for tracked service of the deferred module")
+  tracker.Close();
+
+  // Adding a listener for an interface loads the deferred module after the listener was added
+  ServiceRegistrationListener listener;
+  mc->AddServiceListener(&listener, &ServiceRegistrationListener::ServiceChanged,
+                         "(objectclass=org.cppmicroservices.TestModuleAL3_3Service)");
+
+  Module* moduleAL3_3 = ModuleRegistry::GetModule("TestModuleAL3_3");
+  US_TEST_CONDITION_REQUIRED(moduleAL3_3 != nullptr, "Test for module TestModuleAL3_3 loaded by adding a service listener")
+  US_TEST_CONDITION(listener.registeredCount == 1, "Test for registration event of the deferred module's service")
+  mc->RemoveServiceListener(&listener, &ServiceRegistrationListener::ServiceChanged);
+
+  libAL3.Unload();
+}
+
 } // end unnamed namespace
 
 
@@ -171,5 +257,7 @@ int usModuleAutoLoadTest(int /*argc*/, char* /*argv*/[])
 
   testCustomAutoLoadPath();
 
+  testLazyAutoLoad();
+
   US_TEST_END()
 }
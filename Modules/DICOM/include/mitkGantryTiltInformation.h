@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include "mitkVector.h"
 #include "mitkPoint.h"
 
+#include "MitkDICOMExports.h"
+
 namespace mitk
 {
 
@@ -35,7 +37,7 @@ namespace mitk
   This class is a helper to DICOMITKSeriesGDCMReader and can
   not be used outside of \ref DICOMModule
  */
-class GantryTiltInformation
+class MITKDICOM_EXPORT GantryTiltInformation
 {
   public:
 
@@ -41,6 +41,28 @@ class ITKDICOMSeriesReaderHelper
 
     static bool CanHandleFile(const std::string& filename);
 
+    /** Creates an image (without allocating its buffer) that describes the geometry of
+        @p input after gantry tilt correction: slices are enlarged in Y direction to
+        accomodate the shifted slices, the origin is moved accordingly and the Z spacing
+        is replaced by the real inter-slice distance.
+    */
+    template <typename ImageType>
+    static typename ImageType::Pointer
+    CreateTiltCorrectedGeometry( const ImageType* input, const GantryTiltInformation& tiltInfo );
+
+    /** Undoes the gantry tilt of @p input by shifting each slice in Y direction (linear interpolation)
+        and writes the result into @p output, which must be a buffer with the size of @p correctedGeometry
+        (see CreateTiltCorrectedGeometry). Positions outside of the read slices get @p paddingValue.
+        Slices are processed in parallel.
+    */
+    template <typename ImageType>
+    static void
+    ShearTiltedSlices( const ImageType* input,
+                       const ImageType* correctedGeometry,
+                       const GantryTiltInformation& tiltInfo,
+                       typename ImageType::PixelType paddingValue,
+                       typename ImageType::PixelType* output );
+
   private:
 
     typedef std::vector<TimeBounds> TimeBoundsList;
@@ -79,9 +101,13 @@ class ITKDICOMSeriesReaderHelper
     */
     static TimeGeometry::Pointer GenerateTimeGeometry(const BaseGeometry* templateGeometry, const TimeBoundsList& boundsList);
 
-    template <typename ImageType>
-    typename ImageType::Pointer
-    FixUpTiltedGeometry( ImageType* input, const GantryTiltInformation& tiltInfo );
+    /** Returns the (0028,0120) Pixel Padding Value of the series read by @p io, rescaled like the
+        pixels and clamped to the range of PixelType. Without padding value the minimum of PixelType
+        is returned.
+    */
+    template <typename PixelType>
+    static PixelType
+    GetPixelPaddingValue( const itk::GDCMImageIO* io );
 
     template <typename PixelType>
     Image::Pointer
@@ -12,12 +12,17 @@ found in the LICENSE file.
 
 #include "mitkITKDICOMSeriesReaderHelper.h"
 
+#include <mitkImageWriteAccessor.h>
+#include <mitkParallelFor.h>
+
 #include <itkImageSeriesReader.h>
-#include <itkResampleImageFilter.h>
-//#include <itkAffineTransform.h>
-//#include <itkLinearInterpolateImageFunction.h>
+#include <itkMetaDataObject.h>
 //#include <itkTimeProbesCollectorBase.h>
 
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
 #include "dcmtk/ofstd/ofdatime.h"
 
 template <typename PixelType>
@@ -52,11 +57,18 @@ mitk::ITKDICOMSeriesReaderHelper
   // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
   if (correctTilt)
   {
-    readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
-  }
+    // the corrected slices are written directly into the image, no intermediate volume is needed
+    typename ImageType::Pointer correctedGeometry = CreateTiltCorrectedGeometry( readVolume.GetPointer(), tiltInfo );
+    image->InitializeByItk(correctedGeometry.GetPointer());
 
-  image->InitializeByItk(readVolume.GetPointer());
-  image->SetImportVolume(readVolume->GetBufferPointer());
+    mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(0));
+    ShearTiltedSlices( readVolume.GetPointer(), correctedGeometry.GetPointer(), tiltInfo, GetPixelPaddingValue<PixelType>( io ), static_cast<PixelType*>(accessor.GetData()) );
+  }
+  else
+  {
+    image->InitializeByItk(readVolume.GetPointer());
+    image->SetImportVolume(readVolume->GetBufferPointer());
+  }
 
 #ifdef MBILOG_ENABLE_DEBUG
 
@@ -126,13 +138,23 @@ mitk::ITKDICOMSeriesReaderHelper
   typename ImageType::Pointer readVolume = reader->GetOutput();
 
   // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
+  typename ImageType::Pointer correctedGeometry;
+  PixelType paddingValue = PixelType();
   if (correctTilt)
   {
-    readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
-  }
+    // the corrected slices are written directly into the image, no intermediate volume is needed
+    correctedGeometry = CreateTiltCorrectedGeometry( readVolume.GetPointer(), tiltInfo );
+    image->InitializeByItk(correctedGeometry.GetPointer(), 1, numberOfTimeSteps);
+    paddingValue = GetPixelPaddingValue<PixelType>( io );
 
-  image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
-  image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep++); // timestep 0
+    mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(currentTimeStep++)); // timestep 0
+    ShearTiltedSlices( readVolume.GetPointer(), correctedGeometry.GetPointer(), tiltInfo, paddingValue, static_cast<PixelType*>(accessor.GetData()) );
+  }
+  else
+  {
+    image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
+    image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep++); // timestep 0
+  }
 
   // for other time-steps
   for (auto timestepsIter = ++(filenamesForTimeSteps.cbegin()); // start with SECOND entry
@@ -150,10 +172,13 @@ mitk::ITKDICOMSeriesReaderHelper
 
     if (correctTilt)
     {
-      readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+      mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(currentTimeStep));
+      ShearTiltedSlices( readVolume.GetPointer(), correctedGeometry.GetPointer(), tiltInfo, paddingValue, static_cast<PixelType*>(accessor.GetData()) );
+    }
+    else
+    {
+      image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep);
     }
-
-    image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep);
   }
 
 #ifdef MBILOG_ENABLE_DEBUG
@@ -173,98 +198,56 @@ mitk::ITKDICOMSeriesReaderHelper
 }
 
 
-template <typename ImageType>
-typename ImageType::Pointer
+template <typename PixelType>
+PixelType
 mitk::ITKDICOMSeriesReaderHelper
-::FixUpTiltedGeometry( ImageType* input, const GantryTiltInformation& tiltInfo )
+::GetPixelPaddingValue( const itk::GDCMImageIO* io )
 {
-  typedef itk::ResampleImageFilter<ImageType,ImageType> ResampleFilterType;
-  typename ResampleFilterType::Pointer resampler = ResampleFilterType::New();
-  resampler->SetInput( input );
-
   /*
-     Transform for a point is
-      - transform from actual position to index coordinates
-      - apply a shear that undoes the gantry tilt
-      - transform back into world coordinates
-
-     Anybody who does this in a simpler way: don't forget to write up how and why your solution works
-  */
-  typedef itk::ScalableAffineTransform< double, ImageType::ImageDimension > TransformType;
-  typename TransformType::Pointer transformShear = TransformType::New();
-
-  /**
-    - apply a shear and spacing correction to the image block that corrects the ITK reader's error
-      - ITK ignores the shear and loads slices into an orthogonal volume
-      - ITK calculates the spacing from the origin distance, which is more than the actual spacing with gantry tilt images
-    - to undo the effect
-      - we have calculated some information in tiltInfo:
-        - the shift in Y direction that is added with each additional slice is the most important information
-        - the Y-shift is calculated in mm world coordinates
-      - we apply a shearing transformation to the ITK-read image volume
-        - to do this locally,
-          - we transform the image volume back to origin and "normal" orientation by applying the inverse of its transform
-            (this brings us into the image's "index coordinate" system)
-          - we apply a shear with the Y-shift factor put into a unit transform at row 1, col 2
-          - we transform the image volume back to its actual position (from index to world coordinates)
-      - we lastly apply modify the image spacing in z direction by replacing this number with the correctly calulcated inter-slice distance
+     Without padding value there is no meaningful value for positions outside of the image.
+     For CT, HU -1000 might be meaningful, but a general solution seems not possible. Even for CT,
+     -1000 would only look natural for many not all images.
   */
+  PixelType paddingValue = itk::NumericTraits<PixelType>::min();
 
-  const ScalarType factor = tiltInfo.GetMatrixCoefficientForCorrectionInWorldCoordinates() / input->GetSpacing()[1];
-  // row 1, column 2 corrects shear in parallel to Y axis, proportional to distance in Z direction
-  transformShear->Shear( 1, 2, factor );
-
-  typename TransformType::Pointer imageIndexToWorld = TransformType::New();
-  imageIndexToWorld->SetOffset( input->GetOrigin().GetVectorFromOrigin() );
-
-  typename TransformType::MatrixType indexToWorldMatrix;
-  indexToWorldMatrix = input->GetDirection();
-
-  typename ImageType::DirectionType scale;
-  for ( unsigned int i = 0; i < ImageType::ImageDimension; i++ )
+  std::string paddingString;
+  if ( itk::ExposeMetaData<std::string>( io->GetMetaDataDictionary(), "0028|0120", paddingString ) )
   {
-    scale[i][i] = input->GetSpacing()[i];
+    std::istringstream paddingStream( paddingString );
+    double storedValue = 0.0;
+    if ( paddingStream >> storedValue )
+    {
+      // the padding value is a stored value, while GDCMImageIO delivers rescaled pixels
+      typedef typename itk::NumericTraits<PixelType>::ValueType ComponentType;
+      const double value = storedValue * io->GetRescaleSlope() + io->GetRescaleIntercept();
+      const double lowest = static_cast<double>( itk::NumericTraits<ComponentType>::NonpositiveMin() );
+      const double highest = static_cast<double>( itk::NumericTraits<ComponentType>::max() );
+      paddingValue = PixelType( static_cast<ComponentType>( std::max( lowest, std::min( highest, value ) ) ) );
+    }
   }
-  indexToWorldMatrix *= scale;
-
-  imageIndexToWorld->SetMatrix( indexToWorldMatrix );
-
-  typename TransformType::Pointer imageWorldToIndex = TransformType::New();
-  imageIndexToWorld->GetInverse( imageWorldToIndex );
-
-  typename TransformType::Pointer gantryTiltCorrection = TransformType::New();
-  gantryTiltCorrection->Compose( imageWorldToIndex );
-  gantryTiltCorrection->Compose( transformShear );
-  gantryTiltCorrection->Compose( imageIndexToWorld );
-
-  resampler->SetTransform( gantryTiltCorrection );
 
-  typedef itk::LinearInterpolateImageFunction< ImageType, double > InterpolatorType;
-  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
-  resampler->SetInterpolator( interpolator );
-  /*
-     This would be the right place to invent a meaningful value for positions outside of the image.
-     For CT, HU -1000 might be meaningful, but a general solution seems not possible. Even for CT,
-     -1000 would only look natural for many not all images.
-  */
+  return paddingValue;
+}
 
-  // TODO use (0028,0120) Pixel Padding Value if present
-  resampler->SetDefaultPixelValue( itk::NumericTraits< typename ImageType::PixelType >::min() );
+template <typename ImageType>
+typename ImageType::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::CreateTiltCorrectedGeometry( const ImageType* input, const GantryTiltInformation& tiltInfo )
+{
+  typename ImageType::Pointer result = ImageType::New();
+  result->CopyInformation( input ); // we basically need the same image again, just sheared
 
   // adjust size in Y direction! (maybe just transform the outer last pixel to see how much space we would need
 
-  resampler->SetOutputParametersFromImage( input ); // we basically need the same image again, just sheared
-
-
   // if tilt positive, then we need additional pixels BELOW origin, otherwise we need pixels behind the end of the block
 
   // in any case we need more size to accomodate shifted slices
-  typename ImageType::SizeType largerSize = resampler->GetSize(); // now the resampler already holds the input image's size.
+  typename ImageType::RegionType region = input->GetLargestPossibleRegion();
+  typename ImageType::SizeType largerSize = region.GetSize();
   const double imageSizeZ = largerSize[2];
-  //MITK_DEBUG <<"Calculate lager size = " << largerSize[1] << " + " << tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) << " / " << input->GetSpacing()[1] << "+ 2.0";
   largerSize[1] += static_cast<typename ImageType::SizeType::SizeValueType>(tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) / input->GetSpacing()[1]+ 2.0);
-  resampler->SetSize( largerSize );
-  //MITK_DEBUG << "Fix Y size of image w/ spacing " << input->GetSpacing()[1] << " from " << input->GetLargestPossibleRegion().GetSize()[1] << " to " << largerSize[1];
+  region.SetSize( largerSize );
+  result->SetRegions( region );
 
   // in SOME cases this additional size is below/behind origin
   if ( tiltInfo.GetMatrixCoefficientForCorrectionInWorldCoordinates() > 0.0 )
@@ -284,12 +267,9 @@ mitk::ITKDICOMSeriesReaderHelper
     shiftedOrigin[1] -= yDirection[1] * (tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) + 1.0 * input->GetSpacing()[1]);
     shiftedOrigin[2] -= yDirection[2] * (tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) + 1.0 * input->GetSpacing()[1]);
 
-    resampler->SetOutputOrigin( shiftedOrigin );
+    result->SetOrigin( shiftedOrigin );
   }
 
-  resampler->Update();
-  typename ImageType::Pointer result = resampler->GetOutput();
-
   // ImageSeriesReader calculates z spacing as the distance between the first two origins.
   // This is not correct in case of gantry tilt, so we set our calculated spacing.
   typename ImageType::SpacingType correctedSpacing = result->GetSpacing();
@@ -299,4 +279,86 @@ mitk::ITKDICOMSeriesReaderHelper
   return result;
 }
 
+template <typename ImageType>
+void
+mitk::ITKDICOMSeriesReaderHelper
+::ShearTiltedSlices( const ImageType* input,
+                     const ImageType* correctedGeometry,
+                     const GantryTiltInformation& tiltInfo,
+                     typename ImageType::PixelType paddingValue,
+                     typename ImageType::PixelType* output )
+{
+  typedef typename ImageType::PixelType PixelType;
+  typedef typename itk::NumericTraits<PixelType>::RealType RealType;
+
+  /**
+    - ITK ignores the shear of gantry tilt images and loads slices into an orthogonal volume
+    - in index coordinates, undoing this is a shear with the Y-shift factor at row 1, col 2:
+      each slice is shifted in Y direction, proportional to its Z index
+    - so instead of resampling the whole volume, every row of the corrected slice is
+      interpolated linearly between two rows of the read slice
+    - positions outside of the read slice get the padding value and the same half pixel
+      border handling as the itk::ResampleImageFilter / itk::LinearInterpolateImageFunction
+      combination that was used before
+  */
+  const typename ImageType::SizeType inputSize = input->GetLargestPossibleRegion().GetSize();
+  const typename ImageType::SizeType outputSize = correctedGeometry->GetLargestPossibleRegion().GetSize();
+
+  const std::size_t columns = inputSize[0];
+  const long inputRows = static_cast<long>(inputSize[1]);
+  const long outputRows = static_cast<long>(outputSize[1]);
+
+  std::size_t numberOfSlices = 1;
+  for (unsigned int i = 2; i < ImageType::ImageDimension; ++i)
+  {
+    numberOfSlices *= inputSize[i];
+  }
+
+  const double factor = tiltInfo.GetMatrixCoefficientForCorrectionInWorldCoordinates() / input->GetSpacing()[1];
+
+  // Y index of the first row of the corrected slices within the read slices
+  itk::ContinuousIndex<double, ImageType::ImageDimension> originIndex;
+  input->TransformPhysicalPointToContinuousIndex( correctedGeometry->GetOrigin(), originIndex );
+  const double rowOffset = originIndex[1];
+
+  const PixelType* inputBuffer = input->GetBufferPointer();
+
+  auto shearSlice = [&](std::size_t slice)
+  {
+    const double shift = rowOffset + factor * static_cast<double>(slice % inputSize[2]);
+    const PixelType* inputSlice = inputBuffer + slice * columns * inputRows;
+    PixelType* outputSlice = output + slice * columns * outputRows;
+
+    for (long row = 0; row < outputRows; ++row)
+    {
+      PixelType* outputRow = outputSlice + row * columns;
+      const double y = row + shift;
+
+      if (y < -0.5 || y >= inputRows - 0.5)
+      {
+        std::fill(outputRow, outputRow + columns, paddingValue);
+        continue;
+      }
+
+      const long base = std::max(0L, static_cast<long>(std::floor(y)));
+      const double weight = y - base;
+      const PixelType* inputRow = inputSlice + base * columns;
+
+      if (weight <= 0.0 || base + 1 >= inputRows)
+      {
+        std::copy(inputRow, inputRow + columns, outputRow);
+        continue;
+      }
+
+      const PixelType* nextInputRow = inputRow + columns;
+      for (std::size_t x = 0; x < columns; ++x)
+      {
+        const RealType value = static_cast<RealType>(inputRow[x]);
+        outputRow[x] = static_cast<PixelType>(value + (static_cast<RealType>(nextInputRow[x]) - value) * weight);
+      }
+    }
+  };
+
+  mitk::ParallelFor(numberOfSlices, shearSlice);
+}
 
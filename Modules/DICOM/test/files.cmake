@@ -4,6 +4,7 @@ set(MODULE_TESTS
   mitkDICOMSimpleVolumeImportTest.cpp
   mitkDICOMTagPathTest.cpp
   mitkDICOMPropertyTest.cpp
+  mitkITKDICOMSeriesReaderHelperTest.cpp
 )
 
 set(MODULE_CUSTOM_TESTS
@@ -0,0 +1,230 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkITKDICOMSeriesReaderHelper.txx"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkResampleImageFilter.h>
+#include <itkScalableAffineTransform.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class mitkITKDICOMSeriesReaderHelperTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkITKDICOMSeriesReaderHelperTestSuite);
+
+  MITK_TEST(ShearTiltedSlices_PositiveTilt_EqualsResampling);
+  MITK_TEST(ShearTiltedSlices_NegativeTilt_EqualsResampling);
+  MITK_TEST(ShearTiltedSlices_FloatPixels_EqualsResampling);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  /** Gantry tilt correction as it was done with itk::ResampleImageFilter before ShearTiltedSlices() */
+  template <typename ImageType>
+  static typename ImageType::Pointer ResampleTiltedVolume(ImageType* input,
+                                                          const mitk::GantryTiltInformation& tiltInfo,
+                                                          typename ImageType::PixelType paddingValue)
+  {
+    typedef itk::ResampleImageFilter<ImageType, ImageType> ResampleFilterType;
+    typename ResampleFilterType::Pointer resampler = ResampleFilterType::New();
+    resampler->SetInput( input );
+
+    typedef itk::ScalableAffineTransform< double, ImageType::ImageDimension > TransformType;
+    typename TransformType::Pointer transformShear = TransformType::New();
+
+    const double factor = tiltInfo.GetMatrixCoefficientForCorrectionInWorldCoordinates() / input->GetSpacing()[1];
+    transformShear->Shear( 1, 2, factor );
+
+    typename TransformType::Pointer imageIndexToWorld = TransformType::New();
+    imageIndexToWorld->SetOffset( input->GetOrigin().GetVectorFromOrigin() );
+
+    typename TransformType::MatrixType indexToWorldMatrix;
+    indexToWorldMatrix = input->GetDirection();
+
+    typename ImageType::DirectionType scale;
+    for ( unsigned int i = 0; i < ImageType::ImageDimension; i++ )
+    {
+      scale[i][i] = input->GetSpacing()[i];
+    }
+    indexToWorldMatrix *= scale;
+
+    imageIndexToWorld->SetMatrix( indexToWorldMatrix );
+
+    typename TransformType::Pointer imageWorldToIndex = TransformType::New();
+    imageIndexToWorld->GetInverse( imageWorldToIndex );
+
+    typename TransformType::Pointer gantryTiltCorrection = TransformType::New();
+    gantryTiltCorrection->Compose( imageWorldToIndex );
+    gantryTiltCorrection->Compose( transformShear );
+    gantryTiltCorrection->Compose( imageIndexToWorld );
+
+    resampler->SetTransform( gantryTiltCorrection );
+
+    typedef itk::LinearInterpolateImageFunction< ImageType, double > InterpolatorType;
+    typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+    resampler->SetInterpolator( interpolator );
+
+    resampler->SetDefaultPixelValue( paddingValue );
+    resampler->SetOutputParametersFromImage( input );
+
+    typename ImageType::SizeType largerSize = resampler->GetSize();
+    const double imageSizeZ = largerSize[2];
+    largerSize[1] += static_cast<typename ImageType::SizeType::SizeValueType>(tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) / input->GetSpacing()[1]+ 2.0);
+    resampler->SetSize( largerSize );
+
+    if ( tiltInfo.GetMatrixCoefficientForCorrectionInWorldCoordinates() > 0.0 )
+    {
+      typename ImageType::DirectionType imageDirection = input->GetDirection();
+      mitk::Vector3D yDirection;
+      yDirection[0] = imageDirection[0][1];
+      yDirection[1] = imageDirection[1][1];
+      yDirection[2] = imageDirection[2][1];
+      yDirection.Normalize();
+
+      typename ImageType::PointType shiftedOrigin;
+      shiftedOrigin = input->GetOrigin();
+
+      shiftedOrigin[0] -= yDirection[0] * (tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) + 1.0 * input->GetSpacing()[1]);
+      shiftedOrigin[1] -= yDirection[1] * (tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) + 1.0 * input->GetSpacing()[1]);
+      shiftedOrigin[2] -= yDirection[2] * (tiltInfo.GetTiltCorrectedAdditionalSize(imageSizeZ) + 1.0 * input->GetSpacing()[1]);
+
+      resampler->SetOutputOrigin( shiftedOrigin );
+    }
+
+    resampler->Update();
+    typename ImageType::Pointer result = resampler->GetOutput();
+
+    typename ImageType::SpacingType correctedSpacing = result->GetSpacing();
+    correctedSpacing[2] = tiltInfo.GetRealZSpacing();
+    result->SetSpacing( correctedSpacing );
+
+    return result;
+  }
+
+  /** Creates an obliquely oriented volume as ITK reads a tilted series (slice origins shifted by
+      shiftUp along the up vector per slice) and compares ShearTiltedSlices() with the resampling.
+      The shifts are chosen so that no position falls onto the half pixel border of the read slices,
+      where both implementations may decide differently due to rounding. */
+  template <typename PixelType>
+  static void CheckTiltCorrection(double shiftUp, PixelType paddingValue, double tolerance)
+  {
+    typedef itk::Image<PixelType, 3> ImageType;
+
+    // slices rotated by 30 degrees around Z and tilted by 20 degrees around their right vector
+    const double angleZ = 30.0 * itk::Math::pi / 180.0;
+    const double angleX = 20.0 * itk::Math::pi / 180.0;
+    mitk::Vector3D right;
+    right[0] = std::cos(angleZ);
+    right[1] = std::sin(angleZ);
+    right[2] = 0.0;
+    mitk::Vector3D up;
+    up[0] = -std::sin(angleZ) * std::cos(angleX);
+    up[1] = std::cos(angleZ) * std::cos(angleX);
+    up[2] = std::sin(angleX);
+    const mitk::Vector3D normal = itk::CrossProduct(right, up);
+
+    mitk::Point3D origin1;
+    origin1[0] = -20.0;
+    origin1[1] = 15.0;
+    origin1[2] = 7.0;
+    // the slices are 2.5 mm apart perpendicular to the slice planes
+    const mitk::Point3D origin2 = origin1 + normal * 2.5 + up * shiftUp;
+
+    const mitk::GantryTiltInformation tiltInfo(origin1, origin2, right, up, 1);
+    CPPUNIT_ASSERT(tiltInfo.IsRegularGantryTilt());
+
+    typename ImageType::RegionType region;
+    region.SetSize(0, 12);
+    region.SetSize(1, 10);
+    region.SetSize(2, 6);
+
+    typename ImageType::SpacingType spacing;
+    spacing[0] = 0.8;
+    spacing[1] = 0.65;
+    spacing[2] = origin1.EuclideanDistanceTo(origin2); // ImageSeriesReader uses the distance of the slice origins
+
+    typename ImageType::DirectionType direction;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      direction[i][0] = right[i];
+      direction[i][1] = up[i];
+      direction[i][2] = normal[i];
+    }
+
+    typename ImageType::Pointer input = ImageType::New();
+    input->SetRegions(region);
+    input->SetSpacing(spacing);
+    input->SetOrigin(origin1);
+    input->SetDirection(direction);
+    input->Allocate();
+
+    PixelType* inputBuffer = input->GetBufferPointer();
+    for (std::size_t i = 0; i < region.GetNumberOfPixels(); ++i)
+    {
+      inputBuffer[i] = static_cast<PixelType>(static_cast<double>((i * 37) % 200) - 100.0 + 0.25 * (i % 4));
+    }
+
+    typename ImageType::Pointer expected = ResampleTiltedVolume(input.GetPointer(), tiltInfo, paddingValue);
+
+    typename ImageType::Pointer correctedGeometry =
+      mitk::ITKDICOMSeriesReaderHelper::CreateTiltCorrectedGeometry(input.GetPointer(), tiltInfo);
+
+    const typename ImageType::RegionType& expectedRegion = expected->GetLargestPossibleRegion();
+    CPPUNIT_ASSERT_EQUAL(expectedRegion.GetSize(), correctedGeometry->GetLargestPossibleRegion().GetSize());
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->GetOrigin()[i], correctedGeometry->GetOrigin()[i], 1e-9);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->GetSpacing()[i], correctedGeometry->GetSpacing()[i], 1e-9);
+    }
+
+    std::vector<PixelType> output(expectedRegion.GetNumberOfPixels());
+    mitk::ITKDICOMSeriesReaderHelper::ShearTiltedSlices(
+      input.GetPointer(), correctedGeometry.GetPointer(), tiltInfo, paddingValue, output.data());
+
+    const PixelType* expectedBuffer = expected->GetBufferPointer();
+    for (std::size_t i = 0; i < output.size(); ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Pixel " + std::to_string(i),
+                                           static_cast<double>(expectedBuffer[i]),
+                                           static_cast<double>(output[i]),
+                                           tolerance);
+    }
+  }
+
+public:
+
+  /** Integer pixels may be truncated to the neighboring value, depending on the rounding of the positions */
+  void ShearTiltedSlices_PositiveTilt_EqualsResampling()
+  {
+    CheckTiltCorrection<short>(1.37, -2000, 1.0);
+  }
+
+  void ShearTiltedSlices_NegativeTilt_EqualsResampling()
+  {
+    CheckTiltCorrection<short>(-1.37, -2000, 1.0);
+  }
+
+  void ShearTiltedSlices_FloatPixels_EqualsResampling()
+  {
+    CheckTiltCorrection<float>(1.37, -1024.0f, 1e-3);
+    CheckTiltCorrection<float>(-0.7, -1024.0f, 1e-3);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkITKDICOMSeriesReaderHelper)
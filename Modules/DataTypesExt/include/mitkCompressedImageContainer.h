@@ -18,6 +18,7 @@ found in the LICENSE file.
 #include "mitkGeometry3D.h"
 #include "mitkImage.h"
 #include "mitkImageDataItem.h"
+#include "mitkImageMemory.h"
 
 #include <itkObject.h>
 
@@ -69,8 +70,9 @@ namespace mitk
 
     unsigned int m_NumberOfTimeSteps;
 
-    /// one for each timestep. first = pointer to compressed data; second = size of buffer in bytes
-    std::vector<std::pair<unsigned char *, unsigned long>> m_ByteBuffers;
+    /// one for each timestep, the compressed data is accounted by mitk::ImageMemory under the category
+    /// that is active while SetImage() is called
+    std::vector<ImageMemory::Allocation> m_ByteBuffers;
 
     BaseGeometry::Pointer m_ImageGeometry;
   };
@@ -12,6 +12,9 @@ found in the LICENSE file.
 
 #include "mitkApplyDiffImageOperation.h"
 
+#include <mitkImageMemory.h>
+#include <mitkUndoController.h>
+
 #include <itkCommand.h>
 
 mitk::ApplyDiffImageOperation::ApplyDiffImageOperation(OperationType operationType,
@@ -39,7 +42,8 @@ mitk::ApplyDiffImageOperation::ApplyDiffImageOperation(OperationType operationTy
     command->SetCallbackFunction(this, &ApplyDiffImageOperation::OnImageDeleted);
     m_DeleteTag = image->AddObserver(itk::DeleteEvent(), command);
 
-    // keep a compressed version of the image
+    // keep a compressed version of the image, it belongs to the undo history
+    ImageMemory::CategoryScope memoryCategory(UndoController::ImageMemoryCategory);
     zlibContainer = CompressedImageContainer::New();
     zlibContainer->SetImage(diffImage);
   }
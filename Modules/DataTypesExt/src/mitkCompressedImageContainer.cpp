@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include "itk_zlib.h"
 
 #include <cstdlib>
+#include <cstring>
 
 mitk::CompressedImageContainer::CompressedImageContainer() : m_PixelType(nullptr), m_ImageGeometry(nullptr)
 {
@@ -25,7 +26,7 @@ mitk::CompressedImageContainer::~CompressedImageContainer()
 {
   for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
   {
-    free(iter->first);
+    ImageMemory::Release(*iter);
   }
 
   delete m_PixelType;
@@ -35,7 +36,7 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
 {
   for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
   {
-    free(iter->first);
+    ImageMemory::Release(*iter);
   }
 
   m_ByteBuffers.clear();
@@ -111,13 +112,22 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
       }
     }
 
-    // only use the neccessary amount of memory, realloc the buffer!
-    byteBuffer = (unsigned char *)realloc(byteBuffer, destLen);
-    bufferSize = destLen;
-    // MITK_INFO << "Using " << bufferSize << " bytes to store compressed image (" << destLen << " needed)" <<
-    // std::endl;
+    // only keep the neccessary amount of memory
+    ImageMemory::Allocation compressedData;
+    try
+    {
+      compressedData = ImageMemory::Allocate(destLen);
+    }
+    catch (...)
+    {
+      free(byteBuffer);
+      throw;
+    }
+    std::memcpy(compressedData.Data, byteBuffer, destLen);
+    free(byteBuffer);
+    // MITK_INFO << "Using " << destLen << " bytes to store compressed image" << std::endl;
 
-    m_ByteBuffers.push_back(std::pair<unsigned char *, unsigned long>(byteBuffer, bufferSize));
+    m_ByteBuffers.push_back(compressedData);
   }
 }
 
@@ -141,8 +151,8 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
     ImageReadAccessor imgAcc(image, image->GetVolumeData(timeStep));
     auto *dest((unsigned char *)imgAcc.GetData());
     ::uLongf destLen(m_OneTimeStepImageSizeInBytes);
-    ::Bytef *source(iter->first);
-    ::uLongf sourceLen(iter->second);
+    ::Bytef *source(iter->Data);
+    ::uLongf sourceLen(iter->Size);
     int zlibRetVal = ::uncompress(dest, &destLen, source, sourceLen);
     if (itk::Object::GetDebug())
     {
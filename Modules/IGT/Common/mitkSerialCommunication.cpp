@@ -219,6 +219,51 @@ int mitk::SerialCommunication::Receive(std::string& answer, unsigned int numberO
 #endif
 }
 
+int mitk::SerialCommunication::ReceiveBytes(char* buffer, unsigned int numberOfBytes)
+{
+  if (numberOfBytes == 0)
+    return OK;
+  if (m_Connected == false || buffer == nullptr)
+    return ERROR_VALUE;
+
+#ifdef WIN32
+  if (m_ComPortHandle == INVALID_HANDLE_VALUE)
+    return ERROR_VALUE;
+
+  DWORD numberOfBytesRead = 0;
+  if (ReadFile(m_ComPortHandle, buffer, numberOfBytes, &numberOfBytesRead, nullptr) != 0 && numberOfBytesRead == numberOfBytes)
+    return OK;
+  else
+    return ERROR_VALUE;
+
+#else  // Posix
+  if (m_FileDescriptor == INVALID_HANDLE_VALUE)
+    return ERROR_VALUE;
+
+  unsigned long bytesRead = 0;
+  while (bytesRead < numberOfBytes)
+  {
+    ssize_t num = read(m_FileDescriptor, &buffer[bytesRead], numberOfBytes - bytesRead); // read all remaining bytes at once
+    if (num == -1) // ERROR_VALUE
+    {
+      if (errno == EAGAIN || errno == EINTR) // nonblocking, no byte there right now, but maybe next time
+        continue;
+      else
+        break; // ERROR_VALUE, stop trying to read
+    }
+    if (num == 0) // timeout or eof(?)
+      break;
+
+    bytesRead += num;
+  }
+
+  if (bytesRead == numberOfBytes)
+    return OK;           // everything was received
+  else
+    return ERROR_VALUE;  // some data was received, but not as much as expected
+#endif
+}
+
 int mitk::SerialCommunication::Send(const std::string& input, bool block)
 {
   //long retval = E2ERR_OPENFAILED;
@@ -151,6 +151,19 @@ namespace mitk
     */
     int Receive(std::string& answer, unsigned int numberOfBytes, const char *eol=nullptr);
 
+    /**
+    * \brief Read exactly numberOfBytes bytes from the serial interface into buffer
+    *
+    * In contrast to Receive(), the bytes are read with as few system calls as
+    * possible and no memory is allocated. This is meant for binary replies of
+    * known length. Returns 1 if all bytes were received within the
+    * ReceiveTimeout and 0 otherwise.
+    *
+    * \param[out] buffer  Memory for at least numberOfBytes bytes.
+    * \param[in] numberOfBytes  The number of bytes to read.
+    */
+    int ReceiveBytes(char* buffer, unsigned int numberOfBytes);
+
     /**
     * \brief Send the string input
     *
@@ -63,6 +63,7 @@ set(MODULE_CUSTOM_TESTS
   mitkNavigationToolReaderAndWriterTest.cpp #deactivated because of bug 18835
   mitkNavigationToolStorageSerializerAndDeserializerIntegrationTest.cpp # This test was disabled because of bug 17181.
   mitkNavigationToolStorageSerializerTest.cpp # This test was disabled because of bug 18671
+  mitkVirtualTrackingDeviceBenchmark.cpp
 )
 
 if(MITK_USE_POLHEMUS_TRACKER)
@@ -11,10 +11,24 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkNDIProtocol.h"
+#include "mitkNDITrackingDevice.h"
 
 #include "mitkTestingMacros.h"
 
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 /**Documentation
 * NDIProtocol has a protected constructor and a protected itkFactorylessNewMacro
@@ -37,6 +51,136 @@ protected:
   }
 };
 
+#ifndef WIN32
+/**Documentation
+* Gives the test access to the serial connection of the tracking device, so that it can be
+* connected to a pseudo terminal without the initialization sequence of OpenConnection().
+*/
+class NDITrackingDeviceTestClass : public mitk::NDITrackingDevice
+{
+public:
+  mitkClassMacro(NDITrackingDeviceTestClass, NDITrackingDevice);
+  itkFactorylessNewMacro(Self)
+
+  bool ConnectToDevice(const std::string& deviceName)
+  {
+    m_SerialCommunication = mitk::SerialCommunication::New();
+    m_SerialCommunication->SetDeviceName(deviceName);
+    m_SerialCommunication->SetReceiveTimeout(2000);
+    return m_SerialCommunication->OpenConnection() != 0;
+  }
+
+  void DisconnectFromDevice()
+  {
+    m_SerialCommunication->CloseConnection();
+  }
+
+  mitk::NDIProtocol* GetProtocol()
+  {
+    return m_DeviceProtocol;
+  }
+
+  static unsigned int CRC16(const std::vector<char>& data, std::size_t begin, std::size_t length)
+  {
+    return CalcCRC16(data.data() + begin, length);
+  }
+
+protected:
+  NDITrackingDeviceTestClass() : mitk::NDITrackingDevice()
+  {
+  }
+};
+
+static void AppendUInt16(std::vector<char>& data, unsigned int value)
+{
+  data.push_back(static_cast<char>(value & 0xff));
+  data.push_back(static_cast<char>((value >> 8) & 0xff));
+}
+
+static void AppendFloat32(std::vector<char>& data, float value)
+{
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  AppendUInt16(data, bits & 0xffff);
+  AppendUInt16(data, bits >> 16);
+}
+
+/** Binary BX reply with one valid handle 0A, as it is send by an NDI tracking device */
+static std::vector<char> CreateBXReply(float x, float y, float z, bool corruptBody)
+{
+  std::vector<char> body;
+  body.push_back(1);                    // number of handles
+  body.push_back(0x0A);                 // handle
+  body.push_back(0x01);                 // handle status: valid
+  const float transformation[8] = { 1.0f, 0.0f, 0.0f, 0.0f, x, y, z, 0.125f }; // q0, qx, qy, qz, tx, ty, tz, error
+  for (float value : transformation)
+    AppendFloat32(body, value);
+  body.insert(body.end(), 8, 0);        // port status and frame number
+  AppendUInt16(body, 0);                // system status
+
+  std::vector<char> reply;
+  AppendUInt16(reply, 0xA5C4);          // start sequence
+  AppendUInt16(reply, static_cast<unsigned int>(body.size()));
+  AppendUInt16(reply, NDITrackingDeviceTestClass::CRC16(reply, 0, 4));
+  reply.insert(reply.end(), body.begin(), body.end());
+  AppendUInt16(reply, NDITrackingDeviceTestClass::CRC16(body, 0, body.size()) ^ (corruptBody ? 0x1 : 0x0));
+  return reply;
+}
+
+/** Simulates the tracking device on the master side of a pseudo terminal: reads one command per reply and sends the reply */
+static void SimulateDevice(int masterFileDescriptor, std::vector<std::vector<char>> replies, std::vector<std::string>* commands)
+{
+  for (const auto& reply : replies)
+  {
+    std::string command;
+    char c = 0;
+    while (c != '\r' && read(masterFileDescriptor, &c, 1) == 1)
+      command += c;
+    commands->push_back(command);
+    if (write(masterFileDescriptor, reply.data(), reply.size()) != static_cast<ssize_t>(reply.size()))
+      return;
+  }
+}
+
+static void TestBinaryTrackingReply()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  MITK_TEST_CONDITION_REQUIRED(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0, "Creating pseudo terminal for the device simulator");
+
+  /* an SROM file is needed to add a tool, its content does not matter here */
+  std::string sromFile = std::string(ptsname(master)).substr(5) + ".rom";
+  for (auto& c : sromFile)
+    if (c == '/') c = '_';
+  { std::ofstream(sromFile.c_str(), std::ios::binary) << "SROM"; }
+
+  NDITrackingDeviceTestClass::Pointer device = NDITrackingDeviceTestClass::New();
+  auto* tool = dynamic_cast<mitk::NDIPassiveTool*>(device->AddTool("Tool", sromFile.c_str()));
+  std::remove(sromFile.c_str());
+  MITK_TEST_CONDITION_REQUIRED(tool != nullptr, "Adding a tool");
+  tool->SetPortHandle("0A");
+
+  MITK_TEST_CONDITION_REQUIRED(device->ConnectToDevice(ptsname(master)), "Connecting to the device simulator");
+
+  std::vector<std::string> commands;
+  std::thread simulator(SimulateDevice, master, std::vector<std::vector<char>>{ CreateBXReply(10.5f, -20.25f, 300.0f, false), CreateBXReply(1.0f, 2.0f, 3.0f, true) }, &commands);
+
+  MITK_TEST_CONDITION(device->GetProtocol()->BX() == mitk::NDIOKAY, "Testing BX() with a valid binary reply");
+  mitk::Point3D position;
+  tool->GetPosition(position);
+  MITK_TEST_CONDITION(tool->IsDataValid() && position[0] == 10.5 && position[1] == -20.25 && position[2] == 300.0, "Testing decoded position");
+  MITK_TEST_CONDITION(tool->GetTrackingError() == 0.125f, "Testing decoded tracking error");
+
+  MITK_TEST_CONDITION(device->GetProtocol()->BX() == mitk::NDICRCERROR, "Testing BX() with a corrupted binary reply");
+  MITK_TEST_CONDITION(!tool->IsDataValid(), "Testing that the tool is invalidated after a CRC error");
+
+  simulator.join();
+  MITK_TEST_CONDITION(commands.size() == 2 && commands[0].compare(0, 7, "BX:0001") == 0, "Testing BX command string");
+
+  device->DisconnectFromDevice();
+  close(master);
+}
+#endif
+
 /**Documentation
  *  Test for mitk::NDIProtocol
  */
@@ -59,6 +203,11 @@ int mitkNDIProtocolTest(int /* argc */, char* /*argv*/[])
 
 
 
+#ifndef WIN32
+  //BX: binary replies are tested with a device simulator on a pseudo terminal
+  TestBinaryTrackingReply();
+#endif
+
   //All other methods
   //No testing possible, hardware required
 
@@ -0,0 +1,134 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+
+#include "mitkVirtualTrackingDevice.h"
+#include "mitkTrackingDeviceSource.h"
+#include "mitkNavigationDataDisplacementFilter.h"
+#include "mitkNavigationDataSmoothingFilter.h"
+#include "mitkNavigationDataPassThroughFilter.h"
+#include "mitkIGTTimeStamp.h"
+#include <mitkIOUtil.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* Load test of the IGT filter pipeline without tracking hardware.
+*
+* A virtual tracking device with precomputed tool paths feeds a pipeline of
+* TrackingDeviceSource -> NavigationDataDisplacementFilter -> NavigationDataSmoothingFilter ->
+* NavigationDataPassThroughFilter. The stages are updated one after the other, so the time of
+* every update only contains the work of that stage. The latency of the last stage is measured
+* against the time stamps of the tracking device.
+*
+* Arguments (all optional): number of tools (200), refresh rate in Hz (1000), duration in s (5),
+* recorded navigation data set that is replayed instead of the generated paths.
+*/
+int mitkVirtualTrackingDeviceBenchmark(int argc, char* argv[])
+{
+  MITK_TEST_BEGIN("VirtualTrackingDeviceBenchmark");
+
+  const unsigned int numberOfTools = argc > 1 ? std::stoul(argv[1]) : 200;
+  const unsigned int rate = argc > 2 ? std::stoul(argv[2]) : 1000;
+  const double duration = argc > 3 ? std::stod(argv[3]) : 5.0;
+
+  mitk::VirtualTrackingDevice::Pointer device = mitk::VirtualTrackingDevice::New();
+  device->SetRandomSeed(42);
+  device->SetRefreshIntervalInMicroseconds(1000000 / std::max(1u, rate));
+  device->SetNumberOfTrajectorySamples(10000);
+  for (unsigned int i = 0; i < numberOfTools; ++i)
+  {
+    device->AddTool(("Tool" + std::to_string(i)).c_str());
+  }
+
+  if (argc > 4)
+  {
+    mitk::NavigationDataSet::Pointer replayData = dynamic_cast<mitk::NavigationDataSet*>(mitk::IOUtil::Load(argv[4])[0].GetPointer());
+    MITK_TEST_CONDITION_REQUIRED(replayData.IsNotNull(), "Loading replay data " << argv[4]);
+    device->SetReplayData(replayData);
+  }
+
+  mitk::TrackingDeviceSource::Pointer source = mitk::TrackingDeviceSource::New();
+  source->SetTrackingDevice(device);
+
+  mitk::NavigationDataDisplacementFilter::Pointer displacement = mitk::NavigationDataDisplacementFilter::New();
+  mitk::Vector3D offset;
+  mitk::FillVector3D(offset, 10.0, -5.0, 2.5);
+  displacement->SetOffset(offset);
+  displacement->ConnectTo(source);
+
+  mitk::NavigationDataSmoothingFilter::Pointer smoothing = mitk::NavigationDataSmoothingFilter::New();
+  smoothing->SetNumerOfValues(5);
+  smoothing->ConnectTo(displacement);
+
+  mitk::NavigationDataPassThroughFilter::Pointer passThrough = mitk::NavigationDataPassThroughFilter::New();
+  passThrough->ConnectTo(smoothing);
+
+  std::vector<mitk::NavigationDataSource*> stages = { source, displacement, smoothing, passThrough };
+  const std::vector<std::string> stageNames = { "TrackingDeviceSource", "DisplacementFilter", "SmoothingFilter", "PassThroughFilter" };
+
+  source->Connect();
+  source->StartTracking();
+
+  typedef std::chrono::steady_clock ClockType;
+  std::vector<std::vector<double>> stageTimes(stages.size());
+  std::vector<double> latencies;
+
+  const ClockType::time_point end = ClockType::now() + std::chrono::duration_cast<ClockType::duration>(std::chrono::duration<double>(duration));
+  const std::chrono::microseconds interval(device->GetRefreshIntervalInMicroseconds());
+  for (ClockType::time_point next = ClockType::now(); next < end; next += interval)
+  {
+    std::this_thread::sleep_until(next);
+
+    for (std::size_t stage = 0; stage < stages.size(); ++stage)
+    {
+      const ClockType::time_point stageStart = ClockType::now();
+      stages[stage]->Update();
+      stageTimes[stage].push_back(std::chrono::duration<double, std::micro>(ClockType::now() - stageStart).count());
+    }
+
+    const double now = mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+    latencies.push_back(now - passThrough->GetOutput(0)->GetIGTTimeStamp());
+  }
+
+  source->StopTracking();
+  source->Disconnect();
+
+  MITK_TEST_CONDITION_REQUIRED(!latencies.empty(), "Pipeline was updated during the benchmark");
+
+  auto percentile = [](std::vector<double> values, double p)
+  {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+  };
+
+  MITK_INFO << numberOfTools << " tools at " << rate << " Hz, " << latencies.size() << " pipeline updates";
+  for (std::size_t stage = 0; stage < stages.size(); ++stage)
+  {
+    MITK_INFO << std::setw(22) << stageNames[stage]
+              << "  median " << std::setw(8) << percentile(stageTimes[stage], 0.5) << " us"
+              << "  p99 " << std::setw(8) << percentile(stageTimes[stage], 0.99) << " us";
+  }
+  MITK_INFO << std::setw(22) << "End to end latency"
+            << "  median " << std::setw(8) << percentile(latencies, 0.5) << " ms"
+            << "  p99 " << std::setw(8) << percentile(latencies, 0.99) << " ms";
+
+  MITK_TEST_CONDITION(passThrough->GetNumberOfIndexedOutputs() == numberOfTools, "All tools reached the end of the pipeline");
+
+  MITK_TEST_END();
+}
@@ -15,11 +15,12 @@ found in the LICENSE file.
 #include "mitkTestFixture.h"
 
 //Std includes
+#include <cmath>
 #include <iomanip>
 
 //MITK includes
 #include "mitkVirtualTrackingDevice.h"
-#include "mitkVirtualTrackingDevice.h"
+#include "mitkVirtualTrackingTool.h"
 #include "mitkTrackingTool.h"
 
 //ITK includes
@@ -44,6 +45,9 @@ class mitkVirtualTrackingDeviceTestSuite : public mitk::TestFixture
   MITK_TEST(GetSplineCordLength_InvaldiToolIndex_Error);
   MITK_TEST(StartTracking_NewPositionsProduced);
   MITK_TEST(SetParamsForGaussianNoise_GetCorrrectParams);
+  MITK_TEST(SetRandomSeed_SameSeedSamePaths);
+  MITK_TEST(StartTracking_PrecomputedTrajectories_DeterministicTimeStamps);
+  MITK_TEST(StartTracking_ReplayData_RecordedPositionsProduced);
 
 
   CPPUNIT_TEST_SUITE_END();
@@ -52,6 +56,23 @@ private:
 
   mitk::VirtualTrackingDevice::Pointer m_TestTracker;
 
+  /** Waits until the tracking thread fulfilled condition. The timeout only guards against a hanging
+   *  thread, the assertions do not depend on how many frames were generated. */
+  template <typename TCondition>
+  static bool WaitFor(TCondition condition)
+  {
+    for (int i = 0; i < 1000 && !condition(); ++i)
+      itksys::SystemTools::Delay(10);
+    return condition();
+  }
+
+  static mitk::Point3D EvaluateSpline(mitk::TrackingTool *tool, double t)
+  {
+    mitk::Point3D position;
+    mitk::itk2vtk(dynamic_cast<mitk::VirtualTrackingTool *>(tool)->GetSpline()->EvaluateSpline(t), position);
+    return position;
+  }
+
 public:
 
   void setUp() override
@@ -159,6 +180,7 @@ public:
 
   void StartTracking_NewPositionsProduced()
   {
+    m_TestTracker->SetRandomSeed(1);
     m_TestTracker->AddTool("Tool1");
     mitk::Point3D posBefore;
     mitk::Point3D posAfter;
@@ -168,7 +190,8 @@ public:
     CPPUNIT_ASSERT_EQUAL(posBefore, posAfter);
     m_TestTracker->OpenConnection();
     m_TestTracker->StartTracking();
-    itksys::SystemTools::Delay(500);  //wait for tracking thread to start generating positions
+    CPPUNIT_ASSERT(WaitFor([&tool]() { return tool->IsDataValid(); }));
+    m_TestTracker->StopTracking();
     tool->GetPosition(posAfter);
     CPPUNIT_ASSERT(posBefore != posAfter);
   }
@@ -182,6 +205,80 @@ public:
     CPPUNIT_ASSERT_EQUAL(deviationDistribution, m_TestTracker->GetDeviationDistribution());
   }
 
+  void SetRandomSeed_SameSeedSamePaths()
+  {
+    mitk::VirtualTrackingDevice::Pointer sameSeedTracker = mitk::VirtualTrackingDevice::New();
+    mitk::VirtualTrackingDevice::Pointer otherSeedTracker = mitk::VirtualTrackingDevice::New();
+    m_TestTracker->SetRandomSeed(1);
+    sameSeedTracker->SetRandomSeed(1);
+    otherSeedTracker->SetRandomSeed(2);
+    mitk::TrackingTool *tool = m_TestTracker->AddTool("Tool1");
+    mitk::TrackingTool *sameSeedTool = sameSeedTracker->AddTool("Tool1");
+    mitk::TrackingTool *otherSeedTool = otherSeedTracker->AddTool("Tool1");
+
+    CPPUNIT_ASSERT_EQUAL(m_TestTracker->GetSplineChordLength(0), sameSeedTracker->GetSplineChordLength(0));
+    for (double t = 0.0; t < 1.0; t += 0.125)
+    {
+      CPPUNIT_ASSERT_EQUAL(EvaluateSpline(tool, t), EvaluateSpline(sameSeedTool, t));
+    }
+    CPPUNIT_ASSERT(EvaluateSpline(tool, 0.5) != EvaluateSpline(otherSeedTool, 0.5));
+  }
+
+  void StartTracking_PrecomputedTrajectories_DeterministicTimeStamps()
+  {
+    const unsigned int numberOfSamples = 1000;
+    const unsigned int refreshInterval = 500;
+    m_TestTracker->SetRandomSeed(1);
+    m_TestTracker->SetNumberOfTrajectorySamples(numberOfSamples);
+    m_TestTracker->SetRefreshIntervalInMicroseconds(refreshInterval);
+    m_TestTracker->DeterministicTimeStampsOn();
+    mitk::TrackingTool::Pointer tool = m_TestTracker->AddTool("Tool1");
+
+    m_TestTracker->OpenConnection();
+    m_TestTracker->StartTracking();
+    CPPUNIT_ASSERT(WaitFor([&tool]() { return tool->GetIGTTimeStamp() > 0.0; }));
+    m_TestTracker->StopTracking();
+
+    // the time stamp identifies the frame, the frame the precomputed sample of the tool
+    const double frame = tool->GetIGTTimeStamp() / (refreshInterval / 1000.0);
+    CPPUNIT_ASSERT(frame >= 1.0);
+    CPPUNIT_ASSERT_EQUAL(std::floor(frame), frame);
+
+    const double step = dynamic_cast<mitk::VirtualTrackingTool *>(tool.GetPointer())->GetVelocity() * (refreshInterval * 1e-6) * numberOfSamples;
+    const auto index = static_cast<std::size_t>(std::fmod((frame - 1) * step, static_cast<double>(numberOfSamples)));
+    mitk::Point3D position;
+    tool->GetPosition(position);
+    CPPUNIT_ASSERT_EQUAL(EvaluateSpline(tool, static_cast<double>(index) / numberOfSamples), position);
+    CPPUNIT_ASSERT(tool->IsDataValid());
+  }
+
+  void StartTracking_ReplayData_RecordedPositionsProduced()
+  {
+    mitk::NavigationDataSet::Pointer replayData = mitk::NavigationDataSet::New(1);
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    mitk::Point3D recordedPosition;
+    mitk::FillVector3D(recordedPosition, 1.0, 2.0, 3.0);
+    nd->SetPosition(recordedPosition);
+    nd->SetDataValid(true);
+    replayData->AddNavigationDatas({ nd });
+
+    m_TestTracker->SetRefreshIntervalInMicroseconds(1000);
+    m_TestTracker->DeterministicTimeStampsOn();
+    m_TestTracker->SetReplayData(replayData);
+    mitk::TrackingTool::Pointer tool = m_TestTracker->AddTool("Tool1");
+
+    m_TestTracker->OpenConnection();
+    m_TestTracker->StartTracking();
+    CPPUNIT_ASSERT(WaitFor([&tool]() { return tool->GetIGTTimeStamp() > 0.0; }));
+    m_TestTracker->StopTracking();
+
+    mitk::Point3D posAfter;
+    tool->GetPosition(posAfter);
+    CPPUNIT_ASSERT_EQUAL(recordedPosition, posAfter);
+    CPPUNIT_ASSERT(tool->IsDataValid());
+    CPPUNIT_ASSERT_EQUAL(std::floor(tool->GetIGTTimeStamp()), tool->GetIGTTimeStamp());
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkVirtualTrackingDevice)
@@ -19,7 +19,37 @@ found in the LICENSE file.
 #include <algorithm>
 #include <sstream>
 #include <itksys/SystemTools.hxx>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+
+namespace
+{
+  /* binary replies are little endian, independent of the byte order of the host */
+  inline unsigned int ReadUInt16(const char* data)
+  {
+    return static_cast<unsigned char>(data[0]) | (static_cast<unsigned char>(data[1]) << 8);
+  }
+
+  inline unsigned long ReadUInt32(const char* data)
+  {
+    return static_cast<unsigned long>(ReadUInt16(data)) | (static_cast<unsigned long>(ReadUInt16(data + 2)) << 16);
+  }
+
+  inline float ReadFloat32(const char* data)
+  {
+    const std::uint32_t bits = static_cast<std::uint32_t>(ReadUInt32(data));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  const unsigned int BXStartSequence = 0xA5C4;
+  const unsigned int BXHeaderSize = 6;          // start sequence, reply length and header CRC
+  const unsigned char BXHandleValid = 0x01;
+  const unsigned char BXHandleMissing = 0x02;
+  const unsigned char BXHandleDisabled = 0x04;
+}
 
 mitk::NDIProtocol::NDIProtocol()
 : itk::Object(), m_TrackingDevice(nullptr), m_UseCRC(true)
@@ -1168,8 +1198,171 @@ mitk::NDIErrorCode mitk::NDIProtocol::TX1000(MarkerPointContainerType* markerPos
 
 mitk::NDIErrorCode mitk::NDIProtocol::BX()
 {
-  std::cout << "BX() not implemented yet, using TX() instead." << std::endl;
-  return this->TX();
+  if (m_TrackingDevice == nullptr)
+    return TRACKINGDEVICENOTSET;
+
+  /* send command, reply option 0001 requests the transformation data */
+  std::string fullcommand;
+  if (m_UseCRC == true)
+    fullcommand = "BX:0001";          // command string format 1: with crc
+  else
+    fullcommand = "BX 0001";          // command string format 2: without crc
+
+  NDIErrorCode returnValue = m_TrackingDevice->Send(&fullcommand, m_UseCRC);
+  if (returnValue != NDIOKAY)
+  {
+    /* cleanup and return */
+    m_TrackingDevice->ClearReceiveBuffer();   // flush the buffer to remove the remaining carriage return or unknown/unexpected reply
+    return returnValue;
+  }
+
+  /* read the binary header: start sequence, length of the reply body and header CRC, 2 bytes each */
+  char header[BXHeaderSize];
+  returnValue = m_TrackingDevice->ReceiveBytes(header, BXHeaderSize);
+  if (returnValue != NDIOKAY)
+  {
+    m_TrackingDevice->ClearReceiveBuffer();
+    return returnValue;
+  }
+
+  if (ReadUInt16(header) != BXStartSequence)
+  {
+    /* errors are replied in text mode: ERROR + 2 characters error code + 4 characters CRC */
+    static const std::string error("ERROR");
+    std::string reply(header, BXHeaderSize);  // "ERRORx"
+    if (error.compare(0, 5, reply, 0, 5) == 0)
+    {
+      std::string s;
+      m_TrackingDevice->Receive(&s, 1);         // read the second character of the error code
+      reply += s;
+      std::string errorcode = reply.substr(5, 2);
+      /* perform CRC checking */
+      std::string expectedCRC = m_TrackingDevice->CalcCRC(&reply);    // calculate crc for received reply string
+      std::string readCRC;                      // read attached crc value
+      m_TrackingDevice->Receive(&readCRC, 4);   // CRC16 is 2 bytes long, which is transmitted as 4 hexadecimal digits
+      if (expectedCRC == readCRC)               // if the read CRC is correct, return normal error code
+        returnValue = this->GetErrorCode(&errorcode);
+      else                                      // return error in CRC
+        returnValue = NDICRCERROR;
+    }
+    else
+    {
+      returnValue = NDIUNEXPECTEDREPLY;
+    }
+    m_TrackingDevice->ClearReceiveBuffer();   // flush the buffer to remove the remaining carriage return or unknown/unexpected reply
+    return returnValue;
+  }
+
+  if (NDITrackingDevice::CalcCRC16(header, 4) != ReadUInt16(header + 4))
+  {
+    /* the reply length can not be trusted, so the rest of the reply can not be read */
+    m_TrackingDevice->InvalidateAll();
+    m_TrackingDevice->ClearReceiveBuffer();
+    return NDICRCERROR;
+  }
+
+  /* read the body and its CRC in one piece */
+  const unsigned int replyLength = ReadUInt16(header + 2);
+  if (m_BinaryReply.size() < replyLength + 2)
+    m_BinaryReply.resize(replyLength + 2);    // the buffer only grows, so it is allocated just once for a constant number of tools
+  const char* body = m_BinaryReply.data();
+
+  returnValue = m_TrackingDevice->ReceiveBytes(m_BinaryReply.data(), replyLength + 2);
+  if (returnValue != NDIOKAY)
+  {
+    m_TrackingDevice->InvalidateAll();
+    m_TrackingDevice->ClearReceiveBuffer();
+    return returnValue;
+  }
+
+  if (NDITrackingDevice::CalcCRC16(body, replyLength) != ReadUInt16(body + replyLength))
+  {
+    /* Invalidate all tools because the received data contained an error */
+    m_TrackingDevice->InvalidateAll();
+    return NDICRCERROR;
+  }
+
+  /* decode the body: number of handles, then for each handle the handle, its status and (depending on the status)
+     the transformation (8 floats), the port status and the frame number */
+  unsigned int position = 0;
+  if (replyLength < 1)
+    return NDIUNEXPECTEDREPLY;
+  const unsigned int numberOfHandles = static_cast<unsigned char>(body[position++]);
+
+  returnValue = NDIOKAY;
+  for (unsigned int i = 0; i < numberOfHandles; i++)    // for each handle
+  {
+    if (position + 2 > replyLength)
+    {
+      returnValue = NDIUNEXPECTEDREPLY;
+      break;
+    }
+    const auto handle = static_cast<unsigned char>(body[position++]);
+    const auto handleStatus = static_cast<unsigned char>(body[position++]);
+
+    /* port handles are used as two digit hexadecimal strings, like in the text mode replies */
+    char portHandle[3];
+    sprintf(portHandle, "%02X", handle);
+    NDIPassiveTool::Pointer tool = m_TrackingDevice->GetInternalTool(portHandle);   // get tool object for that handle
+    if (tool.IsNull())
+    {
+      returnValue = UNKNOWNHANDLERETURNED;
+      break;  // if we do not know the handle, we can not assume anything about the remaining data, so we better abort
+    }
+
+    if (handleStatus == BXHandleValid)
+    {
+      if (position + 40 > replyLength)
+      {
+        returnValue = NDIUNEXPECTEDREPLY;
+        break;
+      }
+      const char* transformation = body + position;
+      position += 40;   // 8 floats, 4 bytes port status, 4 bytes frame number
+
+      mitk::Quaternion orientation(ReadFloat32(transformation + 4), ReadFloat32(transformation + 8),
+                                   ReadFloat32(transformation + 12), ReadFloat32(transformation));
+
+      //If the rotation mode is vnlTransposed we have to transpose the quaternion
+      if (m_TrackingDevice->GetRotationMode() == mitk::NDITrackingDevice::RotationTransposed)
+      {
+        orientation[0] *= -1; //qx
+        orientation[1] *= -1; //qy
+        orientation[2] *= -1; //qz
+        //qr is not inverted
+      }
+
+      mitk::Point3D toolPosition;
+      toolPosition[0] = ReadFloat32(transformation + 16);
+      toolPosition[1] = ReadFloat32(transformation + 20);
+      toolPosition[2] = ReadFloat32(transformation + 24);
+
+      tool->SetOrientation(orientation);
+      tool->SetPosition(toolPosition);
+      tool->SetTrackingError(ReadFloat32(transformation + 28));
+      tool->SetErrorMessage("");
+      tool->SetDataValid(true);
+    }
+    else if (handleStatus == BXHandleMissing)
+    {
+      tool->SetErrorMessage("Tool is reported as 'missing'.");
+      tool->SetDataValid(false);
+      position += 8;    // port status and frame number
+    }
+    else if (handleStatus == BXHandleDisabled)
+    {
+      tool->SetErrorMessage("Tool is reported as 'disabled'.");
+      tool->SetDataValid(false);
+    }
+    else
+    {
+      returnValue = NDIUNEXPECTEDREPLY;
+      break;  // the size of the data of an unknown status is unknown, so the remaining data can not be parsed
+    }
+  }
+
+  /* the system status (2 bytes) follows, it is not evaluated, like in TX() */
+  return returnValue;
 }
 
 
@@ -21,6 +21,8 @@ found in the LICENSE file.
 #include "mitkSerialCommunication.h"
 #include "mitkNDIPassiveTool.h"
 
+#include <vector>
+
 namespace mitk
 {
   class NDITrackingDevice;
@@ -123,7 +125,7 @@ namespace mitk
     NDIErrorCode TSTART(bool resetFrameCounter = false);  ///< Start Tracking Mode. The tracking system must be in setup mode and must be initialized.
     NDIErrorCode TSTOP();                         ///< Stop Tracking Mode. The tracking system must be in Tracking mode.
     NDIErrorCode TX(bool trackIndividualMarkers = false, MarkerPointContainerType* markerPositions = nullptr); ///< Report transformations in text mode. Optionally, individual markers can be tracked
-    NDIErrorCode BX();                            ///< Report transformations in binary mode.
+    NDIErrorCode BX();                            ///< Report transformations in binary mode. The reply is read in one piece, CRC checked and decoded without allocations.
     NDIErrorCode POS3D(MarkerPointContainerType* markerPositions); ///< Report 3D Positions of single markers. can only be used in diagnostics mode
     NDIErrorCode VER(mitk::TrackingDeviceType& t);                 ///< returns if the tracking device is a Polaris or an Aurora system
     NDIErrorCode VSEL(mitk::TrackingDeviceData deviceData);                ///< Sets the tracking volume to the given type. Check available tracking volumes with SFLIST first
@@ -157,6 +159,7 @@ namespace mitk
 
     NDITrackingDevice* m_TrackingDevice;  ///< tracking device to which the commands will be send
     bool m_UseCRC;  ///< whether to append a CRC16 checksum to each message
+    std::vector<char> m_BinaryReply;  ///< receive buffer for binary replies, reused for every BX call
   };
 } // namespace mitk
 #endif /* MITKNDIPROTOCOL_H_HEADER_INCLUDED_ */
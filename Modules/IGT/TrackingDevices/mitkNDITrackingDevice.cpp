@@ -264,6 +264,18 @@ mitk::NDIErrorCode mitk::NDITrackingDevice::Receive(std::string* answer, unsigne
     return NDIOKAY;
 }
 
+mitk::NDIErrorCode mitk::NDITrackingDevice::ReceiveBytes(char* answer, unsigned int numberOfBytes)
+{
+  if (answer == nullptr)
+    return SERIALRECEIVEERROR;
+
+  MutexLockHolder lock(*m_SerialCommunicationMutex); // lock and unlock the mutex
+  if (m_SerialCommunication->ReceiveBytes(answer, numberOfBytes) == 0) // 0 == ERROR_VALUE
+    return SERIALRECEIVEERROR;
+  else
+    return NDIOKAY;
+}
+
 mitk::NDIErrorCode mitk::NDITrackingDevice::ReceiveByte(char* answer)
 {
   if (answer == nullptr)
@@ -317,14 +329,23 @@ const std::string mitk::NDITrackingDevice::CalcCRC(const std::string* input)
 {
   if (input == nullptr)
     return "";
+  unsigned int crcValue = CalcCRC16(input->data(), input->length());
+  // crcValue contains now the CRC16 value. Convert it to a string and return it
+  char returnvalue[13];
+  sprintf(returnvalue, "%04X", crcValue);  // 4 hexadecimal digit with uppercase format
+  return std::string(returnvalue);
+}
+
+unsigned int mitk::NDITrackingDevice::CalcCRC16(const char* input, std::size_t length)
+{
   /* the crc16 calculation code is taken from the NDI API guide example code section */
   static int oddparity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
   unsigned int data;  // copy of the input string's current character
   unsigned int crcValue = 0;  // the crc value is stored here
   unsigned int* puCRC16 = &crcValue;  // the algorithm uses a pointer to crcValue, so it's easier to provide that than to change the algorithm
-  for (unsigned int i = 0; i < input->length(); i++)
+  for (std::size_t i = 0; i < length; i++)
   {
-    data = (*input)[i];
+    data = input[i];
     data = (data ^ (*(puCRC16)& 0xff)) & 0xff;
     *puCRC16 >>= 8;
     if (oddparity[data & 0x0f] ^ oddparity[data >> 4])
@@ -336,10 +357,7 @@ const std::string mitk::NDITrackingDevice::CalcCRC(const std::string* input)
     data <<= 1;
     *puCRC16 ^= data;
   }
-  // crcValue contains now the CRC16 value. Convert it to a string and return it
-  char returnvalue[13];
-  sprintf(returnvalue, "%04X", crcValue);  // 4 hexadecimal digit with uppercase format
-  return std::string(returnvalue);
+  return crcValue;
 }
 
 bool mitk::NDITrackingDevice::OpenConnection()
@@ -755,7 +773,7 @@ void mitk::NDITrackingDevice::TrackTools()
     else
     {
       returnvalue = this->m_DeviceProtocol->BX();
-      if (returnvalue != NDIOKAY)
+      if (!((returnvalue == NDIOKAY) || (returnvalue == NDICRCERROR))) // like in text mode, do not stop on crc errors
         break;
     }
     /* Update the local copy of m_StopTracking */
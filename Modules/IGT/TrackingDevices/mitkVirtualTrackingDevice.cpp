@@ -14,12 +14,14 @@ found in the LICENSE file.
 #include "mitkIGTTimeStamp.h"
 #include "mitkIGTException.h"
 
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <cstdio>
-#include <ctime>
 #include <itksys/SystemTools.hxx>
 #include <itkMutexLockHolder.h>
 #include <random>
+#include <thread>
 
 #include <mitkVirtualTrackerTypeInformation.h>
 
@@ -27,7 +29,8 @@ typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
 
 mitk::VirtualTrackingDevice::VirtualTrackingDevice() : mitk::TrackingDevice(),
 m_AllTools(), m_ToolsMutex(nullptr), m_MultiThreader(nullptr), m_ThreadID(-1), m_RefreshRate(100), m_NumberOfControlPoints(20), m_GaussianNoiseEnabled(false),
-m_MeanDistributionParam(0.0), m_DeviationDistributionParam(1.0)
+m_MeanDistributionParam(0.0), m_DeviationDistributionParam(1.0), m_RefreshIntervalInMicroseconds(0), m_NumberOfTrajectorySamples(0),
+m_DeterministicTimeStamps(false), m_ReplayData(nullptr), m_RandomGenerator(std::random_device()()), m_TrackingThreadSeed(0)
 {
   m_Data = mitk::VirtualTrackerTypeInformation::GetDeviceDataVirtualTracker();
   m_Bounds[0] = m_Bounds[2] = m_Bounds[4] = -400.0;  // initialize bounds to -400 ... +400 (mm) cube
@@ -63,8 +66,8 @@ mitk::TrackingTool* mitk::VirtualTrackingDevice::AddTool(const char* toolName)
   mitk::VirtualTrackingTool::Pointer t = mitk::VirtualTrackingTool::New();
   t->SetToolName(toolName);
   t->SetVelocity(0.1);
+  MutexLockHolder lock(*m_ToolsMutex); // lock and unlock the mutex, also guards m_RandomGenerator
   this->InitializeSpline(t);
-  MutexLockHolder lock(*m_ToolsMutex); // lock and unlock the mutex
   m_AllTools.push_back(t);
   return t;
 }
@@ -81,6 +84,14 @@ bool mitk::VirtualTrackingDevice::StartTracking()
 
   mitk::IGTTimeStamp::GetInstance()->Start(this);
 
+  m_LookupTables.clear();
+  if (m_NumberOfTrajectorySamples > 0 || m_ReplayData.IsNotNull())
+    this->PrecomputeLookupTables();
+  {
+    MutexLockHolder lock(*m_ToolsMutex); // lock and unlock the mutex
+    m_TrackingThreadSeed = m_RandomGenerator();
+  }
+
   if (m_MultiThreader.IsNotNull() && (m_ThreadID != -1))
     m_MultiThreader->TerminateThread(m_ThreadID);
   if (m_MultiThreader.IsNull())
@@ -128,7 +139,6 @@ bool mitk::VirtualTrackingDevice::OpenConnection()
   {
     mitkThrowException(mitk::IGTException) << "to few control points for spline interpolation";
   }
-  srand(time(nullptr)); //Init random number generator
 
   this->SetState(Ready);
   return true;
@@ -222,6 +232,17 @@ void mitk::VirtualTrackingDevice::TrackTools()
   localStopTracking = this->m_StopTracking;
   this->m_StopTrackingMutex->Unlock();
 
+  if (!m_LookupTables.empty())
+  {
+    this->TrackToolsFromLookupTables();
+    return;
+  }
+
+  /* the tracking thread uses an own generator, so it does not share state with AddTool() */
+  std::mt19937 randomGenerator(m_TrackingThreadSeed);
+  std::normal_distribution<double> noiseDistribution(this->m_MeanDistributionParam, this->m_DeviationDistributionParam);
+  std::uniform_real_distribution<double> trackingErrorDistribution(0.0, 2.0);
+
   mitk::ScalarType t = 0.0;
   while ((this->GetState() == Tracking) && (localStopTracking == false))
   {
@@ -238,10 +259,7 @@ void mitk::VirtualTrackingDevice::TrackTools()
       //Add Gaussian Noise to Tracking Coordinates if enabled
       if (this->m_GaussianNoiseEnabled)
       {
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        std::normal_distribution<double> dist(this->m_MeanDistributionParam, this->m_DeviationDistributionParam);
-        double noise = dist(generator);
+        double noise = noiseDistribution(randomGenerator);
         mp = mp + noise;
       }
 
@@ -261,11 +279,14 @@ void mitk::VirtualTrackingDevice::TrackTools()
       currentTool->SetOrientation(quat);
       // TODO: rotate once per cycle around a fixed rotation vector
 
-      currentTool->SetTrackingError(2 * (rand() / (RAND_MAX + 1.0)));  // tracking error in 0 .. 2 Range
+      currentTool->SetTrackingError(trackingErrorDistribution(randomGenerator));  // tracking error in 0 .. 2 Range
       currentTool->SetDataValid(true);
       currentTool->Modified();
     }
-    itksys::SystemTools::Delay(m_RefreshRate);
+    if (m_RefreshIntervalInMicroseconds > 0)
+      std::this_thread::sleep_for(std::chrono::microseconds(m_RefreshIntervalInMicroseconds));
+    else
+      itksys::SystemTools::Delay(m_RefreshRate);
     /* Update the local copy of m_StopTracking */
     this->m_StopTrackingMutex->Lock();
     localStopTracking = m_StopTracking;
@@ -273,6 +294,104 @@ void mitk::VirtualTrackingDevice::TrackTools()
   } // tracking ends if we pass this line
 }
 
+void mitk::VirtualTrackingDevice::PrecomputeLookupTables()
+{
+  MutexLockHolder lock(*m_ToolsMutex); // lock and unlock the mutex
+
+  const double interval = m_RefreshIntervalInMicroseconds > 0 ? m_RefreshIntervalInMicroseconds * 1e-6 : m_RefreshRate * 1e-3;
+
+  mitk::Quaternion identity;
+  identity.x() = 0.0;
+  identity.y() = 0.0;
+  identity.z() = 0.0;
+  identity.r() = 1.0;
+
+  for (unsigned int toolIndex = 0; toolIndex < m_AllTools.size(); ++toolIndex)
+  {
+    LookupTable table;
+    table.Tool = m_AllTools[toolIndex];
+    table.Step = 1.0;
+
+    if (m_ReplayData.IsNotNull())
+    {
+      if (toolIndex >= m_ReplayData->GetNumberOfTools())
+        continue;
+
+      /* one recorded time step is replayed per frame */
+      table.Samples.reserve(m_ReplayData->Size());
+      for (unsigned int index = 0; index < m_ReplayData->Size(); ++index)
+      {
+        mitk::NavigationData::Pointer nd = m_ReplayData->GetNavigationDataForIndex(index, toolIndex);
+        TrajectorySample sample;
+        sample.Position = nd->GetPosition();
+        sample.Orientation = nd->GetOrientation();
+        sample.TrackingError = static_cast<float>(std::sqrt(nd->GetCovErrorMatrix()[0][0]));
+        sample.DataValid = nd->IsDataValid();
+        table.Samples.push_back(sample);
+      }
+    }
+    else
+    {
+      /* sample one round of the closed spline path, the tool velocity defines how many samples are skipped per frame */
+      table.Samples.reserve(m_NumberOfTrajectorySamples);
+      for (unsigned int index = 0; index < m_NumberOfTrajectorySamples; ++index)
+      {
+        TrajectorySample sample;
+        mitk::itk2vtk(table.Tool->GetSpline()->EvaluateSpline(static_cast<double>(index) / m_NumberOfTrajectorySamples), sample.Position);
+        sample.Orientation = identity;
+        sample.TrackingError = static_cast<float>(2 * this->GetRandomNumber());  // tracking error in 0 .. 2 Range
+        sample.DataValid = true;
+        table.Samples.push_back(sample);
+      }
+      table.Step = table.Tool->GetVelocity() * interval * m_NumberOfTrajectorySamples;
+    }
+
+    if (!table.Samples.empty())
+      m_LookupTables.push_back(table);
+  }
+}
+
+void mitk::VirtualTrackingDevice::TrackToolsFromLookupTables()
+{
+  typedef std::chrono::steady_clock ClockType;
+
+  const std::chrono::microseconds interval(m_RefreshIntervalInMicroseconds > 0 ? m_RefreshIntervalInMicroseconds : m_RefreshRate * 1000);
+  const double intervalInMilliseconds = interval.count() / 1000.0;
+
+  /* the tracking thread uses an own generator, so it does not share state with AddTool() */
+  std::mt19937 noiseGenerator(m_TrackingThreadSeed);
+  std::normal_distribution<double> noiseDistribution(this->m_MeanDistributionParam, this->m_DeviationDistributionParam);
+
+  const ClockType::time_point start = ClockType::now();
+  bool localStopTracking = false;
+  for (unsigned long long frame = 1; (this->GetState() == Tracking) && (localStopTracking == false); ++frame)
+  {
+    /* pace on the absolute frame time, so the time needed for the update does not add up */
+    std::this_thread::sleep_until(start + frame * interval);
+
+    const double timeStamp = m_DeterministicTimeStamps ? frame * intervalInMilliseconds : mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+
+    for (const auto& table : m_LookupTables)
+    {
+      const std::size_t index = static_cast<std::size_t>(std::fmod((frame - 1) * table.Step, static_cast<double>(table.Samples.size())));
+      const TrajectorySample& sample = table.Samples[index];
+
+      mitk::Point3D position = sample.Position;
+      if (this->m_GaussianNoiseEnabled)
+      {
+        position = position + noiseDistribution(noiseGenerator);
+      }
+
+      table.Tool->SetTrackingData(position, sample.Orientation, sample.TrackingError, sample.DataValid, timeStamp);
+    }
+
+    /* Update the local copy of m_StopTracking */
+    this->m_StopTrackingMutex->Lock();
+    localStopTracking = m_StopTracking;
+    this->m_StopTrackingMutex->Unlock();
+  }
+}
+
 ITK_THREAD_RETURN_TYPE mitk::VirtualTrackingDevice::ThreadStartTracking(void* pInfoStruct)
 {
   /* extract this pointer from Thread Info structure */
@@ -297,13 +416,24 @@ ITK_THREAD_RETURN_TYPE mitk::VirtualTrackingDevice::ThreadStartTracking(void* pI
 mitk::VirtualTrackingDevice::ControlPointType mitk::VirtualTrackingDevice::GetRandomPoint()
 {
   ControlPointType pos;
-  pos[0] = m_Bounds[0] + (m_Bounds[1] - m_Bounds[0]) * (rand() / (RAND_MAX + 1.0));  // X =  xMin + xRange * (random number between 0 and 1)
-  pos[1] = m_Bounds[2] + (m_Bounds[3] - m_Bounds[2]) * (rand() / (RAND_MAX + 1.0));  // Y
-  pos[2] = m_Bounds[4] + (m_Bounds[5] - m_Bounds[4]) * (rand() / (RAND_MAX + 1.0));  // Z
+  pos[0] = m_Bounds[0] + (m_Bounds[1] - m_Bounds[0]) * this->GetRandomNumber();  // X =  xMin + xRange * (random number between 0 and 1)
+  pos[1] = m_Bounds[2] + (m_Bounds[3] - m_Bounds[2]) * this->GetRandomNumber();  // Y
+  pos[2] = m_Bounds[4] + (m_Bounds[5] - m_Bounds[4]) * this->GetRandomNumber();  // Z
 
   return pos;
 }
 
+double mitk::VirtualTrackingDevice::GetRandomNumber()
+{
+  return std::uniform_real_distribution<double>(0.0, 1.0)(m_RandomGenerator);
+}
+
+void mitk::VirtualTrackingDevice::SetRandomSeed(unsigned int seed)
+{
+  MutexLockHolder lock(*m_ToolsMutex); // lock and unlock the mutex
+  m_RandomGenerator.seed(seed);
+}
+
 void mitk::VirtualTrackingDevice::EnableGaussianNoise()
 {
   this->m_GaussianNoiseEnabled = true;
@@ -16,9 +16,11 @@ found in the LICENSE file.
 #include <MitkIGTExports.h>
 #include <mitkTrackingDevice.h>
 #include <mitkVirtualTrackingTool.h>
+#include <mitkNavigationDataSet.h>
 #include <itkMultiThreader.h>
 
 #include "itkFastMutexLock.h"
+#include <random>
 #include <vector>
 
 namespace mitk
@@ -30,6 +32,13 @@ namespace mitk
   * This TrackingDevice class does not interface with a physical tracking device. It simulates
   * a tracking device by moving the tools on a randomly generated spline path.
   *
+  * For load testing of navigation pipelines the device can precompute the tool paths into
+  * lookup tables (see SetNumberOfTrajectorySamples()) or replay a recorded data set
+  * (see SetReplayData()). In this mode the tracking thread only copies precomputed samples,
+  * so hundreds of tools can be emitted at kilohertz rates (see SetRefreshIntervalInMicroseconds()).
+  * Together with SetDeterministicTimeStamps() and SetRandomSeed() the emitted data only
+  * depends on the frame number and not on the scheduling of the tracking thread.
+  *
   * \ingroup IGT
   */
   class MITKIGT_EXPORT VirtualTrackingDevice : public TrackingDevice
@@ -54,6 +63,54 @@ namespace mitk
     */
     itkGetConstMacro(RefreshRate, unsigned int);
 
+    /**
+    * \brief Sets the refresh interval of the tracking thread in microseconds.
+    *
+    * If set to a value larger than 0 it is used instead of the refresh rate in ms.
+    * The tracking thread paces itself on a steady clock, so the interval does not drift
+    * with the time needed to update the tools. Default is 0.
+    */
+    itkSetMacro(RefreshIntervalInMicroseconds, unsigned int);
+    itkGetConstMacro(RefreshIntervalInMicroseconds, unsigned int);
+
+    /**
+    * \brief Sets the number of samples per round that are precomputed for every tool path.
+    *
+    * If set to a value larger than 0, the spline paths of all tools are sampled in StartTracking()
+    * and the tracking thread only looks up the samples. In this mode the tool speed set with
+    * SetToolSpeed() is used. Tools added while tracking are not moved until tracking is restarted.
+    * 0 (default) evaluates the splines on every refresh.
+    */
+    itkSetMacro(NumberOfTrajectorySamples, unsigned int);
+    itkGetConstMacro(NumberOfTrajectorySamples, unsigned int);
+
+    /**
+    * \brief If true, the time stamps of the tools are derived from the frame number and the refresh
+    * interval instead of the wall clock. Only used for precomputed paths or replay.
+    */
+    itkSetMacro(DeterministicTimeStamps, bool);
+    itkGetConstMacro(DeterministicTimeStamps, bool);
+    itkBooleanMacro(DeterministicTimeStamps);
+
+    /**
+    * \brief Sets the seed of the random number generator used for the tool paths,
+    * the tracking errors and the Gaussian noise. Must be set before tools are added.
+    *
+    * The tracking thread draws from an own generator, which StartTracking() seeds from this one.
+    * So the emitted data does not depend on tools being added while tracking.
+    */
+    void SetRandomSeed(unsigned int seed);
+
+    /**
+    * \brief Sets a recorded data set that is replayed in a loop instead of the spline paths.
+    *
+    * Tool i of the device replays tool i of the data set. Tools that have no counterpart in the
+    * data set stay at their last position. Set to nullptr to move the tools on their splines again.
+    * Takes effect with the next call of StartTracking().
+    */
+    itkSetObjectMacro(ReplayData, NavigationDataSet);
+    itkGetConstObjectMacro(ReplayData, NavigationDataSet);
+
     /**
     * \brief Starts the tracking.
     *
@@ -187,13 +244,24 @@ namespace mitk
     */
     void TrackTools();
 
-    void InitializeSpline(mitk::VirtualTrackingTool* t);  ///< initializes the spline path of the tool t with random control points inside the current tracking volume
+    /**
+    * \brief Tracking loop that is used if the tool paths are precomputed or replayed.
+    */
+    void TrackToolsFromLookupTables();
+
+    /**
+    * \brief Fills m_LookupTables with the spline samples or the replay data of all current tools.
+    */
+    void PrecomputeLookupTables();
+
+    void InitializeSpline(mitk::VirtualTrackingTool* t);  ///< initializes the spline path of the tool t with random control points inside the current tracking volume, m_ToolsMutex must be locked
 
     static ITK_THREAD_RETURN_TYPE ThreadStartTracking(void* data); ///< static start method for tracking thread
 
     typedef mitk::VirtualTrackingTool::SplineType::ControlPointType ControlPointType;
 
-    ControlPointType GetRandomPoint(); ///< returns a random position inside the tracking volume (defined by m_Bounds)
+    ControlPointType GetRandomPoint(); ///< returns a random position inside the tracking volume (defined by m_Bounds), m_ToolsMutex must be locked
+    double GetRandomNumber(); ///< returns a uniformly distributed random number in [0, 1), m_ToolsMutex must be locked
     mitk::VirtualTrackingTool* GetInternalTool(unsigned int idx);
 
     typedef std::vector<VirtualTrackingTool::Pointer> ToolContainer; ///< container type for tracking tools
@@ -210,6 +278,31 @@ namespace mitk
   bool m_GaussianNoiseEnabled;    ///< adding Gaussian Noise to tracking coordinates or not, false by default
   double m_MeanDistributionParam;    /// mean distribution for Gaussion Noise, 0.0 by default
   double m_DeviationDistributionParam;  ///< deviation distribution for Gaussian Noise, 1.0 by default
+
+    /** one precomputed tracking state of a tool */
+    struct TrajectorySample
+    {
+      mitk::Point3D Position;
+      mitk::Quaternion Orientation;
+      float TrackingError;
+      bool DataValid;
+    };
+
+    /** precomputed samples of one tool, cycled with Step samples per frame */
+    struct LookupTable
+    {
+      VirtualTrackingTool::Pointer Tool;
+      std::vector<TrajectorySample> Samples;
+      double Step;
+    };
+
+    unsigned int m_RefreshIntervalInMicroseconds;   ///< refresh interval in microseconds, overrides m_RefreshRate if larger than 0
+    unsigned int m_NumberOfTrajectorySamples;       ///< number of precomputed samples per round of a tool path, 0 disables the lookup tables
+    bool m_DeterministicTimeStamps;                 ///< time stamps are computed from the frame number if true
+    NavigationDataSet::Pointer m_ReplayData;        ///< recorded data that is replayed instead of the spline paths
+    std::vector<LookupTable> m_LookupTables;        ///< lookup tables of the tools, only accessed by the tracking thread while tracking
+    std::mt19937 m_RandomGenerator;                 ///< random number generator for paths and precomputed tracking errors, guarded by m_ToolsMutex
+    std::mt19937::result_type m_TrackingThreadSeed; ///< seed of the random number generator of the tracking thread, drawn in StartTracking()
   };
 }//mitk
 #endif /* MITKVIRTUALTRACKINGDEVICE_H_HEADER_INCLUDED_ */
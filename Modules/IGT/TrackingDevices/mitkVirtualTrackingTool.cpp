@@ -23,3 +23,15 @@ mitk::VirtualTrackingTool::VirtualTrackingTool()
 mitk::VirtualTrackingTool::~VirtualTrackingTool()
 {
 }
+
+void mitk::VirtualTrackingTool::SetTrackingData(const mitk::Point3D& position, const mitk::Quaternion& orientation,
+                                                float trackingError, bool dataValid, double timeStamp)
+{
+  MutexLockHolder lock(*m_MyMutex); // lock and unlock the mutex
+  m_Position = position;
+  m_Orientation = orientation;
+  m_TrackingError = trackingError;
+  m_DataValid = dataValid;
+  m_IGTTimeStamp = timeStamp;
+  this->Modified();
+}
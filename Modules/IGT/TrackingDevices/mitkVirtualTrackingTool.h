@@ -55,6 +55,10 @@ namespace mitk {
     VirtualTrackingTool();
     ~VirtualTrackingTool() override;
 
+    /** \brief sets all tracking data of one refresh while holding the tool mutex only once */
+    void SetTrackingData(const mitk::Point3D& position, const mitk::Quaternion& orientation,
+                         float trackingError, bool dataValid, double timeStamp);
+
     SplineType::Pointer m_Spline;
     mitk::ScalarType m_SplineLength;
     mitk::ScalarType m_Velocity;
@@ -168,10 +168,27 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    typedef ModelResultType::ValueType SignalValueType;
+
+    /** Computes the signals of a whole block of parameter sets at once.
+     * The parameter sets are passed as structure of arrays: parameter i of set j is expected at
+     * parameters[i * numberOfSets + j]. The signals are written the same way: the value at time
+     * point t of set j is written to signals[t * numberOfSets + j].
+     * @pre parameters must hold GetNumberOfParameters()*numberOfSets values.
+     * @pre signals must have space for GetTimeGrid().GetSize()*numberOfSets values.*/
+    void GetSignals(const ParameterValueType* parameters, std::size_t numberOfSets, SignalValueType* signals) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Batched counterpart of ComputeModelfunction(), called by GetSignals(). Memory layout as described
+     * for GetSignals(). The default implementation calls ComputeModelfunction() for every parameter set.
+     * Reimplement it for models whose signal can be computed for many parameter sets in one go.*/
+    virtual void ComputeModelfunctions(const ParameterValueType* parameters,
+                                       std::size_t numberOfSets,
+                                       SignalValueType* signals) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
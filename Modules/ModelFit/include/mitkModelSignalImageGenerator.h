@@ -24,7 +24,10 @@ namespace mitk
     /** Generator class that takes a model parameterizer instance, given parameter images and generates
      the corresponding signal image. Thus the generator simulates the signals of the model specified by
      parameterizer given the passed parameter images. The time grid of the signal is also defined by the
-     parameterizer.*/
+     parameterizer.
+     The voxels are evaluated in blocks via ModelBase::GetSignals(). Only LinearModel and T2DecayModel
+     reimplement ModelBase::ComputeModelfunctions() with a batched computation; all other models are
+     still evaluated parameter set by parameter set within each block.*/
     class MITKMODELFIT_EXPORT ModelSignalImageGenerator: public ::itk::Object
     {
     public:
@@ -67,6 +67,9 @@ namespace mitk
     itk::LightObject::Pointer InternalClone() const override;
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
+    void ComputeModelfunctions(const ParameterValueType* parameters,
+                               std::size_t numberOfSets,
+                               SignalValueType* signals) const override;
 
     void SetStaticParameter(const ParameterNameType& name,
                                     const StaticParameterValuesType& values) override;
@@ -11,13 +11,13 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkModelSignalImageGenerator.h"
-#include "itkMultiOutputNaryFunctorImageFilter.h"
 #include "mitkArbitraryTimeGeometry.h"
 #include "mitkImageCast.h"
 #include "mitkImageAccessByItk.h"
 #include "mitkITKImageImport.h"
-#include "mitkModelDataGenerationFunctor.h"
-#include "mitkSimpleFunctorPolicy.h"
+#include "mitkParallelFor.h"
+
+#include <algorithm>
 
 
 void mitk::ModelSignalImageGenerator::SetParameterInputImage(const ParametersIndexType parameterIndex, ParameterImageType parameterImage)
@@ -82,65 +82,77 @@ void mitk::ModelSignalImageGenerator::Generate()
       this->m_InternalMask = nullptr;
     }
 
-    /** @todo #1 This did not work! The Access-Routine would be a much nicer solution, but for some reasons, the handling did not work.
-     * Thats why the code for Generation the Data was pasted below
-     */
-//    mitk::Image::Pointer firstParameterImage = this->m_InputParameterImages[0];
-//    AccessFixedDimensionByItk(firstParameterImage, mitk::ModelSignalImageGenerator::DoGenerateData, 3);
+    if (m_Parameterizer.IsNull())
+    {
+      itkExceptionMacro("Error. Cannot generate signal image. No model parameterizer is set!");
+    }
 
+    const GridType grid = m_Parameterizer->GetDefaultTimeGrid();
+    if (grid.GetSize() == 0)
+    {
+      itkExceptionMacro("Error. Cannot compute SignalCurve. No time grid is set in parameterizer!");
+    }
 
-    typedef itk::Image<double, 3> InputFrameImageType;
-    typedef itk::Image<double, 3> OutputImageType;
+    // All voxels share the same model instance, it is only evaluated (thread safe)
+    ModelBase::Pointer model = m_Parameterizer->GenerateParameterizedModel();
 
-    typedef itk::MultiOutputNaryFunctorImageFilter<InputFrameImageType, OutputImageType, SimpleFunctorPolicy, InternalMaskType> FilterType;
-     FilterType::Pointer filter = FilterType::New();
+    const std::size_t numberOfParameters = this->m_InputParameterImages.size();
+    if (numberOfParameters != model->GetNumberOfParameters())
+    {
+      itkExceptionMacro("Error. Number of parameter images does not match the model. Required: "
+                        << model->GetNumberOfParameters() << "; passed parameter images: " << numberOfParameters);
+    }
 
-    for(unsigned int i=0; i<this->m_ParameterInputMap.size(); ++i)
+    typedef itk::Image<double, 3> InputFrameImageType;
+
+    std::vector<InputFrameImageType::Pointer> frameImages;
+    std::vector<const double*> parameterBuffers;
+    for(std::size_t i=0; i<numberOfParameters; ++i)
     {
         InputFrameImageType::Pointer frameImage = InputFrameImageType::New();
-        Image::Pointer parameterImage = m_InputParameterImages.at(i);
+        mitk::CastToItkImage(m_InputParameterImages.at(i), frameImage);
 
-        mitk::CastToItkImage(parameterImage, frameImage);
-        filter->SetInput(i,frameImage);
-    }
+        if (!frameImages.empty() && frameImage->GetLargestPossibleRegion() != frameImages.front()->GetLargestPossibleRegion())
+        {
+          itkExceptionMacro("Error. Parameter images do not have the same size.");
+        }
 
-    ModelDataGenerationFunctor::Pointer generationFunctor = ModelDataGenerationFunctor::New();
-    generationFunctor->SetModelParameterizer(m_Parameterizer);
+        frameImages.push_back(frameImage);
+        parameterBuffers.push_back(frameImage->GetBufferPointer());
+    }
 
-    SimpleFunctorPolicy functor;
-    functor.SetFunctor(generationFunctor);
-    filter->SetFunctor(functor);
-    if (this->m_InternalMask.IsNotNull())
+    if (frameImages.empty())
     {
-     filter->SetMask(this->m_InternalMask);
+      itkExceptionMacro("Error. Cannot generate signal image. No parameter images are set!");
     }
-    filter->Update();
 
-    if (filter->GetNumberOfOutputs() != generationFunctor->GetGrid().GetSize())
+    const InputFrameImageType* firstFrame = frameImages.front();
+    const std::size_t numberOfVoxels = firstFrame->GetLargestPossibleRegion().GetNumberOfPixels();
+    const std::size_t numberOfTimePoints = grid.GetSize();
+
+    const unsigned char* maskBuffer = nullptr;
+    if (this->m_InternalMask.IsNotNull())
     {
-      itkExceptionMacro("Error. Number of computed output Images does not match Grid size!");
+      if (this->m_InternalMask->GetLargestPossibleRegion() != firstFrame->GetLargestPossibleRegion())
+      {
+        itkExceptionMacro("Error. Mask does not cover the region of the parameter images. Mask region: "
+                          << this->m_InternalMask->GetLargestPossibleRegion() << "Parameter region: "
+                          << firstFrame->GetLargestPossibleRegion());
+      }
+      maskBuffer = this->m_InternalMask->GetBufferPointer();
     }
 
-    /** @todo #1 Better solution than all this code!
-     * This was copied from TestingHelper/TestArtifactGenerator. Just instantiating a mitk::Image and setting its Volumes
-     * in the for-loop did not work somehow.
-     * This was a work around
-     */
-
     typedef itk::Image<double,4> DynamicITKImageType;
 
-    Image::Pointer dynamicImage= Image::New();
-    mitk::Image::Pointer tempImage = mitk::ImportItkImage(filter->GetOutput(0))->Clone();
-
     DynamicITKImageType::Pointer dynamicITKImage = DynamicITKImageType::New();
     DynamicITKImageType::RegionType dynamicITKRegion;
     DynamicITKImageType::PointType dynamicITKOrigin;
     DynamicITKImageType::IndexType dynamicITKIndex;
     DynamicITKImageType::SpacingType dynamicITKSpacing;
 
-    dynamicITKSpacing[0] = tempImage->GetGeometry()->GetSpacing()[0];
-    dynamicITKSpacing[1] = tempImage->GetGeometry()->GetSpacing()[1];
-    dynamicITKSpacing[2] = tempImage->GetGeometry()->GetSpacing()[2];
+    dynamicITKSpacing[0] = firstFrame->GetSpacing()[0];
+    dynamicITKSpacing[1] = firstFrame->GetSpacing()[1];
+    dynamicITKSpacing[2] = firstFrame->GetSpacing()[2];
     dynamicITKSpacing[3] = 3.0;
 
     dynamicITKIndex[0] = 0;  // The first pixel of the REGION
@@ -148,41 +160,96 @@ void mitk::ModelSignalImageGenerator::Generate()
     dynamicITKIndex[2] = 0;
     dynamicITKIndex[3] = 0;
 
-    dynamicITKRegion.SetSize( 0,tempImage->GetDimension(0));
-    dynamicITKRegion.SetSize( 1,tempImage->GetDimension(1));
-    dynamicITKRegion.SetSize( 2,tempImage->GetDimension(2));
-    dynamicITKRegion.SetSize(3, filter->GetNumberOfOutputs());
+    dynamicITKRegion.SetSize( 0,firstFrame->GetLargestPossibleRegion().GetSize()[0]);
+    dynamicITKRegion.SetSize( 1,firstFrame->GetLargestPossibleRegion().GetSize()[1]);
+    dynamicITKRegion.SetSize( 2,firstFrame->GetLargestPossibleRegion().GetSize()[2]);
+    dynamicITKRegion.SetSize(3, numberOfTimePoints);
 
     dynamicITKRegion.SetIndex( dynamicITKIndex );
 
-    dynamicITKOrigin[0]=tempImage->GetGeometry()->GetOrigin()[0];
-    dynamicITKOrigin[1]=tempImage->GetGeometry()->GetOrigin()[1];
-    dynamicITKOrigin[2]=tempImage->GetGeometry()->GetOrigin()[2];
+    dynamicITKOrigin[0]=firstFrame->GetOrigin()[0];
+    dynamicITKOrigin[1]=firstFrame->GetOrigin()[1];
+    dynamicITKOrigin[2]=firstFrame->GetOrigin()[2];
 
     dynamicITKImage->SetOrigin(dynamicITKOrigin);
     dynamicITKImage->SetSpacing(dynamicITKSpacing);
     dynamicITKImage->SetRegions( dynamicITKRegion);
     dynamicITKImage->Allocate();
-    dynamicITKImage->FillBuffer(0); //not sure if this is necessary
+    dynamicITKImage->FillBuffer(0); // voxels outside of the mask stay 0
 
-    // Convert
-    mitk::CastToMitkImage(dynamicITKImage, dynamicImage);
+    double* signalBuffer = dynamicITKImage->GetBufferPointer();
 
+    /* The voxels are evaluated in blocks. For every block the parameters of the (masked) voxels
+     * are gathered as structure of arrays, the model computes all signals of the block at once
+     * and the signals are scattered into the time steps of the dynamic image.*/
+    const std::size_t blockSize = 256;
+    const std::size_t numberOfBlocks = (numberOfVoxels + blockSize - 1) / blockSize;
 
+    // Buffers of every worker, reused for all of its blocks
+    struct BlockBuffers
+    {
+      std::vector<std::size_t> voxels;
+      std::vector<ModelBase::ParameterValueType> parameterBlock;
+      std::vector<ModelBase::SignalValueType> signalBlock;
+    };
+    std::vector<BlockBuffers> workerBuffers(mitk::GetParallelForNumberOfThreads());
+
+    mitk::ParallelFor(numberOfBlocks, [&](std::size_t block, unsigned int workerIndex)
+    {
+      BlockBuffers& buffers = workerBuffers[workerIndex];
+      if (buffers.voxels.empty())
+      {
+        buffers.voxels.resize(blockSize);
+        buffers.parameterBlock.resize(numberOfParameters * blockSize);
+        buffers.signalBlock.resize(numberOfTimePoints * blockSize);
+      }
+      std::vector<std::size_t>& voxels = buffers.voxels;
+      std::vector<ModelBase::ParameterValueType>& parameterBlock = buffers.parameterBlock;
+      std::vector<ModelBase::SignalValueType>& signalBlock = buffers.signalBlock;
+
+      const std::size_t blockEnd = std::min(numberOfVoxels, (block + 1) * blockSize);
+
+      std::size_t numberOfSets = 0;
+      for (std::size_t voxel = block * blockSize; voxel < blockEnd; ++voxel)
+      {
+        if (!maskBuffer || maskBuffer[voxel] > 0)
+        {
+          voxels[numberOfSets++] = voxel;
+        }
+      }
+
+      for (std::size_t i = 0; i < numberOfParameters; ++i)
+      {
+        for (std::size_t set = 0; set < numberOfSets; ++set)
+        {
+          parameterBlock[i * numberOfSets + set] = parameterBuffers[i][voxels[set]];
+        }
+      }
+
+      model->GetSignals(parameterBlock.data(), numberOfSets, signalBlock.data());
+
+      for (std::size_t t = 0; t < numberOfTimePoints; ++t)
+      {
+        double* timeStep = signalBuffer + t * numberOfVoxels;
+        for (std::size_t set = 0; set < numberOfSets; ++set)
+        {
+          timeStep[voxels[set]] = signalBlock[t * numberOfSets + set];
+        }
+      }
+    });
+
+    // Convert
+    Image::Pointer dynamicImage= Image::New();
+    mitk::CastToMitkImage(dynamicITKImage, dynamicImage);
 
     ArbitraryTimeGeometry::Pointer timeGeometry = ArbitraryTimeGeometry::New();
     timeGeometry->ClearAllGeometries();
 
-    auto nrOfOutputs = filter->GetNumberOfOutputs();
-    auto grid = generationFunctor->GetGrid();
-    for (unsigned int i = 0; i<nrOfOutputs; ++i)
+    mitk::Image::Pointer frame = mitk::ImportItkImage(frameImages.front());
+    for (std::size_t i = 0; i<numberOfTimePoints; ++i)
     {
-      mitk::Image::Pointer frame = mitk::ImportItkImage(filter->GetOutput(i))->Clone();
-      mitk::ImageReadAccessor accessor(frame);
-      dynamicImage->SetVolume(accessor.GetData(), i);
-
       double tmax = 0;
-      if (i<(nrOfOutputs - 1))
+      if (i<(numberOfTimePoints - 1))
       {
         tmax = grid[i + 1] * 1000;
       }
@@ -195,6 +262,6 @@ void mitk::ModelSignalImageGenerator::Generate()
 
     dynamicImage->SetTimeGeometry(timeGeometry);
 
-    this->m_ResultImage = dynamicImage->Clone();
+    this->m_ResultImage = dynamicImage;
 
 }
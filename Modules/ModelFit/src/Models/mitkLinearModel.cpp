@@ -78,6 +78,25 @@ mitk::LinearModel::ComputeModelfunction(const ParametersType& parameters) const
   return signal;
 };
 
+void mitk::LinearModel::ComputeModelfunctions(const ParameterValueType* parameters,
+                                              std::size_t numberOfSets,
+                                              SignalValueType* signals) const
+{
+  const ParameterValueType* slopes = parameters;
+  const ParameterValueType* offsets = parameters + numberOfSets;
+
+  for (TimeGridType::SizeValueType t = 0; t < m_TimeGrid.GetSize(); ++t)
+  {
+    const double time = m_TimeGrid[t];
+    SignalValueType* signal = signals + t * numberOfSets;
+
+    for (std::size_t set = 0; set < numberOfSets; ++set)
+    {
+      signal[set] = slopes[set] * time + offsets[set];
+    }
+  }
+}
+
 mitk::LinearModel::ParameterNamesType mitk::LinearModel::GetStaticParameterNames() const
 {
   ParameterNamesType result;
@@ -146,6 +146,55 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+void mitk::ModelBase::GetSignals(const ParameterValueType* parameters,
+                                 std::size_t numberOfSets,
+                                 SignalValueType* signals) const
+{
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signals. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  if (numberOfSets > 0)
+  {
+    ComputeModelfunctions(parameters, numberOfSets, signals);
+  }
+}
+
+void mitk::ModelBase::ComputeModelfunctions(const ParameterValueType* parameters,
+                                            std::size_t numberOfSets,
+                                            SignalValueType* signals) const
+{
+  const ParametersSizeType numberOfParameters = this->GetNumberOfParameters();
+  const std::size_t numberOfTimePoints = m_TimeGrid.GetSize();
+
+  ParametersType setParameters(numberOfParameters);
+
+  for (std::size_t set = 0; set < numberOfSets; ++set)
+  {
+    for (ParametersSizeType i = 0; i < numberOfParameters; ++i)
+    {
+      setParameters[i] = parameters[i * numberOfSets + set];
+    }
+
+    const ModelResultType signal = ComputeModelfunction(setParameters);
+
+    if (signal.GetSize() != numberOfTimePoints)
+    {
+      itkExceptionMacro("Model signal does not match the time grid. Signal size: " << signal.GetSize()
+                        << "; time grid size: " << numberOfTimePoints);
+    }
+
+    for (std::size_t t = 0; t < numberOfTimePoints; ++t)
+    {
+      signals[t * numberOfSets + set] = signal[t];
+    }
+  }
+}
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
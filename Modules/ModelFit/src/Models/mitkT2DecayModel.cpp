@@ -57,11 +57,31 @@ mitk::T2DecayModel::ComputeModelfunction(const ParametersType& parameters) const
   for (const auto& gridPos : m_TimeGrid)
   {
     *signalPos = parameters[0] * exp(-1.0 * gridPos/ parameters[1]);
+    ++signalPos;
   }
 
   return signal;
 };
 
+void mitk::T2DecayModel::ComputeModelfunctions(const ParameterValueType* parameters,
+                                               std::size_t numberOfSets,
+                                               SignalValueType* signals) const
+{
+  const ParameterValueType* m0 = parameters;
+  const ParameterValueType* t2 = parameters + numberOfSets;
+
+  for (TimeGridType::SizeValueType t = 0; t < m_TimeGrid.GetSize(); ++t)
+  {
+    const double time = m_TimeGrid[t];
+    SignalValueType* signal = signals + t * numberOfSets;
+
+    for (std::size_t set = 0; set < numberOfSets; ++set)
+    {
+      signal[set] = m0[set] * exp(-1.0 * time / t2[set]);
+    }
+  }
+}
+
 mitk::T2DecayModel::ParameterNamesType mitk::T2DecayModel::GetStaticParameterNames() const
 {
   ParameterNamesType result;
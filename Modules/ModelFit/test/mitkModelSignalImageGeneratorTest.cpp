@@ -0,0 +1,192 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkModelSignalImageGenerator.h"
+#include "mitkLinearModelParameterizer.h"
+#include "mitkT2DecayModelParameterizer.h"
+#include "mitkTestModel.h"
+
+#include "mitkImageCast.h"
+#include "mitkImagePixelReadAccessor.h"
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class mitkModelSignalImageGeneratorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkModelSignalImageGeneratorTestSuite);
+  MITK_TEST(GetSignals_LinearModel_EqualsGetSignal);
+  MITK_TEST(GetSignals_T2DecayModel_EqualsGetSignal);
+  MITK_TEST(GetSignals_DefaultImplementation_EqualsGetSignal);
+  MITK_TEST(GetGeneratedImage_LinearModel_EqualsGetSignal);
+  MITK_TEST(GetGeneratedImage_T2DecayModel_EqualsGetSignal);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ParameterImageType;
+
+  /** Size of the parameter images, more voxels than one block of the generator and not a multiple of it */
+  static const unsigned int SizeX = 23;
+  static const unsigned int SizeY = 17;
+  static const unsigned int SizeZ = 3;
+
+  mitk::ModelBase::TimeGridType m_Grid;
+
+  /** Parameter i of set j as expected by ModelBase::GetSignals(). Values are positive, so they are valid
+      T2 decay parameters as well.*/
+  static mitk::ModelBase::ParameterValueType GetParameterValue(std::size_t i, std::size_t j)
+  {
+    return 1.0 + 0.5 * i + 0.25 * ((j * 7 + i * 3) % 41);
+  }
+
+  /** Compares GetSignals() of a block of parameter sets with GetSignal() of each set */
+  void CheckSignals(const mitk::ModelBase *model, std::size_t numberOfSets)
+  {
+    const std::size_t numberOfParameters = model->GetNumberOfParameters();
+    const std::size_t numberOfTimePoints = m_Grid.GetSize();
+
+    std::vector<mitk::ModelBase::ParameterValueType> parameters(numberOfParameters * numberOfSets);
+    for (std::size_t i = 0; i < numberOfParameters; ++i)
+      for (std::size_t set = 0; set < numberOfSets; ++set)
+        parameters[i * numberOfSets + set] = GetParameterValue(i, set);
+
+    std::vector<mitk::ModelBase::SignalValueType> signals(numberOfTimePoints * numberOfSets);
+    model->GetSignals(parameters.data(), numberOfSets, signals.data());
+
+    mitk::ModelBase::ParametersType setParameters(numberOfParameters);
+    for (std::size_t set = 0; set < numberOfSets; ++set)
+    {
+      for (std::size_t i = 0; i < numberOfParameters; ++i)
+        setParameters[i] = GetParameterValue(i, set);
+
+      const mitk::ModelBase::ModelResultType expected = model->GetSignal(setParameters);
+      for (std::size_t t = 0; t < numberOfTimePoints; ++t)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Set " + std::to_string(set) + ", time point " + std::to_string(t),
+                                             expected[t],
+                                             signals[t * numberOfSets + set],
+                                             1e-12 * std::abs(expected[t]));
+      }
+    }
+  }
+
+  /** Generates the signal image from parameter images and compares every voxel with GetSignal() */
+  void CheckGeneratedImage(mitk::ModelParameterizerBase *parameterizer)
+  {
+    parameterizer->SetDefaultTimeGrid(m_Grid);
+    mitk::ModelBase::Pointer model = parameterizer->GenerateParameterizedModel();
+    const std::size_t numberOfParameters = model->GetNumberOfParameters();
+
+    mitk::ModelSignalImageGenerator::Pointer generator = mitk::ModelSignalImageGenerator::New();
+    generator->SetParameterizer(parameterizer);
+
+    ParameterImageType::RegionType region;
+    region.SetSize(0, SizeX);
+    region.SetSize(1, SizeY);
+    region.SetSize(2, SizeZ);
+
+    for (std::size_t i = 0; i < numberOfParameters; ++i)
+    {
+      ParameterImageType::Pointer itkImage = ParameterImageType::New();
+      itkImage->SetRegions(region);
+      itkImage->Allocate();
+
+      double *buffer = itkImage->GetBufferPointer();
+      for (std::size_t voxel = 0; voxel < region.GetNumberOfPixels(); ++voxel)
+        buffer[voxel] = GetParameterValue(i, voxel);
+
+      mitk::Image::Pointer image;
+      mitk::CastToMitkImage(itkImage, image);
+      generator->SetParameterInputImage(static_cast<mitk::ModelSignalImageGenerator::ParametersIndexType>(i), image);
+    }
+
+    mitk::Image::Pointer result = generator->GetGeneratedImage();
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(m_Grid.GetSize()), result->GetTimeSteps());
+
+    mitk::ImagePixelReadAccessor<mitk::ScalarType, 4> accessor(result);
+    mitk::ModelBase::ParametersType voxelParameters(numberOfParameters);
+    itk::Index<4> index;
+    std::size_t voxel = 0;
+    for (unsigned int z = 0; z < SizeZ; ++z)
+      for (unsigned int y = 0; y < SizeY; ++y)
+        for (unsigned int x = 0; x < SizeX; ++x, ++voxel)
+        {
+          for (std::size_t i = 0; i < numberOfParameters; ++i)
+            voxelParameters[i] = GetParameterValue(i, voxel);
+
+          const mitk::ModelBase::ModelResultType expected = model->GetSignal(voxelParameters);
+
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          for (unsigned int t = 0; t < m_Grid.GetSize(); ++t)
+          {
+            index[3] = t;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel " + std::to_string(voxel) + ", time point " + std::to_string(t),
+                                                 expected[t],
+                                                 accessor.GetPixelByIndex(index),
+                                                 1e-12 * std::abs(expected[t]));
+          }
+        }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Grid.SetSize(7);
+    for (unsigned int t = 0; t < m_Grid.GetSize(); ++t)
+      m_Grid[t] = 0.5 + 1.5 * t;
+  }
+
+  void GetSignals_LinearModel_EqualsGetSignal()
+  {
+    mitk::LinearModel::Pointer model = mitk::LinearModel::New();
+    model->SetTimeGrid(m_Grid);
+    for (std::size_t numberOfSets : { 1, 5, 256, 1001 })
+      CheckSignals(model, numberOfSets);
+  }
+
+  void GetSignals_T2DecayModel_EqualsGetSignal()
+  {
+    mitk::T2DecayModel::Pointer model = mitk::T2DecayModel::New();
+    model->SetTimeGrid(m_Grid);
+    for (std::size_t numberOfSets : { 1, 5, 256, 1001 })
+      CheckSignals(model, numberOfSets);
+  }
+
+  /** TestModel does not reimplement ComputeModelfunctions() and uses the per set fallback of ModelBase */
+  void GetSignals_DefaultImplementation_EqualsGetSignal()
+  {
+    mitk::TestModel::Pointer model = mitk::TestModel::New();
+    model->SetTimeGrid(m_Grid);
+    for (std::size_t numberOfSets : { 1, 5, 256, 1001 })
+      CheckSignals(model, numberOfSets);
+  }
+
+  void GetGeneratedImage_LinearModel_EqualsGetSignal()
+  {
+    mitk::LinearModelParameterizer::Pointer parameterizer = mitk::LinearModelParameterizer::New();
+    CheckGeneratedImage(parameterizer);
+  }
+
+  void GetGeneratedImage_T2DecayModel_EqualsGetSignal()
+  {
+    mitk::T2DecayModelParameterizer::Pointer parameterizer = mitk::T2DecayModelParameterizer::New();
+    CheckGeneratedImage(parameterizer);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkModelSignalImageGenerator)
@@ -34,6 +34,7 @@ set(MITK_MODULES
   SegmentationUI
   MatchPointRegistration
   MatchPointRegistrationUI
+  BasicImageProcessing
   Classification
   OpenIGTLink
   IGTBase
@@ -69,7 +70,6 @@ set(MITK_MODULES
   SemanticRelations
   SemanticRelationsUI
   CEST
-  BasicImageProcessing
   ModelFit
   ModelFitUI
   Pharmacokinetics
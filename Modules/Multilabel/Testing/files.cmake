@@ -6,3 +6,8 @@ set(MODULE_TESTS
     mitkLabelSetImageSurfaceStampFilterTest.cpp
 )
 
+
+# the DICOM Seg IO is only built with dcmqi
+if(MITK_USE_DCMQI)
+  list(APPEND MODULE_TESTS mitkDICOMSegmentationIOTest.cpp)
+endif()
@@ -0,0 +1,156 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkDICOMQIPropertyHelper.h>
+#include <mitkDICOMSegmentationPropertyHelper.h>
+#include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <memory>
+
+class mitkDICOMSegmentationIOTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMSegmentationIOTestSuite);
+  MITK_TEST(WriteRead_LabelWithoutVoxels_IsKept);
+  MITK_TEST(WriteRead_EmptySegmentation_IsWritten);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LabelSetImage::PixelType PixelType;
+
+  mitk::Image::Pointer m_ReferenceImage;
+  std::string m_TemporaryDirectory;
+
+  /** Segmentation of the reference image with the given labels and the DICOM properties needed by the writer */
+  mitk::LabelSetImage::Pointer CreateSegmentation(const std::vector<std::pair<std::string, PixelType>> &labels)
+  {
+    auto segmentation = mitk::LabelSetImage::New();
+    segmentation->Initialize(m_ReferenceImage);
+
+    for (const auto &nameAndValue : labels)
+    {
+      auto label = mitk::Label::New();
+      label->SetName(nameAndValue.first);
+      label->SetValue(nameAndValue.second);
+      segmentation->GetLabelSet(0)->AddLabel(label);
+    }
+
+    mitk::DICOMQIPropertyHelper::DeriveDICOMSourceProperties(m_ReferenceImage, segmentation);
+    mitk::DICOMSegmentationPropertyHelper::DeriveDICOMSegmentationProperties(segmentation);
+    return segmentation;
+  }
+
+  /** Labels a box in the center of every slice with the given value */
+  static void FillBox(mitk::LabelSetImage *segmentation, PixelType value)
+  {
+    const unsigned int *dimensions = segmentation->GetDimensions();
+
+    mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(segmentation);
+    itk::Index<3> index;
+    for (unsigned int z = 0; z < dimensions[2]; ++z)
+      for (unsigned int y = dimensions[1] / 4; y < dimensions[1] / 2; ++y)
+        for (unsigned int x = dimensions[0] / 3; x < dimensions[0] / 2; ++x)
+        {
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          accessor.SetPixelByIndex(index, value);
+        }
+  }
+
+  mitk::LabelSetImage::Pointer WriteAndRead(mitk::LabelSetImage *segmentation, const std::string &fileName)
+  {
+    const std::string path = m_TemporaryDirectory + "/" + fileName;
+    mitk::IOUtil::Save(segmentation, path);
+    CPPUNIT_ASSERT_MESSAGE("DICOM Seg was not written", itksys::SystemTools::FileExists(path.c_str()));
+
+    return mitk::IOUtil::Load<mitk::LabelSetImage>(path);
+  }
+
+  /** Compares the active layer of the segmentation with the expected labels, nullptr for an empty layer */
+  static void CheckLayer(mitk::LabelSetImage *segmentation, mitk::LabelSetImage *expectedSegmentation)
+  {
+    const unsigned int *dimensions = segmentation->GetDimensions();
+
+    mitk::ImagePixelReadAccessor<PixelType, 3> accessor(segmentation);
+    std::unique_ptr<mitk::ImagePixelReadAccessor<PixelType, 3>> expectedAccessor;
+    if (expectedSegmentation != nullptr)
+      expectedAccessor.reset(new mitk::ImagePixelReadAccessor<PixelType, 3>(expectedSegmentation));
+
+    itk::Index<3> index;
+    for (unsigned int z = 0; z < dimensions[2]; ++z)
+      for (unsigned int y = 0; y < dimensions[1]; ++y)
+        for (unsigned int x = 0; x < dimensions[0]; ++x)
+        {
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          const PixelType expected = expectedAccessor ? expectedAccessor->GetPixelByIndex(index) : 0;
+          CPPUNIT_ASSERT_EQUAL(expected, accessor.GetPixelByIndex(index));
+        }
+  }
+
+public:
+  void setUp() override
+  {
+    m_ReferenceImage = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("TinyCTAbdomen/100"));
+    m_TemporaryDirectory = mitk::IOUtil::CreateTemporaryDirectory();
+  }
+
+  void tearDown() override
+  {
+    m_ReferenceImage = nullptr;
+    itksys::SystemTools::RemoveADirectory(m_TemporaryDirectory);
+  }
+
+  void WriteRead_LabelWithoutVoxels_IsKept()
+  {
+    auto segmentation = CreateSegmentation({ { "Liver", 1 }, { "Spleen", 2 } });
+    FillBox(segmentation, 1);
+
+    auto loadedSegmentation = WriteAndRead(segmentation, "LabelWithoutVoxels.dcm");
+
+    // the reader creates one layer per segment
+    CPPUNIT_ASSERT_EQUAL(2u, loadedSegmentation->GetNumberOfLayers());
+    CPPUNIT_ASSERT_EQUAL(std::string("Liver"), loadedSegmentation->GetActiveLabel(0)->GetName());
+    CPPUNIT_ASSERT_EQUAL(std::string("Spleen"), loadedSegmentation->GetActiveLabel(1)->GetName());
+
+    const unsigned int *dimensions = segmentation->GetDimensions();
+    for (unsigned int i = 0; i < 3; ++i)
+      CPPUNIT_ASSERT_EQUAL(dimensions[i], loadedSegmentation->GetDimension(i));
+
+    // the active layer is the image data of the label set image
+    loadedSegmentation->SetActiveLayer(0);
+    CheckLayer(loadedSegmentation, segmentation);
+    loadedSegmentation->SetActiveLayer(1);
+    CheckLayer(loadedSegmentation, nullptr);
+  }
+
+  void WriteRead_EmptySegmentation_IsWritten()
+  {
+    auto segmentation = CreateSegmentation({ { "Liver", 1 } });
+
+    auto loadedSegmentation = WriteAndRead(segmentation, "EmptySegmentation.dcm");
+
+    CPPUNIT_ASSERT_EQUAL(1u, loadedSegmentation->GetNumberOfLayers());
+    CPPUNIT_ASSERT_EQUAL(std::string("Liver"), loadedSegmentation->GetActiveLabel(0)->GetName());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMSegmentationIO)
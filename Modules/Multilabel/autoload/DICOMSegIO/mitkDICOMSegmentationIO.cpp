@@ -27,8 +27,7 @@ found in the LICENSE file.
 #include <mitkPropertyNameHelper.h>
 
 
-// itk
-#include <itkThresholdImageFilter.h>
+#include <limits>
 
 // dcmqi
 #include <dcmqi/ImageSEGConverter.h>
@@ -39,6 +38,47 @@ found in the LICENSE file.
 
 namespace mitk
 {
+  namespace
+  {
+    /** Splits a label image in one pass into one segmentation image per label of the label set (except the
+     * background), as expected by dcmqi. The images have the order of the label set. Labels without voxels
+     * get an empty segmentation image, so that every label is written. */
+    std::vector<DICOMSegmentationIO::itkInternalImageType::Pointer> SplitLabelImage(
+      const DICOMSegmentationIO::itkInputImageType *labelImage, const LabelSet *labelSet)
+    {
+      typedef DICOMSegmentationIO::itkInternalImageType SegmentImageType;
+
+      // segmentation buffer for every pixel value, nullptr for the background and unknown values
+      std::vector<SegmentImageType::PixelType *> segmentBuffers(std::numeric_limits<Label::PixelType>::max() + 1,
+                                                                nullptr);
+      std::vector<SegmentImageType::Pointer> segmentations;
+      auto labelIter = labelSet->IteratorConstBegin();
+      // Ignore background label
+      ++labelIter;
+      for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
+      {
+        SegmentImageType::Pointer segmentImage = SegmentImageType::New();
+        segmentImage->CopyInformation(labelImage);
+        segmentImage->SetRegions(labelImage->GetBufferedRegion());
+        segmentImage->Allocate(true);
+        segmentations.push_back(segmentImage);
+        segmentBuffers[labelIter->first] = segmentImage->GetBufferPointer();
+      }
+
+      const Label::PixelType *labelBuffer = labelImage->GetBufferPointer();
+      const std::size_t numberOfVoxels = labelImage->GetBufferedRegion().GetNumberOfPixels();
+
+      for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      {
+        SegmentImageType::PixelType *segmentBuffer = segmentBuffers[labelBuffer[i]];
+        if (segmentBuffer != nullptr)
+          segmentBuffer[i] = static_cast<SegmentImageType::PixelType>(labelBuffer[i]);
+      }
+
+      return segmentations;
+    }
+  }
+
   DICOMSegmentationIO::DICOMSegmentationIO()
     : AbstractFileIO(LabelSetImage::GetStaticNameOfClass(),
       mitk::MitkDICOMSEGIOMimeTypes::DICOMSEG_MIMETYPE_NAME(),
@@ -167,38 +207,13 @@ namespace mitk
         mitk::LabelSetImage *mitkLayerImage = const_cast<mitk::LabelSetImage *>(input);
         mitkLayerImage->SetActiveLayer(layer);
 
-        // Cast mitk layer image to itk
+        // Access the mitk layer image read-only, so that ITK uses its memory without copying it
         ImageToItk<itkInputImageType>::Pointer imageToItkFilter = ImageToItk<itkInputImageType>::New();
-        imageToItkFilter->SetInput(mitkLayerImage);
-        // Cast from original itk type to dcmqi input itk image type
-        typedef itk::CastImageFilter<itkInputImageType, itkInternalImageType> castItkImageFilterType;
-        castItkImageFilterType::Pointer castFilter = castItkImageFilterType::New();
-        castFilter->SetInput(imageToItkFilter->GetOutput());
-        castFilter->Update();
+        imageToItkFilter->SetInput(static_cast<const mitk::Image *>(mitkLayerImage));
+        imageToItkFilter->Update();
 
-        itkInternalImageType::Pointer itkLabelImage = castFilter->GetOutput();
-        itkLabelImage->DisconnectPipeline();
-
-        // Iterate over all labels. For each label a segmentation image will be created
-        const LabelSet *labelSet = input->GetLabelSet(layer);
-        auto labelIter = labelSet->IteratorConstBegin();
-        // Ignore background label
-        ++labelIter;
-
-        for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
-        {
-          // Thresold over the image with the given label value
-          itk::ThresholdImageFilter<itkInternalImageType>::Pointer thresholdFilter =
-            itk::ThresholdImageFilter<itkInternalImageType>::New();
-          thresholdFilter->SetInput(itkLabelImage);
-          thresholdFilter->ThresholdOutside(labelIter->first, labelIter->first);
-          thresholdFilter->SetOutsideValue(0);
-          thresholdFilter->Update();
-          itkInternalImageType::Pointer segmentImage = thresholdFilter->GetOutput();
-          segmentImage->DisconnectPipeline();
-
-          segmentations.push_back(segmentImage);
-        }
+        // Split all labels of the layer in one pass. For each label a segmentation image will be created
+        segmentations = SplitLabelImage(imageToItkFilter->GetOutput(), input->GetLabelSet(layer));
       }
       catch (const itk::ExceptionObject &e)
       {
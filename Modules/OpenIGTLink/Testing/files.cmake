@@ -2,4 +2,5 @@ set(MODULE_TESTS
    mitkOpenIGTLinkClientServerTest.cpp
    mitkOpenIGTLinkImageFactoryTest.cpp
    mitkOpenIGTLinkIGTLImageMessageFilterTest.cpp
+   mitkOpenIGTLinkServerSendQueueTest.cpp
 )
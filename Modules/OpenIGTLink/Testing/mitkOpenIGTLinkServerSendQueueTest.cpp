@@ -0,0 +1,99 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//MITK
+#include "mitkIGTLServer.h"
+
+//STD
+#include <vector>
+
+class mitkOpenIGTLinkServerSendQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkServerSendQueueTestSuite);
+  MITK_TEST(Push_BelowMaximum_KeepsAllMessages);
+  MITK_TEST(Push_AboveMaximum_DropsOldestMessages);
+  MITK_TEST(Push_PartiallySentMessage_IsKept);
+  MITK_TEST(Push_Replies_AreNeverDropped);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::IGTLServer::ClientSendQueue QueueType;
+
+  static QueueType::PackedMessageType CreateMessage(char id)
+  {
+    return std::make_shared<const std::vector<char>>(4, id);
+  }
+
+  static std::vector<char> GetQueuedIds(const QueueType& queue)
+  {
+    std::vector<char> ids;
+    for (const auto& entry : queue.Messages)
+      ids.push_back(entry.Message->front());
+    return ids;
+  }
+
+public:
+  void Push_BelowMaximum_KeepsAllMessages()
+  {
+    QueueType queue;
+    for (char id = 0; id < 4; ++id)
+      CPPUNIT_ASSERT(!queue.Push(CreateMessage(id), true, 4));
+
+    CPPUNIT_ASSERT(std::vector<char>({ 0, 1, 2, 3 }) == GetQueuedIds(queue));
+    CPPUNIT_ASSERT_EQUAL(0u, queue.DroppedMessages);
+  }
+
+  void Push_AboveMaximum_DropsOldestMessages()
+  {
+    QueueType queue;
+    for (char id = 0; id < 10; ++id)
+      queue.Push(CreateMessage(id), true, 4);
+
+    CPPUNIT_ASSERT(std::vector<char>({ 6, 7, 8, 9 }) == GetQueuedIds(queue));
+    CPPUNIT_ASSERT_EQUAL(6u, queue.DroppedMessages);
+  }
+
+  void Push_PartiallySentMessage_IsKept()
+  {
+    QueueType queue;
+    queue.Push(CreateMessage(0), true, 3);
+    queue.BytesSent = 2;
+    for (char id = 1; id < 6; ++id)
+      queue.Push(CreateMessage(id), true, 3);
+
+    CPPUNIT_ASSERT(std::vector<char>({ 0, 4, 5 }) == GetQueuedIds(queue));
+    CPPUNIT_ASSERT_EQUAL(3u, queue.DroppedMessages);
+  }
+
+  void Push_Replies_AreNeverDropped()
+  {
+    QueueType queue;
+    // even ids are replies
+    for (char id = 0; id < 8; ++id)
+      queue.Push(CreateMessage(id), id % 2 != 0, 3);
+
+    CPPUNIT_ASSERT(std::vector<char>({ 0, 2, 4, 6 }) == GetQueuedIds(queue));
+    CPPUNIT_ASSERT_EQUAL(4u, queue.DroppedMessages);
+
+    // a queue of replies only grows beyond the maximum
+    QueueType replies;
+    for (char id = 0; id < 5; ++id)
+      CPPUNIT_ASSERT(!replies.Push(CreateMessage(id), false, 3));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), replies.Messages.size());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkServerSendQueue)
@@ -77,6 +77,11 @@ bool mitk::IGTLClient::OpenConnection()
 
 void mitk::IGTLClient::Receive()
 {
+  //wait until there is something to read
+  SocketVectorType sockets(1, this->m_Socket);
+  if (WaitForSockets(sockets, false, GetCommunicationWaitTime()).empty())
+    return;
+
   //MITK_INFO << "Trying to receive message";
   //try to receive a message, if the socket is not present anymore stop the
   //communication
@@ -97,9 +102,12 @@ void mitk::IGTLClient::Send()
   //get the latest message from the queue
   mitkMessage = this->m_MessageQueue->PullSendMessage();
 
-  // there is no message => return
+  // there is no message => wait for the next one
   if (mitkMessage.IsNull())
+  {
+    this->m_MessageQueue->WaitForSendMessage(GetCommunicationWaitTime());
     return;
+  }
 
   if (!this->SendMessagePrivate(mitkMessage, this->m_Socket))
   {
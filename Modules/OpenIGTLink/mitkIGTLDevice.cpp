@@ -15,8 +15,16 @@ found in the LICENSE file.
 //#include "mitkIGTTimeStamp.h"
 #include <itkMutexLockHolder.h>
 #include <itksys/SystemTools.hxx>
+#include <cerrno>
 #include <cstring>
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
 #include <igtlTransformMessage.h>
 #include <mitkIGTLMessageCommon.h>
 
@@ -27,6 +35,8 @@ found in the LICENSE file.
 
 //TODO: Which timeout is acceptable and also needed to transmit image data? Is there a maximum data limit?
 static const int SOCKET_SEND_RECEIVE_TIMEOUT_MSEC = 100;
+//the communication threads check this often whether they shall stop while they wait for sockets or messages
+static const unsigned int COMMUNICATION_WAIT_MSEC = 10;
 typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
 
 mitk::IGTLDevice::IGTLDevice(bool ReadFully) :
@@ -46,6 +56,7 @@ m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0), m_ConnectThre
   m_SendingFinishedMutex = itk::FastMutexLock::New();
   m_ReceivingFinishedMutex = itk::FastMutexLock::New();
   m_ConnectingFinishedMutex = itk::FastMutexLock::New();
+  m_SocketModeMutex = itk::FastMutexLock::New();
   // execution rights are owned by the application thread at the beginning
   m_SendingFinishedMutex->Lock();
   m_ReceivingFinishedMutex->Lock();
@@ -119,6 +130,11 @@ bool mitk::IGTLDevice::TestConnection()
 
 unsigned int mitk::IGTLDevice::ReceivePrivate(igtl::Socket* socket)
 {
+#ifdef _WIN32
+  //SendNonBlocking() switches the socket to non-blocking mode on windows
+  MutexLockHolder socketModeLock(*m_SocketModeMutex);
+#endif
+
   // Create a message buffer to receive header
   igtl::MessageHeader::Pointer headerMsg;
   headerMsg = igtl::MessageHeader::New();
@@ -320,9 +336,6 @@ void mitk::IGTLDevice::RunCommunication(void (IGTLDevice::*ComFunction)(void), i
       this->m_StopCommunicationMutex->Lock();
       localStopCommunication = m_StopCommunication;
       this->m_StopCommunicationMutex->Unlock();
-
-      // time to relax, this sets the maximum ever possible framerate to 1000 Hz
-      itksys::SystemTools::Delay(1);
     }
   }
   catch (...)
@@ -441,6 +454,112 @@ bool mitk::IGTLDevice::SendRTSMessage(const char* type)
 void mitk::IGTLDevice::Connect()
 {
   MITK_DEBUG << "mitk::IGTLDevice::Connect();";
+  //nothing to do, wait until the communication is checked again
+  itksys::SystemTools::Delay(COMMUNICATION_WAIT_MSEC);
+}
+
+unsigned int mitk::IGTLDevice::GetCommunicationWaitTime()
+{
+  return COMMUNICATION_WAIT_MSEC;
+}
+
+std::vector<std::size_t> mitk::IGTLDevice::WaitForSockets(
+  const SocketVectorType& sockets, bool write, unsigned int timeoutMsec)
+{
+  std::vector<std::size_t> readySockets;
+
+  std::vector<pollfd> descriptors;
+  std::vector<std::size_t> socketIndices;
+  for (std::size_t i = 0; i < sockets.size(); ++i)
+  {
+    int descriptor = sockets[i]->GetSocketDescriptor();
+    if (descriptor < 0)
+    {
+      //the socket is closed, report it so that it gets removed
+      readySockets.push_back(i);
+      continue;
+    }
+    pollfd pollDescriptor;
+    pollDescriptor.fd = descriptor;
+    pollDescriptor.events = write ? POLLOUT : POLLIN;
+    pollDescriptor.revents = 0;
+    descriptors.push_back(pollDescriptor);
+    socketIndices.push_back(i);
+  }
+
+  if (!readySockets.empty())
+  {
+    return readySockets;
+  }
+
+  if (descriptors.empty())
+  {
+    itksys::SystemTools::Delay(timeoutMsec);
+    return readySockets;
+  }
+
+#ifdef _WIN32
+  int result = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), static_cast<INT>(timeoutMsec));
+#else
+  int result = poll(descriptors.data(), descriptors.size(), static_cast<int>(timeoutMsec));
+#endif
+
+  if (result <= 0)
+  {
+    //timeout or interrupted
+    return readySockets;
+  }
+
+  for (std::size_t i = 0; i < descriptors.size(); ++i)
+  {
+    if (descriptors[i].revents != 0)
+    {
+      readySockets.push_back(socketIndices[i]);
+    }
+  }
+  return readySockets;
+}
+
+bool mitk::IGTLDevice::SendNonBlocking(igtl::Socket* socket, const char* data,
+  std::size_t length, std::size_t& sent)
+{
+  sent = 0;
+#ifdef _WIN32
+  //there is no flag for a non-blocking send on windows, therefore the socket
+  //is switched to non-blocking mode for this call. ReceivePrivate() must not
+  //read from the socket meanwhile.
+  MutexLockHolder lock(*m_SocketModeMutex);
+  SOCKET descriptor = static_cast<SOCKET>(socket->GetSocketDescriptor());
+  u_long nonBlocking = 1;
+  if (ioctlsocket(descriptor, FIONBIO, &nonBlocking) != 0)
+  {
+    return false;
+  }
+  int result = ::send(descriptor, data, static_cast<int>(length), 0);
+  int error = WSAGetLastError();
+  u_long blocking = 0;
+  ioctlsocket(descriptor, FIONBIO, &blocking);
+  if (result == SOCKET_ERROR)
+  {
+    //the socket buffer is full, try again when the socket is writable
+    return error == WSAEWOULDBLOCK || error == WSAEINTR;
+  }
+  sent = static_cast<std::size_t>(result);
+  return true;
+#else
+  int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+  flags |= MSG_NOSIGNAL;
+#endif
+  ssize_t result = ::send(socket->GetSocketDescriptor(), data, length, flags);
+  if (result < 0)
+  {
+    //the socket buffer is full, try again when the socket is writable
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  sent = static_cast<std::size_t>(result);
+  return true;
+#endif
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLDevice::GetNextImage2dMessage()
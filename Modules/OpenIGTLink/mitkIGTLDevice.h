@@ -31,6 +31,8 @@ found in the LICENSE file.
 #include "mitkIGTLMessageQueue.h"
 #include "mitkIGTLMessage.h"
 
+#include <vector>
+
 namespace mitk {
   /**
   * \brief Interface for all OpenIGTLink Devices
@@ -47,7 +49,10 @@ namespace mitk {
   * OpenConnection() and arrive in the Ready state. From the Ready state you
   * call StartCommunication() to arrive in the Running state. Now the device
   * is continuosly checking for new connections, receiving messages and
-  * sending messages. This runs in a seperate thread. To stop the communication
+  * sending messages. This runs in a seperate thread. The threads wait for
+  * readable sockets, writable sockets or queued messages instead of polling
+  * them periodically, so messages are handled as soon as they arrive. To stop
+  * the communication
   * call StopCommunication() (to arrive in Ready state) or CloseConnection()
   * (to arrive in the Setup state).
   *
@@ -103,7 +108,8 @@ namespace mitk {
      * \brief Continuously calls the given function
      *
      * This may only be called if the device is in Running state and only from
-     * a seperate thread.
+     * a seperate thread. The given function is expected to wait for work by
+     * itself, for at most GetCommunicationWaitTime() milliseconds.
      *
      * \param ComFunction function pointer that specifies the method to be executed
      * \param mutex the mutex that corresponds to the function pointer
@@ -249,6 +255,40 @@ namespace mitk {
     itkSetMacro(LogMessages, bool);
 
   protected:
+    typedef std::vector<igtl::Socket::Pointer> SocketVectorType;
+
+    /**
+    * \brief Returns the time in milliseconds the communication threads wait
+    * for sockets or messages before they check whether they shall stop
+    */
+    static unsigned int GetCommunicationWaitTime();
+
+    /**
+    * \brief Waits until at least one of the given sockets is ready
+    *
+    * \param sockets the sockets to be watched
+    * \param write if true, waits for sockets that can be written without
+    * blocking, otherwise for sockets that can be read
+    * \param timeoutMsec the maximum time to wait
+    * \return the indices of the ready sockets, also of sockets with errors
+    * or closed connections. Empty if the timeout expired.
+    */
+    static std::vector<std::size_t> WaitForSockets(const SocketVectorType& sockets,
+      bool write, unsigned int timeoutMsec);
+
+    /**
+    * \brief Writes as much of the given data to the socket as possible without
+    * blocking
+    *
+    * On windows, the socket is switched to non-blocking mode for the call,
+    * therefore it is not read by ReceivePrivate() meanwhile.
+    *
+    * \param sent returns the number of bytes written
+    * \return false if the connection is broken
+    */
+    bool SendNonBlocking(igtl::Socket* socket, const char* data,
+      std::size_t length, std::size_t& sent);
+
     /**
      * \brief Sends a message.
      *
@@ -336,6 +376,8 @@ namespace mitk {
     itk::FastMutexLock::Pointer m_ConnectingFinishedMutex;
     /** mutex to control access to m_State */
     itk::FastMutexLock::Pointer m_StateMutex;
+    /** mutex used on windows to not read from a socket while it is in non-blocking mode */
+    itk::FastMutexLock::Pointer m_SocketModeMutex;
 
     /** the hostname or ip of the device */
     std::string m_Hostname;
@@ -11,6 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLMessageQueue.h"
+#include <chrono>
 #include <string>
 #include "igtlMessageBase.h"
 
@@ -22,6 +23,13 @@ void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
 
   m_SendQueue.push_back(message);
   this->m_Mutex->Unlock();
+
+  // the waiting thread checks the queue while holding m_SendWaitMutex, thus
+  // the notification cannot get lost between its check and its wait
+  {
+    std::lock_guard<std::mutex> lock(m_SendWaitMutex);
+  }
+  m_SendCondition.notify_all();
 }
 
 void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
@@ -123,6 +131,18 @@ mitk::IGTLMessage::Pointer mitk::IGTLMessageQueue::PullSendMessage()
   return ret;
 }
 
+bool mitk::IGTLMessageQueue::WaitForSendMessage(unsigned int timeoutMsec)
+{
+  std::unique_lock<std::mutex> lock(m_SendWaitMutex);
+  return m_SendCondition.wait_for(lock, std::chrono::milliseconds(timeoutMsec), [this]()
+  {
+    this->m_Mutex->Lock();
+    bool hasMessage = !this->m_SendQueue.empty();
+    this->m_Mutex->Unlock();
+    return hasMessage;
+  });
+}
+
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
   igtl::MessageBase::Pointer ret = nullptr;
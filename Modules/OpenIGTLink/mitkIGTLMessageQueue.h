@@ -19,7 +19,9 @@ found in the LICENSE file.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <mitkIGTLMessage.h>
 
 //OpenIGTLink
@@ -73,6 +75,13 @@ namespace mitk {
     igtl::TransformMessage::Pointer PullTransformMessage();
     mitk::IGTLMessage::Pointer PullSendMessage();
 
+    /**
+    * \brief Blocks until the send queue contains a message or the timeout
+    * expired
+    * \return true if there is a message to be sent
+    */
+    bool WaitForSendMessage(unsigned int timeoutMsec);
+
     /**
     * \brief Get the number of messages in the queue
     */
@@ -129,6 +138,12 @@ namespace mitk {
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
+    /**
+    * \brief Wakes the threads waiting for messages to be sent
+    */
+    std::mutex m_SendWaitMutex;
+    std::condition_variable m_SendCondition;
+
     /**
     * \brief defines the kind of buffering
     */
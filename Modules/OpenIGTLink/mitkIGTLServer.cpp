@@ -11,7 +11,9 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLServer.h"
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #include <itksys/SystemTools.hxx>
 #include <itkMutexLockHolder.h>
@@ -21,8 +23,13 @@ found in the LICENSE file.
 #include <igtlImageMessage.h>
 #include <igtl_status.h>
 
+//time to wait for a congested client before the newly queued messages are distributed
+static const unsigned int CONGESTED_CLIENT_WAIT_MSEC = 1;
+typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
+
 mitk::IGTLServer::IGTLServer(bool ReadFully) :
-IGTLDevice(ReadFully)
+IGTLDevice(ReadFully),
+m_MaximumSendQueueSize(64)
 {
   m_ReceiveListMutex = itk::FastMutexLock::New();
   m_SentListMutex = itk::FastMutexLock::New();
@@ -90,7 +97,7 @@ void mitk::IGTLServer::Connect()
   igtl::Socket::Pointer socket;
   //check if another igtl device wants to connect to this socket
   socket =
-    ((igtl::ServerSocket*)(this->m_Socket.GetPointer()))->WaitForConnection(1);
+    ((igtl::ServerSocket*)(this->m_Socket.GetPointer()))->WaitForConnection(GetCommunicationWaitTime());
   //if there is a new connection the socket is not null
   if (socket.IsNotNull())
   {
@@ -111,22 +118,23 @@ void mitk::IGTLServer::Receive()
   unsigned int status = IGTL_STATUS_OK;
   SocketListType socketsToBeRemoved;
 
-  //the server can be connected with several clients, therefore it has to check
-  //all registered clients
-  SocketListIteratorType it;
+  //the server can be connected with several clients, therefore it has to
+  //wait for all registered clients. Only the clients that sent something are
+  //read, so a quiet client does not delay the others.
   m_ReceiveListMutex->Lock();
-  auto it_end = this->m_RegisteredClients.end();
-  for (it = this->m_RegisteredClients.begin(); it != it_end; ++it)
+  SocketVectorType clients(this->m_RegisteredClients.begin(), this->m_RegisteredClients.end());
+  m_ReceiveListMutex->Unlock();
+
+  std::vector<std::size_t> readableClients = WaitForSockets(clients, false, GetCommunicationWaitTime());
+  for (auto index : readableClients)
   {
     //it is possible that ReceivePrivate detects that the current socket is
     //already disconnected. Therefore, it is necessary to remove this socket
     //from the registered clients list
-    status = this->ReceivePrivate(*it);
+    status = this->ReceivePrivate(clients[index]);
     if (status == IGTL_STATUS_NOT_PRESENT)
     {
-      //remember this socket for later, it is not a good idea to remove it
-      //from the list directly because we iterate over the list at this point
-      socketsToBeRemoved.push_back(*it);
+      socketsToBeRemoved.push_back(clients[index]);
       MITK_WARN("IGTLServer") << "Lost connection to a client socket. ";
     }
     else if (status != 1)
@@ -134,7 +142,6 @@ void mitk::IGTLServer::Receive()
       MITK_DEBUG("IGTLServer") << "IGTL Message with status: " << status;
     }
   }
-  m_ReceiveListMutex->Unlock();
   if (socketsToBeRemoved.size() > 0)
   {
     //remove the sockets that are not connected anymore
@@ -146,31 +153,126 @@ void mitk::IGTLServer::Receive()
 
 void mitk::IGTLServer::Send()
 {
-  //get the latest message from the queue
-  mitk::IGTLMessage::Pointer curMessage = this->m_MessageQueue->PullSendMessage();
-
-  // there is no message => return
-  if (curMessage.IsNull())
-    return;
-
-  //the server can be connected with several clients, therefore it has to check
-  //all registered clients
+  //the server can be connected with several clients, therefore every message
+  //is added to the queues of all registered clients
   //sending a message to all registered clients might not be the best solution,
   //it could be better to store the client together with the requested type. Then
   //the data would be send to the appropriate client and to noone else.
   //(I know it is no excuse but PLUS is doing exactly the same, they broadcast
   //everything)
-  m_SentListMutex->Lock();
-  SocketListIteratorType it;
-  auto it_end =
-    this->m_RegisteredClients.end();
-  for (it = this->m_RegisteredClients.begin(); it != it_end; ++it)
+  SocketVectorType pendingClients;
   {
-    //maybe there should be a check here if the current socket is still active
-    this->SendMessagePrivate(curMessage, *it);
-    MITK_DEBUG("IGTLServer") << "Sent IGTL Message";
+    MutexLockHolder lock(*m_SentListMutex);
+
+    mitk::IGTLMessage::Pointer curMessage;
+    while ((curMessage = this->m_MessageQueue->PullSendMessage()).IsNotNull())
+    {
+      //pack (serialize) the message once for all clients
+      igtl::MessageBase* sendMessage = curMessage->GetMessage();
+      sendMessage->Pack();
+      const char* packPointer = static_cast<const char*>(sendMessage->GetPackPointer());
+      auto packedMessage = std::make_shared<const std::vector<char>>(packPointer, packPointer + sendMessage->GetPackSize());
+
+      //replies to commands must reach the client, all other messages are
+      //superseded by newer ones
+      const bool droppable = std::strncmp(sendMessage->GetDeviceType(), "RTS_", 4) != 0;
+
+      if (m_LogMessages) { MITK_INFO << "Send IGTL message: " << curMessage->ToString(); }
+
+      for (const auto& client : this->m_RegisteredClients)
+      {
+        ClientSendQueue& queue = m_ClientSendQueues[client];
+        if (queue.Broken)
+          continue;
+
+        //the client cannot keep up, its oldest messages are dropped instead of
+        //delaying the other clients
+        if (queue.Push(packedMessage, droppable, m_MaximumSendQueueSize) && queue.DroppedMessages == 1)
+        {
+          MITK_WARN("IGTLServer") << "A client cannot keep up with the sent messages. Its oldest queued messages "
+                                     "are dropped.";
+        }
+      }
+    }
+
+    for (const auto& client : this->m_RegisteredClients)
+    {
+      auto queue = m_ClientSendQueues.find(client);
+      if (queue != m_ClientSendQueues.end() && !queue->second.Messages.empty())
+        pendingClients.push_back(client);
+    }
   }
-  m_SentListMutex->Unlock();
+
+  // there is no message => wait for the next one
+  if (pendingClients.empty())
+  {
+    this->m_MessageQueue->WaitForSendMessage(GetCommunicationWaitTime());
+    return;
+  }
+
+  //the wait only lasts if none of the clients can take more data
+  std::vector<std::size_t> writableClients = WaitForSockets(pendingClients, true, CONGESTED_CLIENT_WAIT_MSEC);
+
+  MutexLockHolder lock(*m_SentListMutex);
+  for (auto index : writableClients)
+  {
+    auto queueIt = m_ClientSendQueues.find(pendingClients[index]);
+    if (queueIt == m_ClientSendQueues.end())
+      continue; //the client was removed meanwhile
+
+    ClientSendQueue& queue = queueIt->second;
+    while (!queue.Messages.empty())
+    {
+      const std::vector<char>& packedMessage = *queue.Messages.front().Message;
+      std::size_t sent = 0;
+      if (!SendNonBlocking(pendingClients[index], packedMessage.data() + queue.BytesSent,
+        packedMessage.size() - queue.BytesSent, sent))
+      {
+        //the receiving thread removes the client when it notices the closed connection
+        MITK_WARN("IGTLServer") << "Could not send IGTL message to a client socket.";
+        queue.Messages.clear();
+        queue.BytesSent = 0;
+        queue.Broken = true;
+        break;
+      }
+
+      queue.BytesSent += sent;
+      if (queue.BytesSent < packedMessage.size())
+        break; //the socket buffer is full, continue when it is writable again
+
+      queue.Messages.pop_front();
+      queue.BytesSent = 0;
+      this->InvokeEvent(MessageSentEvent());
+      MITK_DEBUG("IGTLServer") << "Sent IGTL Message";
+    }
+
+    if (queue.Messages.empty() && queue.DroppedMessages > 0)
+    {
+      MITK_WARN("IGTLServer") << "Dropped " << queue.DroppedMessages << " messages for a client that could not keep up.";
+      queue.DroppedMessages = 0;
+    }
+  }
+}
+
+bool mitk::IGTLServer::ClientSendQueue::Push(const PackedMessageType& message, bool droppable, std::size_t maximumSize)
+{
+  Entry entry;
+  entry.Message = message;
+  entry.Droppable = droppable;
+  Messages.push_back(entry);
+
+  if (Messages.size() <= maximumSize)
+    return false;
+
+  //the first message cannot be dropped if it is partially sent already
+  auto first = BytesSent > 0 ? Messages.begin() + 1 : Messages.begin();
+  auto oldestDroppable = std::find_if(first, Messages.end(), [](const Entry& e) { return e.Droppable; });
+  if (oldestDroppable == Messages.end())
+    return false;
+
+  Messages.erase(oldestDroppable);
+  ++DroppedMessages;
+  return true;
 }
 
 void mitk::IGTLServer::StopCommunicationWithSocket(
@@ -193,6 +295,7 @@ void mitk::IGTLServer::StopCommunicationWithSocket(igtl::Socket* client)
       //    //close the socket
       (*i)->CloseSocket();
       //and remove it from the list
+      m_ClientSendQueues.erase(client);
       i = this->m_RegisteredClients.erase(i);
       MITK_INFO("IGTLServer") << "Removed client socket from server client list.";
       break;
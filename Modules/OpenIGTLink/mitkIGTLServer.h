@@ -17,6 +17,11 @@ found in the LICENSE file.
 
 #include <MitkOpenIGTLinkExports.h>
 
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace mitk
 {
   /**
@@ -28,6 +33,13 @@ namespace mitk
   * connect to several clients. Therefore, it is necessary for the server to
   * have a list with registered sockets.
   *
+  * Every client has its own queue of outgoing messages that is written
+  * without blocking whenever the client's socket is writable, so a slow
+  * client does not delay the others. If a client cannot keep up and its
+  * queue exceeds GetMaximumSendQueueSize() messages, its oldest messages are
+  * dropped and a warning is logged. Replies to commands (RTS_ messages) are
+  * never dropped.
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLServer : public IGTLDevice
@@ -63,6 +75,54 @@ namespace mitk
     */
     unsigned int GetNumberOfConnections() override;
 
+    /**
+    * \brief Sets the maximum number of messages queued for a single client
+    */
+    itkSetClampMacro(MaximumSendQueueSize, unsigned int, 1, itk::NumericTraits<unsigned int>::max());
+
+    /**
+    * \brief Returns the maximum number of messages queued for a single client
+    */
+    itkGetConstMacro(MaximumSendQueueSize, unsigned int);
+
+    /**
+    * \brief Outgoing messages of a client
+    */
+    struct MITKOPENIGTLINK_EXPORT ClientSendQueue
+    {
+      typedef std::shared_ptr<const std::vector<char>> PackedMessageType;
+
+      ClientSendQueue() : BytesSent(0), DroppedMessages(0), Broken(false) {}
+
+      /**
+      * \brief Appends a packed message to the queue
+      *
+      * If more than maximumSize messages are queued afterwards, the oldest
+      * droppable message that was not started yet is dropped. Messages that
+      * are not droppable are always kept, even if the queue grows beyond
+      * maximumSize.
+      *
+      * \return true if a message was dropped
+      */
+      bool Push(const PackedMessageType& message, bool droppable, std::size_t maximumSize);
+
+      /** a packed message and whether it may be dropped */
+      struct Entry
+      {
+        PackedMessageType Message;
+        bool Droppable;
+      };
+
+      /** messages that were not sent completely yet */
+      std::deque<Entry> Messages;
+      /** number of bytes of the first message that were already sent */
+      std::size_t BytesSent;
+      /** number of messages dropped since the queue was empty the last time */
+      unsigned int DroppedMessages;
+      /** true if sending failed, the client is removed by the receiving thread */
+      bool Broken;
+    };
+
   protected:
     /** Constructor */
     IGTLServer(bool ReadFully);
@@ -117,8 +177,14 @@ namespace mitk
     /** mutex to control access to m_RegisteredClients */
     itk::FastMutexLock::Pointer m_ReceiveListMutex;
 
-    /** mutex to control access to m_RegisteredClients */
+    /** mutex to control access to m_RegisteredClients and m_ClientSendQueues */
     itk::FastMutexLock::Pointer m_SentListMutex;
+
+    /** the outgoing messages of the registered clients */
+    std::map<igtl::Socket*, ClientSendQueue> m_ClientSendQueues;
+
+    /** maximum number of messages queued for a single client */
+    unsigned int m_MaximumSendQueueSize;
   };
 } // namespace mitk
 #endif /* MITKIGTLSERVER_H */
@@ -211,6 +211,10 @@ namespace mitk
      * paOutput respectively. In the background the OpenCV Farneback algorithm is
      * used for the flow determination.
      *
+     * Every slice only depends on the first slice of its batch, so the slices are
+     * corrected concurrently using up to @c GetNumberOfThreads() threads. The
+     * slices are accessed in place, no intermediate images are created.
+     *
      * @param paInput The photoacoustic input image
      * @param usInput The ultrasonic input image
      * @param paOutput The photoacoustic output image
@@ -221,18 +225,17 @@ namespace mitk
                            mitk::Image::Pointer paOutput,
                            mitk::Image::Pointer usOutput);
     /*!
-     * \brief Extract a 2d slice as OpenCV matrix.
+     * \brief Wrap a 2d slice of a volume buffer as OpenCV matrix.
      *
-     * This method extracts slice @p i from the 3-dimensional image @p input and
-     * converts it to a OpenCV matrix. Internally, the
-     * mitkImageToOpenCVImageFilter is used.
+     * The returned matrix does not own its data but refers to slice @p i of
+     * @p volume directly. Size and type are the ones determined for the current
+     * input in @c PerformCorrection.
      *
-     * @param input A 3d image from which a slice is extracted as a 2d OpenCV
-     * matrix.
-     * @param i Determines the slice to be extracted.
-     * @return returns a OpenCV matrix containing the 2d slice.
+     * @param volume Pointer to the image data of a 3d image.
+     * @param i Determines the slice to be wrapped.
+     * @return returns a OpenCV matrix header for the 2d slice.
      */
-    cv::Mat GetMatrix(const mitk::Image::Pointer input, unsigned int i);
+    cv::Mat GetSliceMatrix(const void *volume, unsigned int i) const;
 
     /*!
      * \brief Rescale matrix such that the values lie between 0 and 255
@@ -242,32 +245,20 @@ namespace mitk
      * @warning This is a specialized method which does not perform the operation in general, but only if the matrix stems from the right ultrasonic image. Therefore, the method should only be called internally.
      *
      * @param mat The OpenCV matrix to be rescaled
-     * @return The rescaled OpenCV matrix
+     * @param result The rescaled OpenCV matrix, its buffer is reused if possible
      */
-    cv::Mat FitMatrixToChar(cv::Mat mat);
-
-    /*!
-     * \brief Insert a OpenCV matrix as a slice into an image
-     *
-     * This method converts the 2d OpenCV matrix @p mat into an mitk image using
-     * the mitkOpenCVToMitkImageFilter. Afterwards it inserts the image as slice
-     * @p i into the 3d mitk image @p output.
-     *
-     * @param mat The matrix to be inserted as a slice
-     * @param output The 3d image the matrix is inserted into
-     * @param i The index of the slice to be replaced.
-     */
-    void InsertMatrixAsSlice(cv::Mat mat, mitk::Image::Pointer output, unsigned int i);
+    void FitMatrixToChar(const cv::Mat &mat, cv::Mat &result) const;
 
     /*!
      * \brief Compute the remapping map from an optical flow
      *
-     * The optical flow cannot be used directly to compensate an image. Instead we have to generate an appropriate map.
+     * The optical flow cannot be used directly to compensate an image. Instead we have to generate an appropriate map,
+     * which is the flow added to the pixel coordinate grid.
      *
      * @param flow The optical flow which is the base for the remapping.
-     * @return The remapping map.
+     * @param map The remapping map, its buffer is reused if possible.
      */
-    cv::Mat ComputeFlowMap(cv::Mat);
+    void ComputeFlowMap(const cv::Mat &flow, cv::Mat &map) const;
 
   private:
     // Parameters
@@ -288,20 +279,9 @@ namespace mitk
     float m_MinValue; /*!< The minimum of the ultrasonic image*/
 
     // Stuff that OpenCV needs
-    cv::Mat m_UsRef; /*!< Contains the reference ultrasonic image to which the
-                         motion compensation is compared to.*/
-    cv::Mat m_Flow;  /*!< Contains the optical flow between @c m_UsRef and @c m_UsMat*/
-    cv::Mat m_PaRes; /*!< Contains the motion compensated photoacoustic image*/
-    cv::Mat m_UsRes; /*!< Contains the motion compensated ultrasonic image*/
-    cv::Mat m_PaMat; /*!< Contains the latest photoacoustic image to be motion compensated*/
-    cv::Mat m_UsMat; /*!< Contains the latest ultrasonic image on which the
-                        optical flow is to be computed */
-    cv::Mat m_Map; /*!< Contains the remapping map */
-
-    mitk::OpenCVToMitkImageFilter::Pointer m_OpenCVToImageFilter =
-      mitk::OpenCVToMitkImageFilter::New(); /*!< Filter which converts an OpenCV matrix to a mitk image */
-    mitk::ImageToOpenCVImageFilter::Pointer m_ImageToOpenCVFilter =
-      mitk::ImageToOpenCVImageFilter::New(); /*!< Filter which converts a mitk image to an OpenCV matrix */
+    cv::Size m_SliceSize; /*!< Size of the 2d slices of the current input */
+    int m_SliceType;      /*!< OpenCV type corresponding to the pixel type of the current input */
+    cv::Mat m_Grid;       /*!< Contains the pixel coordinates of a slice, the base of every remapping map */
   };
 }
 #endif
@@ -12,6 +12,40 @@ found in the LICENSE file.
 
 #include "./mitkPhotoacousticMotionCorrectionFilter.h"
 #include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  int GetOpenCVType(const mitk::PixelType &pixelType)
+  {
+    if (pixelType.GetNumberOfComponents() != 1)
+      return -1;
+
+    switch (pixelType.GetComponentType())
+    {
+      case itk::ImageIOBase::UCHAR:
+        return CV_8UC1;
+      case itk::ImageIOBase::CHAR:
+        return CV_8SC1;
+      case itk::ImageIOBase::USHORT:
+        return CV_16UC1;
+      case itk::ImageIOBase::SHORT:
+        return CV_16SC1;
+      case itk::ImageIOBase::INT:
+        return CV_32SC1;
+      case itk::ImageIOBase::FLOAT:
+        return CV_32FC1;
+      case itk::ImageIOBase::DOUBLE:
+        return CV_64FC1;
+      default:
+        return -1;
+    }
+  }
+}
 
 mitk::PhotoacousticMotionCorrectionFilter::
     PhotoacousticMotionCorrectionFilter() {
@@ -30,6 +64,8 @@ mitk::PhotoacousticMotionCorrectionFilter::
   m_MaxValue = 255.0;
   m_MinValue = 0.0;
 
+  m_SliceType = -1;
+
   this->SetNumberOfIndexedInputs(2);
   this->SetNumberOfIndexedOutputs(2);
   this->SetNthOutput(0, mitk::Image::New());
@@ -94,9 +130,12 @@ void mitk::PhotoacousticMotionCorrectionFilter::CheckInput(
 void mitk::PhotoacousticMotionCorrectionFilter::InitializeOutputIfNecessary(
     mitk::Image::Pointer paInput, mitk::Image::Pointer usInput,
     mitk::Image::Pointer paOutput, mitk::Image::Pointer usOutput) {
-  if (paOutput->GetDimension() != IMAGE_DIMENSION) {
+  if (paOutput->GetDimension() != IMAGE_DIMENSION ||
+      paOutput->GetPixelType() != paInput->GetPixelType() ||
+      usOutput->GetPixelType() != usInput->GetPixelType()) {
     this->InitializeOutput(paInput, paOutput);
     this->InitializeOutput(usInput, usOutput);
+    return;
   }
 
   for (unsigned int i = 0; i < usOutput->GetDimension(); ++i) {
@@ -119,93 +158,111 @@ void mitk::PhotoacousticMotionCorrectionFilter::PerformCorrection(
     mitk::Image::Pointer paInput, mitk::Image::Pointer usInput,
     mitk::Image::Pointer paOutput, mitk::Image::Pointer usOutput) {
 
+  m_SliceType = GetOpenCVType(paInput->GetPixelType());
+  if (m_SliceType < 0 || GetOpenCVType(usInput->GetPixelType()) != m_SliceType) {
+    MITK_ERROR << "Unsupported pixel type in the motion compensation filter.";
+    throw std::invalid_argument(
+        "Both images must have the same scalar pixel type.");
+  }
+
+  m_SliceSize = cv::Size(paInput->GetDimensions()[0], paInput->GetDimensions()[1]);
+  const unsigned int numberOfSlices = paInput->GetDimensions()[IMAGE_DIMENSION - 1];
+
+  // The remapping maps are the flow added to this coordinate grid
+  if (m_Grid.size() != m_SliceSize) {
+    m_Grid.create(m_SliceSize, CV_32FC2);
+    for (int y = 0; y < m_Grid.rows; ++y) {
+      auto row = m_Grid.ptr<cv::Point2f>(y);
+      for (int x = 0; x < m_Grid.cols; ++x)
+        row[x] = cv::Point2f(x, y);
+    }
+  }
+
   // If batch size was set to 0, use one single batch for the whole data set.
   unsigned int batch;
   if (m_BatchSize == 0) {
-    batch = paInput->GetDimensions()[IMAGE_DIMENSION - 1];
+    batch = numberOfSlices;
   } else {
     batch = m_BatchSize;
   }
 
-  for (unsigned int i = 0; i < paInput->GetDimensions()[IMAGE_DIMENSION - 1]; ++i) {
-
-    // Get the 2d matrix from slice at i
-    m_PaMat = this->GetMatrix(paInput, i);
-    m_UsMat = this->GetMatrix(usInput, i);
-
-    // At the beginning of a batch we set the new reference image and directly
-    // write the result images
+  mitk::ImageReadAccessor paInputAccessor(paInput);
+  mitk::ImageReadAccessor usInputAccessor(usInput);
+  mitk::ImageWriteAccessor paOutputAccessor(paOutput);
+  mitk::ImageWriteAccessor usOutputAccessor(usOutput);
+
+  const void *paInputData = paInputAccessor.GetData();
+  const void *usInputData = usInputAccessor.GetData();
+  void *paOutputData = paOutputAccessor.GetData();
+  void *usOutputData = usOutputAccessor.GetData();
+
+  // Each slice only depends on the first slice of its batch, which is used as
+  // reference. Rescale all references up front, then all slices are independent.
+  std::vector<cv::Mat> references((numberOfSlices + batch - 1) / batch);
+  for (unsigned int i = 0; i < references.size(); ++i)
+    this->FitMatrixToChar(this->GetSliceMatrix(usInputData, i * batch), references[i]);
+
+  // Buffers of every worker, reused for all of its slices since all slices have the same size
+  struct SliceBuffers
+  {
+    cv::Mat usRescaled;
+    cv::Mat flow;
+    cv::Mat map;
+  };
+  std::vector<SliceBuffers> workerBuffers(mitk::GetParallelForNumberOfThreads());
+
+  mitk::ParallelFor(numberOfSlices, [&](std::size_t i, unsigned int workerIndex) {
+    const cv::Mat paMat = this->GetSliceMatrix(paInputData, i);
+    const cv::Mat usMat = this->GetSliceMatrix(usInputData, i);
+    cv::Mat paRes = this->GetSliceMatrix(paOutputData, i);
+    cv::Mat usRes = this->GetSliceMatrix(usOutputData, i);
+
+    // The first slice of a batch is the reference and is copied unchanged
     if (i % batch == 0) {
-      // Rescale reference to full char resolution
-      m_UsRef = this->FitMatrixToChar(m_UsMat);
-      m_UsRes = m_UsMat.clone();
-      m_PaRes = m_PaMat.clone();
-    } else {
-      cv::Mat UsMatRescaled = this->FitMatrixToChar(m_UsMat);
-      cv::calcOpticalFlowFarneback(m_UsRef, UsMatRescaled, m_Flow, m_PyrScale,
-                                   m_Levels, m_WinSize, m_Iterations, m_PolyN,
-                                   m_PolySigma, m_Flags);
-
-      m_Map = this->ComputeFlowMap(m_Flow);
-
-      // Apply the flow to the matrices
-      cv::remap(m_PaMat, m_PaRes, m_Map, cv::noArray(), cv::INTER_LINEAR);
-      cv::remap(m_UsMat, m_UsRes, m_Map, cv::noArray(), cv::INTER_LINEAR);
+      paMat.copyTo(paRes);
+      usMat.copyTo(usRes);
+      return;
     }
 
-    // Enter the matrix as a slice at position i into output
-    this->InsertMatrixAsSlice(m_PaRes, paOutput, i);
-    this->InsertMatrixAsSlice(m_UsRes, usOutput, i);
-  }
-}
+    cv::Mat &usRescaled = workerBuffers[workerIndex].usRescaled;
+    cv::Mat &flow = workerBuffers[workerIndex].flow;
+    cv::Mat &map = workerBuffers[workerIndex].map;
 
-// Copied from https://stackoverflow.com/questions/17459584/opencv-warping-image-based-on-calcopticalflowfarneback
-cv::Mat mitk::PhotoacousticMotionCorrectionFilter::ComputeFlowMap(cv::Mat flow) {
-  cv::Mat map(flow.size(), flow.type());
+    this->FitMatrixToChar(usMat, usRescaled);
+    cv::calcOpticalFlowFarneback(references[i / batch], usRescaled, flow, m_PyrScale,
+                                 m_Levels, m_WinSize, m_Iterations, m_PolyN,
+                                 m_PolySigma, m_Flags);
 
-  for (int y = 0; y < map.rows; ++y) {
-    for(int x = 0; x < map.cols; ++x) {
-      cv::Point2f f = flow.at<cv::Point2f>(y,x);
-      map.at<cv::Point2f>(y,x) = cv::Point2f(x + f.x, y + f.y);
-    }
-  }
+    this->ComputeFlowMap(flow, map);
 
-  return map;
+    // Apply the flow to the matrices, writing into the output slices
+    cv::remap(paMat, paRes, map, cv::noArray(), cv::INTER_LINEAR);
+    cv::remap(usMat, usRes, map, cv::noArray(), cv::INTER_LINEAR);
+  }, this->GetNumberOfThreads());
 }
 
-cv::Mat mitk::PhotoacousticMotionCorrectionFilter::FitMatrixToChar(cv::Mat mat) {
-
-  if (m_MaxValue == m_MinValue) {
-
-    return mat.clone();
-  }
-
-  return MAX_MATRIX*(mat.clone() - m_MinValue) / (m_MaxValue - m_MinValue);
+void mitk::PhotoacousticMotionCorrectionFilter::ComputeFlowMap(const cv::Mat &flow, cv::Mat &map) const {
+  cv::add(m_Grid, flow, map);
 }
 
-cv::Mat mitk::PhotoacousticMotionCorrectionFilter::GetMatrix(
-    const mitk::Image::Pointer input, unsigned int i) {
+void mitk::PhotoacousticMotionCorrectionFilter::FitMatrixToChar(const cv::Mat &mat, cv::Mat &result) const {
 
-  // Access slice i of image input
-  mitk::ImageReadAccessor accessor(input, input->GetSliceData(i));
-  mitk::Image::Pointer slice = mitk::Image::New();
-  slice->Initialize(input->GetPixelType(), IMAGE_DIMENSION - 1, input->GetDimensions());
-  slice->SetVolume(accessor.GetData());
+  if (m_MaxValue == m_MinValue) {
+    mat.copyTo(result);
+    return;
+  }
 
-  // Transform the slice to matrix
-  m_ImageToOpenCVFilter->SetImage(slice);
-  return m_ImageToOpenCVFilter->GetOpenCVMat();
+  const double scale = MAX_MATRIX / (m_MaxValue - m_MinValue);
+  mat.convertTo(result, mat.type(), scale, -m_MinValue * scale);
 }
 
-void mitk::PhotoacousticMotionCorrectionFilter::InsertMatrixAsSlice(
-    cv::Mat mat, mitk::Image::Pointer output, unsigned int i) {
+cv::Mat mitk::PhotoacousticMotionCorrectionFilter::GetSliceMatrix(
+    const void *volume, unsigned int i) const {
 
-  m_OpenCVToImageFilter->SetOpenCVMat(mat);
-  m_OpenCVToImageFilter->Update();
-  mitk::Image::Pointer slice = m_OpenCVToImageFilter->GetOutput();
+  const size_t sliceBytes = m_SliceSize.area() * CV_ELEM_SIZE(m_SliceType);
+  auto data = static_cast<unsigned char *>(const_cast<void *>(volume)) + i * sliceBytes;
 
-  mitk::ImageReadAccessor accessor(slice);
-  output->SetSlice(accessor.GetData(), i);
+  return cv::Mat(m_SliceSize, m_SliceType, data);
 }
 
 // TODO: remove debug messages
@@ -227,7 +284,6 @@ void mitk::PhotoacousticMotionCorrectionFilter::GenerateData() {
   this->m_MaxValue = usInput->GetStatistics()->GetScalarValueMax();
   this->m_MinValue = usInput->GetStatistics()->GetScalarValueMin();
 
-  // m_ImageToOpenCVFilter->SetImage(paInput);
   this->PerformCorrection(paInput, usInput, paOutput, usOutput);
 
   MITK_INFO << "Motion compensation accomplished.";
@@ -32,6 +32,7 @@ class mitkPhotoacousticMotionCorrectionFilterTestSuite : public mitk::TestFixtur
   MITK_TEST(testNullPtr3);
   MITK_TEST(testSameInputDimensions);
   MITK_TEST(testStaticSliceCorrection);
+  MITK_TEST(testStaticSequenceCorrectionInBatches);
   CPPUNIT_TEST_SUITE_END();
 
 
@@ -174,6 +175,21 @@ public:
     MITK_ASSERT_EQUAL(image, out1, "Check that static image does not get changed.");
   }
 
+  void testStaticSequenceCorrectionInBatches() {
+    mitk::Image::Pointer sequence = mitk::Image::New();
+    unsigned int dimensions[3] = {2, 2, 5};
+    sequence->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+    for (unsigned int i = 0; i < dimensions[2]; ++i)
+      sequence->SetSlice(data2d, i);
+
+    filter->SetBatchSize(2);
+    filter->SetInput(0, sequence);
+    filter->SetInput(1, sequence);
+    filter->Update();
+    MITK_ASSERT_EQUAL(sequence, filter->GetOutput(0), "Check that static PA sequence does not get changed.");
+    MITK_ASSERT_EQUAL(sequence, filter->GetOutput(1), "Check that static US sequence does not get changed.");
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkPhotoacousticMotionCorrectionFilter)
@@ -13,6 +13,8 @@ found in the LICENSE file.
 #include "mitkDiffSliceOperation.h"
 
 #include <mitkImage.h>
+#include <mitkImageMemory.h>
+#include <mitkUndoController.h>
 
 #include <itkCommand.h>
 
@@ -48,6 +50,8 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
 
   m_TimeStep = timestep;
 
+  // the compressed slice belongs to the undo history
+  ImageMemory::CategoryScope memoryCategory(UndoController::ImageMemoryCategory);
   m_zlibSliceContainer = CompressedImageContainer::New();
   m_zlibSliceContainer->SetImage(slice);
 
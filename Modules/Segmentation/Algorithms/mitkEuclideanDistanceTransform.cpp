@@ -0,0 +1,116 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkEuclideanDistanceTransform.h"
+#include "mitkParallelFor.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+const float mitk::EuclideanDistanceTransform::Infinity = 1e20f;
+
+namespace
+{
+  // Transforms one line of n pixels, accessed with the given stride. d, v and z are scratch buffers
+  // of size n, n and n + 1.
+  void SquaredDistanceTransform1D(float *f,
+                                  unsigned int n,
+                                  std::size_t stride,
+                                  float squaredSpacing,
+                                  std::vector<float> &d,
+                                  std::vector<int> &v,
+                                  std::vector<float> &z)
+  {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<float>::max();
+    z[1] = std::numeric_limits<float>::max();
+
+    for (unsigned int q = 1; q < n; ++q)
+    {
+      const float fq = f[q * stride] + squaredSpacing * q * q;
+      float s = (fq - (f[v[k] * stride] + squaredSpacing * v[k] * v[k])) /
+                (2.0f * squaredSpacing * (static_cast<int>(q) - v[k]));
+
+      while (s <= z[k])
+      {
+        --k;
+        s = (fq - (f[v[k] * stride] + squaredSpacing * v[k] * v[k])) /
+            (2.0f * squaredSpacing * (static_cast<int>(q) - v[k]));
+      }
+
+      ++k;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = std::numeric_limits<float>::max();
+    }
+
+    k = 0;
+    for (unsigned int q = 0; q < n; ++q)
+    {
+      while (z[k + 1] < q)
+        ++k;
+
+      const auto delta = static_cast<float>(static_cast<int>(q) - v[k]);
+      d[q] = std::min(squaredSpacing * delta * delta + f[v[k] * stride], mitk::EuclideanDistanceTransform::Infinity);
+    }
+
+    for (unsigned int q = 0; q < n; ++q)
+      f[q * stride] = d[q];
+  }
+}
+
+void mitk::EuclideanDistanceTransform::ComputeSquared(float *values,
+                                                      unsigned int dimension,
+                                                      const unsigned int *size,
+                                                      const double *spacing)
+{
+  std::size_t numberOfPixels = 1;
+  for (unsigned int axis = 0; axis < dimension; ++axis)
+    numberOfPixels *= size[axis];
+
+  if (numberOfPixels == 0)
+    return;
+
+  const unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads();
+  std::size_t stride = 1;
+
+  for (unsigned int axis = 0; axis < dimension; stride *= size[axis], ++axis)
+  {
+    if (spacing[axis] <= 0.0 || size[axis] < 2)
+      continue;
+
+    const unsigned int n = size[axis];
+    const std::size_t numberOfLines = numberOfPixels / n;
+    const auto squaredSpacing = static_cast<float>(spacing[axis] * spacing[axis]);
+
+    // lines are handed out in chunks to keep the synchronization overhead low
+    const std::size_t chunkSize = std::max<std::size_t>(1, numberOfLines / (8 * numberOfThreads));
+    const std::size_t numberOfChunks = (numberOfLines + chunkSize - 1) / chunkSize;
+
+    mitk::ParallelFor(numberOfChunks, [&](std::size_t chunk) {
+      std::vector<float> d(n);
+      std::vector<int> v(n);
+      std::vector<float> z(n + 1);
+
+      const std::size_t end = std::min((chunk + 1) * chunkSize, numberOfLines);
+      for (std::size_t line = chunk * chunkSize; line < end; ++line)
+      {
+        // a line is identified by its position in the axes above (outer) and below (inner) the current axis
+        const std::size_t outer = line / stride;
+        const std::size_t inner = line % stride;
+        SquaredDistanceTransform1D(values + outer * stride * n + inner, n, stride, squaredSpacing, d, v, z);
+      }
+    });
+  }
+}
@@ -0,0 +1,56 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkEuclideanDistanceTransform_h
+#define mitkEuclideanDistanceTransform_h
+
+#include <MitkSegmentationExports.h>
+
+#include <cstddef>
+
+namespace mitk
+{
+  /** \brief Exact, separable Euclidean distance transform of N-dimensional images.
+   *
+   * Implements the lower envelope of parabolas algorithm described in
+   *
+   * P. F. Felzenszwalb, D. P. Huttenlocher: "Distance Transforms of Sampled Functions",
+   * Theory of Computing 8, pp. 415-428, 2012
+   *
+   * The transform runs one 1D pass per axis, so its cost is linear in the number of pixels
+   * and independent of the distances involved. The 1D passes are distributed over all
+   * available cores.
+   */
+  class MITKSEGMENTATION_EXPORT EuclideanDistanceTransform
+  {
+  public:
+    /** \brief Value of the pixels that are no feature pixels (large, but finite). */
+    static const float Infinity;
+
+    /** \brief In-place squared Euclidean distance transform.
+     *
+     * \param values Buffer of size[0] * ... * size[dimension - 1] pixels (first axis running fastest).
+     *   On input feature pixels have to be 0 and all other pixels Infinity. On output every pixel holds its
+     *   squared distance to the nearest feature pixel (or Infinity if there is none).
+     * \param dimension Number of axes.
+     * \param size Number of pixels along each axis.
+     * \param spacing Pixel spacing along each axis. Axes with a spacing of 0 are not transformed, i.e.
+     *   distances are only measured within the subspace spanned by the other axes.
+     */
+    static void ComputeSquared(float *values, unsigned int dimension, const unsigned int *size, const double *spacing);
+
+  private:
+    EuclideanDistanceTransform();
+  };
+}
+
+#endif
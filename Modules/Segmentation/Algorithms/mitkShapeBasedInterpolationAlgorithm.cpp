@@ -11,14 +11,15 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkShapeBasedInterpolationAlgorithm.h"
+#include "mitkEuclideanDistanceTransform.h"
 #include "mitkImageAccessByItk.h"
-#include "mitkImageCast.h"
-#include <mitkITKImageImport.h>
+#include <mitkExceptionMacro.h>
 
-#include <itkFastChamferDistanceImageFilter.h>
-#include <itkInvertIntensityImageFilter.h>
-#include <itkIsoContourDistanceImageFilter.h>
-#include <itkSubtractImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <cmath>
+#include <vector>
 
 mitk::Image::Pointer mitk::ShapeBasedInterpolationAlgorithm::Interpolate(
   Image::ConstPointer lowerSlice,
@@ -26,92 +27,121 @@ mitk::Image::Pointer mitk::ShapeBasedInterpolationAlgorithm::Interpolate(
   Image::ConstPointer upperSlice,
   unsigned int upperSliceIndex,
   unsigned int requestedIndex,
-  unsigned int /*sliceDimension*/, // commented variables are not used
+  unsigned int sliceDimension,
   Image::Pointer resultImage,
-  unsigned int /*timeStep*/,
+  unsigned int timeStep,
   Image::ConstPointer /*referenceImage*/)
 {
-  mitk::Image::Pointer lowerDistanceImage = mitk::Image::New();
-  AccessFixedDimensionByItk_1(lowerSlice, ComputeDistanceMap, 2, lowerDistanceImage);
-
-  mitk::Image::Pointer upperDistanceImage = mitk::Image::New();
-  AccessFixedDimensionByItk_1(upperSlice, ComputeDistanceMap, 2, upperDistanceImage);
+  DistanceFilterImageType::Pointer lowerDistanceImage =
+    this->GetDistanceMap(lowerSlice, timeStep, sliceDimension, lowerSliceIndex);
+  DistanceFilterImageType::Pointer upperDistanceImage =
+    this->GetDistanceMap(upperSlice, timeStep, sliceDimension, upperSliceIndex);
 
   // calculate where the current slice is in comparison to the lower and upper neighboring slices
   float ratio = (float)(requestedIndex - lowerSliceIndex) / (float)(upperSliceIndex - lowerSliceIndex);
-  AccessFixedDimensionByItk_3(
-    resultImage, InterpolateIntermediateSlice, 2, upperDistanceImage, lowerDistanceImage, ratio);
+  AccessFixedDimensionByItk_3(resultImage,
+                              InterpolateIntermediateSlice,
+                              2,
+                              lowerDistanceImage.GetPointer(),
+                              upperDistanceImage.GetPointer(),
+                              ratio);
 
   return resultImage;
 }
 
+bool mitk::ShapeBasedInterpolationAlgorithm::IsDistanceMapCached(unsigned int timeStep,
+                                                                 unsigned int sliceDimension,
+                                                                 unsigned int sliceIndex) const
+{
+  return m_DistanceMapCache.find(std::make_tuple(timeStep, sliceDimension, sliceIndex)) != m_DistanceMapCache.end();
+}
+
+void mitk::ShapeBasedInterpolationAlgorithm::ClearDistanceMapCache()
+{
+  m_DistanceMapCache.clear();
+}
+
+mitk::ShapeBasedInterpolationAlgorithm::DistanceFilterImageType::Pointer
+  mitk::ShapeBasedInterpolationAlgorithm::GetDistanceMap(const Image *slice,
+                                                         unsigned int timeStep,
+                                                         unsigned int sliceDimension,
+                                                         unsigned int sliceIndex)
+{
+  const auto key = std::make_tuple(timeStep, sliceDimension, sliceIndex);
+  auto iter = m_DistanceMapCache.find(key);
+
+  if (iter != m_DistanceMapCache.end())
+    return iter->second;
+
+  if (slice == nullptr)
+    mitkThrow() << "No slice passed and no cached distance map available for slice " << sliceIndex << " (dimension "
+                << sliceDimension << ", time step " << timeStep << ").";
+
+  DistanceFilterImageType::Pointer distanceImage;
+  AccessFixedDimensionByItk_1(slice, ComputeDistanceMap, 2, distanceImage);
+
+  m_DistanceMapCache[key] = distanceImage;
+  return distanceImage;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::ShapeBasedInterpolationAlgorithm::ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *binaryImage,
-                                                                mitk::Image::Pointer &result)
+                                                                DistanceFilterImageType::Pointer &result)
 {
-  typedef itk::Image<TPixel, VImageDimension> DistanceFilterInputImageType;
-
-  typedef itk::FastChamferDistanceImageFilter<DistanceFilterImageType, DistanceFilterImageType> DistanceFilterType;
-  typedef itk::IsoContourDistanceImageFilter<DistanceFilterInputImageType, DistanceFilterImageType> IsoContourType;
-  typedef itk::InvertIntensityImageFilter<DistanceFilterInputImageType> InvertIntensityImageFilterType;
-  typedef itk::SubtractImageFilter<DistanceFilterImageType, DistanceFilterImageType> SubtractImageFilterType;
+  typedef itk::Image<TPixel, VImageDimension> BinaryImageType;
 
-  typename DistanceFilterType::Pointer distanceFilter = DistanceFilterType::New();
-  typename DistanceFilterType::Pointer distanceFilterInverted = DistanceFilterType::New();
-  typename IsoContourType::Pointer isoContourFilter = IsoContourType::New();
-  typename IsoContourType::Pointer isoContourFilterInverted = IsoContourType::New();
-  typename InvertIntensityImageFilterType::Pointer invertFilter = InvertIntensityImageFilterType::New();
-  typename SubtractImageFilterType::Pointer subtractImageFilter = SubtractImageFilterType::New();
+  const typename BinaryImageType::RegionType region = binaryImage->GetLargestPossibleRegion();
+  const unsigned int nx = region.GetSize(0);
+  const unsigned int ny = region.GetSize(1);
+  const double spacing[2] = {binaryImage->GetSpacing()[0], binaryImage->GetSpacing()[1]};
 
-  // arbitrary maximum distance
-  int maximumDistance = 100;
+  const std::size_t numberOfPixels = static_cast<std::size_t>(nx) * ny;
+  std::vector<bool> inside(numberOfPixels);
 
-  // this assumes the image contains only 1 and 0
-  invertFilter->SetInput(binaryImage);
-  invertFilter->SetMaximum(1);
+  itk::ImageRegionConstIterator<BinaryImageType> inputIter(binaryImage, region);
+  for (std::size_t i = 0; !inputIter.IsAtEnd(); ++inputIter, ++i)
+    inside[i] = inputIter.Get() != 0;
 
-  // do the processing on the image and the inverted image to get inside and outside distance
-  isoContourFilter->SetInput(binaryImage);
-  isoContourFilter->SetFarValue(maximumDistance + 1);
-  isoContourFilter->SetLevelSetValue(0);
+  // squared distances to the nearest inside pixel (for outside pixels) and to the nearest outside pixel
+  // (for inside pixels)
+  std::vector<float> outsideDistance(numberOfPixels);
+  std::vector<float> insideDistance(numberOfPixels);
 
-  isoContourFilterInverted->SetInput(invertFilter->GetOutput());
-  isoContourFilterInverted->SetFarValue(maximumDistance + 1);
-  isoContourFilterInverted->SetLevelSetValue(0);
+  for (std::size_t i = 0; i < numberOfPixels; ++i)
+  {
+    outsideDistance[i] = inside[i] ? 0.0f : EuclideanDistanceTransform::Infinity;
+    insideDistance[i] = inside[i] ? EuclideanDistanceTransform::Infinity : 0.0f;
+  }
 
-  distanceFilter->SetInput(isoContourFilter->GetOutput());
-  distanceFilter->SetMaximumDistance(maximumDistance);
+  const unsigned int size[2] = {nx, ny};
+  EuclideanDistanceTransform::ComputeSquared(outsideDistance.data(), 2, size, spacing);
+  EuclideanDistanceTransform::ComputeSquared(insideDistance.data(), 2, size, spacing);
 
-  distanceFilterInverted->SetInput(isoContourFilterInverted->GetOutput());
-  distanceFilterInverted->SetMaximumDistance(maximumDistance);
+  result = DistanceFilterImageType::New();
+  result->SetRegions(region);
+  result->SetOrigin(binaryImage->GetOrigin());
+  result->SetSpacing(binaryImage->GetSpacing());
+  result->SetDirection(binaryImage->GetDirection());
+  result->Allocate();
 
   // inside distance should be negative, outside distance positive
-  subtractImageFilter->SetInput2(distanceFilter->GetOutput());
-  subtractImageFilter->SetInput1(distanceFilterInverted->GetOutput());
-  subtractImageFilter->Update();
-
-  result = mitk::GrabItkImageMemory(subtractImageFilter->GetOutput());
+  itk::ImageRegionIterator<DistanceFilterImageType> resultIter(result, region);
+  for (std::size_t i = 0; !resultIter.IsAtEnd(); ++resultIter, ++i)
+  {
+    resultIter.Set(inside[i] ? -std::sqrt(insideDistance[i]) : std::sqrt(outsideDistance[i]));
+  }
 }
 
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::ShapeBasedInterpolationAlgorithm::InterpolateIntermediateSlice(itk::Image<TPixel, VImageDimension> *result,
-                                                                          const mitk::Image::Pointer &lower,
-                                                                          const mitk::Image::Pointer &upper,
+                                                                          const DistanceFilterImageType *lower,
+                                                                          const DistanceFilterImageType *upper,
                                                                           float ratio)
 {
-  typename DistanceFilterImageType::Pointer lowerITK = DistanceFilterImageType::New();
-  typename DistanceFilterImageType::Pointer upperITK = DistanceFilterImageType::New();
+  const typename DistanceFilterImageType::RegionType &region = lower->GetLargestPossibleRegion();
 
-  CastToItkImage(lower, lowerITK);
-  CastToItkImage(upper, upperITK);
-
-  itk::ImageRegionConstIteratorWithIndex<DistanceFilterImageType> lowerIter(lowerITK,
-                                                                            lowerITK->GetLargestPossibleRegion());
-
-  lowerIter.GoToBegin();
-
-  if (!lowerITK->GetLargestPossibleRegion().IsInside(upperITK->GetLargestPossibleRegion()) ||
-      !lowerITK->GetLargestPossibleRegion().IsInside(result->GetLargestPossibleRegion()))
+  if (region.GetSize() != upper->GetLargestPossibleRegion().GetSize() ||
+      region.GetSize() != result->GetLargestPossibleRegion().GetSize())
   {
     // TODO Exception etc.
     MITK_ERROR << "The regions of the slices for the 2D interpolation are not equally sized!";
@@ -120,16 +150,17 @@ void mitk::ShapeBasedInterpolationAlgorithm::InterpolateIntermediateSlice(itk::I
 
   float weight[2] = {1.0f - ratio, ratio};
 
+  itk::ImageRegionConstIterator<DistanceFilterImageType> lowerIter(lower, region);
+  itk::ImageRegionConstIterator<DistanceFilterImageType> upperIter(upper, upper->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<itk::Image<TPixel, VImageDimension>> resultIter(result, result->GetLargestPossibleRegion());
+
   while (!lowerIter.IsAtEnd())
   {
-    typename DistanceFilterImageType::PixelType lowerPixelVal = lowerIter.Get();
-    typename DistanceFilterImageType::PixelType upperPixelVal = upperITK->GetPixel(lowerIter.GetIndex());
-
-    typename DistanceFilterImageType::PixelType intermediatePixelVal =
-      (weight[0] * upperPixelVal + weight[1] * lowerPixelVal > 0 ? 0 : 1);
-
-    result->SetPixel(lowerIter.GetIndex(), static_cast<TPixel>(intermediatePixelVal));
+    const float intermediatePixelVal = weight[0] * lowerIter.Get() + weight[1] * upperIter.Get();
+    resultIter.Set(static_cast<TPixel>(intermediatePixelVal > 0 ? 0 : 1));
 
     ++lowerIter;
+    ++upperIter;
+    ++resultIter;
   }
 }
@@ -16,6 +16,11 @@ found in the LICENSE file.
 #include "mitkSegmentationInterpolationAlgorithm.h"
 #include <MitkSegmentationExports.h>
 
+#include <itkImage.h>
+
+#include <map>
+#include <tuple>
+
 namespace mitk
 {
   /**
@@ -27,6 +32,16 @@ namespace mitk
    * G.T. Herman, J. Zheng, C.A. Bucholtz: "Shape-based interpolation"
    * IEEE Computer Graphics & Applications, pp. 69-79,May 1992
    *
+   * The signed distance maps of the bounding slices are computed by an exact,
+   * separable 2D Euclidean distance transform and cached per time step, slice
+   * dimension and slice index. Interpolating all slices of a gap between two
+   * annotated slices thus computes each distance map only once. The owner of
+   * an instance is responsible for calling ClearDistanceMapCache() whenever the
+   * segmentation (or the orientation of the interpolated slices) changes.
+   *
+   * If the distance map of a bounding slice is already cached (see IsDistanceMapCached()),
+   * the corresponding slice image passed to Interpolate() may be nullptr.
+   *
    *  Last contributor:
    *  $Author:$
    */
@@ -47,17 +62,32 @@ namespace mitk
                                  unsigned int timeStep,
                                  Image::ConstPointer referenceImage) override;
 
+    /** \brief Checks whether the distance map of the specified slice is cached. */
+    bool IsDistanceMapCached(unsigned int timeStep, unsigned int sliceDimension, unsigned int sliceIndex) const;
+
+    /** \brief Removes all cached distance maps. */
+    void ClearDistanceMapCache();
+
   private:
-    typedef itk::Image<mitk::ScalarType, 2> DistanceFilterImageType;
+    typedef itk::Image<float, 2> DistanceFilterImageType;
+    typedef std::tuple<unsigned int, unsigned int, unsigned int> DistanceMapKeyType;
+    typedef std::map<DistanceMapKeyType, DistanceFilterImageType::Pointer> DistanceMapCacheType;
+
+    DistanceFilterImageType::Pointer GetDistanceMap(const Image *slice,
+                                                    unsigned int timeStep,
+                                                    unsigned int sliceDimension,
+                                                    unsigned int sliceIndex);
 
     template <typename TPixel, unsigned int VImageDimension>
-    void ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *, mitk::Image::Pointer &result);
+    void ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *, DistanceFilterImageType::Pointer &result);
 
     template <typename TPixel, unsigned int VImageDimension>
     void InterpolateIntermediateSlice(itk::Image<TPixel, VImageDimension> *result,
-                                      const mitk::Image::Pointer &lowerDistanceImage,
-                                      const mitk::Image::Pointer &upperDistanceImage,
+                                      const DistanceFilterImageType *lowerDistanceImage,
+                                      const DistanceFilterImageType *upperDistanceImage,
                                       float ratio);
+
+    DistanceMapCacheType m_DistanceMapCache;
   };
 
 } // namespace
@@ -11,19 +11,23 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkSurfaceStampImageFilter.h"
-#include "mitkImageAccessByItk.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkImageWriteAccessor.h"
 #include "mitkTimeHelper.h"
-#include <mitkImageCast.h>
+#include <mitkExceptionMacro.h>
+#include <mitkParallelFor.h>
+#include <mitkPixelTypeMultiplex.h>
 
-#include <vtkCell.h>
+#include <vtkImageStencilData.h>
 #include <vtkLinearTransform.h>
 #include <vtkPolyData.h>
+#include <vtkPolyDataToImageStencil.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 
-#include <itkTriangleMeshToBinaryImageFilter.h>
+#include <algorithm>
+#include <cmath>
 
 mitk::SurfaceStampImageFilter::SurfaceStampImageFilter()
   : m_MakeOutputBinary(false), m_OverwriteBackground(false), m_BackgroundValue(0.0), m_ForegroundValue(1.0)
@@ -123,7 +127,7 @@ void mitk::SurfaceStampImageFilter::SurfaceStamp(int time)
 
   transform->PostMultiply();
   transform->Concatenate(geometry->GetVtkTransform()->GetMatrix());
-  // take image geometry into account. vtk-Image information will be changed to unit spacing and zero origin below.
+  // take image geometry into account, the surface is voxelized in index coordinates (unit spacing, zero origin)
   BaseGeometry::Pointer imageGeometry = imageTimeGeometry->GetGeometryForTimeStep(time);
 
   transform->Concatenate(imageGeometry->GetVtkTransform()->GetLinearInverse());
@@ -135,156 +139,95 @@ void mitk::SurfaceStampImageFilter::SurfaceStamp(int time)
   if (!polydata || !polydata->GetNumberOfPoints())
     mitkThrow() << "Polydata retrieved from transformation is null or has no points.";
 
-  MeshType::Pointer mesh = MeshType::New();
-  mesh->SetCellsAllocationMethod(MeshType::CellsAllocatedDynamicallyCellByCell);
-  unsigned int numberOfPoints = polydata->GetNumberOfPoints();
-  mesh->GetPoints()->Reserve(numberOfPoints);
-
-  vtkPoints *points = polydata->GetPoints();
-
-  MeshType::PointType point;
-  for (unsigned int i = 0; i < numberOfPoints; i++)
-  {
-    double *aux = points->GetPoint(i);
-    point[0] = aux[0];
-    point[1] = aux[1];
-    point[2] = aux[2];
-    mesh->SetPoint(i, point);
-  }
-
-  // Load the polygons into the itk::Mesh
-  typedef MeshType::CellAutoPointer CellAutoPointerType;
-  typedef MeshType::CellType CellType;
-  typedef itk::TriangleCell<CellType> TriangleCellType;
-  typedef MeshType::PointIdentifier PointIdentifierType;
-  typedef MeshType::CellIdentifier CellIdentifierType;
-
-  // Read the number of polygons
-  CellIdentifierType numberOfPolygons = 0;
-  numberOfPolygons = polydata->GetNumberOfPolys();
+  mitk::Image::Pointer outputImage = this->GetOutput();
 
-  PointIdentifierType numberOfCellPoints = 3;
-  CellIdentifierType i = 0;
+  // only the bounding box of the surface in index space has to be voxelized
+  double bounds[6];
+  polydata->GetBounds(bounds);
 
-  for (i = 0; i < numberOfPolygons; i++)
+  int extent[6];
+  bool empty = false;
+  for (int i = 0; i < 3; ++i)
   {
-    vtkIdList *cellIds;
-    vtkCell *vcell = polydata->GetCell(i);
-    cellIds = vcell->GetPointIds();
-
-    CellAutoPointerType cell;
-    auto *triangleCell = new TriangleCellType;
-    PointIdentifierType k;
-    for (k = 0; k < numberOfCellPoints; k++)
-    {
-      triangleCell->SetPointId(k, cellIds->GetId(k));
-    }
-
-    cell.TakeOwnership(triangleCell);
-    mesh->SetCell(i, cell);
+    extent[2 * i] = std::max(0, static_cast<int>(std::floor(bounds[2 * i])));
+    extent[2 * i + 1] =
+      std::min(static_cast<int>(outputImage->GetDimension(i)) - 1, static_cast<int>(std::ceil(bounds[2 * i + 1])));
+    empty = empty || extent[2 * i] > extent[2 * i + 1];
   }
 
-  if (!mesh->GetNumberOfPoints())
-    mitkThrow() << "Generated itk mesh is empty.";
+  vtkSmartPointer<vtkPolyDataToImageStencil> surfaceConverter;
+  vtkImageStencilData *stencil = nullptr;
 
-  if (m_MakeOutputBinary)
-  {
-    this->SurfaceStampBinaryOutputProcessing(mesh);
-  }
-  else
+  if (!empty)
   {
-    AccessFixedDimensionByItk_1(inputImage, SurfaceStampProcessing, 3, mesh);
+    surfaceConverter = vtkSmartPointer<vtkPolyDataToImageStencil>::New();
+    surfaceConverter->SetOutputOrigin(0.0, 0.0, 0.0);
+    surfaceConverter->SetOutputSpacing(1.0, 1.0, 1.0);
+    surfaceConverter->SetOutputWholeExtent(extent);
+    surfaceConverter->SetInputData(polydata);
+    surfaceConverter->Update();
+
+    stencil = surfaceConverter->GetOutput();
   }
-}
-
-void mitk::SurfaceStampImageFilter::SurfaceStampBinaryOutputProcessing(MeshType *mesh)
-{
-  auto *inputImage = this->GetInput();
-
-  mitk::Image::Pointer outputImage = this->GetOutput();
-
-  typedef itk::Image<unsigned char, 3> BinaryImageType;
-  BinaryImageType::Pointer itkInputImage;
-  mitk::CastToItkImage(inputImage, itkInputImage);
-
-  typedef itk::TriangleMeshToBinaryImageFilter<MeshType, BinaryImageType> FilterType;
 
-  FilterType::Pointer filter = FilterType::New();
-  filter->SetInput(mesh);
-  filter->SetInfoImage(itkInputImage);
-  filter->SetInsideValue(1);
-  filter->SetOutsideValue(0);
-  filter->Update();
-
-  BinaryImageType::Pointer resultImage = filter->GetOutput();
-  resultImage->DisconnectPipeline();
-
-  mitk::CastToMitkImage(resultImage, outputImage);
+  mitkPixelTypeMultiplex3(SurfaceStampProcessing, outputImage->GetPixelType(), time, stencil, extent);
 }
 
 template <typename TPixel>
-void mitk::SurfaceStampImageFilter::SurfaceStampProcessing(itk::Image<TPixel, 3> *input, MeshType *mesh)
+void mitk::SurfaceStampImageFilter::SurfaceStampProcessing(const mitk::PixelType &,
+                                                           int time,
+                                                           vtkImageStencilData *stencil,
+                                                           const int *extent)
 {
-  typedef itk::Image<TPixel, 3> ImageType;
-  typedef itk::Image<unsigned char, 3> BinaryImageType;
-
-  typedef itk::TriangleMeshToBinaryImageFilter<mitk::SurfaceStampImageFilter::MeshType, BinaryImageType> FilterType;
-
-  BinaryImageType::Pointer binaryInput = BinaryImageType::New();
-  binaryInput->SetSpacing(input->GetSpacing());
-  binaryInput->SetOrigin(input->GetOrigin());
-  binaryInput->SetDirection(input->GetDirection());
-  binaryInput->SetRegions(input->GetLargestPossibleRegion());
-  binaryInput->Allocate();
-  binaryInput->FillBuffer(0);
-
-  FilterType::Pointer filter = FilterType::New();
-  filter->SetInput(mesh);
-  filter->SetInfoImage(binaryInput);
-  filter->SetInsideValue(1);
-  filter->SetOutsideValue(0);
-  filter->Update();
-
-  BinaryImageType::Pointer resultImage = filter->GetOutput();
-  resultImage->DisconnectPipeline();
-
   mitk::Image::Pointer outputImage = this->GetOutput();
-  typename ImageType::Pointer itkOutputImage;
-  mitk::CastToItkImage(outputImage, itkOutputImage);
-
-  typedef itk::ImageRegionConstIterator<BinaryImageType> BinaryIteratorType;
-  typedef itk::ImageRegionConstIterator<ImageType> InputIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> OutputIteratorType;
-
-  BinaryIteratorType sourceIter(resultImage, resultImage->GetLargestPossibleRegion());
-  sourceIter.GoToBegin();
 
-  InputIteratorType inputIter(input, input->GetLargestPossibleRegion());
-  inputIter.GoToBegin();
+  const int dimensions[2] = {static_cast<int>(outputImage->GetDimension(0)),
+                             static_cast<int>(outputImage->GetDimension(1))};
+  const std::size_t numberOfPixels =
+    static_cast<std::size_t>(dimensions[0]) * dimensions[1] * outputImage->GetDimension(2);
 
-  OutputIteratorType outputIter(itkOutputImage, itkOutputImage->GetLargestPossibleRegion());
-  outputIter.GoToBegin();
+  mitk::ImageWriteAccessor outputAccessor(outputImage, outputImage->GetVolumeData(time));
+  auto *output = static_cast<TPixel *>(outputAccessor.GetData());
 
-  typename ImageType::PixelType inputValue;
-  unsigned char sourceValue;
+  TPixel foreground;
 
-  auto fgValue = static_cast<typename ImageType::PixelType>(m_ForegroundValue);
-  auto bgValue = static_cast<typename ImageType::PixelType>(m_BackgroundValue);
-
-  while (!sourceIter.IsAtEnd())
+  // everything outside of the surface is background or keeps the value of the input image
+  if (m_MakeOutputBinary)
   {
-    sourceValue = static_cast<unsigned char>(sourceIter.Get());
-    inputValue = static_cast<typename ImageType::PixelType>(inputIter.Get());
-
-    if (sourceValue != 0)
-      outputIter.Set(fgValue);
-    else if (m_OverwriteBackground)
-      outputIter.Set(bgValue);
+    std::fill_n(output, numberOfPixels, static_cast<TPixel>(0));
+    foreground = static_cast<TPixel>(1);
+  }
+  else
+  {
+    if (m_OverwriteBackground)
+    {
+      std::fill_n(output, numberOfPixels, static_cast<TPixel>(m_BackgroundValue));
+    }
     else
-      outputIter.Set(inputValue);
-
-    ++sourceIter;
-    ++inputIter;
-    ++outputIter;
+    {
+      mitk::Image::ConstPointer inputImage = this->GetInput();
+      mitk::ImageReadAccessor inputAccessor(inputImage, inputImage->GetVolumeData(time));
+      const auto *input = static_cast<const TPixel *>(inputAccessor.GetData());
+      std::copy(input, input + numberOfPixels, output);
+    }
+    foreground = static_cast<TPixel>(m_ForegroundValue);
   }
+
+  if (stencil == nullptr)
+    return;
+
+  // scanline spans of the stencil are written in parallel over the slices of the bounding box
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  mitk::ParallelFor(numberOfSlices, [&](std::size_t slice) {
+    const int z = extent[4] + static_cast<int>(slice);
+    for (int y = extent[2]; y <= extent[3]; ++y)
+    {
+      TPixel *row = output + (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0];
+      int iter = 0;
+      int r1, r2;
+
+      while (stencil->GetNextExtent(r1, r2, extent[0], extent[1], y, z, iter))
+        std::fill(row + r1, row + r2 + 1, foreground);
+    }
+  });
 }
@@ -18,8 +18,7 @@ found in the LICENSE file.
 #include "mitkImageToImageFilter.h"
 #include "mitkSurface.h"
 
-#include <itkQuadEdgeMesh.h>
-
+class vtkImageStencilData;
 class vtkPolyData;
 
 namespace mitk
@@ -30,17 +29,16 @@ namespace mitk
    * image, which header information defines the output image.
    *
    * The resulting image has the same dimension, size, and Geometry3D
-   * as the input image. The image is cut using a vtkStencil.
+   * as the input image. The surface is voxelized by a scanline stencil
+   * (vtkPolyDataToImageStencil) that is restricted to the bounding box of the
+   * surface in index space; the inside spans are written in parallel over
+   * the slices of that bounding box.
    * The user can decide if he wants to keep the original values or create a
    * binary image by setting MakeBinaryOutputOn (default is \a false). If
    * set to \a true all voxels inside the surface are set to one and all
-   * outside voxel are set to zero.
-   *
-   * NOTE: Since the reference input image is passed to the vtkStencil in
-   * any case, the image needs to be initialized with pixel values greater than
-   * the numerical minimum of the used pixel type (e.g. at least -127 for
-   * unsigned char images, etc.) to produce a correct binary image
-   * representation of the surface in MakeOutputBinary mode.
+   * outside voxel are set to zero. Otherwise voxels inside the surface are set
+   * to the foreground value, all other voxels keep the value of the input image
+   * or are set to the background value (see OverwriteBackgroundOn()).
    *
    * @ingroup SurfaceFilters
    * @ingroup Process
@@ -73,8 +71,6 @@ namespace mitk
 
     void SetSurface(mitk::Surface *surface);
 
-    typedef itk::QuadEdgeMesh<double, 3> MeshType;
-
   protected:
     SurfaceStampImageFilter();
 
@@ -82,10 +78,10 @@ namespace mitk
 
     void SurfaceStamp(int time = 0);
 
+    /** \brief Initializes the output volume of the time step and fills the inside spans of the stencil
+        (nullptr if the surface does not intersect the image) within the given extent. */
     template <typename TPixel>
-    void SurfaceStampProcessing(itk::Image<TPixel, 3> *input, MeshType *mesh);
-
-    void SurfaceStampBinaryOutputProcessing(MeshType *mesh);
+    void SurfaceStampProcessing(const mitk::PixelType &, int time, vtkImageStencilData *stencil, const int *extent);
 
     bool m_MakeOutputBinary;
     bool m_OverwriteBackground;
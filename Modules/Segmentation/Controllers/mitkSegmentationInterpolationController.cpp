@@ -19,8 +19,6 @@ found in the LICENSE file.
 #include <mitkImageAccessByItk.h>
 //#include <mitkPlaneGeometry.h>
 
-#include "mitkShapeBasedInterpolationAlgorithm.h"
-
 #include <itkCommand.h>
 #include <itkImage.h>
 #include <itkImageSliceConstIteratorWithIndex.h>
@@ -43,8 +41,12 @@ mitk::SegmentationInterpolationController *mitk::SegmentationInterpolationContro
 }
 
 mitk::SegmentationInterpolationController::SegmentationInterpolationController()
-  : m_BlockModified(false), m_2DInterpolationActivated(false)
+  : m_BlockModified(false),
+    m_2DInterpolationActivated(false),
+    m_InterpolationAlgorithm(ShapeBasedInterpolationAlgorithm::New()),
+    m_DistanceMapCacheTime(0)
 {
+  m_DistanceMapCacheNormal.Fill(0.0);
 }
 
 void mitk::SegmentationInterpolationController::Activate2DInterpolation(bool status)
@@ -93,6 +95,7 @@ void mitk::SegmentationInterpolationController::SetSegmentationVolume(const Imag
 {
   // clear old information (remove all time steps
   m_SegmentationCountInSlice.clear();
+  m_InterpolationAlgorithm->ClearDistanceMapCache();
 
   // delete this from the list of interpolators
   auto iter = s_InterpolatorForImage.find(segmentation);
@@ -188,6 +191,8 @@ void mitk::SegmentationInterpolationController::SetChangedVolume(const Image *sl
   if (sliceDiff->GetDimension() != 3)
     return;
 
+  m_InterpolationAlgorithm->ClearDistanceMapCache();
+
   AccessFixedDimensionByItk_1(sliceDiff, ScanChangedVolume, 3, timeStep);
 
   // PrintStatus();
@@ -201,6 +206,8 @@ void mitk::SegmentationInterpolationController::SetChangedSlice(const Image *sli
 {
   if (!sliceDiff)
     return;
+
+  m_InterpolationAlgorithm->ClearDistanceMapCache();
   if (sliceDimension > 2)
     return;
   if (timeStep >= m_SegmentationCountInSlice.size())
@@ -492,6 +499,19 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
   // MITK_INFO << "Interpolate in timestep " << timeStep << ", dimension " << sliceDimension << ": estimate slice " <<
   // sliceIndex << " from slices " << lowerBound << " and " << upperBound << std::endl;
 
+  // distance maps of the bounding slices are reused as long as neither the segmentation
+  // nor the orientation of the interpolated slices changes
+  if (m_DistanceMapCacheTime < m_Segmentation->GetMTime() ||
+      !Equal(m_DistanceMapCacheNormal, currentPlane->GetNormal()))
+  {
+    m_InterpolationAlgorithm->ClearDistanceMapCache();
+    m_DistanceMapCacheTime = m_Segmentation->GetMTime();
+    m_DistanceMapCacheNormal = currentPlane->GetNormal();
+  }
+
+  const bool lowerSliceRequired = !m_InterpolationAlgorithm->IsDistanceMapCached(timeStep, sliceDimension, lowerBound);
+  const bool upperSliceRequired = !m_InterpolationAlgorithm->IsDistanceMapCached(timeStep, sliceDimension, upperBound);
+
   mitk::Image::Pointer lowerMITKSlice;
   mitk::Image::Pointer upperMITKSlice;
   mitk::Image::Pointer resultImage;
@@ -514,48 +534,57 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
 
     // Creating PlaneGeometry for lower slice
     mitk::PlaneGeometry::Pointer reslicePlane = currentPlane->Clone();
-
-    // Transforming the current origin so that it matches the lower slice
     mitk::Point3D origin = currentPlane->GetOrigin();
-    m_Segmentation->GetSlicedGeometry(timeStep)->WorldToIndex(origin, origin);
-    origin[sliceDimension] = lowerBound;
-    m_Segmentation->GetSlicedGeometry(timeStep)->IndexToWorld(origin, origin);
-    reslicePlane->SetOrigin(origin);
-
-    // Extract the lower slice
-    extractor = ExtractSliceFilter::New();
-    extractor->SetInput(m_Segmentation);
-    extractor->SetTimeStep(timeStep);
-    extractor->SetResliceTransformByGeometry(m_Segmentation->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
-    extractor->SetVtkOutputRequest(false);
-
-    extractor->SetWorldGeometry(reslicePlane);
-    extractor->Modified();
-    extractor->Update();
-    lowerMITKSlice = extractor->GetOutput();
-    lowerMITKSlice->DisconnectPipeline();
-
-    // Transforming the current origin so that it matches the upper slice
-    m_Segmentation->GetSlicedGeometry(timeStep)->WorldToIndex(origin, origin);
-    origin[sliceDimension] = upperBound;
-    m_Segmentation->GetSlicedGeometry(timeStep)->IndexToWorld(origin, origin);
-    reslicePlane->SetOrigin(origin);
-
-    // Extract the upper slice
-    extractor = ExtractSliceFilter::New();
-    extractor->SetInput(m_Segmentation);
-    extractor->SetTimeStep(timeStep);
-    extractor->SetResliceTransformByGeometry(m_Segmentation->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
-    extractor->SetVtkOutputRequest(false);
 
-    extractor->SetWorldGeometry(reslicePlane);
-    extractor->Modified();
-    extractor->Update();
-    upperMITKSlice = extractor->GetOutput();
-    upperMITKSlice->DisconnectPipeline();
+    if (lowerSliceRequired)
+    {
+      // Transforming the current origin so that it matches the lower slice
+      m_Segmentation->GetSlicedGeometry(timeStep)->WorldToIndex(origin, origin);
+      origin[sliceDimension] = lowerBound;
+      m_Segmentation->GetSlicedGeometry(timeStep)->IndexToWorld(origin, origin);
+      reslicePlane->SetOrigin(origin);
+
+      // Extract the lower slice
+      extractor = ExtractSliceFilter::New();
+      extractor->SetInput(m_Segmentation);
+      extractor->SetTimeStep(timeStep);
+      extractor->SetResliceTransformByGeometry(m_Segmentation->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
+      extractor->SetVtkOutputRequest(false);
+
+      extractor->SetWorldGeometry(reslicePlane);
+      extractor->Modified();
+      extractor->Update();
+      lowerMITKSlice = extractor->GetOutput();
+      lowerMITKSlice->DisconnectPipeline();
+
+      if (lowerMITKSlice.IsNull())
+        return nullptr;
+    }
 
-    if (lowerMITKSlice.IsNull() || upperMITKSlice.IsNull())
-      return nullptr;
+    if (upperSliceRequired)
+    {
+      // Transforming the current origin so that it matches the upper slice
+      m_Segmentation->GetSlicedGeometry(timeStep)->WorldToIndex(origin, origin);
+      origin[sliceDimension] = upperBound;
+      m_Segmentation->GetSlicedGeometry(timeStep)->IndexToWorld(origin, origin);
+      reslicePlane->SetOrigin(origin);
+
+      // Extract the upper slice
+      extractor = ExtractSliceFilter::New();
+      extractor->SetInput(m_Segmentation);
+      extractor->SetTimeStep(timeStep);
+      extractor->SetResliceTransformByGeometry(m_Segmentation->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
+      extractor->SetVtkOutputRequest(false);
+
+      extractor->SetWorldGeometry(reslicePlane);
+      extractor->Modified();
+      extractor->Update();
+      upperMITKSlice = extractor->GetOutput();
+      upperMITKSlice->DisconnectPipeline();
+
+      if (upperMITKSlice.IsNull())
+        return nullptr;
+    }
   }
   catch (const std::exception &e)
   {
@@ -571,16 +600,16 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
   //
   // interpolation algorithm can use e.g. itk::ImageSliceConstIteratorWithIndex to
   //   inspect the original patient image at appropriate positions
-
-  mitk::SegmentationInterpolationAlgorithm::Pointer algorithm =
-    mitk::ShapeBasedInterpolationAlgorithm::New().GetPointer();
-  return algorithm->Interpolate(lowerMITKSlice.GetPointer(),
-                                lowerBound,
-                                upperMITKSlice.GetPointer(),
-                                upperBound,
-                                sliceIndex,
-                                sliceDimension,
-                                resultImage,
-                                timeStep,
-                                m_ReferenceImage);
+  //
+  // bounding slices whose distance maps are already cached by the algorithm are not extracted again (nullptr)
+
+  return m_InterpolationAlgorithm->Interpolate(lowerMITKSlice.GetPointer(),
+                                               lowerBound,
+                                               upperMITKSlice.GetPointer(),
+                                               upperBound,
+                                               sliceIndex,
+                                               sliceDimension,
+                                               resultImage,
+                                               timeStep,
+                                               m_ReferenceImage);
 }
@@ -15,6 +15,7 @@ found in the LICENSE file.
 
 #include "mitkCommon.h"
 #include "mitkImage.h"
+#include "mitkShapeBasedInterpolationAlgorithm.h"
 #include <MitkSegmentationExports.h>
 
 #include <itkImage.h>
@@ -213,6 +214,11 @@ namespace mitk
     Image::ConstPointer m_ReferenceImage;
     bool m_BlockModified;
     bool m_2DInterpolationActivated;
+
+    /// keeps the distance maps of the bounding slices between calls of Interpolate()
+    ShapeBasedInterpolationAlgorithm::Pointer m_InterpolationAlgorithm;
+    itk::ModifiedTimeType m_DistanceMapCacheTime;
+    Vector3D m_DistanceMapCacheNormal;
   };
 
 } // namespace
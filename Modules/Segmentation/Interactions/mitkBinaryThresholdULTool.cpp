@@ -24,6 +24,7 @@ found in the LICENSE file.
 
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
+#include "mitkImageMemory.h"
 #include "mitkImageStatisticsHolder.h"
 #include "mitkImageTimeSelector.h"
 #include "mitkLabelSetImage.h"
@@ -158,6 +159,9 @@ void mitk::BinaryThresholdULTool::SetupPreviewNode()
 
     if (image.IsNotNull())
     {
+      // the preview images are accounted separately, but not evicted, since the tool is showing them
+      ImageMemory::CategoryScope memoryCategory(PreviewImageMemoryCategory);
+
       mitk::LabelSetImage::Pointer workingImage =
         dynamic_cast<mitk::LabelSetImage *>(m_ToolManager->GetWorkingData(0)->GetData());
 
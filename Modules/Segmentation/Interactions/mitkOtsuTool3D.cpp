@@ -13,6 +13,8 @@ found in the LICENSE file.
 // MITK
 #include "mitkOtsuTool3D.h"
 #include "mitkImageAccessByItk.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 #include "mitkLabelSetImage.h"
 #include "mitkOtsuSegmentationFilter.h"
 #include "mitkRenderingManager.h"
@@ -25,9 +27,9 @@ found in the LICENSE file.
 #include <mitkSliceNavigationController.h>
 
 // ITK
-#include <itkBinaryThresholdImageFilter.h>
-#include <itkOrImageFilter.h>
-#include <itkOtsuMultipleThresholdsImageFilter.h>
+#include <itkOtsuMultipleThresholdsCalculator.h>
+#include <itkScalarImageToHistogramGenerator.h>
+#include <itkThresholdLabelerImageFilter.h>
 
 // us
 #include <usGetModuleContext.h>
@@ -37,12 +39,18 @@ found in the LICENSE file.
 
 #include <mitkImageStatisticsHolder.h>
 
+// VTK
+#include <vtkLookupTable.h>
+
+#include <algorithm>
+
 namespace mitk
 {
   MITK_TOOL_MACRO(MITKSEGMENTATION_EXPORT, OtsuTool3D, "Otsu Segmentation");
 }
 
 mitk::OtsuTool3D::OtsuTool3D()
+  : m_HistogramImage(nullptr), m_HistogramImageMTime(0), m_HistogramTimeStep(0), m_HistogramNumberOfBins(0)
 {
 }
 
@@ -58,14 +66,6 @@ void mitk::OtsuTool3D::Activated()
   {
     m_OriginalImage = dynamic_cast<mitk::Image *>(m_ToolManager->GetReferenceData(0)->GetData());
 
-    m_BinaryPreviewNode = mitk::DataNode::New();
-    m_BinaryPreviewNode->SetName("Binary_Preview");
-    m_BinaryPreviewNode->SetProperty("color", ColorProperty::New(0.0, 1.0, 0.0));
-    m_BinaryPreviewNode->SetProperty("opacity", FloatProperty::New(0.3));
-    // m_BinaryPreviewNode->SetBoolProperty("helper object", true);
-    // m_BinaryPreviewNode->SetProperty("binary", mitk::BoolProperty::New(true));
-    m_ToolManager->GetDataStorage()->Add(this->m_BinaryPreviewNode);
-
     m_MultiLabelResultNode = mitk::DataNode::New();
     m_MultiLabelResultNode->SetName("Otsu_Preview");
     // m_MultiLabelResultNode->SetBoolProperty("helper object", true);
@@ -84,10 +84,11 @@ void mitk::OtsuTool3D::Deactivated()
 {
   m_ToolManager->GetDataStorage()->Remove(this->m_MultiLabelResultNode);
   m_MultiLabelResultNode = nullptr;
-  m_ToolManager->GetDataStorage()->Remove(this->m_BinaryPreviewNode);
-  m_BinaryPreviewNode = nullptr;
   m_ToolManager->GetDataStorage()->Remove(this->m_MaskedImagePreviewNode);
   m_MaskedImagePreviewNode = nullptr;
+  m_Histogram = nullptr;
+  m_HistogramImage = nullptr;
+  m_SelectedRegionIDs.clear();
 
   Superclass::Deactivated();
 }
@@ -118,21 +119,41 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
     return;
   }
 
-  mitk::OtsuSegmentationFilter::Pointer otsuFilter = mitk::OtsuSegmentationFilter::New();
-  otsuFilter->SetNumberOfThresholds(numberOfThresholds);
-  otsuFilter->SetValleyEmphasis(useValley);
-  otsuFilter->SetNumberOfBins(numberOfBins);
-  otsuFilter->SetInput(image3D);
+  const TimeStepType timeStep = m_OriginalImage->GetTimeGeometry()->TimePointToTimeStep(timePoint);
 
+  mitk::Image::Pointer labelImage;
   try
   {
-    otsuFilter->Update();
+    // the histogram only depends on the image and the number of bins, the thresholds are computed from it
+    if (m_Histogram.IsNull() || m_HistogramImage != m_OriginalImage.GetPointer() ||
+        m_HistogramImageMTime != m_OriginalImage->GetMTime() || m_HistogramTimeStep != timeStep ||
+        m_HistogramNumberOfBins != numberOfBins)
+    {
+      AccessByItk_1(image3D, ComputeHistogram, static_cast<unsigned int>(numberOfBins));
+      m_HistogramImage = m_OriginalImage;
+      m_HistogramImageMTime = m_OriginalImage->GetMTime();
+      m_HistogramTimeStep = timeStep;
+      m_HistogramNumberOfBins = numberOfBins;
+    }
+
+    typedef itk::OtsuMultipleThresholdsCalculator<HistogramType> OtsuCalculatorType;
+    OtsuCalculatorType::Pointer otsuCalculator = OtsuCalculatorType::New();
+    otsuCalculator->SetInputHistogram(m_Histogram);
+    otsuCalculator->SetNumberOfThresholds(numberOfThresholds);
+    otsuCalculator->SetValleyEmphasis(useValley);
+    otsuCalculator->Compute();
+
+    const ThresholdVectorType thresholds = otsuCalculator->GetOutput();
+    AccessByItk_2(image3D, CalculateLabels, thresholds, labelImage);
   }
   catch (...)
   {
+    m_Histogram = nullptr;
     mitkThrow() << "itkOtsuFilter error (image dimension must be in {2, 3} and image must not be RGB)";
   }
 
+  m_SelectedRegionIDs.clear();
+
   m_ToolManager->GetDataStorage()->Remove(this->m_MultiLabelResultNode);
   m_MultiLabelResultNode = nullptr;
   m_MultiLabelResultNode = mitk::DataNode::New();
@@ -142,7 +163,7 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
   m_MultiLabelResultNode->SetOpacity(1.0);
 
   mitk::LabelSetImage::Pointer resultImage = mitk::LabelSetImage::New();
-  resultImage->InitializeByLabeledImage(otsuFilter->GetOutput());
+  resultImage->InitializeByLabeledImage(labelImage);
   this->m_MultiLabelResultNode->SetData(resultImage);
   m_MultiLabelResultNode->SetProperty("binary", mitk::BoolProperty::New(false));
   mitk::RenderingModeProperty::Pointer renderingMode = mitk::RenderingModeProperty::New();
@@ -165,7 +186,6 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
   levWinProp->SetLevelWindow(levelwindow);
   m_MultiLabelResultNode->SetProperty("levelwindow", levWinProp);
 
-  // m_BinaryPreviewNode->SetVisibility(false);
   //  m_MultiLabelResultNode->SetVisibility(true);
   // this->m_OtsuSegmentationDialog->setCursor(Qt::ArrowCursor);
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
@@ -173,8 +193,39 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
 
 void mitk::OtsuTool3D::ConfirmSegmentation()
 {
+  auto multiLabelSegmentation = dynamic_cast<mitk::Image *>(m_MultiLabelResultNode->GetData());
+  if (nullptr == multiLabelSegmentation)
+  {
+    return;
+  }
+
+  // the binary segmentation of the selected regions is created in a single pass over the multilabel result
+  std::vector<mitk::Tool::DefaultSegmentationDataType> isSelected(mitk::Label::MAX_LABEL_VALUE + 1, 0);
+  for (auto regionID : m_SelectedRegionIDs)
+  {
+    if (regionID >= 0 && regionID <= mitk::Label::MAX_LABEL_VALUE)
+      isSelected[regionID] = 1;
+  }
+
+  mitk::Image::Pointer binarySegmentation = mitk::Image::New();
+  binarySegmentation->Initialize(mitk::MakeScalarPixelType<mitk::Tool::DefaultSegmentationDataType>(),
+                                 *multiLabelSegmentation->GetTimeGeometry());
+
+  std::size_t numberOfVoxels = 1;
+  for (unsigned int dim = 0; dim < multiLabelSegmentation->GetDimension() && dim < 3; ++dim)
+    numberOfVoxels *= multiLabelSegmentation->GetDimension(dim);
+
+  {
+    mitk::ImageReadAccessor multiLabelAccessor(multiLabelSegmentation);
+    mitk::ImageWriteAccessor binaryAccessor(binarySegmentation);
+    auto regions = static_cast<const mitk::Label::PixelType *>(multiLabelAccessor.GetData());
+    auto mask = static_cast<mitk::Tool::DefaultSegmentationDataType *>(binaryAccessor.GetData());
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      mask[i] = isSelected[regions[i]];
+  }
+
   mitk::LabelSetImage::Pointer resultImage = mitk::LabelSetImage::New();
-  resultImage->InitializeByLabeledImage(dynamic_cast<mitk::Image *>(m_BinaryPreviewNode->GetData()));
+  resultImage->InitializeByLabeledImage(binarySegmentation);
   GetTargetSegmentationNode()->SetData(resultImage);
 
   m_ToolManager->ActivateTool(-1);
@@ -182,65 +233,43 @@ void mitk::OtsuTool3D::ConfirmSegmentation()
 
 void mitk::OtsuTool3D::UpdateBinaryPreview(std::vector<int> regionIDs)
 {
-  m_MultiLabelResultNode->SetVisibility(false);
-  mitk::Image::Pointer multiLabelSegmentation = dynamic_cast<mitk::Image *>(m_MultiLabelResultNode->GetData());
-  AccessByItk_1(multiLabelSegmentation, CalculatePreview, regionIDs);
+  m_SelectedRegionIDs = regionIDs;
+  this->ShowMultiLabelResultNode(false);
 }
 
 template <typename TPixel, unsigned int VImageDimension>
-void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage, std::vector<int> regionIDs)
+void mitk::OtsuTool3D::ComputeHistogram(const itk::Image<TPixel, VImageDimension> *itkImage, unsigned int numberOfBins)
 {
   typedef itk::Image<TPixel, VImageDimension> InputImageType;
-  typedef itk::Image<mitk::Tool::DefaultSegmentationDataType, VImageDimension> OutputImageType;
-
-  typedef itk::BinaryThresholdImageFilter<InputImageType, OutputImageType> FilterType;
+  typedef itk::Statistics::ScalarImageToHistogramGenerator<InputImageType> HistogramGeneratorType;
 
-  typename FilterType::Pointer filter = FilterType::New();
+  typename HistogramGeneratorType::Pointer histogramGenerator = HistogramGeneratorType::New();
+  histogramGenerator->SetInput(itkImage);
+  histogramGenerator->SetNumberOfBins(numberOfBins);
+  histogramGenerator->Compute();
 
-  // InputImageType::Pointer itkImage;
-  typename OutputImageType::Pointer itkBinaryTempImage1;
-  typename OutputImageType::Pointer itkBinaryTempImage2;
-  typename OutputImageType::Pointer itkBinaryResultImage;
-
-  // mitk::Image::Pointer multiLabelSegmentation = dynamic_cast<mitk::Image*>(m_MultiLabelResultNode->GetData());
-  // mitk::CastToItkImage(multiLabelSegmentation, itkImage);
+  m_Histogram = histogramGenerator->GetOutput();
+}
 
-  filter->SetInput(itkImage);
-  filter->SetLowerThreshold(regionIDs[0]);
-  filter->SetUpperThreshold(regionIDs[0]);
-  filter->SetInsideValue(1);
-  filter->SetOutsideValue(0);
-  filter->Update();
-  itkBinaryTempImage2 = filter->GetOutput();
+template <typename TPixel, unsigned int VImageDimension>
+void mitk::OtsuTool3D::CalculateLabels(const itk::Image<TPixel, VImageDimension> *itkImage,
+                                       const ThresholdVectorType &thresholds,
+                                       mitk::Image::Pointer &labelImage)
+{
+  typedef itk::Image<TPixel, VImageDimension> InputImageType;
+  typedef itk::Image<mitk::OtsuSegmentationFilter::OutputPixelType, VImageDimension> OutputImageType;
+  typedef itk::ThresholdLabelerImageFilter<InputImageType, OutputImageType> LabelerType;
 
-  typename itk::OrImageFilter<OutputImageType, OutputImageType>::Pointer orFilter =
-    itk::OrImageFilter<OutputImageType, OutputImageType>::New();
+  typename LabelerType::RealThresholdVector realThresholds(thresholds.begin(), thresholds.end());
 
-  // if more than one region id is used compute the union of all given binary regions
-  for (auto it = regionIDs.begin(); it != regionIDs.end(); ++it)
-  {
-    filter->SetLowerThreshold(*it);
-    filter->SetUpperThreshold(*it);
-    filter->SetInsideValue(1);
-    filter->SetOutsideValue(0);
-    filter->Update();
-    itkBinaryTempImage1 = filter->GetOutput();
-
-    orFilter->SetInput1(itkBinaryTempImage1);
-    orFilter->SetInput2(itkBinaryTempImage2);
-
-    orFilter->UpdateLargestPossibleRegion();
-    itkBinaryResultImage = orFilter->GetOutput();
-    itkBinaryTempImage2 = itkBinaryResultImage;
-  }
-  //----------------------------------------------------------------------------------------------------
-  mitk::Image::Pointer binarySegmentation;
-  mitk::CastToMitkImage(itkBinaryResultImage, binarySegmentation);
-  m_BinaryPreviewNode->SetData(binarySegmentation);
-  m_BinaryPreviewNode->SetVisibility(true);
-  m_BinaryPreviewNode->SetProperty("outline binary", mitk::BoolProperty::New(false));
+  // same labelling as itk::OtsuMultipleThresholdsImageFilter
+  typename LabelerType::Pointer labeler = LabelerType::New();
+  labeler->SetInput(itkImage);
+  labeler->SetRealThresholds(realThresholds);
+  labeler->SetLabelOffset(0);
+  labeler->Update();
 
-  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+  mitk::CastToMitkImage<OutputImageType>(labeler->GetOutput(), labelImage);
 }
 
 const char *mitk::OtsuTool3D::GetName() const
@@ -264,8 +293,31 @@ void mitk::OtsuTool3D::UpdateVolumePreview(bool volumeRendering)
 
 void mitk::OtsuTool3D::ShowMultiLabelResultNode(bool show)
 {
-  m_MultiLabelResultNode->SetVisibility(show);
-  m_BinaryPreviewNode->SetVisibility(!show);
+  auto resultImage = dynamic_cast<mitk::LabelSetImage *>(m_MultiLabelResultNode->GetData());
+  if (nullptr == resultImage)
+  {
+    return;
+  }
+
+  // the preview of the selected regions only changes the lookup table, the result itself is kept
+  mitk::LabelSet *labelSet = resultImage->GetActiveLabelSet();
+  vtkLookupTable *lookupTable = labelSet->GetLookupTable()->GetVtkLookupTable();
+  for (auto it = labelSet->IteratorBegin(); it != labelSet->IteratorEnd(); ++it)
+  {
+    if (show)
+    {
+      labelSet->UpdateLookupTable(it->first);
+    }
+    else
+    {
+      const bool selected =
+        std::find(m_SelectedRegionIDs.begin(), m_SelectedRegionIDs.end(), it->first) != m_SelectedRegionIDs.end();
+      lookupTable->SetTableValue(it->first, 0.0, 1.0, 0.0, selected ? 0.3 : 0.0);
+    }
+  }
+  labelSet->Modified();
+
+  m_MultiLabelResultNode->SetVisibility(true);
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 }
 
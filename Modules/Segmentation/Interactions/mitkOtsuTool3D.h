@@ -12,10 +12,13 @@ found in the LICENSE file.
 #ifndef MITKOTSUTOOL3D_H
 #define MITKOTSUTOOL3D_H
 
+#include "itkHistogram.h"
 #include "itkImage.h"
 #include "mitkAutoSegmentationTool.h"
 #include <MitkSegmentationExports.h>
 
+#include <vector>
+
 namespace us
 {
   class ModuleResource;
@@ -25,6 +28,13 @@ namespace mitk
 {
   class Image;
 
+  /**
+    \brief Multiple threshold Otsu segmentation of the reference image.
+
+    The histogram of the reference image is computed once and cached, so changing the number of regions or the
+    valley emphasis only recomputes the thresholds from it. The selected regions are previewed by changing the
+    lookup table of the multilabel result; the binary segmentation is only created by ConfirmSegmentation().
+  */
   class MITKSEGMENTATION_EXPORT OtsuTool3D : public AutoSegmentationTool
   {
   public:
@@ -52,12 +62,26 @@ namespace mitk
     OtsuTool3D();
     ~OtsuTool3D() override;
 
+    typedef itk::Statistics::Histogram<double> HistogramType;
+    typedef std::vector<double> ThresholdVectorType;
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void ComputeHistogram(const itk::Image<TPixel, VImageDimension> *itkImage, unsigned int numberOfBins);
+
     template <typename TPixel, unsigned int VImageDimension>
-    void CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage, std::vector<int> regionIDs);
+    void CalculateLabels(const itk::Image<TPixel, VImageDimension> *itkImage,
+                         const ThresholdVectorType &thresholds,
+                         itk::SmartPointer<Image> &labelImage);
 
     itk::SmartPointer<Image> m_OriginalImage;
-    // holds the user selected binary segmentation
-    mitk::DataNode::Pointer m_BinaryPreviewNode;
+    // histogram of the original image, reused as long as the image, time step and number of bins stay the same
+    HistogramType::ConstPointer m_Histogram;
+    const mitk::Image *m_HistogramImage;
+    itk::ModifiedTimeType m_HistogramImageMTime;
+    TimeStepType m_HistogramTimeStep;
+    int m_HistogramNumberOfBins;
+    // the regions of the multilabel result selected by the user
+    std::vector<int> m_SelectedRegionIDs;
     // holds the multilabel result as a preview image
     mitk::DataNode::Pointer m_MultiLabelResultNode;
     // holds the user selected binary segmentation masked original image
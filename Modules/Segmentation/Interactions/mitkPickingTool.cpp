@@ -25,9 +25,12 @@ found in the LICENSE file.
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
 #include "mitkImageTimeSelector.h"
-#include "mitkImageTimeSelector.h"
+#include "mitkImageWriteAccessor.h"
+
+#include <itkBinaryThresholdImageFilter.h>
+#include <itkConnectedComponentImageFilter.h>
 
-#include <itkConnectedThresholdImageFilter.h>
+#include <algorithm>
 
 #include <mitkLabelSetImage.h>
 
@@ -36,7 +39,8 @@ namespace mitk
   MITK_TOOL_MACRO(MITKSEGMENTATION_EXPORT, PickingTool, "PickingTool");
 }
 
-mitk::PickingTool::PickingTool() : m_WorkingData(nullptr)
+mitk::PickingTool::PickingTool()
+  : m_ComponentIndexImage(nullptr), m_ComponentIndexMTime(0), m_ComponentIndexTimeStep(-1), m_WorkingData(nullptr)
 {
   m_PointSetNode = mitk::DataNode::New();
   m_PointSetNode->GetPropertyList()->SetProperty("name", mitk::StringProperty::New("Picking_Seedpoint"));
@@ -99,11 +103,22 @@ void mitk::PickingTool::Activated()
 
   // now add result to data tree
   dataStorage->Add(m_ResultNode, m_WorkingData);
+
+  // label the connected components in advance, so that a pick does not need to traverse the segmentation
+  try
+  {
+    this->UpdateComponentIndex(this->GetCurrentTimeStep());
+  }
+  catch (const itk::ExceptionObject &e)
+  {
+    MITK_WARN << "Labelling the connected components of the segmentation failed: " << e.GetDescription();
+  }
 }
 
 void mitk::PickingTool::Deactivated()
 {
   m_PointSet->Clear();
+  this->ResetComponentIndex();
   // remove from data storage and disable interaction
   GetDataStorage()->Remove(m_PointSetNode);
   GetDataStorage()->Remove(m_ResultNode);
@@ -152,81 +167,208 @@ void mitk::PickingTool::OnPointAdded()
     m_WorkingData = this->GetWorkingData();
   }
 
-  // Perform region growing/picking
+  // Pick the connected component at the seed point
 
-  int timeStep =
-    mitk::BaseRenderer::GetInstance(mitk::BaseRenderer::GetRenderWindowByName("stdmulti.widget0"))->GetTimeStep();
+  int timeStep = this->GetCurrentTimeStep();
 
   mitk::PointSet::PointType seedPoint = m_PointSet->GetPointSet(timeStep)->GetPoints()->Begin().Value();
 
+  try
+  {
+    this->UpdateComponentIndex(timeStep);
+    this->PickComponent(seedPoint);
+  }
+  catch (const itk::ExceptionObject &e)
+  {
+    MITK_ERROR << "Picking a region failed: " << e.GetDescription();
+  }
+
+  this->m_PointSet->Clear();
+
+  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+}
+
+int mitk::PickingTool::GetCurrentTimeStep() const
+{
+  mitk::BaseRenderer *renderer =
+    mitk::BaseRenderer::GetInstance(mitk::BaseRenderer::GetRenderWindowByName("stdmulti.widget0"));
+  return renderer != nullptr ? static_cast<int>(renderer->GetTimeStep()) : 0;
+}
+
+void mitk::PickingTool::UpdateComponentIndex(int timeStep)
+{
   // as we want to pick a region from our segmentation image use the working data from ToolManager
-  mitk::Image::Pointer orgImage = dynamic_cast<mitk::Image *>(m_ToolManager->GetWorkingData(0)->GetData());
+  mitk::Image *workingImage = m_WorkingData != nullptr ? dynamic_cast<mitk::Image *>(m_WorkingData->GetData()) : nullptr;
 
-  if (orgImage.IsNotNull())
+  if (workingImage == nullptr)
   {
-    if (orgImage->GetDimension() == 4)
-    { // there may be 4D segmentation data even though we currently don't support that
-      mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-      timeSelector->SetInput(orgImage);
-      timeSelector->SetTimeNr(timeStep);
-      timeSelector->UpdateLargestPossibleRegion();
-      mitk::Image *timedImage = timeSelector->GetOutput();
+    this->ResetComponentIndex();
+    return;
+  }
 
-      AccessByItk_2(timedImage, StartRegionGrowing, timedImage->GetGeometry(), seedPoint);
-    }
-    else if (orgImage->GetDimension() == 3)
+  if (workingImage == m_ComponentIndexImage && timeStep == m_ComponentIndexTimeStep)
+  {
+    if (m_ComponentImage.IsNotNull() && workingImage->GetMTime() == m_ComponentIndexMTime)
     {
-      AccessByItk_2(orgImage, StartRegionGrowing, orgImage->GetGeometry(), seedPoint);
+      return;
     }
-    this->m_PointSet->Clear();
+
+    // the segmentation has been modified, the components already picked stay in the result
+    m_PickedComponents.clear();
   }
+  else
+  {
+    this->ResetComponentIndex();
+    m_ResultNode->SetData(nullptr);
+  }
+
+  mitk::Image::Pointer image = workingImage;
+  if (workingImage->GetDimension() == 4)
+  { // there may be 4D segmentation data even though we currently don't support that
+    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+    timeSelector->SetInput(workingImage);
+    timeSelector->SetTimeNr(timeStep);
+    timeSelector->UpdateLargestPossibleRegion();
+    image = timeSelector->GetOutput();
+  }
+  else if (workingImage->GetDimension() != 3)
+  {
+    return;
+  }
+
+  AccessFixedDimensionByItk(image, ComputeComponentIndex, 3);
+
+  m_ComponentGeometry = image->GetGeometry()->Clone();
+  m_ComponentIndexImage = workingImage;
+  m_ComponentIndexMTime = workingImage->GetMTime();
+  m_ComponentIndexTimeStep = timeStep;
+}
+
+void mitk::PickingTool::ResetComponentIndex()
+{
+  m_ComponentImage = nullptr;
+  m_ComponentRuns.clear();
+  m_ComponentGeometry = nullptr;
+  m_ComponentIndexImage = nullptr;
+  m_ComponentIndexMTime = 0;
+  m_ComponentIndexTimeStep = -1;
+  m_PickedComponents.clear();
 }
 
 template <typename TPixel, unsigned int VImageDimension>
-void mitk::PickingTool::StartRegionGrowing(itk::Image<TPixel, VImageDimension> *itkImage,
-                                           mitk::BaseGeometry *imageGeometry,
-                                           mitk::PointSet::PointType seedPoint)
+void mitk::PickingTool::ComputeComponentIndex(itk::Image<TPixel, VImageDimension> *itkImage)
 {
   typedef itk::Image<TPixel, VImageDimension> InputImageType;
-  typedef typename InputImageType::IndexType IndexType;
-  typedef itk::ConnectedThresholdImageFilter<InputImageType, InputImageType> RegionGrowingFilterType;
-  typename RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
+  typedef itk::Image<unsigned char, VImageDimension> MaskImageType;
+  typedef itk::BinaryThresholdImageFilter<InputImageType, MaskImageType> ThresholdFilterType;
+  typedef itk::ConnectedComponentImageFilter<MaskImageType, ComponentImageType> ConnectedComponentFilterType;
 
-  // convert world coordinates to image indices
-  IndexType seedIndex;
-  imageGeometry->WorldToIndex(seedPoint, seedIndex);
-
-  // perform region growing in desired segmented region
-  regionGrower->SetInput(itkImage);
-  regionGrower->AddSeed(seedIndex);
+  typename ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
+  thresholdFilter->SetInput(itkImage);
 
   // TODO: conversion added to silence warning and
   // maintain existing behaviour, should be fixed
   // since it's not correct e.g. for signed char
-  regionGrower->SetLower(static_cast<typename InputImageType::PixelType>(1));
-  regionGrower->SetUpper(static_cast<typename InputImageType::PixelType>(255));
+  thresholdFilter->SetLowerThreshold(static_cast<typename InputImageType::PixelType>(1));
+  thresholdFilter->SetUpperThreshold(static_cast<typename InputImageType::PixelType>(255));
+  thresholdFilter->SetInsideValue(1);
+  thresholdFilter->SetOutsideValue(0);
 
-  try
+  // face connected components, as grown by a connected threshold filter
+  typename ConnectedComponentFilterType::Pointer connectedComponentFilter = ConnectedComponentFilterType::New();
+  connectedComponentFilter->SetInput(thresholdFilter->GetOutput());
+  connectedComponentFilter->SetFullyConnected(false);
+  connectedComponentFilter->Update();
+
+  m_ComponentImage = connectedComponentFilter->GetOutput();
+  m_ComponentImage->DisconnectPipeline();
+
+  // collect the runs of all components in one pass over the labels
+  m_ComponentRuns.assign(connectedComponentFilter->GetObjectCount() + 1, std::vector<ComponentRun>());
+
+  const unsigned int *labels = m_ComponentImage->GetBufferPointer();
+  const std::size_t rowLength = m_ComponentImage->GetBufferedRegion().GetSize(0);
+  const std::size_t numberOfVoxels = m_ComponentImage->GetBufferedRegion().GetNumberOfPixels();
+
+  for (std::size_t rowStart = 0; rowStart < numberOfVoxels; rowStart += rowLength)
   {
-    regionGrower->Update();
+    const std::size_t rowEnd = rowStart + rowLength;
+    std::size_t offset = rowStart;
+    while (offset < rowEnd)
+    {
+      const unsigned int label = labels[offset];
+      std::size_t runEnd = offset + 1;
+      while (runEnd < rowEnd && labels[runEnd] == label)
+      {
+        ++runEnd;
+      }
+      if (label != 0)
+      {
+        ComponentRun run;
+        run.offset = offset;
+        run.length = runEnd - offset;
+        m_ComponentRuns[label].push_back(run);
+      }
+      offset = runEnd;
+    }
   }
-  catch (const itk::ExceptionObject &)
+}
+
+void mitk::PickingTool::PickComponent(const mitk::PointSet::PointType &seedPoint)
+{
+  if (m_ComponentImage.IsNull())
   {
-    return; // can't work
+    return;
   }
-  catch (...)
+
+  // convert world coordinates to image indices
+  ComponentImageType::IndexType seedIndex;
+  m_ComponentGeometry->WorldToIndex(seedPoint, seedIndex);
+
+  if (!m_ComponentImage->GetBufferedRegion().IsInside(seedIndex))
   {
     return;
   }
 
-  // Store result and preview
-  mitk::Image::Pointer resultImage = mitk::ImportItkImage(regionGrower->GetOutput(), imageGeometry)->Clone();
-  mitk::LabelSetImage::Pointer resultLabelSetImage = mitk::LabelSetImage::New();
-  resultLabelSetImage->InitializeByLabeledImage(resultImage);
+  const unsigned int component = m_ComponentImage->GetPixel(seedIndex);
+  if (component == 0 || !m_PickedComponents.insert(component).second)
+  {
+    return; // background or already picked
+  }
 
-  m_ResultNode->SetData(resultLabelSetImage);
+  const std::vector<ComponentRun> &runs = m_ComponentRuns[component];
+  auto writeComponent = [&runs](mitk::Label::PixelType *buffer)
+  {
+    for (const auto &run : runs)
+    {
+      std::fill_n(buffer + run.offset, run.length, 1);
+    }
+  };
 
-  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+  // Store result and preview
+  auto *resultImage = dynamic_cast<mitk::LabelSetImage *>(m_ResultNode->GetData());
+  if (resultImage == nullptr)
+  {
+    typedef itk::Image<mitk::Label::PixelType, 3> ResultImageType;
+    ResultImageType::Pointer pickedImage = ResultImageType::New();
+    pickedImage->CopyInformation(m_ComponentImage);
+    pickedImage->SetRegions(m_ComponentImage->GetBufferedRegion());
+    pickedImage->Allocate(true);
+    writeComponent(pickedImage->GetBufferPointer());
+
+    mitk::LabelSetImage::Pointer resultLabelSetImage = mitk::LabelSetImage::New();
+    resultLabelSetImage->InitializeByLabeledImage(mitk::ImportItkImage(pickedImage, m_ComponentGeometry.GetPointer()));
+    m_ResultNode->SetData(resultLabelSetImage);
+  }
+  else
+  {
+    // add the component to the previously picked ones
+    {
+      mitk::ImageWriteAccessor resultAccessor(resultImage);
+      writeComponent(static_cast<mitk::Label::PixelType *>(resultAccessor.GetData()));
+    }
+    resultImage->Modified();
+  }
 }
 
 void mitk::PickingTool::ConfirmSegmentation()
@@ -248,6 +390,7 @@ void mitk::PickingTool::ConfirmSegmentation()
   m_WorkingData->SetVisibility(false);
 
   m_ResultNode->SetData(nullptr);
+  m_PickedComponents.clear();
 
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 }
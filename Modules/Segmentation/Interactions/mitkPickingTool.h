@@ -21,6 +21,9 @@ found in the LICENSE file.
 #include "mitkSinglePointDataInteractor.h"
 #include <MitkSegmentationExports.h>
 
+#include <set>
+#include <vector>
+
 namespace us
 {
   class ModuleResource;
@@ -32,8 +35,9 @@ namespace mitk
   \brief Extracts a single region from a segmentation image and creates a new image with same geometry of the input
   image.
 
-  The region is extracted in 3D space. This is done by performing region growing within the desired region.
-  Use shift click to add the seed point.
+  The region is extracted in 3D space. The connected components of the segmentation are labelled once when the tool
+  is activated or the segmentation has been modified, so that every pick only looks up the component at the seed point.
+  Use shift click to add a seed point; every pick adds its region to the result until it is confirmed.
 
   \ingroup ToolManagerEtAl
   \sa mitk::Tool
@@ -74,11 +78,38 @@ namespace mitk
 
     mitk::DataNode::Pointer m_ResultNode;
 
-    // itk regrowing
+    /** A run of consecutive voxels of a connected component in an image row */
+    struct ComponentRun
+    {
+      std::size_t offset; ///< buffer offset of the first voxel of the run
+      std::size_t length; ///< number of voxels of the run
+    };
+
+    typedef itk::Image<unsigned int, 3> ComponentImageType;
+
+    /** Returns the time step of the standard render window or 0 if there is none */
+    int GetCurrentTimeStep() const;
+
+    /** Labels the connected components of the working segmentation at the time step, unless this has already been
+     * done for the current state of the segmentation. */
+    void UpdateComponentIndex(int timeStep);
+
+    /** Releases the connected components and the picked components */
+    void ResetComponentIndex();
+
     template <typename TPixel, unsigned int VImageDimension>
-    void StartRegionGrowing(itk::Image<TPixel, VImageDimension> *itkImage,
-                            mitk::BaseGeometry *imageGeometry,
-                            mitk::PointSet::PointType seedPoint);
+    void ComputeComponentIndex(itk::Image<TPixel, VImageDimension> *itkImage);
+
+    /** Adds the connected component at the seed point to the result */
+    void PickComponent(const mitk::PointSet::PointType &seedPoint);
+
+    ComponentImageType::Pointer m_ComponentImage; ///< connected component label of every voxel, 0 for the background
+    std::vector<std::vector<ComponentRun>> m_ComponentRuns; ///< run-length representation of every component, indexed by label
+    mitk::BaseGeometry::Pointer m_ComponentGeometry; ///< geometry of the labelled segmentation
+    const mitk::Image *m_ComponentIndexImage; ///< segmentation the components belong to, only used for comparison
+    itk::ModifiedTimeType m_ComponentIndexMTime; ///< modification time of the segmentation when it was labelled
+    int m_ComponentIndexTimeStep; ///< labelled time step of the segmentation
+    std::set<unsigned int> m_PickedComponents; ///< labels of the components in the result
 
     // seed point
     PointSet::Pointer m_PointSet;
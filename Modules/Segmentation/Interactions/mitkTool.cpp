@@ -30,6 +30,8 @@ found in the LICENSE file.
 // itk
 #include <itkObjectFactory.h>
 
+const char *const mitk::Tool::PreviewImageMemoryCategory = "Segmentation preview";
+
 mitk::Tool::Tool(const char *type, const us::Module *interactorModule)
   : m_EventConfig("DisplayConfigMITK.xml"),
     m_ToolManager(nullptr),
@@ -217,6 +217,11 @@ namespace mitk
     */
     std::string m_EventConfig;
 
+    /**
+    \brief Category of mitk::ImageMemory under which tools allocate their preview images.
+    */
+    static const char *const PreviewImageMemoryCategory;
+
     Tool();             // purposely hidden
     Tool(const char *, const us::Module *interactorModule = nullptr); // purposely hidden
     ~Tool() override;
@@ -11,14 +11,17 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkBooleanOperation.h"
-#include <itkAndImageFilter.h>
-#include <itkNotImageFilter.h>
-#include <itkOrImageFilter.h>
 #include <mitkExceptionMacro.h>
-#include <mitkImageCast.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkImageTimeSelector.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkParallelFor.h>
 
-typedef itk::Image<mitk::Label::PixelType, 3> ImageType;
+#include <algorithm>
+#include <array>
+#include <vector>
+
+typedef mitk::Label::PixelType PixelType;
 
 static mitk::Image::Pointer Get3DSegmentation(mitk::Image::Pointer segmentation, mitk::TimePointType time)
 {
@@ -34,10 +37,156 @@ static mitk::Image::Pointer Get3DSegmentation(mitk::Image::Pointer segmentation,
   return imageTimeSelector->GetOutput();
 }
 
-static ImageType::Pointer CastTo3DItkImage(mitk::Image::Pointer segmentation, mitk::TimePointType time)
+// Runs function(z) for all slices z in [begin, end], distributed over all available cores
+template <typename TFunction>
+static void ParallelForSlices(int begin, int end, TFunction function)
+{
+  if (end < begin)
+    return;
+
+  mitk::ParallelFor(end - begin + 1, [&](std::size_t i) { function(begin + static_cast<int>(i)); });
+}
+
+namespace
 {
-  ImageType::Pointer result;
-  mitk::CastToItkImage(Get3DSegmentation(segmentation, time), result);
+  /** \brief Read access to the voxels of a 3D segmentation as mitk::Label::PixelType.
+   *
+   * unsigned short segmentations are accessed in place, unsigned char segmentations are converted.
+   */
+  class SegmentationVoxels
+  {
+  public:
+    explicit SegmentationVoxels(mitk::Image::Pointer segmentation3D)
+      : m_Segmentation(segmentation3D), m_Accessor(segmentation3D.GetPointer()), m_Data(nullptr)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+        m_Dimensions[i] = static_cast<int>(segmentation3D->GetDimension(i));
+
+      if (segmentation3D->GetPixelType().GetComponentType() == itk::ImageIOBase::USHORT)
+      {
+        m_Data = static_cast<const PixelType *>(m_Accessor.GetData());
+      }
+      else
+      {
+        auto *data = static_cast<const unsigned char *>(m_Accessor.GetData());
+        m_ConvertedData.assign(data, data + this->GetNumberOfVoxels());
+        m_Data = m_ConvertedData.data();
+      }
+    }
+
+    const PixelType *GetData() const { return m_Data; }
+    const int *GetDimensions() const { return m_Dimensions; }
+
+    std::size_t GetNumberOfVoxels() const
+    {
+      return static_cast<std::size_t>(m_Dimensions[0]) * m_Dimensions[1] * m_Dimensions[2];
+    }
+
+    /** \brief Computes the index bounding box {x0, x1, y0, y1, z0, z1} of all non-zero voxels.
+     *
+     * Returns false if there are no non-zero voxels.
+     */
+    bool GetBoundingBox(int *boundingBox) const
+    {
+      const int *dims = m_Dimensions;
+
+      // {x0, x1, y0, y1} per slice, empty slices keep x0 > x1
+      std::vector<std::array<int, 4>> sliceBounds(dims[2], std::array<int, 4>{{dims[0], -1, dims[1], -1}});
+
+      ParallelForSlices(0, dims[2] - 1, [&](int z) {
+        std::array<int, 4> &bounds = sliceBounds[z];
+        const PixelType *slice = m_Data + static_cast<std::size_t>(z) * dims[0] * dims[1];
+
+        for (int y = 0; y < dims[1]; ++y)
+        {
+          const PixelType *row = slice + static_cast<std::size_t>(y) * dims[0];
+
+          int firstX = 0;
+          while (firstX < dims[0] && row[firstX] == 0)
+            ++firstX;
+
+          if (firstX == dims[0])
+            continue;
+
+          int lastX = dims[0] - 1;
+          while (row[lastX] == 0)
+            --lastX;
+
+          bounds[0] = std::min(bounds[0], firstX);
+          bounds[1] = std::max(bounds[1], lastX);
+          bounds[2] = std::min(bounds[2], y);
+          bounds[3] = y;
+        }
+      });
+
+      boundingBox[0] = dims[0];
+      boundingBox[1] = -1;
+      boundingBox[2] = dims[1];
+      boundingBox[3] = -1;
+      boundingBox[4] = dims[2];
+      boundingBox[5] = -1;
+
+      for (int z = 0; z < dims[2]; ++z)
+      {
+        const std::array<int, 4> &bounds = sliceBounds[z];
+        if (bounds[0] > bounds[1])
+          continue;
+
+        boundingBox[0] = std::min(boundingBox[0], bounds[0]);
+        boundingBox[1] = std::max(boundingBox[1], bounds[1]);
+        boundingBox[2] = std::min(boundingBox[2], bounds[2]);
+        boundingBox[3] = std::max(boundingBox[3], bounds[3]);
+        boundingBox[4] = std::min(boundingBox[4], z);
+        boundingBox[5] = z;
+      }
+
+      return boundingBox[4] <= boundingBox[5];
+    }
+
+  private:
+    mitk::Image::Pointer m_Segmentation;
+    mitk::ImageReadAccessor m_Accessor;
+    int m_Dimensions[3];
+    const PixelType *m_Data;
+    std::vector<PixelType> m_ConvertedData;
+  };
+}
+
+// Applies operation voxel-wise within the given bounding box (all other voxels are 0) and
+// returns the result as labeled image
+template <typename TOperation>
+static mitk::LabelSetImage::Pointer ApplyVoxelwise(const SegmentationVoxels &voxelsA,
+                                                   const SegmentationVoxels &voxelsB,
+                                                   const mitk::Image *referenceImage,
+                                                   const int *boundingBox,
+                                                   TOperation operation)
+{
+  auto tempResult = mitk::Image::New();
+  tempResult->Initialize(mitk::MakeScalarPixelType<PixelType>(), *referenceImage->GetTimeGeometry());
+
+  {
+    mitk::ImageWriteAccessor accessor(tempResult);
+    auto *resultData = static_cast<PixelType *>(accessor.GetData());
+    std::fill_n(resultData, voxelsA.GetNumberOfVoxels(), 0);
+
+    const int *dims = voxelsA.GetDimensions();
+    const PixelType *dataA = voxelsA.GetData();
+    const PixelType *dataB = voxelsB.GetData();
+
+    ParallelForSlices(boundingBox[4], boundingBox[5], [&](int z) {
+      for (int y = boundingBox[2]; y <= boundingBox[3]; ++y)
+      {
+        const std::size_t rowOffset = (static_cast<std::size_t>(z) * dims[1] + y) * dims[0];
+
+        for (int x = boundingBox[0]; x <= boundingBox[1]; ++x)
+          resultData[rowOffset + x] = operation(dataA[rowOffset + x], dataB[rowOffset + x]);
+      }
+    });
+  }
+
+  auto result = mitk::LabelSetImage::New();
+  result->InitializeByLabeledImage(tempResult);
+
   return result;
 }
 
@@ -74,71 +223,64 @@ mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetResult() const
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetDifference() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
-
-  auto notFilter = itk::NotImageFilter<ImageType, ImageType>::New();
-  notFilter->SetInput(input2);
-
-  auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
-  andFilter->SetInput1(input1);
-  andFilter->SetInput2(notFilter->GetOutput());
-
-  andFilter->UpdateLargestPossibleRegion();
-
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
-
-  tempResult->DisconnectPipeline();
+  auto segmentationA = Get3DSegmentation(m_SegmentationA, m_TimePoint);
+  SegmentationVoxels voxelsA(segmentationA);
+  SegmentationVoxels voxelsB(Get3DSegmentation(m_SegmentationB, m_TimePoint));
 
-  auto result = mitk::LabelSetImage::New();
-  result->InitializeByLabeledImage(tempResult);
+  // A AND (NOT B) can only be non-zero within the bounding box of A
+  int boundingBox[6];
+  voxelsA.GetBoundingBox(boundingBox);
 
-  return result;
+  return ApplyVoxelwise(voxelsA, voxelsB, segmentationA, boundingBox, [](PixelType a, PixelType b) {
+    return static_cast<PixelType>(a & static_cast<PixelType>(!b));
+  });
 }
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetIntersection() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
-
-  auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
-  andFilter->SetInput1(input1);
-  andFilter->SetInput2(input2);
-
-  andFilter->UpdateLargestPossibleRegion();
-
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
+  auto segmentationA = Get3DSegmentation(m_SegmentationA, m_TimePoint);
+  SegmentationVoxels voxelsA(segmentationA);
+  SegmentationVoxels voxelsB(Get3DSegmentation(m_SegmentationB, m_TimePoint));
 
-  tempResult->DisconnectPipeline();
+  // A AND B can only be non-zero within the intersection of both bounding boxes
+  int boundingBox[6];
+  int boundingBoxB[6];
+  voxelsA.GetBoundingBox(boundingBox);
+  voxelsB.GetBoundingBox(boundingBoxB);
 
-  auto result = mitk::LabelSetImage::New();
-  result->InitializeByLabeledImage(tempResult);
+  for (int i = 0; i < 6; i += 2)
+  {
+    boundingBox[i] = std::max(boundingBox[i], boundingBoxB[i]);
+    boundingBox[i + 1] = std::min(boundingBox[i + 1], boundingBoxB[i + 1]);
+  }
 
-  return result;
+  return ApplyVoxelwise(voxelsA, voxelsB, segmentationA, boundingBox, [](PixelType a, PixelType b) {
+    return static_cast<PixelType>(a & b);
+  });
 }
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetUnion() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
-
-  auto orFilter = itk::OrImageFilter<ImageType, ImageType>::New();
-  orFilter->SetInput1(input1);
-  orFilter->SetInput2(input2);
-
-  orFilter->UpdateLargestPossibleRegion();
-
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(orFilter->GetOutput(), tempResult);
-
-  tempResult->DisconnectPipeline();
-
-  auto result = mitk::LabelSetImage::New();
-  result->InitializeByLabeledImage(tempResult);
+  auto segmentationA = Get3DSegmentation(m_SegmentationA, m_TimePoint);
+  SegmentationVoxels voxelsA(segmentationA);
+  SegmentationVoxels voxelsB(Get3DSegmentation(m_SegmentationB, m_TimePoint));
+
+  // A OR B can only be non-zero within the union of both bounding boxes
+  // (an empty bounding box has its lower bounds above its upper bounds, so it does not contribute)
+  int boundingBox[6];
+  int boundingBoxB[6];
+  voxelsA.GetBoundingBox(boundingBox);
+  voxelsB.GetBoundingBox(boundingBoxB);
+
+  for (int i = 0; i < 6; i += 2)
+  {
+    boundingBox[i] = std::min(boundingBox[i], boundingBoxB[i]);
+    boundingBox[i + 1] = std::max(boundingBox[i + 1], boundingBoxB[i + 1]);
+  }
 
-  return result;
+  return ApplyVoxelwise(voxelsA, voxelsB, segmentationA, boundingBox, [](PixelType a, PixelType b) {
+    return static_cast<PixelType>(a | b);
+  });
 }
 
 void mitk::BooleanOperation::ValidateSegmentation(mitk::Image::Pointer segmentation) const
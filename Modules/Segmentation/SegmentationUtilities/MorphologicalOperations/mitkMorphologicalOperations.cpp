@@ -11,18 +11,168 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkMorphologicalOperations.h"
-#include <itkBinaryBallStructuringElement.h>
-#include <itkBinaryCrossStructuringElement.h>
-#include <itkBinaryDilateImageFilter.h>
-#include <itkBinaryErodeImageFilter.h>
 #include <itkBinaryFillholeImageFilter.h>
-#include <itkBinaryMorphologicalClosingImageFilter.h>
-#include <itkBinaryMorphologicalOpeningImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <mitkEuclideanDistanceTransform.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkImageTimeSelector.h>
 
+#include <vector>
+
+namespace
+{
+  /** Squared distance (in voxels) of every voxel to the nearest voxel with mask value feature. Only the
+      axes with axes[i] > 0 are considered. */
+  std::vector<float> SquaredDistanceTo(const std::vector<unsigned char> &mask,
+                                       unsigned char feature,
+                                       unsigned int dimension,
+                                       const unsigned int *size,
+                                       const double *axes)
+  {
+    std::vector<float> distance(mask.size());
+
+    for (std::size_t i = 0; i < mask.size(); ++i)
+      distance[i] = mask[i] == feature ? 0.0f : mitk::EuclideanDistanceTransform::Infinity;
+
+    mitk::EuclideanDistanceTransform::ComputeSquared(distance.data(), dimension, size, axes);
+    return distance;
+  }
+
+  /** Dilates (dilate == true) or erodes the mask (1 = foreground, 0 = background) in place.
+
+      A voxel offset o is part of a ball structuring element of radius r if |o|^2 <= (r + 0.5)^2, which is
+      the definition of itk::BinaryBallStructuringElement. For integer offsets this equals |o|^2 <= r^2 + r,
+      so a voxel belongs to the dilation if its squared distance to the foreground is at most r^2 + r. A cross
+      of radius r is the union of lines of length 2r + 1 along the axes, so its dilation is the union of the
+      1D dilations along each axis. Erosion is the dilation of the background. */
+  void BinaryMorphology(std::vector<unsigned char> &mask,
+                        unsigned int dimension,
+                        const unsigned int *size,
+                        int factor,
+                        mitk::MorphologicalOperations::StructuralElementType structuralElement,
+                        bool dilate)
+  {
+    if (factor <= 0)
+      return;
+
+    // axes spanned by the structuring element
+    bool activeAxes[3] = {false, false, false};
+    switch (structuralElement)
+    {
+      case mitk::MorphologicalOperations::Ball_Axial:
+      case mitk::MorphologicalOperations::Cross_Axial:
+        activeAxes[0] = activeAxes[1] = true;
+        break;
+      case mitk::MorphologicalOperations::Ball_Coronal:
+      case mitk::MorphologicalOperations::Cross_Coronal:
+        activeAxes[0] = activeAxes[2] = true;
+        break;
+      case mitk::MorphologicalOperations::Ball_Sagital:
+      case mitk::MorphologicalOperations::Cross_Sagital:
+        activeAxes[1] = activeAxes[2] = true;
+        break;
+      case mitk::MorphologicalOperations::Ball:
+      case mitk::MorphologicalOperations::Cross:
+        activeAxes[0] = activeAxes[1] = activeAxes[2] = true;
+        break;
+    }
+
+    // dilation grows the foreground, erosion grows the background
+    const unsigned char feature = dilate ? 1 : 0;
+
+    if (structuralElement & mitk::MorphologicalOperations::Ball)
+    {
+      double axes[3] = {0.0, 0.0, 0.0};
+      for (unsigned int i = 0; i < dimension && i < 3; ++i)
+        axes[i] = activeAxes[i] ? 1.0 : 0.0;
+
+      const auto threshold = static_cast<float>(factor) * factor + factor;
+      const std::vector<float> distance = SquaredDistanceTo(mask, feature, dimension, size, axes);
+
+      for (std::size_t i = 0; i < mask.size(); ++i)
+      {
+        if (distance[i] <= threshold)
+          mask[i] = feature;
+      }
+    }
+    else
+    {
+      const auto threshold = static_cast<float>(factor) * factor;
+      const std::vector<unsigned char> input = mask;
+
+      for (unsigned int axis = 0; axis < dimension && axis < 3; ++axis)
+      {
+        if (!activeAxes[axis])
+          continue;
+
+        double axes[3] = {0.0, 0.0, 0.0};
+        axes[axis] = 1.0;
+
+        const std::vector<float> distance = SquaredDistanceTo(input, feature, dimension, size, axes);
+
+        for (std::size_t i = 0; i < mask.size(); ++i)
+        {
+          if (distance[i] <= threshold)
+            mask[i] = feature;
+        }
+      }
+    }
+  }
+
+  /** Returns the foreground mask (pixel value 1) of the image and stores its size. */
+  template <typename TPixel, unsigned int VDimension>
+  std::vector<unsigned char> ExtractForeground(const itk::Image<TPixel, VDimension> *image, unsigned int *size)
+  {
+    typedef itk::Image<TPixel, VDimension> ImageType;
+    const typename ImageType::RegionType region = image->GetLargestPossibleRegion();
+
+    for (unsigned int i = 0; i < VDimension; ++i)
+      size[i] = region.GetSize(i);
+
+    std::vector<unsigned char> mask(region.GetNumberOfPixels());
+
+    itk::ImageRegionConstIterator<ImageType> iter(image, region);
+    for (std::size_t i = 0; !iter.IsAtEnd(); ++iter, ++i)
+      mask[i] = iter.Get() == 1 ? 1 : 0;
+
+    return mask;
+  }
+
+  /** Foreground voxels of the mask get value 1. Background voxels get 0 if binaryOutput is set and keep their
+      original value if they were no foreground voxels before, otherwise. */
+  template <typename TPixel, unsigned int VDimension>
+  void CreateResultImage(const itk::Image<TPixel, VDimension> *sourceImage,
+                         const std::vector<unsigned char> &mask,
+                         bool binaryOutput,
+                         mitk::Image::Pointer &resultImage)
+  {
+    typedef itk::Image<TPixel, VDimension> ImageType;
+
+    typename ImageType::Pointer output = ImageType::New();
+    output->CopyInformation(sourceImage);
+    output->SetRegions(sourceImage->GetLargestPossibleRegion());
+    output->Allocate();
+
+    itk::ImageRegionConstIterator<ImageType> inputIter(sourceImage, sourceImage->GetLargestPossibleRegion());
+    itk::ImageRegionIterator<ImageType> outputIter(output, output->GetLargestPossibleRegion());
+
+    for (std::size_t i = 0; !outputIter.IsAtEnd(); ++inputIter, ++outputIter, ++i)
+    {
+      if (mask[i] != 0)
+        outputIter.Set(1);
+      else if (binaryOutput || inputIter.Get() == 1)
+        outputIter.Set(0);
+      else
+        outputIter.Set(inputIter.Get());
+    }
+
+    mitk::CastToMitkImage(output, resultImage);
+  }
+}
+
 void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
                                             int factor,
                                             mitk::MorphologicalOperations::StructuralElementType structuralElement)
@@ -213,36 +363,15 @@ void mitk::MorphologicalOperations::itkClosing(
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
-  typedef itk::Image<TPixel, VDimension> ImageType;
-  typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
-  typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
-  typedef typename itk::BinaryMorphologicalClosingImageFilter<ImageType, ImageType, BallType> BallClosingFilterType;
-  typedef typename itk::BinaryMorphologicalClosingImageFilter<ImageType, ImageType, CrossType> CrossClosingFilterType;
+  unsigned int size[VDimension];
+  std::vector<unsigned char> mask = ExtractForeground(sourceImage, size);
 
-  if (structuralElementFlags & (Ball_Axial | Ball_Coronal | Ball_Sagital))
-  {
-    BallType ball = CreateStructuringElement<BallType>(structuralElementFlags, factor);
-
-    typename BallClosingFilterType::Pointer closingFilter = BallClosingFilterType::New();
-    closingFilter->SetKernel(ball);
-    closingFilter->SetInput(sourceImage);
-    closingFilter->SetForegroundValue(1);
-    closingFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(closingFilter->GetOutput(), resultImage);
-  }
-  else
-  {
-    CrossType cross = CreateStructuringElement<CrossType>(structuralElementFlags, factor);
+  // Outside of the image counts as foreground for the erosion, so the dilated mask does not
+  // shrink at the image border (comparable to the safe border of ITK's closing filter).
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, true);
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, false);
 
-    typename CrossClosingFilterType::Pointer closingFilter = CrossClosingFilterType::New();
-    closingFilter->SetKernel(cross);
-    closingFilter->SetInput(sourceImage);
-    closingFilter->SetForegroundValue(1);
-    closingFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(closingFilter->GetOutput(), resultImage);
-  }
+  CreateResultImage(sourceImage, mask, false, resultImage);
 }
 
 template <typename TPixel, unsigned int VDimension>
@@ -252,36 +381,12 @@ void mitk::MorphologicalOperations::itkErode(
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
-  typedef itk::Image<TPixel, VDimension> ImageType;
-  typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
-  typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
-  typedef typename itk::BinaryErodeImageFilter<ImageType, ImageType, BallType> BallErodeFilterType;
-  typedef typename itk::BinaryErodeImageFilter<ImageType, ImageType, CrossType> CrossErodeFilterType;
-
-  if (structuralElementFlags & (Ball_Axial | Ball_Coronal | Ball_Sagital))
-  {
-    BallType ball = CreateStructuringElement<BallType>(structuralElementFlags, factor);
+  unsigned int size[VDimension];
+  std::vector<unsigned char> mask = ExtractForeground(sourceImage, size);
 
-    typename BallErodeFilterType::Pointer erodeFilter = BallErodeFilterType::New();
-    erodeFilter->SetKernel(ball);
-    erodeFilter->SetInput(sourceImage);
-    erodeFilter->SetErodeValue(1);
-    erodeFilter->UpdateLargestPossibleRegion();
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, false);
 
-    mitk::CastToMitkImage(erodeFilter->GetOutput(), resultImage);
-  }
-  else
-  {
-    CrossType cross = CreateStructuringElement<CrossType>(structuralElementFlags, factor);
-
-    typename CrossErodeFilterType::Pointer erodeFilter = CrossErodeFilterType::New();
-    erodeFilter->SetKernel(cross);
-    erodeFilter->SetInput(sourceImage);
-    erodeFilter->SetErodeValue(1);
-    erodeFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(erodeFilter->GetOutput(), resultImage);
-  }
+  CreateResultImage(sourceImage, mask, false, resultImage);
 }
 
 template <typename TPixel, unsigned int VDimension>
@@ -291,36 +396,12 @@ void mitk::MorphologicalOperations::itkDilate(
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
-  typedef itk::Image<TPixel, VDimension> ImageType;
-  typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
-  typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
-  typedef typename itk::BinaryDilateImageFilter<ImageType, ImageType, BallType> BallDilateFilterType;
-  typedef typename itk::BinaryDilateImageFilter<ImageType, ImageType, CrossType> CrossDilateFilterType;
+  unsigned int size[VDimension];
+  std::vector<unsigned char> mask = ExtractForeground(sourceImage, size);
 
-  if (structuralElementFlags & (Ball_Axial | Ball_Coronal | Ball_Sagital))
-  {
-    BallType ball = CreateStructuringElement<BallType>(structuralElementFlags, factor);
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, true);
 
-    typename BallDilateFilterType::Pointer dilateFilter = BallDilateFilterType::New();
-    dilateFilter->SetKernel(ball);
-    dilateFilter->SetInput(sourceImage);
-    dilateFilter->SetDilateValue(1);
-    dilateFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(dilateFilter->GetOutput(), resultImage);
-  }
-  else
-  {
-    CrossType cross = CreateStructuringElement<CrossType>(structuralElementFlags, factor);
-
-    typename CrossDilateFilterType::Pointer dilateFilter = CrossDilateFilterType::New();
-    dilateFilter->SetKernel(cross);
-    dilateFilter->SetInput(sourceImage);
-    dilateFilter->SetDilateValue(1);
-    dilateFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(dilateFilter->GetOutput(), resultImage);
-  }
+  CreateResultImage(sourceImage, mask, false, resultImage);
 }
 
 template <typename TPixel, unsigned int VDimension>
@@ -330,38 +411,13 @@ void mitk::MorphologicalOperations::itkOpening(
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
-  typedef itk::Image<TPixel, VDimension> ImageType;
-  typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
-  typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
-  typedef typename itk::BinaryMorphologicalOpeningImageFilter<ImageType, ImageType, BallType> BallOpeningFiltertype;
-  typedef typename itk::BinaryMorphologicalOpeningImageFilter<ImageType, ImageType, CrossType> CrossOpeningFiltertype;
-
-  if (structuralElementFlags & (Ball_Axial | Ball_Coronal | Ball_Sagital))
-  {
-    BallType ball = CreateStructuringElement<BallType>(structuralElementFlags, factor);
-
-    typename BallOpeningFiltertype::Pointer openingFilter = BallOpeningFiltertype::New();
-    openingFilter->SetKernel(ball);
-    openingFilter->SetInput(sourceImage);
-    openingFilter->SetForegroundValue(1);
-    openingFilter->SetBackgroundValue(0);
-    openingFilter->UpdateLargestPossibleRegion();
-
-    mitk::CastToMitkImage(openingFilter->GetOutput(), resultImage);
-  }
-  else
-  {
-    CrossType cross = CreateStructuringElement<CrossType>(structuralElementFlags, factor);
+  unsigned int size[VDimension];
+  std::vector<unsigned char> mask = ExtractForeground(sourceImage, size);
 
-    typename CrossOpeningFiltertype::Pointer openingFilter = CrossOpeningFiltertype::New();
-    openingFilter->SetKernel(cross);
-    openingFilter->SetInput(sourceImage);
-    openingFilter->SetForegroundValue(1);
-    openingFilter->SetBackgroundValue(0);
-    openingFilter->UpdateLargestPossibleRegion();
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, false);
+  BinaryMorphology(mask, VDimension, size, factor, structuralElementFlags, true);
 
-    mitk::CastToMitkImage(openingFilter->GetOutput(), resultImage);
-  }
+  CreateResultImage(sourceImage, mask, true, resultImage);
 }
 
 template <typename TPixel, unsigned int VDimension>
@@ -378,37 +434,3 @@ void mitk::MorphologicalOperations::itkFillHoles(itk::Image<TPixel, VDimension>
 
   mitk::CastToMitkImage(fillHoleFilter->GetOutput(), resultImage);
 }
-
-template <class TStructuringElement>
-TStructuringElement  mitk::MorphologicalOperations::CreateStructuringElement(StructuralElementType structuralElementFlag, int factor)
-{
-  TStructuringElement strElem;
-  typename TStructuringElement::SizeType size;
-  size.Fill(0);
-  switch (structuralElementFlag)
-  {
-  case Ball_Axial:
-  case Cross_Axial:
-    size.SetElement(0, factor);
-    size.SetElement(1, factor);
-    break;
-  case Ball_Coronal:
-  case Cross_Coronal:
-    size.SetElement(0, factor);
-    size.SetElement(2, factor);
-    break;
-  case Ball_Sagital:
-  case Cross_Sagital:
-    size.SetElement(1, factor);
-    size.SetElement(2, factor);
-    break;
-  case Ball:
-  case Cross:
-    size.Fill(factor);
-    break;
-  }
-
-  strElem.SetRadius(size);
-  strElem.CreateStructuringElement();
-  return strElem;
-}
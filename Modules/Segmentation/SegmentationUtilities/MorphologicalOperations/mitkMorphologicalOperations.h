@@ -19,6 +19,13 @@ found in the LICENSE file.
 namespace mitk
 {
   /** \brief Encapsulates several morphological operations that can be performed on segmentations.
+    *
+    * Erosion, dilation, opening and closing are computed by thresholding exact Euclidean distance
+    * transforms (ball) or 1D distance transforms along the axes (cross) of the binary mask. Their
+    * cost is therefore linear in the number of voxels and independent of the radius (factor). Away
+    * from the image border, the results are the same as those of the ITK binary morphology filters
+    * with itk::BinaryBallStructuringElement or itk::BinaryCrossStructuringElement of that radius.
+    * FillHoles uses itk::BinaryFillholeImageFilter.
     */
   class MITKSEGMENTATION_EXPORT MorphologicalOperations
   {
@@ -50,11 +57,8 @@ namespace mitk
   private:
     MorphologicalOperations();
 
-    template <class TStructuringElement>
-    static TStructuringElement CreateStructuringElement(StructuralElementType structuralElementFlag, int factor);
-
     ///@{
-    /** \brief Perform morphological operation by using corresponding ITK filter.
+    /** \brief Perform morphological operation on the foreground (pixel value 1) of an ITK image (see class description).
      */
     template <typename TPixel, unsigned int VDimension>
     static void itkClosing(itk::Image<TPixel, VDimension> *sourceImage,
@@ -6,12 +6,16 @@ set(MODULE_TESTS
   mitkFeatureBasedEdgeDetectionFilterTest.cpp
   mitkImageToContourFilterTest.cpp
   mitkSegmentationInterpolationTest.cpp
+  mitkShapeBasedInterpolationAlgorithmTest.cpp
+  mitkSurfaceStampImageFilterTest.cpp
   mitkOverwriteSliceFilterTest.cpp
   mitkOverwriteSliceFilterObliquePlaneTest.cpp
 #  mitkToolManagerTest.cpp
   mitkToolManagerProviderTest.cpp
   mitkManualSegmentationToSurfaceFilterTest.cpp #new cpp unit style
   mitkToolInteractionTest.cpp
+  mitkMorphologicalOperationsTest.cpp
+  mitkBooleanOperationTest.cpp
 )
 
 set(MODULE_IMAGE_TESTS
@@ -0,0 +1,167 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkBooleanOperation.h>
+#include <mitkTestFixture.h>
+
+#include <mitkImageCast.h>
+#include <mitkImageReadAccessor.h>
+
+#include <itkAndImageFilter.h>
+#include <itkNotImageFilter.h>
+#include <itkOrImageFilter.h>
+
+#include <string>
+
+class mitkBooleanOperationTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBooleanOperationTestSuite);
+  MITK_TEST(OverlappingSegmentations_EqualVoxelwiseOperations);
+  MITK_TEST(DisjointSegmentations_EqualVoxelwiseOperations);
+  MITK_TEST(EmptySegmentation_EqualsVoxelwiseOperations);
+  MITK_TEST(UnsignedCharSegmentations_EqualVoxelwiseOperations);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<mitk::Label::PixelType, 3> ImageType;
+  typedef itk::Image<unsigned char, 3> UnsignedCharImageType;
+
+  /** Box [lower, upper] of ones, voxels on a diagonal pattern are left out */
+  template <class TImageType>
+  static typename TImageType::Pointer CreateSegmentation(const int *lower, const int *upper)
+  {
+    typename TImageType::RegionType region;
+    region.SetSize(0, 30);
+    region.SetSize(1, 25);
+    region.SetSize(2, 20);
+
+    typename TImageType::Pointer image = TImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(0);
+
+    auto *buffer = image->GetBufferPointer();
+    for (int z = 0; z < 20; ++z)
+      for (int y = 0; y < 25; ++y)
+        for (int x = 0; x < 30; ++x, ++buffer)
+        {
+          if (x >= lower[0] && x <= upper[0] && y >= lower[1] && y <= upper[1] && z >= lower[2] && z <= upper[2] &&
+              (x + 2 * y + 3 * z) % 7 != 0)
+            *buffer = 1;
+        }
+    return image;
+  }
+
+  /** The former implementation of the operations with ITK filters on the whole image */
+  static ImageType::Pointer ComputeWithFilters(mitk::BooleanOperation::Type type, ImageType *imageA, ImageType *imageB)
+  {
+    typedef itk::AndImageFilter<ImageType, ImageType> AndFilterType;
+    typedef itk::OrImageFilter<ImageType, ImageType> OrFilterType;
+    typedef itk::NotImageFilter<ImageType, ImageType> NotFilterType;
+
+    if (type == mitk::BooleanOperation::Union)
+    {
+      auto orFilter = OrFilterType::New();
+      orFilter->SetInput1(imageA);
+      orFilter->SetInput2(imageB);
+      orFilter->UpdateLargestPossibleRegion();
+      return orFilter->GetOutput();
+    }
+
+    auto andFilter = AndFilterType::New();
+    andFilter->SetInput1(imageA);
+    auto notFilter = NotFilterType::New();
+    if (type == mitk::BooleanOperation::Difference)
+    {
+      notFilter->SetInput(imageB);
+      andFilter->SetInput2(notFilter->GetOutput());
+    }
+    else
+    {
+      andFilter->SetInput2(imageB);
+    }
+    andFilter->UpdateLargestPossibleRegion();
+    return andFilter->GetOutput();
+  }
+
+  template <class TImageType>
+  static void CheckOperations(TImageType *itkImageA, TImageType *itkImageB)
+  {
+    mitk::Image::Pointer segmentationA;
+    mitk::Image::Pointer segmentationB;
+    mitk::CastToMitkImage(itkImageA, segmentationA);
+    mitk::CastToMitkImage(itkImageB, segmentationB);
+
+    ImageType::Pointer imageA;
+    ImageType::Pointer imageB;
+    mitk::CastToItkImage(segmentationA, imageA);
+    mitk::CastToItkImage(segmentationB, imageB);
+
+    for (auto type : { mitk::BooleanOperation::Difference, mitk::BooleanOperation::Intersection, mitk::BooleanOperation::Union })
+    {
+      mitk::BooleanOperation operation(type, segmentationA, segmentationB);
+      mitk::LabelSetImage::Pointer result = operation.GetResult();
+      ImageType::Pointer expected = ComputeWithFilters(type, imageA, imageB);
+
+      mitk::ImageReadAccessor accessor(result.GetPointer());
+      const auto *resultBuffer = static_cast<const mitk::Label::PixelType *>(accessor.GetData());
+      const auto *expectedBuffer = expected->GetBufferPointer();
+      const std::size_t numberOfVoxels = expected->GetLargestPossibleRegion().GetNumberOfPixels();
+      for (std::size_t i = 0; i < numberOfVoxels; ++i)
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Operation " + std::to_string(type), expectedBuffer[i], resultBuffer[i]);
+    }
+  }
+
+public:
+  void OverlappingSegmentations_EqualVoxelwiseOperations()
+  {
+    const int lowerA[3] = { 2, 3, 4 }, upperA[3] = { 18, 15, 12 };
+    const int lowerB[3] = { 10, 8, 1 }, upperB[3] = { 29, 24, 9 };
+    auto imageA = CreateSegmentation<ImageType>(lowerA, upperA);
+    auto imageB = CreateSegmentation<ImageType>(lowerB, upperB);
+    CheckOperations<ImageType>(imageA, imageB);
+    CheckOperations<ImageType>(imageB, imageA);
+  }
+
+  void DisjointSegmentations_EqualVoxelwiseOperations()
+  {
+    const int lowerA[3] = { 0, 0, 0 }, upperA[3] = { 8, 10, 5 };
+    const int lowerB[3] = { 15, 12, 10 }, upperB[3] = { 25, 20, 19 };
+    auto imageA = CreateSegmentation<ImageType>(lowerA, upperA);
+    auto imageB = CreateSegmentation<ImageType>(lowerB, upperB);
+    CheckOperations<ImageType>(imageA, imageB);
+    CheckOperations<ImageType>(imageB, imageA);
+  }
+
+  void EmptySegmentation_EqualsVoxelwiseOperations()
+  {
+    const int lowerA[3] = { 5, 5, 5 }, upperA[3] = { 20, 20, 15 };
+    const int lowerB[3] = { 1, 1, 1 }, upperB[3] = { 0, 0, 0 };
+    auto imageA = CreateSegmentation<ImageType>(lowerA, upperA);
+    auto imageB = CreateSegmentation<ImageType>(lowerB, upperB);
+    CheckOperations<ImageType>(imageA, imageB);
+    CheckOperations<ImageType>(imageB, imageA);
+    CheckOperations<ImageType>(imageB, imageB);
+  }
+
+  void UnsignedCharSegmentations_EqualVoxelwiseOperations()
+  {
+    const int lowerA[3] = { 2, 3, 4 }, upperA[3] = { 18, 15, 12 };
+    const int lowerB[3] = { 10, 8, 1 }, upperB[3] = { 29, 24, 9 };
+    auto imageA = CreateSegmentation<UnsignedCharImageType>(lowerA, upperA);
+    auto imageB = CreateSegmentation<UnsignedCharImageType>(lowerB, upperB);
+    CheckOperations<UnsignedCharImageType>(imageA, imageB);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBooleanOperation)
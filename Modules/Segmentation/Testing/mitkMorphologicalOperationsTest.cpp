@@ -0,0 +1,265 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkMorphologicalOperations.h>
+#include <mitkTestFixture.h>
+
+#include <mitkImageCast.h>
+
+#include <itkBinaryBallStructuringElement.h>
+#include <itkBinaryCrossStructuringElement.h>
+#include <itkBinaryDilateImageFilter.h>
+#include <itkBinaryErodeImageFilter.h>
+#include <itkBinaryMorphologicalClosingImageFilter.h>
+#include <itkBinaryMorphologicalOpeningImageFilter.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class mitkMorphologicalOperationsTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMorphologicalOperationsTestSuite);
+  MITK_TEST(Dilate_Ball_EqualsStructuringElementFilter);
+  MITK_TEST(Dilate_Cross_EqualsStructuringElementFilter);
+  MITK_TEST(Erode_Ball_EqualsStructuringElementFilter);
+  MITK_TEST(Erode_Cross_EqualsStructuringElementFilter);
+  MITK_TEST(Closing_EqualsStructuringElementFilter);
+  MITK_TEST(Opening_EqualsStructuringElementFilter);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<unsigned char, 3> ImageType;
+  typedef itk::BinaryBallStructuringElement<unsigned char, 3> BallType;
+  typedef itk::BinaryCrossStructuringElement<unsigned char, 3> CrossType;
+  typedef mitk::MorphologicalOperations::StructuralElementType StructuralElementType;
+  typedef std::function<void(mitk::Image::Pointer &, int, StructuralElementType)> OperationType;
+
+  ImageType::Pointer m_Segmentation;
+
+  /** Same structuring elements as MorphologicalOperations used to pass to the ITK filters */
+  template <class TStructuringElement>
+  static TStructuringElement CreateStructuringElement(StructuralElementType structuralElement, int factor)
+  {
+    typename TStructuringElement::SizeType size;
+    size.Fill(0);
+    switch (structuralElement)
+    {
+      case mitk::MorphologicalOperations::Ball_Axial:
+      case mitk::MorphologicalOperations::Cross_Axial:
+        size[0] = size[1] = factor;
+        break;
+      case mitk::MorphologicalOperations::Ball_Coronal:
+      case mitk::MorphologicalOperations::Cross_Coronal:
+        size[0] = size[2] = factor;
+        break;
+      case mitk::MorphologicalOperations::Ball_Sagital:
+      case mitk::MorphologicalOperations::Cross_Sagital:
+        size[1] = size[2] = factor;
+        break;
+      default:
+        size.Fill(factor);
+        break;
+    }
+
+    TStructuringElement element;
+    element.SetRadius(size);
+    element.CreateStructuringElement();
+    return element;
+  }
+
+  template <class TStructuringElement>
+  static ImageType::Pointer DilateWithFilter(ImageType *image, const TStructuringElement &element)
+  {
+    typedef itk::BinaryDilateImageFilter<ImageType, ImageType, TStructuringElement> FilterType;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetKernel(element);
+    filter->SetInput(image);
+    filter->SetDilateValue(1);
+    filter->UpdateLargestPossibleRegion();
+    return filter->GetOutput();
+  }
+
+  template <class TStructuringElement>
+  static ImageType::Pointer ErodeWithFilter(ImageType *image, const TStructuringElement &element)
+  {
+    typedef itk::BinaryErodeImageFilter<ImageType, ImageType, TStructuringElement> FilterType;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetKernel(element);
+    filter->SetInput(image);
+    filter->SetErodeValue(1);
+    filter->UpdateLargestPossibleRegion();
+    return filter->GetOutput();
+  }
+
+  template <class TStructuringElement>
+  static ImageType::Pointer CloseWithFilter(ImageType *image, const TStructuringElement &element)
+  {
+    typedef itk::BinaryMorphologicalClosingImageFilter<ImageType, ImageType, TStructuringElement> FilterType;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetKernel(element);
+    filter->SetInput(image);
+    filter->SetForegroundValue(1);
+    filter->UpdateLargestPossibleRegion();
+    return filter->GetOutput();
+  }
+
+  template <class TStructuringElement>
+  static ImageType::Pointer OpenWithFilter(ImageType *image, const TStructuringElement &element)
+  {
+    typedef itk::BinaryMorphologicalOpeningImageFilter<ImageType, ImageType, TStructuringElement> FilterType;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetKernel(element);
+    filter->SetInput(image);
+    filter->SetForegroundValue(1);
+    filter->SetBackgroundValue(0);
+    filter->UpdateLargestPossibleRegion();
+    return filter->GetOutput();
+  }
+
+  /** Applies the operation to a copy of the segmentation and compares the result voxel by voxel */
+  void CheckOperation(const OperationType &operation, StructuralElementType structuralElement, int factor, ImageType *expected)
+  {
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(m_Segmentation, image);
+    operation(image, factor, structuralElement);
+
+    ImageType::Pointer result;
+    mitk::CastToItkImage(image, result);
+
+    const std::string message = "Element " + std::to_string(structuralElement) + ", factor " + std::to_string(factor);
+    const std::size_t numberOfVoxels = m_Segmentation->GetLargestPossibleRegion().GetNumberOfPixels();
+    const unsigned char *resultBuffer = result->GetBufferPointer();
+    const unsigned char *expectedBuffer = expected->GetBufferPointer();
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(message, static_cast<int>(expectedBuffer[i]), static_cast<int>(resultBuffer[i]));
+    }
+  }
+
+  static std::vector<StructuralElementType> GetBalls()
+  {
+    return { mitk::MorphologicalOperations::Ball,
+             mitk::MorphologicalOperations::Ball_Axial,
+             mitk::MorphologicalOperations::Ball_Coronal,
+             mitk::MorphologicalOperations::Ball_Sagital };
+  }
+
+  static std::vector<StructuralElementType> GetCrosses()
+  {
+    return { mitk::MorphologicalOperations::Cross,
+             mitk::MorphologicalOperations::Cross_Axial,
+             mitk::MorphologicalOperations::Cross_Coronal,
+             mitk::MorphologicalOperations::Cross_Sagital };
+  }
+
+public:
+  /** A sphere and a box with holes, a thin line and single voxels, at least 9 voxels away from the image border,
+      so that no operation below reaches the border */
+  void setUp() override
+  {
+    ImageType::RegionType region;
+    region.SetSize(0, 34);
+    region.SetSize(1, 32);
+    region.SetSize(2, 30);
+
+    m_Segmentation = ImageType::New();
+    m_Segmentation->SetRegions(region);
+    m_Segmentation->Allocate();
+    m_Segmentation->FillBuffer(0);
+
+    unsigned char *buffer = m_Segmentation->GetBufferPointer();
+    for (int z = 0; z < 30; ++z)
+      for (int y = 0; y < 32; ++y)
+        for (int x = 0; x < 34; ++x, ++buffer)
+        {
+          const int dx = x - 14, dy = y - 15, dz = z - 14;
+          const bool sphere = dx * dx + dy * dy + dz * dz <= 25;
+          const bool box = x >= 17 && x <= 24 && y >= 10 && y <= 20 && z >= 9 && z <= 19 && (x * 7 + y * 13 + z * 5) % 11 != 0;
+          const bool line = y == 21 && z == 12 && x >= 9 && x <= 22;
+          const bool single = (x == 10 && y == 10 && z == 20) || (x == 22 && y == 22 && z == 9);
+          *buffer = (sphere || box || line || single) ? 1 : 0;
+        }
+  }
+
+  void tearDown() override
+  {
+    m_Segmentation = nullptr;
+  }
+
+  void Dilate_Ball_EqualsStructuringElementFilter()
+  {
+    for (StructuralElementType ball : GetBalls())
+      for (int factor : { 1, 2, 4 })
+      {
+        auto expected = DilateWithFilter(m_Segmentation, CreateStructuringElement<BallType>(ball, factor));
+        CheckOperation(&mitk::MorphologicalOperations::Dilate, ball, factor, expected);
+      }
+  }
+
+  void Dilate_Cross_EqualsStructuringElementFilter()
+  {
+    for (StructuralElementType cross : GetCrosses())
+      for (int factor : { 1, 3 })
+      {
+        auto expected = DilateWithFilter(m_Segmentation, CreateStructuringElement<CrossType>(cross, factor));
+        CheckOperation(&mitk::MorphologicalOperations::Dilate, cross, factor, expected);
+      }
+  }
+
+  void Erode_Ball_EqualsStructuringElementFilter()
+  {
+    for (StructuralElementType ball : GetBalls())
+      for (int factor : { 1, 2, 3 })
+      {
+        auto expected = ErodeWithFilter(m_Segmentation, CreateStructuringElement<BallType>(ball, factor));
+        CheckOperation(&mitk::MorphologicalOperations::Erode, ball, factor, expected);
+      }
+  }
+
+  void Erode_Cross_EqualsStructuringElementFilter()
+  {
+    for (StructuralElementType cross : GetCrosses())
+      for (int factor : { 1, 2 })
+      {
+        auto expected = ErodeWithFilter(m_Segmentation, CreateStructuringElement<CrossType>(cross, factor));
+        CheckOperation(&mitk::MorphologicalOperations::Erode, cross, factor, expected);
+      }
+  }
+
+  void Closing_EqualsStructuringElementFilter()
+  {
+    for (int factor : { 1, 2, 4 })
+    {
+      auto expectedBall = CloseWithFilter(m_Segmentation, CreateStructuringElement<BallType>(mitk::MorphologicalOperations::Ball, factor));
+      CheckOperation(&mitk::MorphologicalOperations::Closing, mitk::MorphologicalOperations::Ball, factor, expectedBall);
+
+      auto expectedCross = CloseWithFilter(m_Segmentation, CreateStructuringElement<CrossType>(mitk::MorphologicalOperations::Cross_Axial, factor));
+      CheckOperation(&mitk::MorphologicalOperations::Closing, mitk::MorphologicalOperations::Cross_Axial, factor, expectedCross);
+    }
+  }
+
+  void Opening_EqualsStructuringElementFilter()
+  {
+    for (int factor : { 1, 2 })
+    {
+      auto expectedBall = OpenWithFilter(m_Segmentation, CreateStructuringElement<BallType>(mitk::MorphologicalOperations::Ball_Sagital, factor));
+      CheckOperation(&mitk::MorphologicalOperations::Opening, mitk::MorphologicalOperations::Ball_Sagital, factor, expectedBall);
+
+      auto expectedCross = OpenWithFilter(m_Segmentation, CreateStructuringElement<CrossType>(mitk::MorphologicalOperations::Cross, factor));
+      CheckOperation(&mitk::MorphologicalOperations::Opening, mitk::MorphologicalOperations::Cross, factor, expectedCross);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMorphologicalOperations)
@@ -31,6 +31,7 @@ class mitkSegmentationInterpolationTestSuite : public mitk::TestFixture
   MITK_TEST(Equal_Axial_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Frontal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Sagittal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
+  MITK_TEST(Interpolate_ChangedBoundingSlice_UsesChangedSlice);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -144,6 +145,41 @@ private:
     }
   }
 
+  /** Fills a square of (2 * halfWidth + 1)^2 pixels around the center point in the given axial slice */
+  void FillAxialSquare(unsigned int slice, int halfWidth, mitk::Tool::DefaultSegmentationDataType value)
+  {
+    mitk::ImagePixelWriteAccessor<mitk::Tool::DefaultSegmentationDataType, 3> writeAccessor(m_SegmentationImage);
+    itk::Index<3> currentPoint;
+    currentPoint[2] = slice;
+    for (int i = -halfWidth; i <= halfWidth; ++i)
+    {
+      for (int j = -halfWidth; j <= halfWidth; ++j)
+      {
+        currentPoint[0] = m_CenterPoint[0] + i;
+        currentPoint[1] = m_CenterPoint[1] + j;
+        writeAccessor.SetPixelByIndexSafe(currentPoint, value);
+      }
+    }
+  }
+
+  static unsigned int CountSegmentedPixels(mitk::Image *slice)
+  {
+    mitk::ImagePixelReadAccessor<mitk::Tool::DefaultSegmentationDataType, 2> readAccess(slice);
+    unsigned int count = 0;
+    itk::Index<2> index;
+    for (unsigned int y = 0; y < slice->GetDimension(1); ++y)
+    {
+      for (unsigned int x = 0; x < slice->GetDimension(0); ++x)
+      {
+        index[0] = x;
+        index[1] = y;
+        if (readAccess.GetPixelByIndex(index) != 0)
+          ++count;
+      }
+    }
+    return count;
+  }
+
   mitk::Image::Pointer m_ReferenceImage;
   mitk::Image::Pointer m_SegmentationImage;
   itk::Index<3> m_CenterPoint;
@@ -199,6 +235,35 @@ public:
     mitk::SliceNavigationController::ViewDirection viewDirection = mitk::SliceNavigationController::Sagittal;
     testRoutine(viewDirection);
   }
+
+  /** The distance maps of the bounding slices are cached, a changed bounding slice has to be used nevertheless */
+  void Interpolate_ChangedBoundingSlice_UsesChangedSlice()
+  {
+    FillAxialSquare(m_CenterPoint[2] - 1, 1, 1);
+    FillAxialSquare(m_CenterPoint[2] + 1, 1, 1);
+
+    m_InterpolationController->SetSegmentationVolume(m_SegmentationImage);
+    m_InterpolationController->SetReferenceVolume(m_ReferenceImage);
+
+    mitk::SliceNavigationController::Pointer navigationController = mitk::SliceNavigationController::New();
+    navigationController->SetInputWorldTimeGeometry(m_SegmentationImage->GetTimeGeometry());
+    navigationController->Update(mitk::SliceNavigationController::Axial);
+    mitk::Point3D pointMM;
+    m_SegmentationImage->GetTimeGeometry()->GetGeometryForTimeStep(0)->IndexToWorld(m_CenterPoint, pointMM);
+    navigationController->SelectSliceByPoint(pointMM);
+    auto plane = navigationController->GetCurrentPlaneGeometry();
+
+    // two 3x3 squares give a 3x3 square
+    mitk::Image::Pointer interpolationResult = m_InterpolationController->Interpolate(2, m_CenterPoint[2], plane, 0);
+    CPPUNIT_ASSERT_EQUAL(9u, CountSegmentedPixels(interpolationResult));
+
+    // a 3x3 and a 7x7 square give a 5x5 square
+    FillAxialSquare(m_CenterPoint[2] + 1, 3, 1);
+    m_SegmentationImage->Modified();
+
+    interpolationResult = m_InterpolationController->Interpolate(2, m_CenterPoint[2], plane, 0);
+    CPPUNIT_ASSERT_EQUAL(25u, CountSegmentedPixels(interpolationResult));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkSegmentationInterpolation)
@@ -0,0 +1,242 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <mitkEuclideanDistanceTransform.h>
+#include <mitkExceptionMacro.h>
+#include <mitkImageCast.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkShapeBasedInterpolationAlgorithm.h>
+#include <mitkTool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+class mitkShapeBasedInterpolationAlgorithmTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShapeBasedInterpolationAlgorithmTestSuite);
+  MITK_TEST(ComputeSquared_2D_EqualsBruteForce);
+  MITK_TEST(Interpolate_RandomShapes_EqualsBruteForceSignedDistances);
+  MITK_TEST(Interpolate_CachedDistanceMaps_NoSlicesRequired);
+  MITK_TEST(Interpolate_ClearedCache_Throws);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::Tool::DefaultSegmentationDataType PixelType;
+  typedef itk::Image<PixelType, 2> SliceType;
+
+  /** Odd sizes and an anisotropic spacing, the spacings are powers of two, so all squared distances are exact */
+  static const unsigned int SizeX = 23;
+  static const unsigned int SizeY = 17;
+  const double m_Spacing[2] = {1.0, 0.5};
+
+  /** Random binary mask of SizeX * SizeY pixels with about the given fraction of set pixels */
+  static std::vector<bool> CreateRandomMask(std::mt19937 &generator, unsigned int percentage)
+  {
+    std::vector<bool> mask(SizeX * SizeY);
+    for (std::size_t i = 0; i < mask.size(); ++i)
+      mask[i] = generator() % 100 < percentage;
+    return mask;
+  }
+
+  /** Squared distance of every pixel to the nearest pixel with the given mask value */
+  std::vector<float> ComputeBruteForceSquaredDistances(const std::vector<bool> &mask, bool featureValue) const
+  {
+    std::vector<float> result(mask.size(), mitk::EuclideanDistanceTransform::Infinity);
+    for (unsigned int y = 0; y < SizeY; ++y)
+      for (unsigned int x = 0; x < SizeX; ++x)
+        for (unsigned int featureY = 0; featureY < SizeY; ++featureY)
+          for (unsigned int featureX = 0; featureX < SizeX; ++featureX)
+          {
+            if (mask[featureY * SizeX + featureX] != featureValue)
+              continue;
+
+            const double dx = (static_cast<double>(x) - featureX) * m_Spacing[0];
+            const double dy = (static_cast<double>(y) - featureY) * m_Spacing[1];
+            float &distance = result[y * SizeX + x];
+            distance = std::min(distance, static_cast<float>(dx * dx + dy * dy));
+          }
+    return result;
+  }
+
+  mitk::Image::Pointer CreateSlice(const std::vector<bool> &mask) const
+  {
+    SliceType::RegionType region;
+    region.SetSize(0, SizeX);
+    region.SetSize(1, SizeY);
+
+    SliceType::Pointer itkSlice = SliceType::New();
+    itkSlice->SetRegions(region);
+    itkSlice->SetSpacing(m_Spacing);
+    itkSlice->Allocate();
+
+    PixelType *buffer = itkSlice->GetBufferPointer();
+    for (std::size_t i = 0; i < mask.size(); ++i)
+      buffer[i] = mask[i] ? 1 : 0;
+
+    mitk::Image::Pointer slice;
+    mitk::CastToMitkImage(itkSlice, slice);
+    return slice;
+  }
+
+  static std::vector<bool> ReadSlice(mitk::Image *slice)
+  {
+    mitk::ImagePixelReadAccessor<PixelType, 2> accessor(slice);
+    std::vector<bool> mask(SizeX * SizeY);
+    itk::Index<2> index;
+    for (unsigned int y = 0; y < SizeY; ++y)
+      for (unsigned int x = 0; x < SizeX; ++x)
+      {
+        index[0] = x;
+        index[1] = y;
+        mask[y * SizeX + x] = accessor.GetPixelByIndex(index) != 0;
+      }
+    return mask;
+  }
+
+  /** Signed distance map as described by ShapeBasedInterpolationAlgorithm: negative inside, positive outside */
+  std::vector<float> ComputeBruteForceSignedDistances(const std::vector<bool> &mask) const
+  {
+    const std::vector<float> outsideDistance = ComputeBruteForceSquaredDistances(mask, true);
+    const std::vector<float> insideDistance = ComputeBruteForceSquaredDistances(mask, false);
+
+    std::vector<float> result(mask.size());
+    for (std::size_t i = 0; i < mask.size(); ++i)
+      result[i] = mask[i] ? -std::sqrt(insideDistance[i]) : std::sqrt(outsideDistance[i]);
+    return result;
+  }
+
+public:
+  void ComputeSquared_2D_EqualsBruteForce()
+  {
+    std::mt19937 generator(42);
+    const unsigned int size[2] = {SizeX, SizeY};
+
+    // sparse features give long distances, the empty mask checks that Infinity is kept
+    for (unsigned int percentage : {0, 1, 5, 30, 90})
+    {
+      const std::vector<bool> mask = CreateRandomMask(generator, percentage);
+
+      std::vector<float> values(mask.size());
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        values[i] = mask[i] ? 0.0f : mitk::EuclideanDistanceTransform::Infinity;
+
+      mitk::EuclideanDistanceTransform::ComputeSquared(values.data(), 2, size, m_Spacing);
+
+      const std::vector<float> expected = ComputeBruteForceSquaredDistances(mask, true);
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Pixel " + std::to_string(i) + ", " + std::to_string(percentage) + "% features",
+                                     expected[i],
+                                     values[i]);
+    }
+  }
+
+  void Interpolate_RandomShapes_EqualsBruteForceSignedDistances()
+  {
+    std::mt19937 generator(7);
+    const std::vector<bool> lowerMask = CreateRandomMask(generator, 20);
+    const std::vector<bool> upperMask = CreateRandomMask(generator, 40);
+
+    const std::vector<float> lowerDistances = ComputeBruteForceSignedDistances(lowerMask);
+    const std::vector<float> upperDistances = ComputeBruteForceSignedDistances(upperMask);
+
+    mitk::ShapeBasedInterpolationAlgorithm::Pointer algorithm = mitk::ShapeBasedInterpolationAlgorithm::New();
+    const unsigned int lowerIndex = 3;
+    const unsigned int upperIndex = 11;
+
+    // every slice of the gap selects a different level set of the interpolated distances
+    for (unsigned int requestedIndex = lowerIndex + 1; requestedIndex < upperIndex; ++requestedIndex)
+    {
+      mitk::Image::Pointer result = algorithm->Interpolate(CreateSlice(lowerMask),
+                                                           lowerIndex,
+                                                           CreateSlice(upperMask),
+                                                           upperIndex,
+                                                           requestedIndex,
+                                                           2,
+                                                           CreateSlice(std::vector<bool>(SizeX * SizeY)),
+                                                           0,
+                                                           nullptr);
+      const std::vector<bool> resultMask = ReadSlice(result);
+
+      const float ratio = (float)(requestedIndex - lowerIndex) / (float)(upperIndex - lowerIndex);
+      for (std::size_t i = 0; i < resultMask.size(); ++i)
+      {
+        const float expected = (1.0f - ratio) * lowerDistances[i] + ratio * upperDistances[i];
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Pixel " + std::to_string(i) + " of slice " + std::to_string(requestedIndex),
+                                     expected <= 0,
+                                     static_cast<bool>(resultMask[i]));
+      }
+    }
+  }
+
+  void Interpolate_CachedDistanceMaps_NoSlicesRequired()
+  {
+    std::mt19937 generator(3);
+    const std::vector<bool> lowerMask = CreateRandomMask(generator, 20);
+    const std::vector<bool> upperMask = CreateRandomMask(generator, 20);
+
+    mitk::ShapeBasedInterpolationAlgorithm::Pointer algorithm = mitk::ShapeBasedInterpolationAlgorithm::New();
+    CPPUNIT_ASSERT(!algorithm->IsDistanceMapCached(0, 2, 0));
+
+    mitk::Image::Pointer expected = algorithm->Interpolate(CreateSlice(lowerMask),
+                                                           0,
+                                                           CreateSlice(upperMask),
+                                                           4,
+                                                           2,
+                                                           2,
+                                                           CreateSlice(std::vector<bool>(SizeX * SizeY)),
+                                                           0,
+                                                           nullptr);
+
+    CPPUNIT_ASSERT(algorithm->IsDistanceMapCached(0, 2, 0));
+    CPPUNIT_ASSERT(algorithm->IsDistanceMapCached(0, 2, 4));
+    CPPUNIT_ASSERT(!algorithm->IsDistanceMapCached(1, 2, 0));
+    CPPUNIT_ASSERT(!algorithm->IsDistanceMapCached(0, 1, 0));
+
+    mitk::Image::Pointer result = algorithm->Interpolate(
+      nullptr, 0, nullptr, 4, 2, 2, CreateSlice(std::vector<bool>(SizeX * SizeY)), 0, nullptr);
+
+    CPPUNIT_ASSERT(ReadSlice(expected) == ReadSlice(result));
+  }
+
+  void Interpolate_ClearedCache_Throws()
+  {
+    std::mt19937 generator(5);
+    const std::vector<bool> mask = CreateRandomMask(generator, 20);
+
+    mitk::ShapeBasedInterpolationAlgorithm::Pointer algorithm = mitk::ShapeBasedInterpolationAlgorithm::New();
+    algorithm->Interpolate(CreateSlice(mask),
+                           0,
+                           CreateSlice(mask),
+                           2,
+                           1,
+                           2,
+                           CreateSlice(std::vector<bool>(SizeX * SizeY)),
+                           0,
+                           nullptr);
+
+    algorithm->ClearDistanceMapCache();
+    CPPUNIT_ASSERT(!algorithm->IsDistanceMapCached(0, 2, 0));
+    CPPUNIT_ASSERT_THROW(
+      algorithm->Interpolate(nullptr, 0, nullptr, 2, 1, 2, CreateSlice(std::vector<bool>(SizeX * SizeY)), 0, nullptr),
+      mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShapeBasedInterpolationAlgorithm)
@@ -0,0 +1,114 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkSurfaceStampImageFilter.h>
+
+#include <algorithm>
+
+class mitkSurfaceStampImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSurfaceStampImageFilterTestSuite);
+  MITK_TEST(Stamp_KeepBackground_OutsideKeepsInputValues);
+  MITK_TEST(Stamp_OverwriteBackground_OutsideIsBackground);
+  MITK_TEST(Stamp_BinaryOutput_IsMask);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Surface::Pointer m_Surface;
+  mitk::Image::Pointer m_Image;
+
+  /** Index of a voxel outside and one inside of the ball */
+  itk::Index<3> m_OutsideIndex;
+  itk::Index<3> m_InsideIndex;
+
+  mitk::Image::Pointer Stamp(bool makeOutputBinary, bool overwriteBackground)
+  {
+    mitk::SurfaceStampImageFilter::Pointer filter = mitk::SurfaceStampImageFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetSurface(m_Surface);
+    filter->SetMakeOutputBinary(makeOutputBinary);
+    filter->SetOverwriteBackground(overwriteBackground);
+    filter->SetForegroundValue(100);
+    filter->SetBackgroundValue(-5);
+    filter->Update();
+
+    return filter->GetOutput();
+  }
+
+public:
+  void setUp() override
+  {
+    m_Surface = mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath("ball.stl"));
+
+    // image as in mitkSurfaceToImageFilterTest, the ball fills most of it
+    unsigned int dims[3] = {32, 32, 32};
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dims);
+    m_Image->SetOrigin(m_Surface->GetGeometry()->GetOrigin());
+    m_Image->GetGeometry()->SetIndexToWorldTransform(m_Surface->GetGeometry()->GetIndexToWorldTransform());
+
+    mitk::ImageWriteAccessor accessor(m_Image);
+    auto *data = static_cast<short *>(accessor.GetData());
+    std::fill_n(data, 32 * 32 * 32, 7);
+
+    m_OutsideIndex.Fill(0);
+    m_InsideIndex.Fill(15);
+  }
+
+  void tearDown() override
+  {
+    m_Surface = nullptr;
+    m_Image = nullptr;
+  }
+
+  void Stamp_KeepBackground_OutsideKeepsInputValues()
+  {
+    mitk::Image::Pointer output = Stamp(false, false);
+
+    mitk::ImagePixelReadAccessor<short, 3> outputReader(output);
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(7), outputReader.GetPixelByIndex(m_OutsideIndex));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(100), outputReader.GetPixelByIndex(m_InsideIndex));
+
+    // the input image is not changed
+    mitk::ImagePixelReadAccessor<short, 3> inputReader(m_Image);
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(7), inputReader.GetPixelByIndex(m_InsideIndex));
+  }
+
+  void Stamp_OverwriteBackground_OutsideIsBackground()
+  {
+    mitk::Image::Pointer output = Stamp(false, true);
+
+    mitk::ImagePixelReadAccessor<short, 3> outputReader(output);
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(-5), outputReader.GetPixelByIndex(m_OutsideIndex));
+    CPPUNIT_ASSERT_EQUAL(static_cast<short>(100), outputReader.GetPixelByIndex(m_InsideIndex));
+  }
+
+  void Stamp_BinaryOutput_IsMask()
+  {
+    mitk::Image::Pointer output = Stamp(true, false);
+    CPPUNIT_ASSERT(output->GetPixelType().GetComponentType() == itk::ImageIOBase::UCHAR);
+
+    mitk::ImagePixelReadAccessor<unsigned char, 3> outputReader(output);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0), outputReader.GetPixelByIndex(m_OutsideIndex));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(1), outputReader.GetPixelByIndex(m_InsideIndex));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSurfaceStampImageFilter)
@@ -24,6 +24,11 @@ found in the LICENSE file.
 #include <itkMedianImageFilter.h>
 #include <mitkImagePixelReadAccessor.h>
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
 
 /**Documentation
 *  \brief test for the class "ToFCompositeFilter".
@@ -318,6 +323,60 @@ int mitkToFCompositeFilterTest(int /* argc */, char* /*argv*/[])
 //  MITK_TEST_CONDITION_REQUIRED(pipelineSuccess,"Test all filters in pipeline");
 
 
+//-------------------------------------------------------------------------------------------------------
+
+  //Apply temporal median and average filter to a stream of frames
+
+  compositeFilter->SetApplyThresholdFilter(false);
+  compositeFilter->SetApplyMedianFilter(false);
+  compositeFilter->SetApplyBilateralFilter(false);
+  compositeFilter->SetApplyTemporalMedianFilter(true);
+  const unsigned int temporalFilterNumOfFrames = 5;
+  compositeFilter->SetTemporalMedianFilterParameter(temporalFilterNumOfFrames);
+
+  std::vector<ItkImageType_2D::Pointer> frames;
+  bool temporalMedianCorrect = true;
+  bool temporalAverageCorrect = true;
+  for (unsigned int frame = 0; frame < 12; ++frame)
+  {
+    // the average filter takes precedence over the median filter and uses the same frame buffer
+    compositeFilter->SetApplyAverageFilter(frame >= 8);
+
+    ItkImageType_2D::Pointer itkFrame = ItkImageType_2D::New();
+    mitk::Image::Pointer mitkFrame = mitk::Image::New();
+    CreateRandomDistanceImage(100,100,itkFrame,mitkFrame);
+    frames.push_back(itkFrame);
+    compositeFilter->SetInput(mitkFrame);
+    mitkOutputImage = compositeFilter->GetOutput();
+    mitkOutputImage->Update();
+
+    mitk::ImagePixelReadAccessor<ToFScalarType,2> outputAccess(mitkOutputImage, mitkOutputImage->GetSliceData());
+    const std::size_t firstFrame = frames.size() > temporalFilterNumOfFrames ? frames.size() - temporalFilterNumOfFrames : 0;
+    ItkImageRegionIteratorType2D imageIterator(itkFrame,itkFrame->GetLargestPossibleRegion());
+    for (imageIterator.GoToBegin(); !imageIterator.IsAtEnd(); ++imageIterator)
+    {
+      std::vector<ToFScalarType> values;
+      for (std::size_t i = firstFrame; i < frames.size(); ++i)
+      {
+        values.push_back(frames[i]->GetPixel(imageIterator.GetIndex()));
+      }
+      const ToFScalarType outputValue = outputAccess.GetPixelByIndex(imageIterator.GetIndex());
+      if (frame >= 8)
+      {
+        const double average = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        temporalAverageCorrect = temporalAverageCorrect && std::abs(outputValue - average) < 1e-3;
+      }
+      else
+      {
+        std::sort(values.begin(), values.end());
+        temporalMedianCorrect = temporalMedianCorrect && outputValue == values[(values.size() - 1) / 2];
+      }
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(temporalMedianCorrect, "Test temporal median filter");
+  MITK_TEST_CONDITION_REQUIRED(temporalAverageCorrect, "Test temporal average filter");
+  compositeFilter->SetApplyAverageFilter(false);
+
 //-------------------------------------------------------------------------------------------------------
 
   //Check set/get functions
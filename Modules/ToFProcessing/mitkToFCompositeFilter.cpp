@@ -17,23 +17,75 @@ found in the LICENSE file.
 #include <itkImage.h>
 
 #include "opencv2/imgproc.hpp"
+#include "opencv2/core/utility.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+namespace
+{
+  /** Windows up to this size are sorted by a sorting network, larger ones use quick select */
+  const int MaxSortingNetworkSize = 32;
+
+  /**
+  * Returns the median (lower median for even n) of n values by sorting them in place with
+  * Batcher's merge exchange network (Knuth, The Art of Computer Programming, Vol. 3, Algorithm 5.2.2M).
+  * The sequence of compare-exchange operations does not depend on the data.
+  */
+  float SortingNetworkMedian(float* values, int n)
+  {
+    if (n <= 1)
+    {
+      return values[0];
+    }
+
+    int t = 0;
+    while ((1 << t) < n)
+    {
+      ++t;
+    }
+
+    for (int p = 1 << (t - 1); p > 0; p >>= 1)
+    {
+      int q = 1 << (t - 1);
+      int r = 0;
+      int d = p;
+      for (;;)
+      {
+        for (int i = 0; i < n - d; ++i)
+        {
+          if ((i & p) == r)
+          {
+            const float a = values[i];
+            const float b = values[i + d];
+            values[i] = std::min(a, b);
+            values[i + d] = std::max(a, b);
+          }
+        }
+        if (q == p)
+        {
+          break;
+        }
+        d = q - p;
+        q >>= 1;
+        r = p;
+      }
+    }
+    return values[(n - 1) / 2];
+  }
+}
 
 mitk::ToFCompositeFilter::ToFCompositeFilter() : m_SegmentationMask(nullptr), m_ImageWidth(0), m_ImageHeight(0), m_ImageSize(0),
-m_IplDistanceImage(nullptr), m_IplOutputImage(nullptr), m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
-  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false), m_DataBuffer(nullptr),
-m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
+m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
+  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false),
+m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_DataBufferNumberOfFrames(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
 m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0)
 {
 }
 
 mitk::ToFCompositeFilter::~ToFCompositeFilter()
 {
-  cvReleaseImage(&(this->m_IplDistanceImage));
-  cvReleaseImage(&(this->m_IplOutputImage));
-  if (m_DataBuffer!=nullptr)
-  {
-    delete [] m_DataBuffer;
-  }
 }
 
 void mitk::ToFCompositeFilter::SetInput(  const InputImageType* distanceImage )
@@ -49,7 +101,7 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  const InputImageType
   }
   else
   {
-    if (idx==0) //create IPL image holding distance data
+    if (idx==0) //create OpenCV image holding distance data
     {
       if (!distanceImage->IsEmpty())
       {
@@ -57,20 +109,12 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  const InputImageType
         this->m_ImageHeight = distanceImage->GetDimension(1);
         this->m_ImageSize = this->m_ImageWidth * this->m_ImageHeight * sizeof(float);
 
-        if (this->m_IplDistanceImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplDistanceImage));
-        }
         ImageReadAccessor distImgAcc(distanceImage, distanceImage->GetSliceData(0,0,0));
         float* distanceFloatData = (float*) distImgAcc.GetData();
-        this->m_IplDistanceImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-        memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
+        this->m_DistanceImage.create(this->m_ImageHeight, this->m_ImageWidth, CV_32FC1);
+        memcpy(this->m_DistanceImage.data, (void*)distanceFloatData, this->m_ImageSize);
 
-        if (this->m_IplOutputImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplOutputImage));
-        }
-        this->m_IplOutputImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
+        this->m_OutputImage.create(this->m_ImageHeight, this->m_ImageWidth, CV_32FC1);
 
         CreateItkImage(this->m_ItkInputImage);
       }
@@ -115,33 +159,33 @@ void mitk::ToFCompositeFilter::GenerateData()
   //mitk::Image::Pointer inputDistanceImage = this->GetInput();
   ImageReadAccessor inputAcc(this->GetInput(), this->GetInput()->GetSliceData(0, 0, 0) );
 
-  // copy initial distance image to ipl image
+  // copy initial distance image to OpenCV image
   float* distanceFloatData = (float*)inputAcc.GetData();
-  memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
+  memcpy(this->m_DistanceImage.data, (void*)distanceFloatData, this->m_ImageSize);
   if (m_ApplyThresholdFilter||m_ApplyMaskSegmentation)
   {
-    ProcessSegmentation(this->m_IplDistanceImage);
+    ProcessSegmentation(this->m_DistanceImage);
   }
   if (this->m_ApplyTemporalMedianFilter||this->m_ApplyAverageFilter)
   {
-    ProcessStreamedQuickSelectMedianImageFilter(this->m_IplDistanceImage);
+    ProcessStreamedQuickSelectMedianImageFilter(this->m_DistanceImage);
   }
   if (this->m_ApplyMedianFilter)
   {
-    ProcessCVMedianFilter(this->m_IplDistanceImage, this->m_IplOutputImage);
-    memcpy( this->m_IplDistanceImage->imageData, this->m_IplOutputImage->imageData, this->m_ImageSize );
+    ProcessCVMedianFilter(this->m_DistanceImage, this->m_OutputImage);
+    cv::swap(this->m_DistanceImage, this->m_OutputImage);
   }
   if (this->m_ApplyBilateralFilter)
   {
       float* itkFloatData = this->m_ItkInputImage->GetBufferPointer();
-      memcpy(itkFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
+      memcpy(itkFloatData, this->m_DistanceImage.data, this->m_ImageSize );
       ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
-      memcpy( this->m_IplDistanceImage->imageData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
+      memcpy( this->m_DistanceImage.data, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
 
-    //ProcessCVBilateralFilter(this->m_IplDistanceImage, this->m_OutputIplImage, domainSigma, rangeSigma, kernelRadius);
-    //memcpy( distanceFloatData, this->m_OutputIplImage->imageData, distanceImageSize );
+    //ProcessCVBilateralFilter(this->m_DistanceImage, this->m_OutputImage);
+    //cv::swap(this->m_DistanceImage, this->m_OutputImage);
   }
-  memcpy( outputDistanceFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
+  memcpy( outputDistanceFloatData, this->m_DistanceImage.data, this->m_ImageSize );
 }
 
 void mitk::ToFCompositeFilter::CreateOutputsForAllInputs()
@@ -172,19 +216,21 @@ void mitk::ToFCompositeFilter::GenerateOutputInformation()
   output->SetPropertyList(input->GetPropertyList()->Clone());
 }
 
-void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
+void mitk::ToFCompositeFilter::ProcessSegmentation(cv::Mat& inputImage)
 {
+  // the accessor has to live as long as the mask data is used
+  std::unique_ptr<ImageReadAccessor> segMaskAcc;
   char* segmentationMask;
   if (m_SegmentationMask.IsNotNull())
   {
-    ImageReadAccessor segMaskAcc(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0));
-    segmentationMask = (char*)segMaskAcc.GetData();
+    segMaskAcc.reset(new ImageReadAccessor(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0)));
+    segmentationMask = (char*)segMaskAcc->GetData();
   }
   else
   {
     segmentationMask = nullptr;
   }
-  float *f = (float*)inputIplImage->imageData;
+  float *f = inputImage.ptr<float>();
   for(int i=0; i<this->m_ImageWidth*this->m_ImageHeight; i++)
   {
     if (this->m_ApplyThresholdFilter)
@@ -224,93 +270,88 @@ ItkImageType2D::Pointer mitk::ToFCompositeFilter::ProcessItkBilateralFilter(ItkI
   return outputItkImage;
 }
 
-void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage)
+void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(const cv::Mat& inputImage, cv::Mat& outputImage)
 {
   int diameter = m_BilateralFilterKernelRadius;
   double sigmaColor = m_BilateralFilterRangeSigma;
   double sigmaSpace = m_BilateralFilterDomainSigma;
-  cvSmooth(inputIplImage, outputIplImage, CV_BILATERAL, diameter, 0, sigmaColor, sigmaSpace);
+  cv::bilateralFilter(inputImage, outputImage, diameter, sigmaColor, sigmaSpace, cv::BORDER_REPLICATE);
 }
 
-void mitk::ToFCompositeFilter::ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius)
+void mitk::ToFCompositeFilter::ProcessCVMedianFilter(const cv::Mat& inputImage, cv::Mat& outputImage, int radius)
 {
-  cvSmooth(inputIplImage, outputIplImage, CV_MEDIAN, radius, 0, 0, 0);
+  cv::medianBlur(inputImage, outputImage, radius);
 }
 
-void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage)
+void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(cv::Mat& inputImage)
 {
-  float* data = (float*)inputIplImage->imageData;
-
-  int imageSize = inputIplImage->width * inputIplImage->height;
-  float* tmpArray;
-
-  if (this->m_TemporalMedianFilterNumOfFrames == 0)
+  if (this->m_TemporalMedianFilterNumOfFrames <= 0)
   {
     return;
   }
 
-  if (m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize) // reset
-  {
-    //delete current buffer
-    for( int i=0; i<this->m_DataBufferMaxSize; i++ ) {
-      delete[] this->m_DataBuffer[i];
-    }
-    if (this->m_DataBuffer != nullptr)
-    {
-      delete[] this->m_DataBuffer;
-    }
+  const std::size_t imageSize = inputImage.total();
 
+  if (m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize ||
+      this->m_DataBufferSums.size() != imageSize) // reset
+  {
     this->m_DataBufferMaxSize = m_TemporalMedianFilterNumOfFrames;
-
-    // create new buffer with current size
-    this->m_DataBuffer = new float*[this->m_DataBufferMaxSize];
-    for(int i=0; i<this->m_DataBufferMaxSize; i++)
-    {
-      this->m_DataBuffer[i] = nullptr;
-    }
+    this->m_DataBuffer.assign(imageSize * this->m_DataBufferMaxSize, 0.0f);
+    this->m_DataBufferSums.assign(imageSize, 0.0);
     this->m_DataBufferCurrentIndex = 0;
+    this->m_DataBufferNumberOfFrames = 0;
   }
 
-  int currentBufferSize = this->m_DataBufferMaxSize;
-  tmpArray = new float[this->m_DataBufferMaxSize];
+  const int bufferSize = this->m_DataBufferMaxSize;
+  const int currentIndex = this->m_DataBufferCurrentIndex;
+  const bool replaceFrame = this->m_DataBufferNumberOfFrames == bufferSize;
+  const int numberOfFrames = replaceFrame ? bufferSize : this->m_DataBufferNumberOfFrames + 1;
 
-  // copy data to buffer
-  if (this->m_DataBuffer[this->m_DataBufferCurrentIndex] == nullptr)
+  cv::parallel_for_(cv::Range(0, inputImage.rows), [&](const cv::Range& rows)
   {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex] = new float[imageSize];
-    currentBufferSize = this->m_DataBufferCurrentIndex + 1;
-  }
-
-  for(int j=0; j<imageSize; j++)
-  {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex][j] = data[j];
-  }
+    std::vector<float> window(numberOfFrames);
 
-  float tmpValue = 0.0f;
-  for(int i=0; i<imageSize; i++)
-  {
-    if (m_ApplyAverageFilter)
-    {
-      tmpValue = 0.0f;
-      for(int j=0; j<currentBufferSize; j++)
-      {
-          tmpValue+=this->m_DataBuffer[j][i];
-      }
-      data[i] = tmpValue/currentBufferSize;
-    }
-    else if (m_ApplyTemporalMedianFilter)
+    for (int y = rows.start; y < rows.end; ++y)
     {
-      for(int j=0; j<currentBufferSize; j++)
+      float* data = inputImage.ptr<float>(y);
+      for (int x = 0; x < inputImage.cols; ++x)
       {
-        tmpArray[j] = this->m_DataBuffer[j][i];
+        const std::size_t pixel = static_cast<std::size_t>(y) * inputImage.cols + x;
+        float* values = &this->m_DataBuffer[pixel * bufferSize];
+        double& sum = this->m_DataBufferSums[pixel];
+
+        // update the running sum; it is recomputed once per pass through the buffer to avoid accumulating rounding errors
+        if (currentIndex == 0)
+        {
+          values[0] = data[x];
+          sum = std::accumulate(values, values + numberOfFrames, 0.0);
+        }
+        else
+        {
+          if (replaceFrame)
+          {
+            sum -= values[currentIndex];
+          }
+          values[currentIndex] = data[x];
+          sum += data[x];
+        }
+
+        if (m_ApplyAverageFilter)
+        {
+          data[x] = static_cast<float>(sum / numberOfFrames);
+        }
+        else if (m_ApplyTemporalMedianFilter)
+        {
+          std::copy(values, values + numberOfFrames, window.begin());
+          data[x] = numberOfFrames <= MaxSortingNetworkSize ? SortingNetworkMedian(window.data(), numberOfFrames)
+                                                            : quick_select(window.data(), numberOfFrames);
+        }
       }
-      data[i] = quick_select(tmpArray, currentBufferSize);
     }
-  }
-
-  this->m_DataBufferCurrentIndex = (this->m_DataBufferCurrentIndex + 1) % this->m_DataBufferMaxSize;
+  });
 
-  delete[] tmpArray;
+  this->m_DataBufferCurrentIndex = (currentIndex + 1) % bufferSize;
+  this->m_DataBufferNumberOfFrames = numberOfFrames;
 }
 
 #define ELEM_SWAP(a,b) { register float t=(a);(a)=(b);(b)=t; }
@@ -18,6 +18,8 @@ found in the LICENSE file.
 #include <itkBilateralImageFilter.h>
 #include "opencv2/core.hpp"
 
+#include <vector>
+
 typedef itk::Image<float, 2> ItkImageType2D;
 typedef itk::Image<float, 3> ItkImageType3D;
 typedef itk::BilateralImageFilter<ItkImageType2D,ItkImageType2D> BilateralFilterType;
@@ -129,26 +131,29 @@ namespace mitk
     All pixels with values outside the mask, below the lower threshold (min) and above the upper threshold (max)
     are assigned the pixel value 0
     */
-    void ProcessSegmentation(IplImage* inputIplImage);
+    void ProcessSegmentation(cv::Mat& inputImage);
     /*!
     \brief Applies the ITK bilateral filter to the input image
     See http://www.itk.org/Doxygen320/html/classitk_1_1BilateralImageFilter.html for more details.
     */
     ItkImageType2D::Pointer ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage);
     /*!
-    \brief Applies the OpenCV bilateral filter to the input image.
-    See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
+    \brief Applies the OpenCV bilateral filter (cv::bilateralFilter) to the input image.
     */
-    void ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage);
+    void ProcessCVBilateralFilter(const cv::Mat& inputImage, cv::Mat& outputImage);
     /*!
-    \brief Applies the OpenCV median filter to the input image.
-    See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
+    \brief Applies the OpenCV median filter (cv::medianBlur) to the input image.
+    \param radius aperture size of the filter mask, 3 or 5 for float images
     */
-    void ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius = 3);
+    void ProcessCVMedianFilter(const cv::Mat& inputImage, cv::Mat& outputImage, int radius = 3);
     /*!
-    \brief Performs temporal median filter on an image given the number of frames to be considered
+    \brief Performs the temporal median or average filter on an image given the number of frames to be considered
+
+    The last frames are kept in a ring buffer which stores the values of a pixel next to each other. The average
+    filter uses a running sum per pixel, the median of small windows is computed by a sorting network. The image
+    rows are processed in parallel.
     */
-    void ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage);
+    void ProcessStreamedQuickSelectMedianImageFilter(cv::Mat& inputImage);
     /*!
     \brief Quickselect algorithm
     * This Quickselect routine is based on the algorithm described in
@@ -168,8 +173,8 @@ namespace mitk
     int m_ImageHeight; ///< y-dimension of the image
     int m_ImageSize; ///< size of the image in bytes
 
-    IplImage* m_IplDistanceImage; ///< OpenCV-representation of the distance image
-    IplImage* m_IplOutputImage; ///< OpenCV-representation of the output image
+    cv::Mat m_DistanceImage; ///< OpenCV-representation of the distance image
+    cv::Mat m_OutputImage; ///< OpenCV-representation of the output image
 
     ItkImageType2D::Pointer m_ItkInputImage; ///< ITK representation of the distance image
 
@@ -180,9 +185,11 @@ namespace mitk
     bool m_ApplyMaskSegmentation; ///< Flag indicating if a mask segmentation is performed
     bool m_ApplyBilateralFilter; ///< Flag indicating if the bilateral filter is currently active for processing the distance image
 
-    float** m_DataBuffer; ///< Buffer used for calculating the pixel-wise median over the last n (m_TemporalMedianFilterNumOfFrames) number of frames
+    std::vector<float> m_DataBuffer; ///< Ring buffer used for calculating the pixel-wise median over the last n (m_TemporalMedianFilterNumOfFrames) number of frames. The n values of a pixel are stored consecutively
+    std::vector<double> m_DataBufferSums; ///< Pixel-wise sum of the values in the buffer, used by the average filter
     int m_DataBufferCurrentIndex; ///< Current index in the buffer of the temporal median filter
     int m_DataBufferMaxSize; ///< Maximal size for the buffer of the temporal median filter (m_DataBuffer)
+    int m_DataBufferNumberOfFrames; ///< Number of frames currently held in the buffer of the temporal median filter
 
     int m_TemporalMedianFilterNumOfFrames; ///< Number of frames to be used in the calculation of the temporal median
     int m_ThresholdFilterMin; ///< Lower threshold of the threshold filter. Pixels with values below will be assigned value 0 when applying the threshold filter
@@ -48,11 +48,8 @@ found in the LICENSE file.
 #include <itkImageFileWriter.h>
 
 // Resampling
-#include <itkResampleImageFilter.h>
-#include <itkNearestNeighborInterpolateImageFunction.h>
-#include <itkBSplineInterpolateImageFunction.h>
+#include <itkSeparableResampleImageFilter.h>
 #include <itkCastImageFilter.h>
-#include <itkLinearInterpolateImageFunction.h>
 
 #include <itkRescaleIntensityImageFilter.h>
 #include <itkShiftScaleImageFilter.h>
@@ -67,14 +64,9 @@ typedef itk::Image<unsigned char, 3>
 typedef itk::Image<double, 3>                                                           DoubleImageType;
 typedef itk::Image<itk::Vector<float,3>, 3>                                             VectorImageType;
 
-typedef itk::ResampleImageFilter< ImageType, ImageType >                                ResampleImageFilterType;
-typedef itk::ResampleImageFilter< ImageType, ImageType >                                ResampleImageFilterType2;
+typedef itk::SeparableResampleImageFilter< ImageType, ImageType >                       ResampleImageFilterType;
 typedef itk::CastImageFilter< ImageType, DoubleImageType >                               ImagePTypeToFloatPTypeCasterType;
 
-typedef itk::LinearInterpolateImageFunction< ImageType, double >                        LinearInterpolatorType;
-typedef itk::NearestNeighborInterpolateImageFunction< ImageType, double >               NearestInterpolatorType;
-typedef itk::BSplineInterpolateImageFunction<ImageType, double>                         BSplineInterpolatorType;
-
 
 QmitkPreprocessingResampling::QmitkPreprocessingResampling()
 : QmitkAbstractView(),
@@ -308,30 +300,25 @@ void QmitkPreprocessingResampling::StartButtonClicked()
       {
       case LINEAR:
         {
-          LinearInterpolatorType::Pointer interpolator = LinearInterpolatorType::New();
-          resampler->SetInterpolator(interpolator);
+          resampler->SetInterpolator(ResampleImageFilterType::Linear);
           selectedInterpolator = "Linear";
           break;
         }
       case NEAREST:
         {
-          NearestInterpolatorType::Pointer interpolator = NearestInterpolatorType::New();
-          resampler->SetInterpolator(interpolator);
+          resampler->SetInterpolator(ResampleImageFilterType::NearestNeighbor);
           selectedInterpolator = "Nearest";
           break;
       }
       case SPLINE:
       {
-        BSplineInterpolatorType::Pointer interpolator = BSplineInterpolatorType::New();
-        interpolator->SetSplineOrder(3);
-        resampler->SetInterpolator(interpolator);
+        resampler->SetInterpolator(ResampleImageFilterType::BSpline);
         selectedInterpolator = "B-Spline";
         break;
       }
       default:
         {
-          LinearInterpolatorType::Pointer interpolator = LinearInterpolatorType::New();
-          resampler->SetInterpolator(interpolator);
+          resampler->SetInterpolator(ResampleImageFilterType::Linear);
           selectedInterpolator = "Linear";
           break;
         }
@@ -378,7 +365,6 @@ void QmitkPreprocessingResampling::StartButtonClicked()
 
       resampler->SetSize( output_size );
       resampler->SetOutputSpacing( output_spacing );
-      resampler->SetOutputDirection( itkImage->GetDirection() );
 
       resampler->UpdateLargestPossibleRegion();
 